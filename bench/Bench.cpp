@@ -0,0 +1,139 @@
+#include "Bench.h"
+
+#include <new>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+static std::atomic<uint64_t> g_allocations_count(0);
+static std::atomic<uint64_t> g_sink(0);
+
+// MSVC has no std::aligned_alloc, its aligned blocks must also go back through _aligned_free
+static void* AlignedAlloc(std::size_t size, std::size_t alignment)
+{
+    size = size ? size : 1;
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void AlignedFree(void* ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned overloads
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    g_allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = AlignedAlloc(size, static_cast<std::size_t>(alignment)))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace PewParser {
+
+    BenchRunner::BenchRunner(std::ostream& out, double min_time, const std::string& filter)
+        : out_(out), min_time_(min_time), filter_(filter)
+    {
+        char header[128];
+        std::snprintf(header, sizeof(header), "%-56s %12s %14s %12s %12s\n", "benchmark", "iterations", "ns/op", "MB/s", "allocs/op");
+        out_ << header;
+    }
+
+    uint64_t BenchRunner::GetAllocationsCount()
+    {
+        return g_allocations_count.load(std::memory_order_relaxed);
+    }
+
+    void BenchRunner::Consume(uint64_t value)
+    {
+        g_sink.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    bool BenchRunner::Matches(const std::string& name) const
+    {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    void BenchRunner::Report(const Result& result)
+    {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-56s %12llu %14.1f %12.1f %12.2f\n",
+            result.name.c_str(), (unsigned long long)result.iterations, result.ns_per_op, result.bytes_per_sec / (1024 * 1024), result.allocs_per_op);
+        out_ << line << std::flush;
+    }
+
+}
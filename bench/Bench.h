@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+namespace PewParser {
+
+    // Calibrating micro benchmark runner, every case is repeated until it ran for at least min_time seconds.
+    // Allocations are counted through the replaced global operator new in Bench.cpp.
+    class BenchRunner
+    {
+    public:
+        struct Result
+        {
+            std::string name;
+            uint64_t iterations;
+            double ns_per_op;
+            double bytes_per_sec;
+            double allocs_per_op;
+        };
+    public:
+        BenchRunner(std::ostream& out, double min_time, const std::string& filter);
+
+        template<typename Func>
+        void Run(const std::string& name, uint64_t bytes_per_op, Func&& func);
+
+        const std::vector<Result>& GetResults() const { return results_; }
+
+        static uint64_t GetAllocationsCount();
+        static void Consume(uint64_t value);
+    private:
+        bool Matches(const std::string& name) const;
+        void Report(const Result& result);
+    private:
+        std::ostream& out_;
+        double min_time_;
+        std::string filter_;
+        std::vector<Result> results_;
+    };
+
+    template<typename Func>
+    void BenchRunner::Run(const std::string& name, uint64_t bytes_per_op, Func&& func)
+    {
+        if (!Matches(name))
+            return;
+
+        func();
+
+        uint64_t iterations = 1;
+        while (true)
+        {
+            uint64_t allocations_before = GetAllocationsCount();
+            auto begin = std::chrono::steady_clock::now();
+
+            for (uint64_t i = 0; i < iterations; i++)
+                func();
+
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            uint64_t allocations = GetAllocationsCount() - allocations_before;
+
+            if (elapsed >= min_time_ || iterations >= (1ull << 32))
+            {
+                Result result;
+                result.name = name;
+                result.iterations = iterations;
+                result.ns_per_op = elapsed * 1e9 / iterations;
+                result.bytes_per_sec = bytes_per_op ? (double)bytes_per_op * iterations / elapsed : 0;
+                result.allocs_per_op = (double)allocations / iterations;
+
+                Report(result);
+                results_.push_back(result);
+                return;
+            }
+
+            // Aim a little past min_time so the next round is usually the last one
+            double scale = (elapsed > 0) ? (min_time_ * 1.4 / elapsed) : 100;
+            iterations = (uint64_t)(iterations * std::min(std::max(scale, 2.0), 100.0));
+        }
+    }
+
+}
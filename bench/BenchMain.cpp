@@ -0,0 +1,791 @@
+#include <PewParser/PewParser.h>
+#include <Terminal/Commands.h>
+#include <Utf16.h>
+
+#include "Bench.h"
+#include "SyntheticPE.h"
+
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <iostream>
+#include <streambuf>
+
+using namespace PewParser;
+
+namespace {
+
+    struct Sample
+    {
+        std::string name;
+        std::vector<BYTE> image;
+
+        RawFile MakeRawFile()
+        {
+            return RawFile(std::filesystem::path(), name, image.size(), image.data(), RawFile::Backing::BORROWED);
+        }
+    };
+
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    const std::pair<SimdIsa, const char*> kIsas[] = {
+        { SimdIsa::SCALAR, "scalar" },
+        { SimdIsa::SSE2, "sse2" },
+        { SimdIsa::AVX2, "avx2" },
+    };
+
+    Sample MakeSample(const std::string& name, const SyntheticPE::Config& config)
+    {
+        return { name, SyntheticPE::Build(config) };
+    }
+
+    SyntheticPE::Config SectionsConfig(size_t sections_count)
+    {
+        SyntheticPE::Config config;
+        config.sections_count = sections_count;
+        config.libraries_count = 4;
+        config.imports_per_library = 16;
+        return config;
+    }
+
+    SyntheticPE::Config ImportsConfig(size_t libraries_count, size_t imports_per_library)
+    {
+        SyntheticPE::Config config;
+        config.libraries_count = libraries_count;
+        config.imports_per_library = imports_per_library;
+        return config;
+    }
+
+    SyntheticPE::Config DelayImportsConfig(size_t libraries_count, size_t imports_per_library)
+    {
+        SyntheticPE::Config config;
+        config.libraries_count = 1;
+        config.imports_per_library = imports_per_library;
+        config.delay_libraries_count = libraries_count;
+        return config;
+    }
+
+    SyntheticPE::Config ExportsConfig(size_t exports_count)
+    {
+        SyntheticPE::Config config;
+        config.exports_count = exports_count;
+        return config;
+    }
+
+    SyntheticPE::Config RsrcConfig(size_t types_count, size_t names_per_type, size_t langs_per_name)
+    {
+        SyntheticPE::Config config;
+        config.rsrc_types_count = types_count;
+        config.rsrc_names_per_type = names_per_type;
+        config.rsrc_langs_per_name = langs_per_name;
+        return config;
+    }
+
+    SyntheticPE::Config RelocsConfig(size_t relocs_count)
+    {
+        SyntheticPE::Config config;
+        config.relocs_count = relocs_count;
+        return config;
+    }
+
+    SyntheticPE::Config FunctionsConfig(size_t functions_count)
+    {
+        SyntheticPE::Config config;
+        config.functions_count = functions_count;
+        return config;
+    }
+
+    SyntheticPE::Config GuardFunctionsConfig(size_t guard_functions_count)
+    {
+        SyntheticPE::Config config;
+        config.load_config_version = 4;
+        config.guard_functions_count = guard_functions_count;
+        return config;
+    }
+
+    // Level by level through the cursor API, kept as the baseline for GetRsrcTree
+    size_t WalkRsrcTree(ResourceDirWrapper& wrapper, IMAGE_RESOURCE_DIRECTORY* rsrc_dir, uint32_t level)
+    {
+        size_t nodes_count = 0;
+
+        wrapper.SetCurrentRsrcDir(rsrc_dir);
+        size_t entries_count = wrapper.GetEntriesCount();
+
+        for (index_t entry = 0; entry < entries_count; entry++)
+        {
+            wrapper.SetCurrentRsrcDir(rsrc_dir);
+            wrapper.SetCurrentEntry(entry);
+            nodes_count++;
+
+            if (wrapper.IsDirectory() && level < ResourceDirWrapper::TreeLevel::LANGUAGE)
+            {
+                IMAGE_RESOURCE_DIRECTORY* child = wrapper.GetEntryRsrcDir(entry);
+                if (child)
+                    nodes_count += WalkRsrcTree(wrapper, child, level + 1);
+            }
+        }
+
+        return nodes_count;
+    }
+
+    void RunParserBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            runner.Run("ValidatePE/" + sample.name, sample.image.size(), [&]() {
+                BenchRunner::Consume((uint64_t)PEParser::ValidatePE(raw_file));
+            });
+        }
+
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEType type = PEParser::ValidatePE(raw_file);
+
+            runner.Run("PEFile/" + sample.name, sample.image.size(), [&]() {
+                PEFile pe(raw_file, type);
+                BenchRunner::Consume(pe.GetNumOfSections());
+            });
+
+            Arena arena;
+            runner.Run("PEFile+Arena/" + sample.name, sample.image.size(), [&]() {
+                {
+                    PEFile pe(raw_file, type, &arena);
+                    BenchRunner::Consume(pe.GetNumOfSections());
+                }
+                arena.Reset();
+            });
+        }
+    }
+
+    void RunRvaToRawBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            // Uniform over the mapped part of the image, so the last-hit cache only helps by chance
+            std::vector<offset_t> rvas(4096);
+            std::mt19937 rng(42);
+            DWORD first_rva = pe.GetSectionHdrsWrapper()->GetRootSectionHdr()->VirtualAddress;
+            std::uniform_int_distribution<DWORD> dist(first_rva, first_rva + (DWORD)sample.image.size());
+            for (offset_t& rva : rvas)
+                rva = dist(rng);
+
+            index_t next = 0;
+            runner.Run("RvaToRaw/" + sample.name, 0, [&]() {
+                BenchRunner::Consume(pe.RvaToRaw(rvas[next++ & (rvas.size() - 1)]));
+            });
+        }
+    }
+
+    void RunImportBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            runner.Run("ImportDirWrapper/" + sample.name, sample.image.size(), [&]() {
+                ImportDirWrapper wrapper(&pe);
+                const ImportTable& table = wrapper.GetImportTable();
+
+                uint64_t names_size = 0;
+                for (index_t func = 0; func < table.GetTotalFuncCount(); func++)
+                    names_size += table.names[func].size() + table.ordinals[func];
+                BenchRunner::Consume(names_size);
+            });
+        }
+    }
+
+    void RunDelayImportBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            runner.Run("DelayImportDirWrapper/" + sample.name, sample.image.size(), [&]() {
+                DelayImportDirWrapper wrapper(&pe);
+                const ImportTable& table = wrapper.GetImportTable();
+
+                uint64_t names_size = 0;
+                for (index_t func = 0; func < table.GetTotalFuncCount(); func++)
+                    names_size += table.names[func].size() + table.ordinals[func];
+                BenchRunner::Consume(names_size);
+            });
+        }
+    }
+
+    void RunExportBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            runner.Run("ExportDirWrapper::CacheNames/" + sample.name, sample.image.size(), [&]() {
+                ExportDirWrapper wrapper(&pe);
+                BenchRunner::Consume(wrapper.GetNumOfNames());
+            });
+
+            ExportDirWrapper* wrapper = pe.GetExportDirWrapper();
+            std::vector<std::string> names;
+            for (index_t func = 0; func < wrapper->GetNumOfNames(); func += std::max<size_t>(wrapper->GetNumOfNames() / 256, 1))
+                names.push_back(SyntheticPE::ExportName(func));
+
+            index_t next = 0;
+            runner.Run("ExportDirWrapper::FindExportByName/" + sample.name, 0, [&]() {
+                index_t EAT_entry = 0;
+                wrapper->FindExportByName(names[next++ % names.size()], EAT_entry);
+                BenchRunner::Consume(EAT_entry);
+            });
+        }
+    }
+
+    void RunRsrcBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            runner.Run("ResourceDirWrapper cursor walk/" + sample.name, sample.image.size(), [&]() {
+                ResourceDirWrapper wrapper(&pe);
+                BenchRunner::Consume(WalkRsrcTree(wrapper, wrapper.GetRootRsrcDir(), ResourceDirWrapper::TreeLevel::ROOT));
+            });
+
+            runner.Run("ResourceDirWrapper::GetRsrcTree/" + sample.name, sample.image.size(), [&]() {
+                ResourceDirWrapper wrapper(&pe);
+                BenchRunner::Consume(wrapper.GetRsrcTree().GetNodesCount());
+            });
+
+            runner.Run("ResourceDirWrapper::GetPayloads/" + sample.name, sample.image.size(), [&]() {
+                ResourceDirWrapper wrapper(&pe);
+                uint64_t payloads_size = 0;
+                for (const RsrcPayload& payload : wrapper.GetPayloads())
+                    payloads_size += payload.data.size();
+                BenchRunner::Consume(payloads_size);
+            });
+
+            Arena arena;
+            runner.Run("ResourceDirWrapper::GetRsrcTree+Arena/" + sample.name, sample.image.size(), [&]() {
+                {
+                    PEFile arena_pe(raw_file, PEParser::ValidatePE(raw_file), &arena);
+                    BenchRunner::Consume(arena_pe.GetResourceDirWrapper()->GetRsrcTree().GetNodesCount());
+                }
+                arena.Reset();
+            });
+        }
+    }
+
+    void RunRsrcNamesBenchmarks(BenchRunner& runner, Sample& sample)
+    {
+        RawFile raw_file = sample.MakeRawFile();
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        const RsrcTree& tree = pe.GetResourceDirWrapper()->GetRsrcTree();
+
+        runner.Run("ResourceDirWrapper::GetNodeName/" + sample.name, 0, [&]() {
+            std::string name;
+            uint64_t names_size = 0;
+            for (const RsrcNode& node : tree.nodes)
+            {
+                if (node.IsString())
+                {
+                    pe.GetResourceDirWrapper()->GetNodeName(node, name);
+                    names_size += name.size();
+                }
+            }
+            BenchRunner::Consume(names_size);
+        });
+    }
+
+    void RunRelocBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            runner.Run("RelocDirWrapper/" + sample.name, sample.image.size(), [&]() {
+                RelocDirWrapper wrapper(&pe);
+                BenchRunner::Consume(wrapper.GetRelocTable().GetFixupsCount());
+            });
+
+            const RelocTable& table = pe.GetRelocDirWrapper()->GetRelocTable();
+            std::vector<DWORD> rvas(table.GetTotalEntriesCount());
+            std::vector<BYTE> types(table.GetTotalEntriesCount());
+
+            for (const auto& [isa, isa_name] : kIsas)
+            {
+                if (isa > GetSimdIsa())
+                    continue;
+
+                runner.Run(std::string("RelocDirWrapper::DecodeEntries/") + isa_name + "/" + sample.name, table.GetTotalEntriesCount() * sizeof(WORD), [&]() {
+                    for (index_t block = 0; block < table.GetBlocksCount(); block++)
+                    {
+                        const BYTE* entries = pe.GetContentAt(table.block_offsets[block] + sizeof(IMAGE_BASE_RELOCATION), OffsetType::RAW);
+                        index_t first = table.entry_begin[block];
+                        RelocDirWrapper::DecodeEntries(isa, entries, table.GetEntriesCount(block), table.page_rvas[block], rvas.data() + first, types.data() + first);
+                    }
+                    BenchRunner::Consume(rvas.back());
+                });
+            }
+        }
+    }
+
+    void RunExceptionBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            runner.Run("ExceptionDirWrapper/" + sample.name, sample.image.size(), [&]() {
+                ExceptionDirWrapper wrapper(&pe);
+                BenchRunner::Consume(wrapper.GetFunctionsCount());
+            });
+
+            // 64k lookups over the whole table, in address order (coverage traces) and shuffled
+            ExceptionDirWrapper* wrapper = pe.GetExceptionDirWrapper();
+            const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY& last = wrapper->GetFunction(wrapper->GetFunctionsCount() - 1);
+            DWORD first_rva = wrapper->GetFunction(0).BeginAddress;
+            DWORD span = last.EndAddress - first_rva;
+
+            std::vector<DWORD> rvas(64 * 1024);
+            for (index_t i = 0; i < rvas.size(); i++)
+                rvas[i] = first_rva + (DWORD)((uint64_t)span * i / rvas.size());
+
+            auto find_all = [&]() {
+                int64_t found = 0;
+                for (DWORD rva : rvas)
+                    found += wrapper->FindFunction(rva);
+                BenchRunner::Consume(found);
+            };
+
+            runner.Run("ExceptionDirWrapper::FindFunction/sequential/" + sample.name, rvas.size() * sizeof(DWORD), find_all);
+
+            std::shuffle(rvas.begin(), rvas.end(), std::mt19937(42));
+            runner.Run("ExceptionDirWrapper::FindFunction/random/" + sample.name, rvas.size() * sizeof(DWORD), find_all);
+
+            runner.Run("ExceptionDirWrapper::GetUnwindInfo/" + sample.name, 0, [&]() {
+                UnwindInfo unwind_info;
+                size_t codes_count = 0;
+                for (index_t function = 0; function < wrapper->GetFunctionsCount(); function++)
+                {
+                    if (wrapper->GetUnwindInfo(function, unwind_info))
+                        codes_count += unwind_info.codes_count;
+                }
+                BenchRunner::Consume(codes_count);
+            });
+        }
+    }
+
+    void RunLoadConfigBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+            runner.Run("LoadConfigDirWrapper/" + sample.name, sample.image.size(), [&]() {
+                LoadConfigDirWrapper wrapper(&pe);
+                BenchRunner::Consume(wrapper.GetTable(LoadConfigDirWrapper::GUARD_CF_FUNCTIONS).count);
+            });
+
+            const LoadConfigTable& functions = pe.GetLoadConfigDirWrapper()->GetTable(LoadConfigDirWrapper::GUARD_CF_FUNCTIONS);
+            std::vector<DWORD> rvas(functions.count);
+
+            runner.Run("LoadConfigTable::GetRva/" + sample.name, functions.data.size(), [&]() {
+                for (index_t function = 0; function < functions.count; function++)
+                    rvas[function] = functions.GetRva(function);
+                BenchRunner::Consume(rvas.back());
+            });
+
+            runner.Run("LoadConfigTable::ExtractRvas/" + sample.name, functions.data.size(), [&]() {
+                functions.ExtractRvas(rvas.data());
+                BenchRunner::Consume(rvas.back());
+            });
+        }
+    }
+
+    void RunRebaseBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            ULONGLONG image_base = ImageMapper::GetPreferredBase(&pe) + 0x10000000;
+
+            runner.Run("ImageMapper::Map/" + sample.name, sample.image.size(), [&]() {
+                ImageMapper mapper;
+                BenchRunner::Consume(mapper.Map(&pe, image_base).GetStats().fixups_applied);
+            });
+
+            ImageMapper pooled_mapper;
+            runner.Run("ImageMapper::Map+Pool/" + sample.name, sample.image.size(), [&]() {
+                BenchRunner::Consume(pooled_mapper.Map(&pe, image_base).GetStats().fixups_applied);
+            });
+        }
+    }
+
+    void RunAuthenticodeBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            AuthenticodeHasher hasher(&pe);
+
+            runner.Run("AuthenticodeHasher/sha1/" + sample.name, sample.image.size(), [&]() {
+                BenchRunner::Consume(hasher.Compute(DigestAlgorithm::SHA1).bytes[0]);
+            });
+
+            runner.Run("AuthenticodeHasher/sha256/" + sample.name, sample.image.size(), [&]() {
+                BenchRunner::Consume(hasher.Compute(DigestAlgorithm::SHA256).bytes[0]);
+            });
+
+            // Both digests from one pass over the image
+            runner.Run("AuthenticodeHasher/sha1+sha256/" + sample.name, sample.image.size(), [&]() {
+                Digest digests[2];
+                digests[0].algorithm = DigestAlgorithm::SHA1;
+                digests[1].algorithm = DigestAlgorithm::SHA256;
+                hasher.Compute(digests, 2);
+                BenchRunner::Consume(digests[0].bytes[0] ^ digests[1].bytes[0]);
+            });
+        }
+    }
+
+    void RunHashBenchmarks(BenchRunner& runner)
+    {
+        std::vector<BYTE> input(1 << 20);
+        std::mt19937 rng(42);
+        for (BYTE& byte : input)
+            byte = (BYTE)rng();
+
+        runner.Run("Md5", input.size(), [&]() {
+            BYTE digest[Md5::kDigestSize];
+            Md5 md5;
+            md5.Update(input.data(), input.size());
+            md5.Final(digest);
+            BenchRunner::Consume(digest[0]);
+        });
+
+        // The portable rounds against SHA-NI, the second run is skipped when the CPU lacks it
+        for (bool use_sha_extensions : { false, true })
+        {
+            if (use_sha_extensions && !HasShaExtensions())
+                continue;
+
+            std::string variant = use_sha_extensions ? "/sha_ni" : "/scalar";
+            runner.Run("Sha1" + variant, input.size(), [&]() {
+                BYTE digest[Sha1::kDigestSize];
+                Sha1 sha1(use_sha_extensions);
+                sha1.Update(input.data(), input.size());
+                sha1.Final(digest);
+                BenchRunner::Consume(digest[0]);
+            });
+
+            runner.Run("Sha256" + variant, input.size(), [&]() {
+                BYTE digest[Sha256::kDigestSize];
+                Sha256 sha256(use_sha_extensions);
+                sha256.Update(input.data(), input.size());
+                sha256.Final(digest);
+                BenchRunner::Consume(digest[0]);
+            });
+        }
+    }
+
+    void RunFileHasherBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        std::vector<size_t> threads_counts = { 1 };
+        if (std::thread::hardware_concurrency() > 1)
+            threads_counts.push_back(std::thread::hardware_concurrency());
+
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            FileHasher hasher(&pe);
+            std::vector<Digest> section_digests(hasher.GetSectionsCount());
+
+            Digest digests[3];
+            digests[0].algorithm = DigestAlgorithm::MD5;
+            digests[1].algorithm = DigestAlgorithm::SHA1;
+            digests[2].algorithm = DigestAlgorithm::SHA256;
+
+            // One digest per pass over the file, what the pipeline replaces
+            runner.Run("FileHasher/separate_passes/" + sample.name, sample.image.size(), [&]() {
+                for (Digest& digest : digests)
+                    hasher.Compute(&digest, 1, nullptr);
+                BenchRunner::Consume(digests[0].bytes[0] ^ digests[1].bytes[0] ^ digests[2].bytes[0]);
+            });
+
+            runner.Run("FileHasher/one_pass/" + sample.name, sample.image.size(), [&]() {
+                hasher.Compute(digests, 3, nullptr);
+                BenchRunner::Consume(digests[0].bytes[0] ^ digests[1].bytes[0] ^ digests[2].bytes[0]);
+            });
+
+            for (size_t threads : threads_counts)
+            {
+                runner.Run("FileHasher/one_pass+sections,threads=" + std::to_string(threads) + "/" + sample.name, sample.image.size(), [&]() {
+                    hasher.Compute(digests, 3, section_digests.data(), threads);
+                    BenchRunner::Consume(digests[0].bytes[0] ^ section_digests[0].bytes[0]);
+                });
+            }
+        }
+    }
+
+    void RunChecksumBenchmarks(BenchRunner& runner, std::vector<Sample>& samples)
+    {
+        for (Sample& sample : samples)
+        {
+            RawFile raw_file = sample.MakeRawFile();
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            offset_t checksum_offset = pe.GetOptionalHdrOffset() + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum);
+
+            for (const auto& [isa, isa_name] : kIsas)
+            {
+                if (isa > GetSimdIsa())
+                    continue;
+
+                runner.Run(std::string("ComputeImageChecksum/") + isa_name + "/" + sample.name, sample.image.size(), [&]() {
+                    BenchRunner::Consume(ComputeImageChecksum(isa, sample.image.data(), sample.image.size(), checksum_offset));
+                });
+            }
+        }
+    }
+
+    void RunEntropyBenchmarks(BenchRunner& runner)
+    {
+        // Zero filled input is the worst case for a single count table, every increment waits on the previous one
+        std::vector<std::pair<std::string, std::vector<BYTE>>> inputs(2);
+        inputs[0].first = "zeros";
+        inputs[1].first = "random";
+        inputs[0].second.resize(1 << 20);
+        inputs[1].second.resize(1 << 20);
+
+        std::mt19937 rng(42);
+        for (BYTE& byte : inputs[1].second)
+            byte = (BYTE)rng();
+
+        for (const auto& [name, input] : inputs)
+        {
+            runner.Run("CountBytes/single_table/" + name, input.size(), [&]() {
+                uint64_t counts[kByteValuesCount] = {};
+                for (BYTE byte : input)
+                    counts[byte]++;
+                BenchRunner::Consume(counts[0]);
+            });
+
+            runner.Run("CountBytes/" + name, input.size(), [&]() {
+                uint64_t counts[kByteValuesCount] = {};
+                CountBytes(input.data(), input.size(), counts);
+                BenchRunner::Consume(counts[0]);
+            });
+
+            std::vector<double> entropies(GetEntropyWindowsCount(input.size(), 256, 64));
+            for (size_t step : { 256, 64 })
+            {
+                runner.Run("ComputeWindowedEntropy/window=256,step=" + std::to_string(step) + "/" + name, input.size(), [&]() {
+                    ComputeWindowedEntropy(input.data(), input.size(), 256, step, entropies.data());
+                    BenchRunner::Consume((uint64_t)(entropies[0] * 1000));
+                });
+            }
+        }
+    }
+
+    void RunUtf16Benchmarks(BenchRunner& runner)
+    {
+        // 4k units of ASCII, Latin / Cyrillic (2 byte), CJK (3 byte) and a mix with surrogate pairs
+        std::vector<std::pair<std::string, std::vector<WCHAR>>> inputs(4);
+        inputs[0].first = "ascii";
+        inputs[1].first = "cyrillic";
+        inputs[2].first = "cjk";
+        inputs[3].first = "mixed";
+
+        std::mt19937 rng(42);
+        for (size_t i = 0; i < 4096; i++)
+        {
+            inputs[0].second.push_back((WCHAR)('A' + rng() % 26));
+            inputs[1].second.push_back((WCHAR)(0x0410 + rng() % 32));
+            inputs[2].second.push_back((WCHAR)(0x4E00 + rng() % 0x5000));
+
+            switch (rng() % 8)
+            {
+                case 0:     inputs[3].second.push_back((WCHAR)(0x4E00 + rng() % 0x5000)); break;
+                case 1:     inputs[3].second.push_back(0xD83D); inputs[3].second.push_back((WCHAR)(0xDE00 + rng() % 0x40)); break;
+                default:    inputs[3].second.push_back((WCHAR)('a' + rng() % 26)); break;
+            }
+        }
+
+        for (const auto& [name, input] : inputs)
+        {
+            std::vector<char> output(Utf8MaxSize(input.size()));
+
+            for (const auto& [isa, isa_name] : kIsas)
+            {
+                if (isa > GetSimdIsa())
+                    continue;
+
+                runner.Run(std::string("Utf16ToUtf8/") + isa_name + "/" + name, input.size() * sizeof(WCHAR), [&]() {
+                    BenchRunner::Consume(Utf16ToUtf8(isa, input.data(), input.size(), output.data()));
+                });
+            }
+        }
+    }
+
+    void RunPrinterBenchmarks(BenchRunner& runner, Sample& sample)
+    {
+        RawFile raw_file = sample.MakeRawFile();
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        Commands commands(&pe);
+
+        NullBuffer null_buffer;
+        std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+        std::streambuf* cerr_buffer = std::cerr.rdbuf(&null_buffer);
+
+        const std::string suffix = "/" + sample.name;
+        runner.Run("Commands::PrintDosHdr" + suffix, 0, [&]() { commands.PrintDosHdr(); });
+        runner.Run("Commands::PrintFileHdr" + suffix, 0, [&]() { commands.PrintFileHdr(); });
+        runner.Run("Commands::PrintOptHdr" + suffix, 0, [&]() { commands.PrintOptHdr(); });
+        runner.Run("Commands::PrintSecHdrs" + suffix, 0, [&]() { commands.PrintSecHdrs(); });
+        runner.Run("Commands::PrintExportDir" + suffix, 0, [&]() { commands.PrintExportDir(); });
+        runner.Run("Commands::PrintExports" + suffix, 0, [&]() { commands.PrintExports(); });
+        runner.Run("Commands::PrintImports" + suffix, 0, [&]() { commands.PrintImports(); });
+        runner.Run("Commands::PrintDelayImports" + suffix, 0, [&]() { commands.PrintDelayImports(); });
+        runner.Run("Commands::PrintRsrcDir" + suffix, 0, [&]() { commands.PrintRsrcDir(); });
+        runner.Run("Commands::PrintRelocs" + suffix, 0, [&]() { commands.PrintRelocs(); });
+        runner.Run("Commands::PrintExceptions" + suffix, 0, [&]() { commands.PrintExceptions(); });
+        runner.Run("Commands::PrintTlsDir" + suffix, 0, [&]() { commands.PrintTlsDir(); });
+        runner.Run("Commands::PrintLoadConfigDir" + suffix, 0, [&]() { commands.PrintLoadConfigDir(); });
+        runner.Run("Commands::PrintSecurityDir" + suffix, 0, [&]() { commands.PrintSecurityDir(); });
+        runner.Run("Commands::PrintJson" + suffix, 0, [&]() { commands.PrintJson(); });
+
+        std::cout.rdbuf(cout_buffer);
+        std::cerr.rdbuf(cerr_buffer);
+    }
+
+}
+
+// PewParserBench [filter] [--min-time seconds]
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    double min_time = 0.25;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--min-time" && i + 1 < argc)
+            min_time = std::strtod(argv[++i], nullptr);
+        else
+            filter = arg;
+    }
+
+    std::vector<Sample> sections_samples = {
+        MakeSample("sections=1", SectionsConfig(1)),
+        MakeSample("sections=16", SectionsConfig(16)),
+        MakeSample("sections=96", SectionsConfig(96)),
+    };
+
+    std::vector<Sample> imports_samples = {
+        MakeSample("imports=1", ImportsConfig(1, 1)),
+        MakeSample("imports=1k", ImportsConfig(10, 100)),
+        MakeSample("imports=100k", ImportsConfig(100, 1000)),
+    };
+
+    std::vector<Sample> delay_imports_samples = {
+        MakeSample("delay_imports=1k", DelayImportsConfig(10, 100)),
+        MakeSample("delay_imports=100k", DelayImportsConfig(100, 1000)),
+    };
+
+    std::vector<Sample> exports_samples = {
+        MakeSample("exports=1", ExportsConfig(1)),
+        MakeSample("exports=1k", ExportsConfig(1000)),
+        MakeSample("exports=100k", ExportsConfig(100000)),
+    };
+
+    std::vector<Sample> rsrc_samples = {
+        MakeSample("rsrc=1", RsrcConfig(1, 1, 1)),
+        MakeSample("rsrc=2k", RsrcConfig(16, 64, 2)),
+    };
+
+    std::vector<Sample> relocs_samples = {
+        MakeSample("relocs=1k", RelocsConfig(1000)),
+        MakeSample("relocs=256k", RelocsConfig(256 * 1024)),
+    };
+
+    std::vector<Sample> functions_samples = {
+        MakeSample("functions=1k", FunctionsConfig(1000)),
+        MakeSample("functions=256k", FunctionsConfig(256 * 1024)),
+    };
+
+    std::vector<Sample> guard_samples = {
+        MakeSample("guard_functions=1k", GuardFunctionsConfig(1000)),
+        MakeSample("guard_functions=256k", GuardFunctionsConfig(256 * 1024)),
+    };
+
+    // The large image is over FileHasher::kParallelMinSize, so the threaded run hashes its sections on workers
+    SyntheticPE::Config large_config = RelocsConfig(1024 * 1024);
+    large_config.functions_count = 256 * 1024;
+    std::vector<Sample> hashes_samples = {
+        MakeSample("relocs=1k", RelocsConfig(1000)),
+        MakeSample("relocs=1m,functions=256k", large_config),
+    };
+
+    SyntheticPE::Config names_config = RsrcConfig(16, 256, 1);
+    names_config.rsrc_named_entries = true;
+    Sample names_sample = MakeSample("rsrc_names=4k", names_config);
+
+    SyntheticPE::Config mixed_config;
+    mixed_config.sections_count = 16;
+    mixed_config.libraries_count = 10;
+    mixed_config.imports_per_library = 100;
+    mixed_config.delay_libraries_count = 4;
+    mixed_config.exports_count = 1000;
+    mixed_config.rsrc_types_count = 16;
+    mixed_config.rsrc_names_per_type = 8;
+    mixed_config.relocs_count = 1000;
+    mixed_config.functions_count = 1000;
+    mixed_config.tls_dir = true;
+    mixed_config.tls_callbacks_count = 4;
+    mixed_config.load_config_version = 4;
+    mixed_config.guard_functions_count = 1000;
+    mixed_config.certificates_count = 2;
+    mixed_config.checksum = true;
+    Sample mixed_sample = MakeSample("mixed", mixed_config);
+
+    // Printer benchmarks silence std::cout, the report keeps writing to the original stream buffer
+    std::ostream report(std::cout.rdbuf());
+    BenchRunner runner(report, min_time, filter);
+
+    RunParserBenchmarks(runner, sections_samples);
+    RunRvaToRawBenchmarks(runner, sections_samples);
+    RunImportBenchmarks(runner, imports_samples);
+    RunDelayImportBenchmarks(runner, delay_imports_samples);
+    RunExportBenchmarks(runner, exports_samples);
+    RunRsrcBenchmarks(runner, rsrc_samples);
+    RunRsrcNamesBenchmarks(runner, names_sample);
+    RunRelocBenchmarks(runner, relocs_samples);
+    RunRebaseBenchmarks(runner, relocs_samples);
+    RunExceptionBenchmarks(runner, functions_samples);
+    RunLoadConfigBenchmarks(runner, guard_samples);
+    RunAuthenticodeBenchmarks(runner, relocs_samples);
+    RunChecksumBenchmarks(runner, relocs_samples);
+    RunHashBenchmarks(runner);
+    RunFileHasherBenchmarks(runner, hashes_samples);
+    RunEntropyBenchmarks(runner);
+    RunUtf16Benchmarks(runner);
+    RunPrinterBenchmarks(runner, mixed_sample);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "SyntheticPE.h"
+
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+using namespace PewParser;
+
+namespace {
+
+    std::string FileName(index_t image, const SyntheticPE::Config& config)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "synth_%06zu.%s", image, config.exports_count ? "dll" : "exe");
+        return name;
+    }
+
+    void WriteManifestHeader(std::ostream& manifest)
+    {
+        manifest << "#file\tx64\tsections\tlibraries\timports_per_library\tordinal_every\tbound\texports\t"
+                    "rsrc_types\trsrc_names\trsrc_langs\trsrc_extra_depth\trsrc_named\trsrc_payload\tdebug\trelocs\tfunctions\ttls\ttls_callbacks\tload_config\tguard_functions\tse_handlers\tdelay_libraries\tdelay_va\tcertificates\tchecksum\tmalformation\tsize\n";
+    }
+
+    void WriteManifestLine(std::ostream& manifest, const std::string& name, const SyntheticPE::Config& config, size_t size)
+    {
+        manifest << name << '\t' << config.x64 << '\t' << config.sections_count << '\t'
+            << config.libraries_count << '\t' << config.imports_per_library << '\t' << config.ordinal_import_every << '\t' << config.bound_imports << '\t'
+            << config.exports_count << '\t'
+            << config.rsrc_types_count << '\t' << config.rsrc_names_per_type << '\t' << config.rsrc_langs_per_name << '\t'
+            << config.rsrc_extra_depth << '\t' << config.rsrc_named_entries << '\t' << config.rsrc_payload_size << '\t'
+            << config.debug_entries_count << '\t' << config.relocs_count << '\t' << config.functions_count << '\t' << config.tls_dir << '\t' << config.tls_callbacks_count << '\t'
+            << config.load_config_version << '\t' << config.guard_functions_count << '\t' << config.se_handlers_count << '\t'
+            << config.delay_libraries_count << '\t' << config.delay_va_based << '\t' << config.certificates_count << '\t' << config.checksum << '\t' << SyntheticPE::MalformationName(config.malformation) << '\t' << size << '\n';
+    }
+
+}
+
+// PewParserGen <output directory> [count] [--seed n] [--malformed ratio]
+// The same seed and ratio always produce the same corpus, manifest.tsv records the config of every image.
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: PewParserGen <output directory> [count] [--seed n] [--malformed ratio]\n";
+        return 1;
+    }
+
+    std::filesystem::path output_dir(argv[1]);
+    size_t count = 1000;
+    uint64_t seed = 1;
+    double malformed_ratio = 0.1;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--seed" && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--malformed" && i + 1 < argc)
+            malformed_ratio = std::strtod(argv[++i], nullptr);
+        else
+            count = std::strtoul(arg.c_str(), nullptr, 10);
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(output_dir, error);
+    if (error)
+    {
+        std::cerr << "Failed to create " << output_dir.u8string() << ": " << error.message() << "\n";
+        return 1;
+    }
+
+    std::ofstream manifest(output_dir / "manifest.tsv");
+    WriteManifestHeader(manifest);
+
+    std::mt19937_64 rng(seed);
+    uint64_t total_size = 0;
+    size_t malformed_count = 0;
+
+    for (index_t image_index = 0; image_index < count; image_index++)
+    {
+        SyntheticPE::Config config = SyntheticPE::RandomConfig(rng, malformed_ratio);
+        std::vector<BYTE> image = SyntheticPE::Build(config);
+        std::string name = FileName(image_index, config);
+
+        std::ofstream file(output_dir / name, std::ios::binary);
+        file.write((const char*)image.data(), image.size());
+        if (!file)
+        {
+            std::cerr << "Failed to write " << (output_dir / name).u8string() << "\n";
+            return 1;
+        }
+
+        WriteManifestLine(manifest, name, config, image.size());
+        total_size += image.size();
+        malformed_count += (config.malformation != SyntheticPE::Malformation::NONE);
+    }
+
+    std::cout << count << " images (" << malformed_count << " malformed), " << total_size / 1024 << " KiB written to " << output_dir.u8string() << "\n";
+    return 0;
+}
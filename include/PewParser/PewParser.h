@@ -4,4 +4,11 @@
 #include <PEParser.h>
 #include <Headers/Headers.h>
 #include <DataDirectory/DataDirectory.h>
-#include <Helper.h>
\ No newline at end of file
+#include <ImageMapper.h>
+#include <Authenticode.h>
+#include <Checksum.h>
+#include <Entropy.h>
+#include <FileHasher.h>
+#include <Hash/MultiDigest.h>
+#include <Helper.h>
+#include <Serializer/Serializer.h>
\ No newline at end of file
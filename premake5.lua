@@ -39,6 +39,146 @@ project "PewParser"
 
     filter "system:linux"
         buildoptions { "-Wno-format-security" }
+        links { "pthread" }
+
+    filter "platforms:x64"
+        architecture "x64"
+
+    filter "platforms:x86"
+        architecture "x86"
+
+-- Microbenchmarks over synthetic PEs, everything but the terminal entry point is linked in
+project "PewParserBench"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+
+    targetdir (builddir .. "/bin/")
+    objdir (builddir .. "/obj/%{prj.name}/")
+
+    files {
+        "bench/**.h",
+        "bench/**.cpp",
+        "synth/**.h",
+        "synth/**.cpp",
+        "src/**.h",
+        "src/**.cpp"
+    }
+
+    removefiles {
+        "src/Terminal/Main.cpp"
+    }
+
+    includedirs {
+        "include",
+        "src",
+        "synth"
+    }
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "NDEBUG" }
+        optimize "On"
+
+    filter "system:windows"
+        systemversion "latest"
+        defines { "_CRT_SECURE_NO_WARNINGS" }
+
+    filter "system:linux"
+        buildoptions { "-Wno-format-security" }
+        links { "pthread" }
+
+    filter "platforms:x64"
+        architecture "x64"
+
+    filter "platforms:x86"
+        architecture "x86"
+
+-- Synthetic PE corpus generator, only needs the PEFormat.h structs
+project "PewParserGen"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+
+    targetdir (builddir .. "/bin/")
+    objdir (builddir .. "/obj/%{prj.name}/")
+
+    files {
+        "gen/**.h",
+        "gen/**.cpp",
+        "synth/**.h",
+        "synth/**.cpp"
+    }
+
+    includedirs {
+        "src",
+        "synth"
+    }
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "NDEBUG" }
+        optimize "On"
+
+    filter "system:windows"
+        systemversion "latest"
+        defines { "_CRT_SECURE_NO_WARNINGS" }
+
+    filter "platforms:x64"
+        architecture "x64"
+
+    filter "platforms:x86"
+        architecture "x86"
+
+-- Unit tests, exits non-zero when a test fails
+project "PewParserTests"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+
+    targetdir (builddir .. "/bin/")
+    objdir (builddir .. "/obj/%{prj.name}/")
+
+    files {
+        "tests/**.h",
+        "tests/**.cpp",
+        "synth/**.h",
+        "synth/**.cpp",
+        "src/**.h",
+        "src/**.cpp"
+    }
+
+    removefiles {
+        "src/Terminal/Main.cpp"
+    }
+
+    includedirs {
+        "include",
+        "src",
+        "synth"
+    }
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "NDEBUG" }
+        optimize "On"
+
+    filter "system:windows"
+        systemversion "latest"
+        defines { "_CRT_SECURE_NO_WARNINGS" }
+
+    filter "system:linux"
+        buildoptions { "-Wno-format-security" }
+        links { "pthread" }
 
     filter "platforms:x64"
         architecture "x64"
@@ -0,0 +1,10 @@
+#include "Arena.h"
+
+namespace PewParser {
+
+    Arena::Arena(size_t initial_size)
+        : initial_size_(initial_size), initial_block_(new BYTE[initial_size]), resource_(initial_block_.get(), initial_size)
+    {
+    }
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "PEFormat.h"
+
+#include <memory>
+#include <memory_resource>
+
+namespace PewParser {
+
+    // Monotonic arena for the parse state of a single PEFile.
+    // Deallocations are no-ops, Reset() hands everything back at once and rewinds to the initial block,
+    // so one arena can be reused file after file without touching the heap once it is warm.
+    class Arena
+    {
+    public:
+        Arena(size_t initial_size = 256 * 1024);
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        std::pmr::memory_resource* GetResource() { return &resource_; }
+        size_t GetInitialSize() const { return initial_size_; }
+
+        void Reset() { resource_.release(); }
+    private:
+        size_t initial_size_;
+        std::unique_ptr<BYTE[]> initial_block_;
+        std::pmr::monotonic_buffer_resource resource_;
+    };
+
+}
@@ -0,0 +1,84 @@
+#include "Authenticode.h"
+
+#include "PEFile.h"
+#include "Hash/MultiDigest.h"
+
+#include <cstddef>
+#include <algorithm>
+
+namespace PewParser {
+
+    AuthenticodeHasher::AuthenticodeHasher(const PEFile* pe)
+        : buffer_(pe->GetRawFile().Buffer()), ranges_count_(0)
+    {
+        offset_t file_size = pe->GetRawFileSize();
+
+        offset_t checksum_offset = pe->GetOptionalHdrOffset() + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum);
+        offset_t security_entry_offset = pe->GetOptionalHdrOffset() + DataDirEntries::SECU * sizeof(IMAGE_DATA_DIRECTORY) +
+            ((pe->GetPEType() == PEType::x32PE) ? offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory) : offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory));
+
+        // The certificate table is only skipped when it lies after the headers, like the signing tools expect
+        IMAGE_DATA_DIRECTORY security_dir = pe->GetDataDirectory()[DataDirEntries::SECU];
+        offset_t table_begin = security_dir.VirtualAddress;
+        offset_t table_end = table_begin + security_dir.Size;
+        if (!security_dir.VirtualAddress || !security_dir.Size || table_begin < security_entry_offset + sizeof(IMAGE_DATA_DIRECTORY))
+            table_begin = table_end = file_size;
+
+        const Range skipped[] = {
+            { checksum_offset, checksum_offset + sizeof(DWORD) },
+            { security_entry_offset, security_entry_offset + sizeof(IMAGE_DATA_DIRECTORY) },
+            { table_begin, table_end }
+        };
+
+        offset_t position = 0;
+        for (const Range& skip : skipped)
+        {
+            AddRange(position, std::min(skip.begin, file_size));
+            position = std::max(position, std::min(skip.end, file_size));
+        }
+        AddRange(position, file_size);
+    }
+
+    void AuthenticodeHasher::AddRange(offset_t begin, offset_t end)
+    {
+        if (begin < end && ranges_count_ < kMaxRanges)
+            ranges_[ranges_count_++] = { begin, end };
+    }
+
+    uintmax_t AuthenticodeHasher::GetHashedSize() const
+    {
+        uintmax_t size = 0;
+        for (index_t range = 0; range < ranges_count_; range++)
+            size += ranges_[range].end - ranges_[range].begin;
+
+        return size;
+    }
+
+    void AuthenticodeHasher::Compute(Digest* digests, size_t digests_count) const
+    {
+        MultiDigest hasher(digests, digests_count);
+
+        for (index_t range = 0; range < ranges_count_; range++)
+        {
+            for (offset_t chunk = ranges_[range].begin; chunk < ranges_[range].end; chunk += kChunkSize)
+            {
+                const BYTE* data = buffer_ + chunk;
+                size_t size = (size_t)std::min<offset_t>(kChunkSize, ranges_[range].end - chunk);
+
+                hasher.Update(data, size);
+            }
+        }
+
+        hasher.Final(digests, digests_count);
+    }
+
+    Digest AuthenticodeHasher::Compute(DigestAlgorithm algorithm) const
+    {
+        Digest digest;
+        digest.algorithm = algorithm;
+        Compute(&digest, 1);
+
+        return digest;
+    }
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "PEFormat.h"
+#include "PewTypes.h"
+
+#include "Hash/Digest.h"
+
+namespace PewParser {
+
+    class PEFile;
+
+    // Authenticode image digest: the file front to back minus OptionalHeader.CheckSum, the security data directory
+    // entry and the certificate table it points to. The ranges are cut into kChunkSize pieces and every requested
+    // algorithm consumes a piece before the next one is touched, so several digests still read the file once.
+    class AuthenticodeHasher
+    {
+    public:
+        static constexpr size_t kChunkSize = 256 * 1024;
+        static constexpr size_t kMaxRanges = 4;
+
+        struct Range
+        {
+            offset_t begin;
+            offset_t end;
+        };
+    public:
+        AuthenticodeHasher(const PEFile* pe);
+
+        size_t GetRangesCount() const { return ranges_count_; }
+        const Range& GetRange(index_t range) const { return ranges_[range]; }
+        uintmax_t GetHashedSize() const;
+
+        // digests[i].algorithm picks what goes in digests[i], unknown algorithms are left empty
+        void Compute(Digest* digests, size_t digests_count) const;
+        Digest Compute(DigestAlgorithm algorithm) const;
+    private:
+        void AddRange(offset_t begin, offset_t end);
+    private:
+        const BYTE* buffer_;
+        Range ranges_[kMaxRanges];
+        size_t ranges_count_;
+    };
+
+}
@@ -0,0 +1,116 @@
+#include "Checksum.h"
+
+#include <cstring>
+
+namespace PewParser {
+
+    static uint64_t SumWordsScalar(const BYTE* data, size_t size)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i + 1 < size; i += sizeof(WORD))
+        {
+            WORD word;
+            std::memcpy(&word, data + i, sizeof(WORD));
+            sum += word;
+        }
+
+        // A trailing odd byte is a word with a zero high byte
+        if (size & 1)
+            sum += data[size - 1];
+
+        return sum;
+    }
+
+#if defined(PEW_SIMD_X64)
+    // Every 32 bit lane gains at most 4 * 0xFFFF per iteration, flushing to the 64 bit sum every
+    // kFlushIterations keeps the lanes from wrapping
+    static constexpr size_t kFlushIterations = 0x4000;
+
+    static PEW_FORCE_INLINE __m128i AddWordPairs(__m128i sum, __m128i in)
+    {
+        const __m128i low_words = _mm_set1_epi32(0xFFFF);
+        return _mm_add_epi32(sum, _mm_add_epi32(_mm_and_si128(in, low_words), _mm_srli_epi32(in, 16)));
+    }
+
+    static uint64_t SumWordsSse2(const BYTE* data, size_t size)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i total = _mm_setzero_si128();
+
+        size_t i = 0;
+        while (i + 32 <= size)
+        {
+            __m128i sum = _mm_setzero_si128();
+            for (size_t iteration = 0; iteration < kFlushIterations && i + 32 <= size; iteration++, i += 32)
+            {
+                sum = AddWordPairs(sum, _mm_loadu_si128((const __m128i*)(data + i)));
+                sum = AddWordPairs(sum, _mm_loadu_si128((const __m128i*)(data + i + 16)));
+            }
+
+            total = _mm_add_epi64(total, _mm_add_epi64(_mm_unpacklo_epi32(sum, zero), _mm_unpackhi_epi32(sum, zero)));
+        }
+
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i*)lanes, total);
+        return lanes[0] + lanes[1] + SumWordsScalar(data + i, size - i);
+    }
+
+    PEW_TARGET_AVX2 static PEW_FORCE_INLINE __m256i AddWordPairsAvx2(__m256i sum, __m256i in)
+    {
+        const __m256i low_words = _mm256_set1_epi32(0xFFFF);
+        return _mm256_add_epi32(sum, _mm256_add_epi32(_mm256_and_si256(in, low_words), _mm256_srli_epi32(in, 16)));
+    }
+
+    PEW_TARGET_AVX2 static uint64_t SumWordsAvx2(const BYTE* data, size_t size)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i total = _mm256_setzero_si256();
+
+        size_t i = 0;
+        while (i + 64 <= size)
+        {
+            __m256i sum = _mm256_setzero_si256();
+            for (size_t iteration = 0; iteration < kFlushIterations && i + 64 <= size; iteration++, i += 64)
+            {
+                sum = AddWordPairsAvx2(sum, _mm256_loadu_si256((const __m256i*)(data + i)));
+                sum = AddWordPairsAvx2(sum, _mm256_loadu_si256((const __m256i*)(data + i + 32)));
+            }
+
+            total = _mm256_add_epi64(total, _mm256_add_epi64(_mm256_unpacklo_epi32(sum, zero), _mm256_unpackhi_epi32(sum, zero)));
+        }
+
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i*)lanes, total);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumWordsScalar(data + i, size - i);
+    }
+#endif
+
+    DWORD ComputeImageChecksum(const BYTE* data, size_t size, offset_t checksum_offset)
+    {
+        return ComputeImageChecksum(GetSimdIsa(), data, size, checksum_offset);
+    }
+
+    DWORD ComputeImageChecksum(SimdIsa isa, const BYTE* data, size_t size, offset_t checksum_offset)
+    {
+        uint64_t sum = 0;
+
+        switch (isa)
+        {
+#if defined(PEW_SIMD_X64)
+            case SimdIsa::AVX2:    sum = SumWordsAvx2(data, size);      break;
+            case SimdIsa::SSE2:    sum = SumWordsSse2(data, size);      break;
+#endif
+            default:               sum = SumWordsScalar(data, size);    break;
+        }
+
+        // Take the CheckSum bytes back out, an odd offset (malformed e_lfanew) splits them across three words
+        for (offset_t position = checksum_offset; position < checksum_offset + sizeof(DWORD) && position < size; position++)
+            sum -= (uint64_t)data[position] << ((position & 1) * 8);
+
+        while (sum >> 16)
+            sum = (sum & 0xFFFF) + (sum >> 16);
+
+        return (DWORD)sum + (DWORD)size;
+    }
+
+}
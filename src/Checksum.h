@@ -0,0 +1,14 @@
+#pragma once
+#include "PEFormat.h"
+#include "PewTypes.h"
+#include "Simd.h"
+
+namespace PewParser {
+
+    // OptionalHeader.CheckSum the way the loader and CheckSumMappedFile compute it: the file as little endian
+    // 16 bit words added with the carries folded back in, the 4 bytes at checksum_offset read as zero, plus the size.
+    // Words are summed into wide lanes and folded once at the end, which gives the same value as folding every add.
+    DWORD ComputeImageChecksum(const BYTE* data, size_t size, offset_t checksum_offset);
+    DWORD ComputeImageChecksum(SimdIsa isa, const BYTE* data, size_t size, offset_t checksum_offset);
+
+}
@@ -23,13 +23,13 @@ namespace PewParser {
         offset_t bound_import_dir_rva = related_pe_->GetDataDirectory()[DataDirEntries::BOUNDIMP].VirtualAddress;
         offset_t bound_import_dir_raw = related_pe_->RvaToRaw(bound_import_dir_rva);
 
-        if (bound_import_dir_raw)
+        if (bound_import_dir_raw && (bound_import_dir_raw + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
         {
             root_descriptor_ = (IMAGE_BOUND_IMPORT_DESCRIPTOR*)related_pe_->GetContentAt(bound_import_dir_raw, OffsetType::RAW);
             current_descriptor_ = root_descriptor_;
             root_descriptor_offset_ = bound_import_dir_raw;
         }
-        else if ((bound_import_dir_rva + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
+        else if (!bound_import_dir_raw && (bound_import_dir_rva + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
         {
             root_descriptor_ = (IMAGE_BOUND_IMPORT_DESCRIPTOR*)related_pe_->GetContentAt(bound_import_dir_rva, OffsetType::RAW);
             current_descriptor_ = root_descriptor_;
@@ -51,7 +51,7 @@ namespace PewParser {
         }
     }
 
-    BYTE* BoundImportDirWrapper::GetFieldValue() const
+    const BYTE* BoundImportDirWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
@@ -18,7 +18,7 @@ namespace PewParser {
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         std::string GetFieldDescription() const;
         FieldType GetFieldType() const { return field_type_; }
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
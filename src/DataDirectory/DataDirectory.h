@@ -4,4 +4,10 @@
 #include "ImportDirWrapper.h"
 #include "ResourceDirWrapper.h"
 #include "BoundImportDirWrapper.h"
-#include "DebugDirWrapper.h"
\ No newline at end of file
+#include "DebugDirWrapper.h"
+#include "RelocDirWrapper.h"
+#include "ExceptionDirWrapper.h"
+#include "TlsDirWrapper.h"
+#include "LoadConfigDirWrapper.h"
+#include "DelayImportDirWrapper.h"
+#include "SecurityDirWrapper.h"
\ No newline at end of file
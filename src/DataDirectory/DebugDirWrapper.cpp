@@ -20,12 +20,12 @@ namespace PewParser {
         offset_t debug_dir_rva = related_pe_->GetDataDirectory()[DataDirEntries::DBG].VirtualAddress;
         offset_t debug_dir_raw = related_pe_->RvaToRaw(debug_dir_rva);
 
-        if (debug_dir_raw)
+        if (debug_dir_raw && (debug_dir_raw + GetDebugDirSize()) <= related_pe_->GetRawFileSize())
         {
             debug_dir_ = (IMAGE_DEBUG_DIRECTORY*)related_pe_->GetContentAt(debug_dir_raw, OffsetType::RAW);
             debug_dir_offset_ = debug_dir_raw;
         }
-        else if ((debug_dir_rva + GetDebugDirSize()) <= related_pe_->GetRawFileSize())
+        else if (!debug_dir_raw && (debug_dir_rva + GetDebugDirSize()) <= related_pe_->GetRawFileSize())
         {
             debug_dir_ = (IMAGE_DEBUG_DIRECTORY*)related_pe_->GetContentAt(debug_dir_rva, OffsetType::RAW);
             debug_dir_offset_ = debug_dir_rva;
@@ -48,7 +48,7 @@ namespace PewParser {
         }
     }
 
-    BYTE* DebugDirWrapper::GetFieldValue() const
+    const BYTE* DebugDirWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
@@ -58,7 +58,7 @@ namespace PewParser {
         switch (field_index_)
         {
             case Fields::TIMESTAMP:    return PEUtils::TimeDateStampConverter(debug_dir_->TimeDateStamp);
-            case Fields::TYPE:         return GetTypeDescription().data();
+            case Fields::TYPE:         return std::string(GetTypeDescription());
             default:                   return std::string();
         }
     }
@@ -0,0 +1,76 @@
+#include "DelayImportDirWrapper.h"
+
+#include <PEFile.h>
+
+namespace PewParser {
+
+    DelayImportDirWrapper::DelayImportDirWrapper(PEFile* pe)
+        : related_pe_(pe), root_descriptor_(nullptr), root_descriptor_offset_(0), table_(pe->GetMemoryResource())
+    {
+        Init();
+        BuildImportTable();
+    }
+
+    void DelayImportDirWrapper::Init()
+    {
+        offset_t root_descriptor_rva = related_pe_->GetDataDirectory()[DataDirEntries::DLYIMP].VirtualAddress;
+        offset_t root_descriptor_raw = related_pe_->RvaToRaw(root_descriptor_rva);
+
+        if (root_descriptor_raw && (root_descriptor_raw + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
+        {
+            root_descriptor_ = (IMAGE_DELAYLOAD_DESCRIPTOR*)related_pe_->GetContentAt(root_descriptor_raw, OffsetType::RAW);
+            root_descriptor_offset_ = root_descriptor_raw;
+        }
+        else if (!root_descriptor_raw && (root_descriptor_rva + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
+        {
+            root_descriptor_ = (IMAGE_DELAYLOAD_DESCRIPTOR*)related_pe_->GetContentAt(root_descriptor_rva, OffsetType::RAW);
+            root_descriptor_offset_ = root_descriptor_rva;
+        }
+    }
+
+    offset_t DelayImportDirWrapper::ToRva(index_t library, DWORD address) const
+    {
+        if (IsRvaBased(library))
+            return address;
+
+        ULONGLONG image_base = related_pe_->GetImageBase();
+        if (address < image_base)
+            return 0;
+
+        return (offset_t)(address - image_base);
+    }
+
+    void DelayImportDirWrapper::BuildImportTable()
+    {
+        ImportTableBuilder builder(related_pe_, table_);
+
+        if (!root_descriptor_)
+            return;
+
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        ULONGLONG image_base = related_pe_->GetImageBase();
+
+        // The list ends at the first descriptor without a library name
+        offset_t descriptor_raw = root_descriptor_offset_;
+        for (index_t library = 0; descriptor_raw + sizeof(IMAGE_DELAYLOAD_DESCRIPTOR) <= file_size && root_descriptor_[library].DllNameRVA;
+            library++, descriptor_raw += sizeof(IMAGE_DELAYLOAD_DESCRIPTOR))
+        {
+            const IMAGE_DELAYLOAD_DESCRIPTOR& descriptor = root_descriptor_[library];
+
+            // The IAT points at the loader thunks until the first call, names only come from the INT
+            if (!builder.AddLibrary(builder.GetStringAt(ToRva(library, descriptor.DllNameRVA)),
+                ToRva(library, descriptor.ImportNameTableRVA), ToRva(library, descriptor.ImportAddressTableRVA),
+                IsRvaBased(library) ? 0 : image_base))
+                break;
+        }
+    }
+
+    bool DelayImportDirWrapper::IsValidWrapper() const
+    {
+        if (root_descriptor_)
+            return true;
+
+        return false;
+    }
+
+}
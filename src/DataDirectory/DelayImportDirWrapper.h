@@ -0,0 +1,43 @@
+#pragma once
+#include <PEFile.h>
+#include <PewTypes.h>
+
+#include "ImportTable.h"
+
+namespace PewParser {
+
+    // IMAGE_DELAYLOAD_DESCRIPTOR array, flattened into the same ImportTable layout as the regular imports.
+    // Version 2 descriptors (RvaBased) hold RVAs, the older Visual C++ 6 ones hold VAs at the preferred image base
+    // in every field and in the name thunks.
+    class DelayImportDirWrapper
+    {
+    public:
+        DelayImportDirWrapper(PEFile* pe);
+
+        const ImportTable& GetImportTable() const { return table_; }
+
+        size_t GetLibrariesCount() const { return table_.GetLibrariesCount(); }
+        const IMAGE_DELAYLOAD_DESCRIPTOR& GetDescriptor(index_t library) const { return root_descriptor_[library]; }
+        bool IsRvaBased(index_t library) const { return root_descriptor_[library].Attributes.AllAttributes & 1; }
+
+        // Descriptor field of library as an RVA, 0 when a VA based field is below the image base
+        offset_t ToRva(index_t library, DWORD address) const;
+
+        bool IsValidWrapper() const;
+
+        IMAGE_DELAYLOAD_DESCRIPTOR* GetRootDescriptor() const { return root_descriptor_; }
+        offset_t GetRootDescriptorOffset() const { return root_descriptor_offset_; }
+        size_t GetDescriptorSize() const { return sizeof(IMAGE_DELAYLOAD_DESCRIPTOR); }
+    private:
+        void Init();
+        void BuildImportTable();
+    private:
+        IMAGE_DELAYLOAD_DESCRIPTOR* root_descriptor_;
+        offset_t root_descriptor_offset_;
+
+        ImportTable table_;
+
+        PEFile* related_pe_;
+    };
+
+}
@@ -0,0 +1,215 @@
+#include "ExceptionDirWrapper.h"
+
+#include <PEFile.h>
+
+#include <cstring>
+#include <algorithm>
+
+namespace PewParser {
+
+    // Version and flags, prolog size, codes count, frame register and offset
+    static constexpr size_t kUnwindInfoHdrSize = 4;
+
+    ExceptionDirWrapper::ExceptionDirWrapper(PEFile* pe)
+        : related_pe_(pe), root_entry_(nullptr), root_entry_offset_(0), entries_count_(0), functions_(nullptr), functions_count_(0),
+          sorted_copy_(pe->GetMemoryResource()), begins_(pe->GetMemoryResource()), last_hit_(0)
+    {
+        Init();
+
+        BuildFunctionTable();
+    }
+
+    void ExceptionDirWrapper::Init()
+    {
+        if (related_pe_->GetFileHdrWrapper()->GetFileHdr()->Machine != IMAGE_FILE_MACHINE_AMD64)
+            return;
+
+        offset_t root_entry_rva = related_pe_->GetDataDirectory()[DataDirEntries::EXPTN].VirtualAddress;
+        offset_t root_entry_raw = related_pe_->RvaToRaw(root_entry_rva);
+
+        if (root_entry_raw && (root_entry_raw + GetEntrySize()) <= related_pe_->GetRawFileSize())
+        {
+            root_entry_ = (IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY*)related_pe_->GetContentAt(root_entry_raw, OffsetType::RAW);
+            root_entry_offset_ = root_entry_raw;
+        }
+        else if (!root_entry_raw && (root_entry_rva + GetEntrySize()) <= related_pe_->GetRawFileSize())
+        {
+            root_entry_ = (IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY*)related_pe_->GetContentAt(root_entry_rva, OffsetType::RAW);
+            root_entry_offset_ = root_entry_rva;
+        }
+
+        if (root_entry_)
+        {
+            uintmax_t dir_size = std::min<uintmax_t>(related_pe_->GetDataDirectory()[DataDirEntries::EXPTN].Size, related_pe_->GetRawFileSize() - root_entry_offset_);
+            entries_count_ = dir_size / GetEntrySize();
+        }
+    }
+
+    void ExceptionDirWrapper::BuildFunctionTable()
+    {
+        // Linkers emit the table sorted, so it is normally searched where it lies
+        const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY* entries = root_entry_;
+
+        bool in_place = true;
+        DWORD prev_end = 0;
+        for (size_t i = 0; i < entries_count_; i++)
+        {
+            if (entries[i].BeginAddress >= entries[i].EndAddress || entries[i].BeginAddress < prev_end)
+            {
+                in_place = false;
+                break;
+            }
+
+            prev_end = entries[i].EndAddress;
+        }
+
+        if (in_place)
+        {
+            functions_ = entries;
+            functions_count_ = entries_count_;
+        }
+        else
+        {
+            sorted_copy_.reserve(entries_count_);
+            for (size_t i = 0; i < entries_count_; i++)
+            {
+                if (entries[i].BeginAddress < entries[i].EndAddress)
+                    sorted_copy_.push_back(entries[i]);
+            }
+
+            std::stable_sort(sorted_copy_.begin(), sorted_copy_.end(), [](const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY& lhs, const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY& rhs)
+            {
+                return lhs.BeginAddress < rhs.BeginAddress;
+            });
+
+            // Overlapping entries would break the search, the first one of each overlap is kept
+            DWORD kept_end = 0;
+            auto overlapping = [&kept_end](const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY& entry)
+            {
+                if (entry.BeginAddress < kept_end)
+                    return true;
+
+                kept_end = entry.EndAddress;
+                return false;
+            };
+            sorted_copy_.erase(std::remove_if(sorted_copy_.begin(), sorted_copy_.end(), overlapping), sorted_copy_.end());
+
+            functions_ = sorted_copy_.data();
+            functions_count_ = sorted_copy_.size();
+        }
+
+        begins_.resize(functions_count_);
+        for (size_t i = 0; i < functions_count_; i++)
+            begins_[i] = functions_[i].BeginAddress;
+    }
+
+    int64_t ExceptionDirWrapper::FindFunction(DWORD rva) const
+    {
+        if (!functions_count_)
+            return -1;
+
+        // Lookups tend to come in address order, so the last hit and its successor are tried first
+        if (rva >= begins_[last_hit_])
+        {
+            if (rva < functions_[last_hit_].EndAddress)
+                return last_hit_;
+
+            index_t next = last_hit_ + 1;
+            if (next < functions_count_ && rva >= begins_[next] && rva < functions_[next].EndAddress)
+            {
+                last_hit_ = next;
+                return next;
+            }
+        }
+
+        // Branchless search for the last function that begins at or before rva
+        const DWORD* base = begins_.data();
+        size_t count = functions_count_;
+        while (count > 1)
+        {
+            size_t half = count / 2;
+            base = (base[half] <= rva) ? base + half : base;
+            count -= half;
+        }
+
+        index_t index = base - begins_.data();
+        if (rva < *base || rva >= functions_[index].EndAddress)
+            return -1;
+
+        last_hit_ = index;
+        return index;
+    }
+
+    bool ExceptionDirWrapper::GetUnwindInfo(index_t function, UnwindInfo& unwind_info) const
+    {
+        unwind_info = UnwindInfo();
+
+        if (function >= functions_count_)
+            return false;
+
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        DWORD unwind_rva = functions_[function].UnwindInfoAddress;
+
+        // Bit 0 set means the entry shares the unwind data of another RUNTIME_FUNCTION
+        if (unwind_rva & 1)
+        {
+            offset_t shared_raw = related_pe_->RvaToRaw(unwind_rva & ~(DWORD)1);
+            if (!shared_raw || shared_raw + GetEntrySize() > file_size)
+                return false;
+
+            IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY shared;
+            std::memcpy(&shared, related_pe_->GetContentAt(shared_raw, OffsetType::RAW), sizeof(shared));
+            unwind_rva = shared.UnwindInfoAddress;
+        }
+
+        offset_t raw = related_pe_->RvaToRaw(unwind_rva);
+        if (!raw || raw + kUnwindInfoHdrSize > file_size)
+            return false;
+
+        const BYTE* data = related_pe_->GetContentAt(raw, OffsetType::RAW);
+
+        unwind_info.raw = raw;
+        unwind_info.version = data[0] & 0x7;
+        unwind_info.flags = data[0] >> 3;
+        unwind_info.prolog_size = data[1];
+        unwind_info.codes_count = data[2];
+        unwind_info.frame_register = data[3] & 0xF;
+        unwind_info.frame_offset = data[3] >> 4;
+
+        size_t codes_size = unwind_info.codes_count * sizeof(WORD);
+        if (raw + kUnwindInfoHdrSize + codes_size > file_size)
+            return false;
+
+        unwind_info.codes = ByteSpan(data + kUnwindInfoHdrSize, codes_size);
+
+        // The codes array is padded to an even count before the handler or the chained entry
+        size_t tail = kUnwindInfoHdrSize + ((unwind_info.codes_count + 1) & ~1) * sizeof(WORD);
+
+        if (unwind_info.flags & UnwindInfo::kFlagChainInfo)
+        {
+            if (raw + tail + sizeof(unwind_info.chained) > file_size)
+                return false;
+
+            std::memcpy(&unwind_info.chained, data + tail, sizeof(unwind_info.chained));
+            unwind_info.has_chained = true;
+        }
+        else if (unwind_info.flags & (UnwindInfo::kFlagExceptionHandler | UnwindInfo::kFlagTerminationHandler))
+        {
+            if (raw + tail + sizeof(DWORD) > file_size)
+                return false;
+
+            std::memcpy(&unwind_info.handler_rva, data + tail, sizeof(DWORD));
+        }
+
+        return true;
+    }
+
+    bool ExceptionDirWrapper::IsValidWrapper() const
+    {
+        if (root_entry_)
+            return true;
+
+        return false;
+    }
+
+}
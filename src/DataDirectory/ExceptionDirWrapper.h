@@ -0,0 +1,75 @@
+#pragma once
+#include <PEFile.h>
+#include <PewTypes.h>
+
+#include <vector>
+#include <memory_resource>
+
+namespace PewParser {
+
+    // x64 UNWIND_INFO of one function, decoded on request
+    struct UnwindInfo
+    {
+        static constexpr BYTE kFlagExceptionHandler = 0x1;
+        static constexpr BYTE kFlagTerminationHandler = 0x2;
+        static constexpr BYTE kFlagChainInfo = 0x4;
+
+        offset_t raw = 0;
+        BYTE version = 0;
+        BYTE flags = 0;
+        BYTE prolog_size = 0;
+        BYTE codes_count = 0;
+        BYTE frame_register = 0;
+        BYTE frame_offset = 0;          // in 16 byte units
+        ByteSpan codes;                 // codes_count UNWIND_CODE slots, 2 bytes each
+
+        DWORD handler_rva = 0;          // exception / termination handler, language specific data follows it
+        bool has_chained = false;
+        IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY chained = {};
+    };
+
+    // RUNTIME_FUNCTION table of x64 images. The table is used in place when the directory is sorted and well formed,
+    // otherwise a sorted copy without empty or overlapping entries is built. Other machines get an empty table.
+    class ExceptionDirWrapper
+    {
+    public:
+        ExceptionDirWrapper(PEFile* pe);
+
+        // Sorted by BeginAddress
+        const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY* GetFunctions() const { return functions_; }
+        size_t GetFunctionsCount() const { return functions_count_; }
+        const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY& GetFunction(index_t function) const { return functions_[function]; }
+
+        // Index of the function whose [BeginAddress, EndAddress) holds rva, -1 when there is none
+        int64_t FindFunction(DWORD rva) const;
+
+        // false when the UNWIND_INFO does not fit in the file
+        bool GetUnwindInfo(index_t function, UnwindInfo& unwind_info) const;
+
+        // The on disk table was usable as is
+        bool IsInPlace() const { return functions_ == root_entry_; }
+
+        bool IsValidWrapper() const;
+
+        IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY* GetRootEntry() const { return root_entry_; }
+        offset_t GetRootEntryOffset() const { return root_entry_offset_; }
+        size_t GetEntrySize() const { return sizeof(IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY); }
+        size_t GetEntriesCount() const { return entries_count_; }
+    private:
+        void Init();
+        void BuildFunctionTable();
+    private:
+        IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY* root_entry_;
+        offset_t root_entry_offset_;
+        size_t entries_count_;
+
+        const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY* functions_;
+        size_t functions_count_;
+        std::pmr::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY> sorted_copy_;
+        std::pmr::vector<DWORD> begins_;        // BeginAddress of every function, packed for the search
+        mutable index_t last_hit_;
+
+        PEFile* related_pe_;
+    };
+
+}
@@ -3,10 +3,14 @@
 #include <PEFile.h>
 #include <PEUtils.h>
 
+#include <cstring>
+#include <algorithm>
+
 namespace PewParser {
 
     ExportDirWrapper::ExportDirWrapper(PEFile* pe)
-        : related_pe_(pe), export_dir_(nullptr), export_dir_offset_(0)
+        : related_pe_(pe), export_dir_(nullptr), export_dir_offset_(0), EAT_(nullptr), ENT_(nullptr),
+        EAT_to_name_(pe->GetMemoryResource()), sorted_names_(pe->GetMemoryResource())
     {
         Init();
 
@@ -23,12 +27,12 @@ namespace PewParser {
         offset_t export_dir_rva = related_pe_->GetDataDirectory()[DataDirEntries::EXP].VirtualAddress;
         offset_t export_dir_raw = related_pe_->RvaToRaw(export_dir_rva);
 
-        if (export_dir_raw)
+        if (export_dir_raw && (export_dir_raw + GetExportDirSize()) <= related_pe_->GetRawFileSize())
         {
             export_dir_ = (IMAGE_EXPORT_DIRECTORY*)related_pe_->GetContentAt(export_dir_raw, OffsetType::RAW);
             export_dir_offset_ = export_dir_raw;
         }
-        else if ((export_dir_rva + GetExportDirSize()) <= related_pe_->GetRawFileSize())
+        else if (!export_dir_raw && (export_dir_rva + GetExportDirSize()) <= related_pe_->GetRawFileSize())
         {
             export_dir_ = (IMAGE_EXPORT_DIRECTORY*)related_pe_->GetContentAt(export_dir_rva, OffsetType::RAW);
             export_dir_offset_ = export_dir_rva;
@@ -54,7 +58,7 @@ namespace PewParser {
         }
     }
 
-    BYTE* ExportDirWrapper::GetFieldValue() const
+    const BYTE* ExportDirWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
@@ -100,73 +104,63 @@ namespace PewParser {
         return offset;
     }
 
-    WORD ExportDirWrapper::GetOrdinal() const
+    DWORD ExportDirWrapper::GetOrdinal() const
     {
-        WORD base_ordinal = (WORD)export_dir_->Base + EAT_entry_;
-        WORD ordinal = base_ordinal;
-
-        return ordinal;
+        return export_dir_->Base + (DWORD)EAT_entry_;
     }
 
     DWORD ExportDirWrapper::GetFuncRVA() const
     {
-        DWORD rva = 0;
-
-        DWORD* EAT = (DWORD*)related_pe_->GetContentAt(export_dir_->AddressOfFunctions, OffsetType::RVA);
+        if (EAT_ && EAT_entry_ < EAT_to_name_.size())
+            return EAT_[EAT_entry_];
 
-        if (EAT)
-            rva = *(EAT + EAT_entry_);
-
-        return rva;
+        return 0;
     }
 
     DWORD ExportDirWrapper::GetFuncNameRVA() const
     {
-        DWORD rva = 0;
-
-        DWORD* ENT = (DWORD*)related_pe_->GetContentAt(export_dir_->AddressOfNames, OffsetType::RVA);
+        if (IsByOrdinal())
+            return 0;
 
-        if (ENT)
-            rva = *(ENT + ordinal_to_name_.at(EAT_entry_));
-
-        return rva;
+        return ENT_[EAT_to_name_[EAT_entry_]];
     }
 
-    std::string ExportDirWrapper::GetFuncName() const
+    std::string_view ExportDirWrapper::GetFuncName() const
     {
         DWORD func_name_rva = GetFuncNameRVA();
 
         if (func_name_rva)
-        {
-            char* func_name = (char*)related_pe_->GetContentAt(func_name_rva, OffsetType::RVA);
-
-            if (func_name)
-                return std::string(func_name);
-        }
+            return GetStringAt(func_name_rva);
 
-        return std::string();
+        return std::string_view();
     }
 
-    std::string ExportDirWrapper::GetForwarderName() const
+    std::string_view ExportDirWrapper::GetForwarderName() const
     {
         DWORD func_rva = GetFuncRVA();
 
         if (func_rva)
-        {
-            char* func_name = (char*)related_pe_->GetContentAt(func_rva, OffsetType::RVA);
-            if (func_name)
-                return std::string(func_name);
-        }
+            return GetStringAt(func_rva);
 
-        return std::string();
+        return std::string_view();
+    }
+
+    std::string_view ExportDirWrapper::GetStringAt(offset_t rva) const
+    {
+        offset_t raw = related_pe_->RvaToRaw(rva);
+        if (!raw || raw >= related_pe_->GetRawFileSize())
+            return std::string_view();
+
+        const char* str = (const char*)related_pe_->GetContentAt(raw, OffsetType::RAW);
+        return std::string_view(str, strnlen(str, related_pe_->GetRawFileSize() - raw));
     }
 
     bool ExportDirWrapper::IsByOrdinal() const
     {
-        if(ordinal_to_name_.find(EAT_entry_) == ordinal_to_name_.end())
+        if (EAT_entry_ >= EAT_to_name_.size())
             return true;
-        else
-            return false;
+
+        return EAT_to_name_[EAT_entry_] == kNoName;
     }
 
     bool ExportDirWrapper::IsForwarder() const
@@ -179,19 +173,64 @@ namespace PewParser {
         return (func_rva >= export_dir_rva && func_rva <= export_dir_size);
     }
 
+    bool ExportDirWrapper::FindExportByName(std::string_view name, index_t& EAT_entry) const
+    {
+        auto it = std::lower_bound(sorted_names_.begin(), sorted_names_.end(), name,
+            [](const ExportName& export_name, std::string_view value) { return export_name.name < value; });
+
+        if (it == sorted_names_.end() || it->name != name)
+            return false;
+
+        EAT_entry = it->EAT_entry;
+        return true;
+    }
+
     void ExportDirWrapper::CacheNames()
     {
-        WORD* ordinals_array = (WORD*)related_pe_->GetContentAt(export_dir_->AddressOfNameOrdinals, OffsetType::RVA);
+        EAT_to_name_.clear();
+        sorted_names_.clear();
+
+        if (!export_dir_)
+            return;
+
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+
+        // Both tables are clamped to what the file actually holds, NumberOfFunctions is not trusted
+        offset_t EAT_raw = related_pe_->RvaToRaw(export_dir_->AddressOfFunctions);
+        if (!EAT_raw || EAT_raw >= file_size)
+            return;
+
+        size_t functions_count = std::min<uintmax_t>(export_dir_->NumberOfFunctions, (file_size - EAT_raw) / sizeof(DWORD));
+        EAT_ = (const DWORD*)related_pe_->GetContentAt(EAT_raw, OffsetType::RAW);
+        EAT_to_name_.assign(functions_count, kNoName);
 
-        if (!ordinals_array)
+        offset_t ENT_raw = related_pe_->RvaToRaw(export_dir_->AddressOfNames);
+        offset_t ordinals_raw = related_pe_->RvaToRaw(export_dir_->AddressOfNameOrdinals);
+        if (!ENT_raw || ENT_raw >= file_size || !ordinals_raw || ordinals_raw >= file_size)
             return;
 
-        for (size_t i = 0; i < export_dir_->NumberOfNames; i++)
+        size_t names_count = export_dir_->NumberOfNames;
+        names_count = std::min<uintmax_t>(names_count, (file_size - ENT_raw) / sizeof(DWORD));
+        names_count = std::min<uintmax_t>(names_count, (file_size - ordinals_raw) / sizeof(WORD));
+
+        ENT_ = (const DWORD*)related_pe_->GetContentAt(ENT_raw, OffsetType::RAW);
+        const WORD* ordinals_array = (const WORD*)related_pe_->GetContentAt(ordinals_raw, OffsetType::RAW);
+
+        sorted_names_.reserve(names_count);
+        for (DWORD i = 0; i < names_count; i++)
         {
-            WORD ordinal = *ordinals_array;
-            ordinal_to_name_[ordinal] = (WORD)i;
-            ordinals_array++;
+            WORD EAT_entry = ordinals_array[i];
+            if (EAT_entry >= functions_count)
+                continue;
+
+            EAT_to_name_[EAT_entry] = i;
+            sorted_names_.push_back({ GetStringAt(ENT_[i]), EAT_entry });
         }
+
+        // Linkers emit the name table already sorted, so this is normally a single linear check
+        auto by_name = [](const ExportName& lhs, const ExportName& rhs) { return lhs.name < rhs.name; };
+        if (!std::is_sorted(sorted_names_.begin(), sorted_names_.end(), by_name))
+            std::stable_sort(sorted_names_.begin(), sorted_names_.end(), by_name);
     }
 
     bool ExportDirWrapper::IsValidWrapper() const
@@ -2,7 +2,9 @@
 #include <PEFile.h>
 #include <PewTypes.h>
 
-#include <unordered_map>
+#include <vector>
+#include <string_view>
+#include <memory_resource>
 
 namespace PewParser {
 
@@ -28,7 +30,7 @@ namespace PewParser {
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         std::string GetFieldDescription() const;
         FieldType GetFieldType() const { return field_type_; }
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
@@ -38,22 +40,29 @@ namespace PewParser {
         void LoadNextField();
         void Reset();
 
-        size_t GetNumOfFunctions() const { return export_dir_->NumberOfFunctions; }
+        size_t GetNumOfFunctions() const { return EAT_to_name_.size(); }
+        size_t GetNumOfNames() const { return sorted_names_.size(); }
 
         std::string GetLibraryName() const;
 
         offset_t GetOffset() const;
-        WORD GetOrdinal() const;
+        // Base + EAT entry, a DWORD like Base itself so large bases do not wrap at 16 bits
+        DWORD GetOrdinal() const;
         DWORD GetFuncRVA() const;
         DWORD GetFuncNameRVA() const;
-        std::string GetFuncName() const;
-        std::string GetForwarderName() const;
+        std::string_view GetFuncName() const;
+        std::string_view GetForwarderName() const;
 
         bool IsByOrdinal() const;
         bool IsForwarder() const;
 
         void LoadNextEATEntry() { EAT_entry_++; }
         void ResetEATEntry() { EAT_entry_ = 0; }
+        index_t GetEATEntry() const { return EAT_entry_; }
+        void SetEATEntry(index_t EAT_entry) { EAT_entry_ = EAT_entry; }
+
+        // Binary search over the name-sorted index, on success EAT_entry is the entry exported under name
+        bool FindExportByName(std::string_view name, index_t& EAT_entry) const;
 
         void CacheNames();
 
@@ -62,8 +71,17 @@ namespace PewParser {
         IMAGE_EXPORT_DIRECTORY* GetExportDir() { return export_dir_; }
         offset_t GetExportDirOffset() { return export_dir_offset_; }
         size_t GetExportDirSize() { return sizeof(IMAGE_EXPORT_DIRECTORY); }
+    private:
+        struct ExportName
+        {
+            std::string_view name;
+            DWORD EAT_entry;
+        };
+
+        static constexpr DWORD kNoName = 0xFFFFFFFF;
     private:
         void Init();
+        std::string_view GetStringAt(offset_t rva) const;
     private:
         IMAGE_EXPORT_DIRECTORY* export_dir_;
         offset_t export_dir_offset_;
@@ -72,9 +90,12 @@ namespace PewParser {
         FieldIndex field_index_;
         FieldType field_type_;
 
-        WORD EAT_entry_;
+        index_t EAT_entry_;
 
-        std::unordered_map<WORD, index_t> ordinal_to_name_;
+        const DWORD* EAT_;
+        const DWORD* ENT_;
+        std::pmr::vector<DWORD> EAT_to_name_;
+        std::pmr::vector<ExportName> sorted_names_;
 
         PEFile* related_pe_;
     };
@@ -3,11 +3,13 @@
 #include <PEFile.h>
 
 #include <cstring>
+#include <algorithm>
 
 namespace PewParser {
 
     ImportDirWrapper::ImportDirWrapper(PEFile* pe)
-        : related_pe_(pe), root_descriptor_(nullptr), selected_descriptor_(nullptr), root_descriptor_offset_(0), current_forwarderchain_(-1)
+        : related_pe_(pe), root_descriptor_(nullptr), selected_descriptor_(nullptr), root_descriptor_offset_(0), current_forwarderchain_(-1),
+        table_(pe->GetMemoryResource())
     {
         Init();
 
@@ -20,6 +22,8 @@ namespace PewParser {
             thunk_type_ = ThunkType::THUNK32;
         else
             thunk_type_ = ThunkType::THUNK64;
+
+        BuildImportTable();
     }
 
     void ImportDirWrapper::Init()
@@ -27,22 +31,46 @@ namespace PewParser {
         offset_t root_descriptor_rva = related_pe_->GetDataDirectory()[DataDirEntries::IMP].VirtualAddress;
         offset_t root_descriptor_raw = related_pe_->RvaToRaw(root_descriptor_rva);
 
-        if (root_descriptor_raw)
+        if (root_descriptor_raw && (root_descriptor_raw + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
         {
             root_descriptor_ = (IMAGE_IMPORT_DESCRIPTOR*)related_pe_->GetContentAt(root_descriptor_raw, OffsetType::RAW);
             selected_descriptor_ = root_descriptor_;
             root_descriptor_offset_ = root_descriptor_raw;
             current_forwarderchain_ = selected_descriptor_->ForwarderChain;
         }
-        else if ((root_descriptor_raw + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
+        else if (!root_descriptor_raw && (root_descriptor_rva + GetDescriptorSize()) <= related_pe_->GetRawFileSize())
         {
-            root_descriptor_ = (IMAGE_IMPORT_DESCRIPTOR*)related_pe_->GetContentAt(root_descriptor_raw, OffsetType::RAW);
+            root_descriptor_ = (IMAGE_IMPORT_DESCRIPTOR*)related_pe_->GetContentAt(root_descriptor_rva, OffsetType::RAW);
             selected_descriptor_ = root_descriptor_;
-            root_descriptor_offset_ = root_descriptor_raw;
+            root_descriptor_offset_ = root_descriptor_rva;
             current_forwarderchain_ = selected_descriptor_->ForwarderChain;
         }
     }
 
+    void ImportDirWrapper::BuildImportTable()
+    {
+        ImportTableBuilder builder(related_pe_, table_);
+
+        if (!root_descriptor_)
+            return;
+
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        IMAGE_IMPORT_DESCRIPTOR null_descriptor = { 0 };
+
+        table_.descriptors = root_descriptor_;
+
+        offset_t descriptor_raw = root_descriptor_offset_;
+        for (const IMAGE_IMPORT_DESCRIPTOR* descriptor = root_descriptor_;
+            descriptor_raw + sizeof(IMAGE_IMPORT_DESCRIPTOR) <= file_size && std::memcmp(descriptor, &null_descriptor, sizeof(IMAGE_IMPORT_DESCRIPTOR)) != 0;
+            descriptor++, descriptor_raw += sizeof(IMAGE_IMPORT_DESCRIPTOR))
+        {
+            // Names and ordinals come from the INT when present, the IAT is used for images without one
+            offset_t lookup_rva = descriptor->OriginalFirstThunk ? descriptor->OriginalFirstThunk : descriptor->FirstThunk;
+            if (!builder.AddLibrary(builder.GetStringAt(descriptor->Name), lookup_rva, descriptor->FirstThunk))
+                break;
+        }
+    }
+
     std::string_view ImportDirWrapper::GetFieldName() const
     {
         switch (field_index_)
@@ -56,69 +84,11 @@ namespace PewParser {
         }
     }
 
-    BYTE* ImportDirWrapper::GetFieldValue() const
+    const BYTE* ImportDirWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
 
-    size_t ImportDirWrapper::GetLiberiresCount() const
-    {
-        size_t descriptors_count = 0;
-
-        IMAGE_IMPORT_DESCRIPTOR* descriptor = root_descriptor_;
-        IMAGE_IMPORT_DESCRIPTOR null_descriptor = { 0 };
-
-        while (std::memcmp(descriptor, &null_descriptor, sizeof(IMAGE_IMPORT_DESCRIPTOR)) != 0)
-        {
-            descriptors_count++;
-            descriptor++;
-        }
-
-        return descriptors_count;
-    }
-
-    std::string ImportDirWrapper::GetLibraryName(index_t descriptor_index) const
-    {
-        char* libraryName = (char*)related_pe_->GetContentAt((root_descriptor_ + descriptor_index)->Name, OffsetType::RVA);
-
-        if(libraryName)
-            return std::string(libraryName);
-        
-        return std::string();
-    }
-
-    size_t ImportDirWrapper::GetFuncCount(index_t descriptor_index) const
-    {
-        size_t functions_count = 0;
-        offset_t symbols_array_offset = 0;
-
-        if (HasINT(descriptor_index))
-            symbols_array_offset = (root_descriptor_ + descriptor_index)->OriginalFirstThunk;
-        else if (HasIAT(descriptor_index))
-            symbols_array_offset = (root_descriptor_ + descriptor_index)->FirstThunk;
-
-        if (thunk_type_ == ThunkType::THUNK32)
-        {
-            DWORD* symbols_array_ptr = (DWORD*)related_pe_->GetContentAt(symbols_array_offset, OffsetType::RVA);
-            while (*symbols_array_ptr)
-            {
-                functions_count++;
-                symbols_array_ptr++;
-            }
-        }
-        else
-        {
-            ULONGLONG* symbols_array_ptr = (ULONGLONG*)related_pe_->GetContentAt(symbols_array_offset, OffsetType::RVA);
-            while (*symbols_array_ptr)
-            {
-                functions_count++;
-                symbols_array_ptr++;
-            }
-        }
-
-        return functions_count;
-    }
-
     Binding ImportDirWrapper::BindingStyle(index_t descriptor_index) const
     {
         if ((root_descriptor_ + descriptor_index)->TimeDateStamp == -1)
@@ -151,58 +121,19 @@ namespace PewParser {
 
     bool ImportDirWrapper::IsByOrdinal() const
     {
-        offset_t entry_offset = 0;
-
-        if (HasINT(selected_library_))
-            entry_offset = selected_descriptor_->OriginalFirstThunk + (current_ft_array_index_ * GetThunkDataSize());
-        else if (HasIAT(selected_library_))
-            entry_offset = selected_descriptor_->FirstThunk + (current_ft_array_index_ * GetThunkDataSize());
-
-        if (thunk_type_ == ThunkType::THUNK32)
-        {
-            IMAGE_THUNK_DATA32 thunk = *(IMAGE_THUNK_DATA32*)related_pe_->GetContentAt(entry_offset, OffsetType::RVA);
-            if (IMAGE_SNAP_BY_ORDINAL32(thunk.u1.Ordinal))
-                return true;
-        }
-        else
-        {
-            IMAGE_THUNK_DATA64 thunk = *(IMAGE_THUNK_DATA64*)related_pe_->GetContentAt(entry_offset, OffsetType::RVA);
-            if (IMAGE_SNAP_BY_ORDINAL64(thunk.u1.Ordinal))
-                return true;
-        }
-
-        return false;
+        return table_.by_ordinal[GetSelectedFunc()];
     }
 
     WORD ImportDirWrapper::GetOrdinal() const
     {
-        offset_t entry_offset = 0;
-        WORD ordinal = 0;
-
-        if (HasINT(selected_library_))
-            entry_offset = selected_descriptor_->OriginalFirstThunk + (current_ft_array_index_ * GetThunkDataSize());
-        else if (HasIAT(selected_library_))
-            entry_offset = selected_descriptor_->FirstThunk + (current_ft_array_index_ * GetThunkDataSize());
-
-        if (thunk_type_ == ThunkType::THUNK32)
-        {
-            IMAGE_THUNK_DATA32 thunk = *(IMAGE_THUNK_DATA32*)related_pe_->GetContentAt(entry_offset, OffsetType::RVA);
-            ordinal = IMAGE_ORDINAL32(thunk.u1.Ordinal);
-        }
-        else
-        {
-            IMAGE_THUNK_DATA64 thunk = *(IMAGE_THUNK_DATA64*)related_pe_->GetContentAt(entry_offset, OffsetType::RVA);
-            ordinal = IMAGE_ORDINAL64(thunk.u1.Ordinal);
-        }
-
-        return ordinal;
+        return table_.ordinals[GetSelectedFunc()];
     }
 
-    void* ImportDirWrapper::GetOriginalThunk() const
+    const void* ImportDirWrapper::GetOriginalThunk() const
     {
         offset_t oft_offset = selected_descriptor_->OriginalFirstThunk + (current_ft_array_index_ * GetThunkDataSize());
 
-        void* oft_ptr = related_pe_->GetContentAt(oft_offset, OffsetType::RVA);
+        const void* oft_ptr = related_pe_->GetContentAt(oft_offset, OffsetType::RVA);
 
         if (!oft_ptr)
             return nullptr;
@@ -210,11 +141,11 @@ namespace PewParser {
         return oft_ptr;
     }
 
-    void* ImportDirWrapper::GetThunk() const
+    const void* ImportDirWrapper::GetThunk() const
     {
         offset_t ft_offset = selected_descriptor_->FirstThunk + (current_ft_array_index_ * GetThunkDataSize());
 
-        void* ft_ptr = related_pe_->GetContentAt(ft_offset, OffsetType::RVA);
+        const void* ft_ptr = related_pe_->GetContentAt(ft_offset, OffsetType::RVA);
 
         if (!ft_ptr)
             return nullptr;
@@ -224,40 +155,12 @@ namespace PewParser {
 
     WORD ImportDirWrapper::GetHint() const
     {
-        IMAGE_IMPORT_BY_NAME* hint_and_name = GetHintAndName();
-
-        return hint_and_name->Hint;
+        return table_.hints[GetSelectedFunc()];
     }
 
-    std::string ImportDirWrapper::GetName() const
+    std::string_view ImportDirWrapper::GetName() const
     {
-        IMAGE_IMPORT_BY_NAME* hint_and_name = GetHintAndName();
-
-        return (char*)hint_and_name->Name;
-    }
-
-    IMAGE_IMPORT_BY_NAME* ImportDirWrapper::GetHintAndName() const
-    {
-        offset_t entry_offset = 0;
-        IMAGE_IMPORT_BY_NAME* hint_and_name = nullptr;
-
-        if (HasINT(selected_library_))
-            entry_offset = selected_descriptor_->OriginalFirstThunk + (current_ft_array_index_ * GetThunkDataSize());
-        else if (HasIAT(selected_library_))
-            entry_offset = selected_descriptor_->FirstThunk + (current_ft_array_index_ * GetThunkDataSize());
-
-        if (thunk_type_ == ThunkType::THUNK32)
-        {
-            IMAGE_THUNK_DATA32 thunk = *(IMAGE_THUNK_DATA32*)related_pe_->GetContentAt(entry_offset, OffsetType::RVA);
-            hint_and_name = (IMAGE_IMPORT_BY_NAME*)related_pe_->GetContentAt(thunk.u1.AddressOfData, OffsetType::RVA);
-        }
-        else
-        {
-            IMAGE_THUNK_DATA64 thunk = *(IMAGE_THUNK_DATA64*)related_pe_->GetContentAt(entry_offset, OffsetType::RVA);
-            hint_and_name = (IMAGE_IMPORT_BY_NAME*)related_pe_->GetContentAt(thunk.u1.AddressOfData, OffsetType::RVA);
-        }
-
-        return hint_and_name;
+        return table_.names[GetSelectedFunc()];
     }
 
     bool ImportDirWrapper::HasForwarders(index_t descriptor_index) const
@@ -2,6 +2,12 @@
 #include <PEFile.h>
 #include <PewTypes.h>
 
+#include "ImportTable.h"
+
+#include <vector>
+#include <string_view>
+#include <memory_resource>
+
 namespace PewParser {
 
     class ImportDirWrapper
@@ -20,22 +26,24 @@ namespace PewParser {
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
 
-        size_t GetLiberiresCount() const;
-        std::string GetLibraryName(index_t descriptor_index) const;
-        size_t GetFuncCount(index_t descriptor_index) const;
+        const ImportTable& GetImportTable() const { return table_; }
+
+        size_t GetLiberiresCount() const { return table_.GetLibrariesCount(); }
+        std::string_view GetLibraryName(index_t descriptor_index) const { return table_.library_names[descriptor_index]; }
+        size_t GetFuncCount(index_t descriptor_index) const { return table_.GetFuncCount(descriptor_index); }
         Binding BindingStyle(index_t descriptor_index) const;
         bool IsValidForwarderChain(index_t descriptor_index) const;
 
         offset_t CallFuncVia() const;
         bool IsByOrdinal() const;
         WORD GetOrdinal() const;
-        void* GetOriginalThunk() const;
-        void* GetThunk() const;
+        const void* GetOriginalThunk() const;
+        const void* GetThunk() const;
         WORD GetHint() const;
-        std::string GetName() const;
+        std::string_view GetName() const;
 
         bool HasForwarders(index_t descriptor_index) const;
         bool IsForwarder() const;
@@ -66,9 +74,10 @@ namespace PewParser {
     private:
         bool HasINT(index_t descriptor_index) const;
         bool HasIAT(index_t descriptor_index) const;
-        IMAGE_IMPORT_BY_NAME* GetHintAndName() const;
+        index_t GetSelectedFunc() const { return table_.func_begin[selected_library_] + current_ft_array_index_; }
     private:
         void Init();
+        void BuildImportTable();
     private:
         IMAGE_IMPORT_DESCRIPTOR* root_descriptor_;
         IMAGE_IMPORT_DESCRIPTOR* selected_descriptor_;
@@ -82,6 +91,8 @@ namespace PewParser {
         ThunkType thunk_type_;
         index_t current_ft_array_index_;
 
+        ImportTable table_;
+
         PEFile* related_pe_;
     };
 }
\ No newline at end of file
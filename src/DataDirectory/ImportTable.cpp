@@ -0,0 +1,110 @@
+#include "ImportTable.h"
+
+#include <PEFile.h>
+
+#include <cstring>
+
+namespace PewParser {
+
+    ImportTableBuilder::ImportTableBuilder(PEFile* pe, ImportTable& table)
+        : related_pe_(pe), table_(table), thunk_size_((pe->GetPEType() == PEType::x32PE) ? sizeof(DWORD) : sizeof(ULONGLONG)),
+        max_funcs_((size_t)(pe->GetRawFileSize() / thunk_size_)), walked_lookups_(pe->GetMemoryResource())
+    {
+        if (table_.func_begin.empty())
+            table_.func_begin.push_back(0);
+    }
+
+    std::string_view ImportTableBuilder::GetStringAt(offset_t rva) const
+    {
+        offset_t raw = related_pe_->RvaToRaw(rva);
+        if (!raw || raw >= related_pe_->GetRawFileSize())
+            return std::string_view();
+
+        const char* str = (const char*)related_pe_->GetContentAt(raw, OffsetType::RAW);
+        return std::string_view(str, strnlen(str, related_pe_->GetRawFileSize() - raw));
+    }
+
+    bool ImportTableBuilder::AddLibrary(std::string_view library_name, offset_t lookup_rva, offset_t iat_rva, ULONGLONG name_bias)
+    {
+        if (table_.GetLibrariesCount() >= kMaxLibraries)
+        {
+            table_.is_truncated = true;
+            return false;
+        }
+
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        offset_t lookup_raw = lookup_rva ? related_pe_->RvaToRaw(lookup_rva) : 0;
+
+        table_.library_names.push_back(library_name);
+
+        // The library is kept with no functions when its lookup table was already walked
+        if (lookup_raw && !walked_lookups_.insert(lookup_rva).second)
+        {
+            table_.is_truncated = true;
+            lookup_raw = 0;
+        }
+
+        if (lookup_raw)
+        {
+            const BYTE* lookup = related_pe_->GetContentAt(lookup_raw, OffsetType::RAW);
+            size_t max_funcs = (lookup_raw < file_size) ? (size_t)((file_size - lookup_raw) / thunk_size_) : 0;
+
+            for (index_t func = 0; func < max_funcs; func++)
+            {
+                if (table_.GetTotalFuncCount() >= max_funcs_)
+                {
+                    table_.is_truncated = true;
+                    break;
+                }
+
+                ULONGLONG thunk = 0;
+                bool by_ordinal = false;
+
+                if (thunk_size_ == sizeof(DWORD))
+                {
+                    DWORD thunk32 = 0;
+                    std::memcpy(&thunk32, lookup + func * thunk_size_, sizeof(thunk32));
+                    thunk = thunk32;
+                    by_ordinal = IMAGE_SNAP_BY_ORDINAL32(thunk32);
+                }
+                else
+                {
+                    std::memcpy(&thunk, lookup + func * thunk_size_, sizeof(thunk));
+                    by_ordinal = IMAGE_SNAP_BY_ORDINAL64(thunk);
+                }
+
+                if (!thunk)
+                    break;
+
+                table_.thunk_rvas.push_back(iat_rva + func * thunk_size_);
+                table_.by_ordinal.push_back(by_ordinal);
+
+                if (by_ordinal)
+                {
+                    table_.ordinals.push_back((WORD)(thunk & 0xFFFF));
+                    table_.hints.push_back(0);
+                    table_.names.push_back(std::string_view());
+                    continue;
+                }
+
+                WORD hint = 0;
+                std::string_view name;
+                DWORD hint_rva = (DWORD)(thunk - name_bias);
+                offset_t hint_raw = related_pe_->RvaToRaw(hint_rva);
+                if (hint_raw && hint_raw + sizeof(WORD) <= file_size)
+                {
+                    std::memcpy(&hint, related_pe_->GetContentAt(hint_raw, OffsetType::RAW), sizeof(hint));
+                    name = GetStringAt(hint_rva + sizeof(WORD));
+                }
+
+                table_.ordinals.push_back(0);
+                table_.hints.push_back(hint);
+                table_.names.push_back(name);
+            }
+        }
+
+        table_.func_begin.push_back(table_.names.size());
+        return true;
+    }
+
+}
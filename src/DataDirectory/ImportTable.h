@@ -0,0 +1,69 @@
+#pragma once
+#include <PEFormat.h>
+#include <PewTypes.h>
+
+#include <vector>
+#include <string_view>
+#include <unordered_set>
+#include <memory_resource>
+
+namespace PewParser {
+
+    class PEFile;
+
+    // Flattened import directory, built in one linear pass when the wrapper is created.
+    // Functions of library i occupy [func_begin[i], func_begin[i + 1]) in the per-function arrays,
+    // names are views into the image so the table is only valid while the PEFile is alive.
+    // Regular and delay imports share the layout, so both can be walked with the same loop.
+    struct ImportTable
+    {
+        ImportTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : library_names(resource), func_begin(resource), thunk_rvas(resource), by_ordinal(resource),
+            ordinals(resource), hints(resource), names(resource)
+        {
+        }
+
+        const IMAGE_IMPORT_DESCRIPTOR* descriptors = nullptr;    // regular imports only
+        std::pmr::vector<std::string_view> library_names;
+        std::pmr::vector<index_t> func_begin;
+
+        std::pmr::vector<offset_t> thunk_rvas;
+        std::pmr::vector<BYTE> by_ordinal;
+        std::pmr::vector<WORD> ordinals;
+        std::pmr::vector<WORD> hints;
+        std::pmr::vector<std::string_view> names;
+
+        // Set when a limit of ImportTableBuilder cut the table, or a lookup table shared with an earlier library was skipped
+        bool is_truncated = false;
+
+        size_t GetLibrariesCount() const { return library_names.size(); }
+        size_t GetFuncCount(index_t library) const { return func_begin[library + 1] - func_begin[library]; }
+        size_t GetTotalFuncCount() const { return names.size(); }
+    };
+
+    // Appends libraries to an ImportTable, shared by ImportDirWrapper and DelayImportDirWrapper.
+    // Descriptors can all point at the same lookup table, so the total work is bounded instead of trusting them:
+    // at most kMaxLibraries libraries, at most one function per thunk sized slot of the file, and a lookup table
+    // that was already walked for an earlier library is not walked again.
+    class ImportTableBuilder
+    {
+    public:
+        static constexpr size_t kMaxLibraries = 8192;
+    public:
+        ImportTableBuilder(PEFile* pe, ImportTable& table);
+
+        // Thunks are read from lookup_rva up to the null one, iat_rva only gives the slot of every function.
+        // Name thunks minus name_bias are RVAs, the bias is the image base for VA based delay imports.
+        // Returns false without adding the library once kMaxLibraries is reached.
+        bool AddLibrary(std::string_view library_name, offset_t lookup_rva, offset_t iat_rva, ULONGLONG name_bias = 0);
+
+        std::string_view GetStringAt(offset_t rva) const;
+    private:
+        PEFile* related_pe_;
+        ImportTable& table_;
+        size_t thunk_size_;
+        size_t max_funcs_;
+        std::pmr::unordered_set<offset_t> walked_lookups_;
+    };
+
+}
@@ -0,0 +1,223 @@
+#include "LoadConfigDirWrapper.h"
+
+#include <Headers/SectionHdrsWrapper.h>
+
+#include <algorithm>
+
+namespace PewParser {
+
+    // Version 1 and 2 DVRT headers, read by offset since the 64 bit symbol is not naturally aligned
+    constexpr size_t kDynamicRelocV2MinHeaderSize = 2 * sizeof(DWORD);
+
+    void LoadConfigTable::ExtractRvas(DWORD* rvas) const
+    {
+        if (stride == sizeof(DWORD))
+        {
+            std::memcpy(rvas, data.data(), count * sizeof(DWORD));
+            return;
+        }
+
+        const BYTE* entry = data.data();
+        for (size_t i = 0; i < count; i++, entry += stride)
+            std::memcpy(rvas + i, entry, sizeof(DWORD));
+    }
+
+    LoadConfigDirWrapper::LoadConfigDirWrapper(PEFile* pe)
+        : related_pe_(pe), load_config_dir_(nullptr), load_config_dir_offset_(0), is_x32_(pe->GetPEType() == PEType::x32PE),
+          declared_size_(0), config_size_(0), is_truncated_(false), config32_(), config64_(), tables_(),
+          dynamic_reloc_table_offset_(0), dynamic_reloc_version_(0), is_dynamic_reloc_table_valid_(false), dynamic_relocs_(pe->GetMemoryResource()),
+          chpe_metadata_offset_(0), chpe_version_(0)
+    {
+        Init();
+
+        if (load_config_dir_)
+        {
+            ResolveTables();
+            ResolveChpeMetadata();
+            ParseDynamicRelocs();
+        }
+    }
+
+    void LoadConfigDirWrapper::Init()
+    {
+        offset_t load_config_dir_rva = related_pe_->GetDataDirectory()[DataDirEntries::LDCFG].VirtualAddress;
+        offset_t load_config_dir_raw = related_pe_->RvaToRaw(load_config_dir_rva);
+
+        if (!load_config_dir_raw)
+            load_config_dir_raw = load_config_dir_rva;
+
+        if (!load_config_dir_raw || load_config_dir_raw + sizeof(DWORD) > related_pe_->GetRawFileSize())
+            return;
+
+        load_config_dir_ = related_pe_->GetContentAt(load_config_dir_raw, OffsetType::RAW);
+        load_config_dir_offset_ = load_config_dir_raw;
+
+        // Older linkers wrote shorter structs and newer ones may write longer, only the known prefix is kept
+        std::memcpy(&declared_size_, load_config_dir_, sizeof(DWORD));
+
+        size_t struct_size = is_x32_ ? sizeof(IMAGE_LOAD_CONFIG_DIRECTORY32) : sizeof(IMAGE_LOAD_CONFIG_DIRECTORY64);
+        config_size_ = (size_t)std::min<uintmax_t>({ declared_size_, struct_size, related_pe_->GetRawFileSize() - load_config_dir_raw });
+        is_truncated_ = (config_size_ < std::min<size_t>(declared_size_, struct_size));
+
+        std::memcpy(is_x32_ ? (void*)&config32_ : (void*)&config64_, load_config_dir_, config_size_);
+    }
+
+    void LoadConfigDirWrapper::ResolveTable(Tables table, offset_t raw, ULONGLONG count, size_t stride)
+    {
+        LoadConfigTable& resolved = tables_[table];
+        resolved.stride = stride;
+
+        if (!raw || !count || raw >= related_pe_->GetRawFileSize())
+            return;
+
+        uintmax_t available = (related_pe_->GetRawFileSize() - raw) / stride;
+
+        resolved.raw = raw;
+        resolved.count = (size_t)std::min<uintmax_t>(count, available);
+        resolved.is_truncated = (count > available);
+        resolved.data = ByteSpan(related_pe_->GetContentAt(raw, OffsetType::RAW), resolved.count * stride);
+    }
+
+    void LoadConfigDirWrapper::ResolveTables()
+    {
+        // Fields past the copied size read as zero and leave their table empty.
+        // Every GFIDS style table shares the metadata size from the high nibble of GuardFlags
+        size_t guard_stride = sizeof(DWORD) + ((GetGuardFlags() & IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_MASK) >> IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT);
+
+        ResolveTable(SE_HANDLERS, related_pe_->VaToRaw(GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::SEHandlerTable, &IMAGE_LOAD_CONFIG_DIRECTORY64::SEHandlerTable)),
+                     GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::SEHandlerCount, &IMAGE_LOAD_CONFIG_DIRECTORY64::SEHandlerCount), sizeof(DWORD));
+
+        ResolveTable(GUARD_CF_FUNCTIONS, related_pe_->VaToRaw(GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardCFFunctionTable, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardCFFunctionTable)),
+                     GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardCFFunctionCount, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardCFFunctionCount), guard_stride);
+
+        ResolveTable(GUARD_IAT_ENTRIES, related_pe_->VaToRaw(GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardAddressTakenIatEntryTable, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardAddressTakenIatEntryTable)),
+                     GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardAddressTakenIatEntryCount, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardAddressTakenIatEntryCount), guard_stride);
+
+        ResolveTable(GUARD_LONG_JUMPS, related_pe_->VaToRaw(GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardLongJumpTargetTable, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardLongJumpTargetTable)),
+                     GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardLongJumpTargetCount, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardLongJumpTargetCount), guard_stride);
+
+        ResolveTable(GUARD_EH_CONTINUATIONS, related_pe_->VaToRaw(GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardEHContinuationTable, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardEHContinuationTable)),
+                     GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardEHContinuationCount, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardEHContinuationCount), guard_stride);
+    }
+
+    void LoadConfigDirWrapper::ResolveChpeMetadata()
+    {
+        tables_[CHPE_CODE_RANGES].stride = 2 * sizeof(DWORD);
+
+        offset_t metadata_raw = related_pe_->VaToRaw(GetChpeMetadataPointer());
+        if (!metadata_raw || metadata_raw + 3 * sizeof(DWORD) > related_pe_->GetRawFileSize())
+            return;
+
+        // Version, code map RVA, code map count
+        DWORD metadata[3];
+        std::memcpy(metadata, related_pe_->GetContentAt(metadata_raw, OffsetType::RAW), sizeof(metadata));
+
+        chpe_metadata_offset_ = metadata_raw;
+        chpe_version_ = metadata[0];
+
+        ResolveTable(CHPE_CODE_RANGES, related_pe_->RvaToRaw(metadata[1]), metadata[2], tables_[CHPE_CODE_RANGES].stride);
+    }
+
+    void LoadConfigDirWrapper::ParseDynamicRelocs()
+    {
+        offset_t table_raw = 0;
+
+        // Section and offset are preferred since the VA field is zeroed once the loader has applied the relocations
+        WORD section = (WORD)GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::DynamicValueRelocTableSection, &IMAGE_LOAD_CONFIG_DIRECTORY64::DynamicValueRelocTableSection);
+        DWORD offset = (DWORD)GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::DynamicValueRelocTableOffset, &IMAGE_LOAD_CONFIG_DIRECTORY64::DynamicValueRelocTableOffset);
+
+        SectionHdrsWrapper* section_hdrs = related_pe_->GetSectionHdrsWrapper();
+        if (section && section_hdrs && section <= section_hdrs->GetNumOfSections())
+            table_raw = (offset_t)section_hdrs->GetRootSectionHdr()[section - 1].PointerToRawData + offset;
+
+        if (!table_raw)
+            table_raw = related_pe_->VaToRaw(GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::DynamicValueRelocTable, &IMAGE_LOAD_CONFIG_DIRECTORY64::DynamicValueRelocTable));
+
+        if (!table_raw || table_raw + sizeof(IMAGE_DYNAMIC_RELOCATION_TABLE) > related_pe_->GetRawFileSize())
+            return;
+
+        IMAGE_DYNAMIC_RELOCATION_TABLE table_hdr;
+        std::memcpy(&table_hdr, related_pe_->GetContentAt(table_raw, OffsetType::RAW), sizeof(table_hdr));
+
+        dynamic_reloc_table_offset_ = table_raw;
+        dynamic_reloc_version_ = table_hdr.Version;
+        is_dynamic_reloc_table_valid_ = (table_hdr.Version == 1 || table_hdr.Version == 2);
+
+        if (!is_dynamic_reloc_table_valid_)
+            return;
+
+        const BYTE* file = related_pe_->GetContentAt(0, OffsetType::RAW);
+        uintmax_t entries_begin = table_raw + sizeof(IMAGE_DYNAMIC_RELOCATION_TABLE);
+        uintmax_t entries_end = std::min<uintmax_t>(entries_begin + table_hdr.Size, related_pe_->GetRawFileSize());
+        size_t symbol_size = is_x32_ ? sizeof(DWORD) : sizeof(ULONGLONG);
+
+        // Every entry has at least an 8 byte header, so the walk ends after Size / 8 steps
+        for (uintmax_t entry = entries_begin; entry < entries_end; )
+        {
+            DynamicRelocation relocation = {};
+            relocation.raw = (offset_t)entry;
+
+            uintmax_t header_size;
+            DWORD fixups_size;
+
+            if (table_hdr.Version == 1)
+            {
+                header_size = symbol_size + sizeof(DWORD);
+                if (entry + header_size > entries_end)
+                    break;
+
+                std::memcpy(&relocation.symbol, file + entry, symbol_size);
+                std::memcpy(&fixups_size, file + entry + symbol_size, sizeof(DWORD));
+            }
+            else
+            {
+                // HeaderSize, FixupInfoSize, Symbol, SymbolGroup, Flags
+                if (entry + kDynamicRelocV2MinHeaderSize + symbol_size > entries_end)
+                    break;
+
+                DWORD v2_header_size;
+                std::memcpy(&v2_header_size, file + entry, sizeof(DWORD));
+                std::memcpy(&fixups_size, file + entry + sizeof(DWORD), sizeof(DWORD));
+                std::memcpy(&relocation.symbol, file + entry + kDynamicRelocV2MinHeaderSize, symbol_size);
+
+                header_size = v2_header_size;
+                if (header_size < kDynamicRelocV2MinHeaderSize + symbol_size || entry + header_size > entries_end)
+                    break;
+            }
+
+            uintmax_t fixups_begin = entry + header_size;
+            size_t fixups_available = (size_t)std::min<uintmax_t>(fixups_size, entries_end - fixups_begin);
+            relocation.fixups = ByteSpan(file + fixups_begin, fixups_available);
+
+            dynamic_relocs_.push_back(relocation);
+
+            if (fixups_available < fixups_size)
+                break;
+
+            entry = fixups_begin + fixups_size;
+        }
+    }
+
+    std::string_view LoadConfigDirWrapper::GetTableName(Tables table)
+    {
+        switch (table)
+        {
+            case SE_HANDLERS:               return "SEHandlerTable";
+            case GUARD_CF_FUNCTIONS:        return "GuardCFFunctionTable";
+            case GUARD_IAT_ENTRIES:         return "GuardAddressTakenIatEntryTable";
+            case GUARD_LONG_JUMPS:          return "GuardLongJumpTargetTable";
+            case GUARD_EH_CONTINUATIONS:    return "GuardEHContinuationTable";
+            case CHPE_CODE_RANGES:          return "CHPECodeMap";
+            default:                        return "Unknown";
+        }
+    }
+
+    bool LoadConfigDirWrapper::IsValidWrapper() const
+    {
+        if (load_config_dir_)
+            return true;
+
+        return false;
+    }
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <PEFile.h>
+#include <PewTypes.h>
+
+#include <array>
+#include <vector>
+#include <cstring>
+#include <string_view>
+#include <memory_resource>
+
+namespace PewParser {
+
+    // Array of RVAs that a load config field points to, viewed in place. Entries are stride bytes apart,
+    // the RVA comes first and the rest of the entry is metadata (GFIDS flags for the guard tables).
+    struct LoadConfigTable
+    {
+        offset_t raw = 0;
+        size_t count = 0;                   // entries inside the file
+        size_t stride = sizeof(DWORD);
+        ByteSpan data;                      // count * stride bytes
+        bool is_truncated = false;          // the declared count runs past the end of the file
+
+        DWORD GetRva(index_t entry) const
+        {
+            DWORD rva;
+            std::memcpy(&rva, data.data() + entry * stride, sizeof(DWORD));
+            return rva;
+        }
+
+        // First metadata byte, 0 when the entries have none
+        BYTE GetFlags(index_t entry) const { return (stride > sizeof(DWORD)) ? data[entry * stride + sizeof(DWORD)] : 0; }
+
+        // Every RVA into rvas, which must hold count entries
+        void ExtractRvas(DWORD* rvas) const;
+    };
+
+    struct DynamicRelocation
+    {
+        ULONGLONG symbol;                   // IMAGE_DYNAMIC_RELOCATION_* or an import symbol VA
+        offset_t raw;                       // header of the entry
+        ByteSpan fixups;                    // version 1: IMAGE_BASE_RELOCATION blocks, version 2: FixupInfo
+    };
+
+    // IMAGE_LOAD_CONFIG_DIRECTORY32 / 64 of any size. The struct grew with every Windows release and its Size field
+    // tells which version the linker wrote, fields past it (or past the end of the file) read as zero.
+    class LoadConfigDirWrapper
+    {
+    public:
+        enum Tables
+        {
+            SE_HANDLERS = 0,                // x86 only, SafeSEH handler RVAs
+            GUARD_CF_FUNCTIONS,
+            GUARD_IAT_ENTRIES,
+            GUARD_LONG_JUMPS,
+            GUARD_EH_CONTINUATIONS,
+            CHPE_CODE_RANGES,               // hybrid x86 / ARM64EC code map, 8 byte entries with the code type in the low bits
+            TABLES_COUNT
+        };
+    public:
+        LoadConfigDirWrapper(PEFile* pe);
+
+        // Size field as written, GetLoadConfigSize is the part that was actually read
+        DWORD GetDeclaredSize() const { return declared_size_; }
+        size_t GetLoadConfigSize() const { return config_size_; }
+        bool IsTruncated() const { return is_truncated_; }    // the file ends before the declared (and known) size
+        bool HasField(size_t field_offset, size_t field_size) const { return field_offset + field_size <= config_size_; }
+
+        // Widened field of the struct matching IsX32, e.g. GetField(&IMAGE_LOAD_CONFIG_DIRECTORY32::GuardFlags, &IMAGE_LOAD_CONFIG_DIRECTORY64::GuardFlags)
+        template<typename Field32, typename Field64>
+        ULONGLONG GetField(Field32 IMAGE_LOAD_CONFIG_DIRECTORY32::* field32, Field64 IMAGE_LOAD_CONFIG_DIRECTORY64::* field64) const
+        {
+            return is_x32_ ? (ULONGLONG)(config32_.*field32) : (ULONGLONG)(config64_.*field64);
+        }
+
+        // Zero filled past GetLoadConfigSize, use the one matching IsX32
+        const IMAGE_LOAD_CONFIG_DIRECTORY32& GetLoadConfig32() const { return config32_; }
+        const IMAGE_LOAD_CONFIG_DIRECTORY64& GetLoadConfig64() const { return config64_; }
+        bool IsX32() const { return is_x32_; }
+
+        DWORD GetTimeDateStamp() const { return is_x32_ ? config32_.TimeDateStamp : config64_.TimeDateStamp; }
+        ULONGLONG GetSecurityCookie() const { return is_x32_ ? config32_.SecurityCookie : config64_.SecurityCookie; }
+        ULONGLONG GetGuardCFCheckFunctionPointer() const { return is_x32_ ? config32_.GuardCFCheckFunctionPointer : config64_.GuardCFCheckFunctionPointer; }
+        ULONGLONG GetGuardCFDispatchFunctionPointer() const { return is_x32_ ? config32_.GuardCFDispatchFunctionPointer : config64_.GuardCFDispatchFunctionPointer; }
+        DWORD GetGuardFlags() const { return is_x32_ ? config32_.GuardFlags : config64_.GuardFlags; }
+        ULONGLONG GetChpeMetadataPointer() const { return is_x32_ ? config32_.CHPEMetadataPointer : config64_.CHPEMetadataPointer; }
+
+        const LoadConfigTable& GetTable(Tables table) const { return tables_[table]; }
+        static std::string_view GetTableName(Tables table);
+
+        // Dynamic value relocation table (DVRT), found through its section and offset or through its VA
+        offset_t GetDynamicRelocTableOffset() const { return dynamic_reloc_table_offset_; }
+        DWORD GetDynamicRelocVersion() const { return dynamic_reloc_version_; }
+        const std::pmr::vector<DynamicRelocation>& GetDynamicRelocations() const { return dynamic_relocs_; }
+        bool IsDynamicRelocTableValid() const { return is_dynamic_reloc_table_valid_; }
+
+        // Version is the first DWORD of IMAGE_CHPE_METADATA_X86 and IMAGE_ARM64EC_METADATA alike
+        offset_t GetChpeMetadataOffset() const { return chpe_metadata_offset_; }
+        DWORD GetChpeVersion() const { return chpe_version_; }
+
+        bool IsValidWrapper() const;
+
+        offset_t GetLoadConfigDirOffset() const { return load_config_dir_offset_; }
+    private:
+        void Init();
+        void ResolveTable(Tables table, ULONGLONG va, ULONGLONG count, size_t stride);
+        void ResolveTables();
+        void ResolveChpeMetadata();
+        void ParseDynamicRelocs();
+    private:
+        const BYTE* load_config_dir_;
+        offset_t load_config_dir_offset_;
+        bool is_x32_;
+
+        DWORD declared_size_;
+        size_t config_size_;
+        bool is_truncated_;
+        IMAGE_LOAD_CONFIG_DIRECTORY32 config32_;
+        IMAGE_LOAD_CONFIG_DIRECTORY64 config64_;
+
+        std::array<LoadConfigTable, TABLES_COUNT> tables_;
+
+        offset_t dynamic_reloc_table_offset_;
+        DWORD dynamic_reloc_version_;
+        bool is_dynamic_reloc_table_valid_;
+        std::pmr::vector<DynamicRelocation> dynamic_relocs_;
+
+        offset_t chpe_metadata_offset_;
+        DWORD chpe_version_;
+
+        PEFile* related_pe_;
+    };
+
+}
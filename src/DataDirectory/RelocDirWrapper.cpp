@@ -0,0 +1,247 @@
+#include "RelocDirWrapper.h"
+
+#include <PEFile.h>
+
+#include <cstring>
+#include <algorithm>
+
+namespace PewParser {
+
+    static constexpr DWORD kPageSize = 0x1000;
+
+    RelocDirWrapper::RelocDirWrapper(PEFile* pe)
+        : RelocDirWrapper(pe, GetSimdIsa())
+    {
+    }
+
+    RelocDirWrapper::RelocDirWrapper(PEFile* pe, SimdIsa isa)
+        : related_pe_(pe), root_block_(nullptr), root_block_offset_(0), dir_size_(0), table_(pe->GetMemoryResource())
+    {
+        Init();
+
+        BuildRelocTable(isa);
+    }
+
+    void RelocDirWrapper::Init()
+    {
+        offset_t root_block_rva = related_pe_->GetDataDirectory()[DataDirEntries::BRELOC].VirtualAddress;
+        offset_t root_block_raw = related_pe_->RvaToRaw(root_block_rva);
+
+        if (root_block_raw && (root_block_raw + GetBlockHdrSize()) <= related_pe_->GetRawFileSize())
+        {
+            root_block_ = (IMAGE_BASE_RELOCATION*)related_pe_->GetContentAt(root_block_raw, OffsetType::RAW);
+            root_block_offset_ = root_block_raw;
+        }
+        else if (!root_block_raw && (root_block_rva + GetBlockHdrSize()) <= related_pe_->GetRawFileSize())
+        {
+            root_block_ = (IMAGE_BASE_RELOCATION*)related_pe_->GetContentAt(root_block_rva, OffsetType::RAW);
+            root_block_offset_ = root_block_rva;
+        }
+
+        if (root_block_)
+            dir_size_ = std::min<uintmax_t>(related_pe_->GetDataDirectory()[DataDirEntries::BRELOC].Size, related_pe_->GetRawFileSize() - root_block_offset_);
+    }
+
+    static void DecodeScalar(const BYTE* entries, size_t count, DWORD page_rva, DWORD* rvas, BYTE* types)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            WORD entry;
+            std::memcpy(&entry, entries + i * sizeof(WORD), sizeof(WORD));
+            rvas[i] = page_rva + (entry & 0x0FFF);
+            types[i] = (BYTE)(entry >> 12);
+        }
+    }
+
+#if defined(PEW_SIMD_X64)
+    // 8 entries per step: the offsets are zero extended to DWORDs and rebased on the page, the types packed to bytes
+    static void DecodeSse2(const BYTE* entries, size_t count, DWORD page_rva, DWORD* rvas, BYTE* types)
+    {
+        const __m128i offset_mask = _mm_set1_epi16(0x0FFF);
+        const __m128i page = _mm_set1_epi32((int)page_rva);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i in = _mm_loadu_si128((const __m128i*)(entries + i * sizeof(WORD)));
+            __m128i offsets = _mm_and_si128(in, offset_mask);
+
+            _mm_storeu_si128((__m128i*)(rvas + i), _mm_add_epi32(_mm_unpacklo_epi16(offsets, zero), page));
+            _mm_storeu_si128((__m128i*)(rvas + i + 4), _mm_add_epi32(_mm_unpackhi_epi16(offsets, zero), page));
+
+            __m128i entry_types = _mm_srli_epi16(in, 12);
+            _mm_storel_epi64((__m128i*)(types + i), _mm_packus_epi16(entry_types, entry_types));
+        }
+
+        DecodeScalar(entries + i * sizeof(WORD), count - i, page_rva, rvas + i, types + i);
+    }
+
+    PEW_TARGET_AVX2 static void DecodeAvx2(const BYTE* entries, size_t count, DWORD page_rva, DWORD* rvas, BYTE* types)
+    {
+        const __m256i offset_mask = _mm256_set1_epi16(0x0FFF);
+        const __m256i page = _mm256_set1_epi32((int)page_rva);
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i in = _mm256_loadu_si256((const __m256i*)(entries + i * sizeof(WORD)));
+            __m256i offsets = _mm256_and_si256(in, offset_mask);
+
+            _mm256_storeu_si256((__m256i*)(rvas + i), _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(offsets)), page));
+            _mm256_storeu_si256((__m256i*)(rvas + i + 8), _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(offsets, 1)), page));
+
+            // packus works per 128 bit lane, the permute joins the low halves of both
+            __m256i entry_types = _mm256_srli_epi16(in, 12);
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(entry_types, entry_types), 0xD8);
+            _mm_storeu_si128((__m128i*)(types + i), _mm256_castsi256_si128(packed));
+        }
+
+        DecodeScalar(entries + i * sizeof(WORD), count - i, page_rva, rvas + i, types + i);
+    }
+#endif
+
+    void RelocDirWrapper::DecodeEntries(SimdIsa isa, const BYTE* entries, size_t count, DWORD page_rva, DWORD* rvas, BYTE* types)
+    {
+        switch (isa)
+        {
+#if defined(PEW_SIMD_X64)
+            case SimdIsa::AVX2:    DecodeAvx2(entries, count, page_rva, rvas, types);      break;
+            case SimdIsa::SSE2:    DecodeSse2(entries, count, page_rva, rvas, types);      break;
+#endif
+            default:               DecodeScalar(entries, count, page_rva, rvas, types);    break;
+        }
+    }
+
+    void RelocDirWrapper::BuildRelocTable(SimdIsa isa)
+    {
+        table_.entry_begin.push_back(0);
+
+        if (!root_block_)
+            return;
+
+        const BYTE* dir = (const BYTE*)root_block_;
+
+        // First pass validates the chain so the entry arrays are sized once
+        size_t entries_count = 0;
+        for (size_t offset = 0; offset < dir_size_; )
+        {
+            if (offset + GetBlockHdrSize() > dir_size_)
+            {
+                table_.is_chain_valid = false;
+                break;
+            }
+
+            IMAGE_BASE_RELOCATION block;
+            std::memcpy(&block, dir + offset, sizeof(block));
+
+            // Some linkers end the chain with an empty block
+            if (!block.VirtualAddress && !block.SizeOfBlock)
+                break;
+
+            if (block.SizeOfBlock < GetBlockHdrSize() || (block.SizeOfBlock % sizeof(WORD)))
+            {
+                table_.is_chain_valid = false;
+                break;
+            }
+
+            size_t block_size = block.SizeOfBlock;
+            if (offset + block_size > dir_size_)
+            {
+                table_.is_chain_valid = false;
+                block_size = dir_size_ - offset;
+            }
+
+            entries_count += (block_size - GetBlockHdrSize()) / sizeof(WORD);
+
+            table_.block_offsets.push_back(root_block_offset_ + offset);
+            table_.page_rvas.push_back(block.VirtualAddress);
+            table_.entry_begin.push_back(entries_count);
+
+            offset += block_size;
+        }
+
+        table_.rvas.resize(entries_count);
+        table_.types.resize(entries_count);
+
+        for (index_t block = 0; block < table_.GetBlocksCount(); block++)
+        {
+            const BYTE* entries = related_pe_->GetContentAt(table_.block_offsets[block] + GetBlockHdrSize(), OffsetType::RAW);
+            index_t first = table_.entry_begin[block];
+
+            DecodeEntries(isa, entries, table_.GetEntriesCount(block), table_.page_rvas[block], table_.rvas.data() + first, table_.types.data() + first);
+        }
+
+        // Nearly every entry has the same type, separate counters keep the increments from waiting on each other
+        size_t counts[4][16] = {};
+        size_t entry = 0;
+        for (; entry + 4 <= entries_count; entry += 4)
+        {
+            counts[0][table_.types[entry]]++;
+            counts[1][table_.types[entry + 1]]++;
+            counts[2][table_.types[entry + 2]]++;
+            counts[3][table_.types[entry + 3]]++;
+        }
+        for (; entry < entries_count; entry++)
+            counts[0][table_.types[entry]]++;
+
+        for (size_t type = 0; type < table_.type_counts.size(); type++)
+            table_.type_counts[type] = counts[0][type] + counts[1][type] + counts[2][type] + counts[3][type];
+
+        // The slot after a HIGHADJ entry holds its high half parameter, not a fixup.
+        // It is marked ABSOLUTE so consumers skip it, the value stays in the raw block.
+        if (table_.type_counts[IMAGE_REL_BASED_HIGHADJ])
+        {
+            for (index_t block = 0; block < table_.GetBlocksCount(); block++)
+            {
+                for (index_t entry = table_.entry_begin[block]; entry + 1 < table_.entry_begin[block + 1]; entry++)
+                {
+                    if (table_.types[entry] != IMAGE_REL_BASED_HIGHADJ)
+                        continue;
+
+                    entry++;
+                    table_.type_counts[table_.types[entry]]--;
+                    table_.type_counts[IMAGE_REL_BASED_ABSOLUTE]++;
+                    table_.types[entry] = IMAGE_REL_BASED_ABSOLUTE;
+                }
+            }
+        }
+    }
+
+    double RelocDirWrapper::GetDensity() const
+    {
+        OptionalHdrWrapper* optional_hdr_wrapper = related_pe_->GetOptionalHdrWrapper();
+
+        DWORD image_size;
+        if (optional_hdr_wrapper->GetOptionalHdrType() == OptHdrType::x32)
+            image_size = ((IMAGE_OPTIONAL_HEADER32*)optional_hdr_wrapper->GetOptionalHdr())->SizeOfImage;
+        else
+            image_size = ((IMAGE_OPTIONAL_HEADER64*)optional_hdr_wrapper->GetOptionalHdr())->SizeOfImage;
+
+        size_t pages_count = ((size_t)image_size + kPageSize - 1) / kPageSize;
+        if (!pages_count)
+            return 0.0;
+
+        return (double)table_.GetFixupsCount() / pages_count;
+    }
+
+    std::string_view RelocDirWrapper::GetTypeName(BYTE type)
+    {
+        // Types above DIR64 are undefined, they keep distinct names so JSON keys stay unique
+        static constexpr std::array<std::string_view, 16> kTypeNames = {
+            "ABSOLUTE", "HIGH", "LOW", "HIGHLOW", "HIGHADJ", "MACHINE_SPECIFIC_5", "RESERVED", "MACHINE_SPECIFIC_7",
+            "MACHINE_SPECIFIC_8", "MACHINE_SPECIFIC_9", "DIR64", "TYPE_11", "TYPE_12", "TYPE_13", "TYPE_14", "TYPE_15"
+        };
+
+        return kTypeNames[type & 0x0F];
+    }
+
+    bool RelocDirWrapper::IsValidWrapper() const
+    {
+        if (root_block_)
+            return true;
+
+        return false;
+    }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <PEFile.h>
+#include <PewTypes.h>
+#include <Simd.h>
+
+#include <array>
+#include <vector>
+#include <string_view>
+#include <memory_resource>
+
+namespace PewParser {
+
+    // Flattened base relocation directory, decoded in bulk when the wrapper is created.
+    // Entries of block i occupy [entry_begin[i], entry_begin[i + 1]) in rvas and types.
+    struct RelocTable
+    {
+        RelocTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : block_offsets(resource), page_rvas(resource), entry_begin(resource), rvas(resource), types(resource)
+        {
+        }
+
+        std::pmr::vector<offset_t> block_offsets;    // raw offset of every IMAGE_BASE_RELOCATION
+        std::pmr::vector<DWORD> page_rvas;
+        std::pmr::vector<index_t> entry_begin;
+
+        std::pmr::vector<DWORD> rvas;                // page rva + 12 bit offset
+        std::pmr::vector<BYTE> types;                // IMAGE_REL_BASED_*
+
+        std::array<size_t, 16> type_counts = {};
+
+        // False when a block is shorter than its header, runs past the directory or leaves trailing bytes
+        bool is_chain_valid = true;
+
+        size_t GetBlocksCount() const { return page_rvas.size(); }
+        size_t GetEntriesCount(index_t block) const { return entry_begin[block + 1] - entry_begin[block]; }
+        size_t GetTotalEntriesCount() const { return rvas.size(); }
+        // Entries the loader applies, IMAGE_REL_BASED_ABSOLUTE padding is not counted
+        size_t GetFixupsCount() const { return rvas.size() - type_counts[IMAGE_REL_BASED_ABSOLUTE]; }
+    };
+
+    class RelocDirWrapper
+    {
+    public:
+        RelocDirWrapper(PEFile* pe);
+        // Decodes with the given implementation instead of the widest one, for the tests
+        RelocDirWrapper(PEFile* pe, SimdIsa isa);
+
+        const RelocTable& GetRelocTable() const { return table_; }
+
+        // Fixups per 4K page of SizeOfImage, packed images tend to have few or none
+        double GetDensity() const;
+
+        static std::string_view GetTypeName(BYTE type);
+
+        bool IsValidWrapper() const;
+
+        IMAGE_BASE_RELOCATION* GetRootBlock() const { return root_block_; }
+        offset_t GetRootBlockOffset() const { return root_block_offset_; }
+        size_t GetBlockHdrSize() const { return sizeof(IMAGE_BASE_RELOCATION); }
+        size_t GetDirSize() const { return dir_size_; }
+
+        // Decodes count TypeOffset WORDs into rvas / types, exposed for the benchmarks
+        static void DecodeEntries(SimdIsa isa, const BYTE* entries, size_t count, DWORD page_rva, DWORD* rvas, BYTE* types);
+    private:
+        void Init();
+        void BuildRelocTable(SimdIsa isa);
+    private:
+        IMAGE_BASE_RELOCATION* root_block_;
+        offset_t root_block_offset_;
+        size_t dir_size_;
+
+        RelocTable table_;
+
+        PEFile* related_pe_;
+    };
+
+}
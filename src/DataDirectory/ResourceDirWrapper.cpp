@@ -2,38 +2,49 @@
 
 #include <PEUtils.h>
 
-#if defined(__linux__)
-#include <iconv.h>
-#elif defined(_WIN32)
-#include <Windows.h>
-#endif
+#include <map>
+#include <iterator>
+#include <algorithm>
 
 namespace PewParser {
 
-    std::string Utf16ToUtf8(WCHAR* src, int len)
+    // Byte ranges (header and entry array) of the expanded directories, kept disjoint so the expanded entries
+    // of the whole tree never add up to more than the bytes they are read from
+    class DirRangeSet
     {
-#if defined(__linux__)
-        size_t src_len = len * sizeof(WCHAR);
-        size_t dst_len = 256;
-        char dst[dst_len] = {0};
+    public:
+        enum class InsertResult
+        {
+            INSERTED = 0,
+            REPEATED,       // a directory at the same offset was already expanded
+            OVERLAPPING     // the range shares bytes with an expanded directory at another offset
+        };
+    public:
+        DirRangeSet(std::pmr::memory_resource* resource)
+            : ranges_(resource)
+        {
+        }
 
-        char* pIn = (char*)src;
-        char* pOut = dst;
+        InsertResult Insert(offset_t begin, offset_t end)
+        {
+            auto next = ranges_.lower_bound(begin);
+            if (next != ranges_.end() && next->first == begin)
+                return InsertResult::REPEATED;
 
-        iconv_t conv = iconv_open("UTF-8", "UTF-16");
-        iconv(conv, &pIn, &src_len, &pOut, &dst_len);
-        iconv_close(conv);
-#elif defined(_WIN32)
-        if (!src) return std::string();
-        int size_needed = WideCharToMultiByte(CP_UTF8, 0, src, len, NULL, 0, NULL, NULL);
-        std::string dst(size_needed, 0);
-        WideCharToMultiByte(CP_UTF8, 0, src, len, &dst[0], size_needed, NULL, NULL);
-#endif
-        return dst;
-    }
+            if ((next != ranges_.end() && next->first < end) || (next != ranges_.begin() && std::prev(next)->second > begin))
+                return InsertResult::OVERLAPPING;
+
+            ranges_.emplace_hint(next, begin, end);
+            return InsertResult::INSERTED;
+        }
+    private:
+        std::pmr::map<offset_t, offset_t> ranges_;
+    };
 
     ResourceDirWrapper::ResourceDirWrapper(PEFile* pe)
-        : related_pe_(pe), root_rsrc_dir_(nullptr), current_rsrc_dir_(nullptr), root_rsrc_dir_offset_(0), current_entry_(0), current_tree_level_(0)
+        : related_pe_(pe), root_rsrc_dir_(nullptr), current_rsrc_dir_(nullptr), root_rsrc_dir_offset_(0), current_entry_(0), current_tree_level_(0),
+        tree_(pe->GetMemoryResource()), tree_built_(false), payloads_(pe->GetMemoryResource()), payloads_built_(false),
+        version_info_(pe->GetMemoryResource()), version_info_built_(false), has_version_info_(false)
     {
         Init();
 
@@ -47,13 +58,13 @@ namespace PewParser {
         offset_t resource_dir_rva = related_pe_->GetDataDirectory()[DataDirEntries::RSRC].VirtualAddress;
         offset_t resource_dir_raw = related_pe_->RvaToRaw(resource_dir_rva);
 
-        if (resource_dir_raw)
+        if (resource_dir_raw && (resource_dir_raw + GetRsrcDirSize()) <= related_pe_->GetRawFileSize())
         {
             root_rsrc_dir_ = (IMAGE_RESOURCE_DIRECTORY*)related_pe_->GetContentAt(resource_dir_raw, OffsetType::RAW);
             current_rsrc_dir_ = root_rsrc_dir_;
             root_rsrc_dir_offset_ = resource_dir_raw;
         }
-        else if ((resource_dir_rva + GetRsrcDirSize()) <= related_pe_->GetRawFileSize())
+        else if (!resource_dir_raw && (resource_dir_rva + GetRsrcDirSize()) <= related_pe_->GetRawFileSize())
         {
             root_rsrc_dir_ = (IMAGE_RESOURCE_DIRECTORY*)related_pe_->GetContentAt(resource_dir_rva, OffsetType::RAW);
             current_rsrc_dir_ = root_rsrc_dir_;
@@ -75,7 +86,7 @@ namespace PewParser {
         }
     }
 
-    BYTE* ResourceDirWrapper::GetFieldValue() const
+    const BYTE* ResourceDirWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
@@ -132,9 +143,14 @@ namespace PewParser {
     {
         IMAGE_RESOURCE_DIRECTORY_ENTRY* entry = (IMAGE_RESOURCE_DIRECTORY_ENTRY*)((BYTE*)(current_rsrc_dir_) + GetRsrcDirSize() + (sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY) * current_entry_));
 
-        IMAGE_RESOURCE_DIR_STRING_U* str_u = (IMAGE_RESOURCE_DIR_STRING_U*)related_pe_->GetContentAt(root_rsrc_dir_offset_ + entry->NameOffset, OffsetType::RAW);
+        offset_t name_offset = root_rsrc_dir_offset_ + entry->NameOffset;
+        if (name_offset + sizeof(WORD) > related_pe_->GetRawFileSize())
+            return std::string();
+
+        IMAGE_RESOURCE_DIR_STRING_U* str_u = (IMAGE_RESOURCE_DIR_STRING_U*)related_pe_->GetContentAt(name_offset, OffsetType::RAW);
+        size_t max_length = (related_pe_->GetRawFileSize() - name_offset - sizeof(WORD)) / sizeof(WCHAR);
 
-        std::string name = Utf16ToUtf8(str_u->NameString, str_u->Length);
+        std::string name = Utf16ToUtf8(str_u->NameString, (int)std::min<size_t>(str_u->Length, max_length));
 
         return name;
     }
@@ -144,7 +160,12 @@ namespace PewParser {
     {
         IMAGE_RESOURCE_DIRECTORY_ENTRY* entry = (IMAGE_RESOURCE_DIRECTORY_ENTRY*)((BYTE*)(current_rsrc_dir_) + GetRsrcDirSize() + (sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY) * current_entry_));
 
-        switch (entry->Id)
+        return GetTypeName(entry->Id);
+    }
+
+    std::string_view ResourceDirWrapper::GetTypeName(WORD id)
+    {
+        switch (id)
         {
             case RT::CURSOR:          return "Cursor";
             case RT::BITMAP:          return "Bitmap";
@@ -212,7 +233,13 @@ namespace PewParser {
 
         size_t count = current_rsrc_dir_->NumberOfNamedEntries + current_rsrc_dir_->NumberOfIdEntries;
 
-        return count;
+        // Only the entries that fit in the file
+        offset_t entries_offset = root_rsrc_dir_offset_ + ((BYTE*)current_rsrc_dir_ - (BYTE*)root_rsrc_dir_) + GetRsrcDirSize();
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        if (entries_offset >= file_size)
+            return 0;
+
+        return std::min<uintmax_t>(count, (file_size - entries_offset) / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
     }
 
     size_t ResourceDirWrapper::GetEntriesCount(index_t entry_index) const
@@ -236,6 +263,295 @@ namespace PewParser {
         return rsrc_dir;
     }
 
+    const RsrcTree& ResourceDirWrapper::GetRsrcTree()
+    {
+        if (!tree_built_)
+        {
+            BuildRsrcTree();
+            tree_built_ = true;
+        }
+
+        return tree_;
+    }
+
+    void ResourceDirWrapper::BuildRsrcTree()
+    {
+        tree_.nodes.clear();
+        tree_.root_entries_count = 0;
+        tree_.revisits_count = 0;
+        tree_.overlaps_count = 0;
+        tree_.truncated_count = 0;
+
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+
+        if (!root_rsrc_dir_ || root_rsrc_dir_offset_ + GetRsrcDirSize() > file_size)
+            return;
+
+        // Directories are expanded only when their bytes do not overlap an already expanded one, so cycles, shared subtrees
+        // and headers packed a few bytes apart over one entry array are all expanded once. On top of that the node count
+        // is capped by the size of the directory, every entry takes sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY) bytes of it.
+        DirRangeSet expanded_dirs(related_pe_->GetMemoryResource());
+
+        uintmax_t rsrc_size = related_pe_->GetDataDirectory()[DataDirEntries::RSRC].Size;
+        if (!rsrc_size || rsrc_size > file_size - root_rsrc_dir_offset_)
+            rsrc_size = file_size - root_rsrc_dir_offset_;
+        size_t max_nodes = (size_t)(rsrc_size / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+
+        // Entries of the directory at dir_offset that fit in the file
+        auto get_entries_count = [&](offset_t dir_offset) {
+            const IMAGE_RESOURCE_DIRECTORY* dir = (const IMAGE_RESOURCE_DIRECTORY*)related_pe_->GetContentAt(dir_offset, OffsetType::RAW);
+            offset_t entries_offset = dir_offset + GetRsrcDirSize();
+
+            size_t entries_count = (size_t)dir->NumberOfNamedEntries + dir->NumberOfIdEntries;
+            return (size_t)std::min<uintmax_t>(entries_count, (file_size - entries_offset) / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+        };
+
+        // Appends the first entries_count entries of the directory at dir_offset
+        auto append_entries = [&](offset_t dir_offset, size_t entries_count, DWORD parent, WORD level) {
+            const IMAGE_RESOURCE_DIRECTORY* dir = (const IMAGE_RESOURCE_DIRECTORY*)related_pe_->GetContentAt(dir_offset, OffsetType::RAW);
+            offset_t entries_offset = dir_offset + GetRsrcDirSize();
+
+            const IMAGE_RESOURCE_DIRECTORY_ENTRY* entries = (const IMAGE_RESOURCE_DIRECTORY_ENTRY*)(dir + 1);
+            for (index_t i = 0; i < entries_count; i++)
+            {
+                const IMAGE_RESOURCE_DIRECTORY_ENTRY& entry = entries[i];
+
+                RsrcNode node = {};
+                node.parent = parent;
+                node.level = level;
+                node.index = (WORD)i;
+                node.name = entry.Name;
+                node.offset_to_data = entry.OffsetToData;
+                node.entry_offset = entries_offset + i * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY);
+                node.is_directory = entry.DataIsDirectory;
+
+                if (entry.NameIsString && root_rsrc_dir_offset_ + entry.NameOffset + sizeof(WORD) <= file_size)
+                    node.name_offset = root_rsrc_dir_offset_ + entry.NameOffset;
+
+                size_t target_size = node.is_directory ? GetRsrcDirSize() : sizeof(IMAGE_RESOURCE_DATA_ENTRY);
+                if (root_rsrc_dir_offset_ + entry.OffsetToDirectory + target_size <= file_size)
+                    node.data_offset = root_rsrc_dir_offset_ + entry.OffsetToDirectory;
+
+                tree_.nodes.push_back(node);
+            }
+        };
+
+        auto get_dir_end = [&](offset_t dir_offset, size_t entries_count) {
+            return dir_offset + GetRsrcDirSize() + entries_count * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY);
+        };
+
+        size_t root_entries_count = std::min(get_entries_count(root_rsrc_dir_offset_), max_nodes);
+        expanded_dirs.Insert(root_rsrc_dir_offset_, get_dir_end(root_rsrc_dir_offset_, root_entries_count));
+        append_entries(root_rsrc_dir_offset_, root_entries_count, RsrcNode::kNoParent, TreeLevel::TYPE);
+        tree_.root_entries_count = root_entries_count;
+
+        // Breadth first, the node array itself is the work queue
+        for (index_t current = 0; current < tree_.nodes.size(); current++)
+        {
+            offset_t dir_offset = tree_.nodes[current].data_offset;
+            if (!tree_.nodes[current].is_directory || !dir_offset)
+                continue;
+
+            // Distinct directories chained one below the other would otherwise nest as deep as the section allows
+            if (tree_.nodes[current].level >= RsrcTree::kMaxLevel || tree_.nodes.size() == max_nodes)
+            {
+                tree_.nodes[current].is_truncated = true;
+                tree_.truncated_count++;
+                continue;
+            }
+
+            size_t entries_count = get_entries_count(dir_offset);
+            DirRangeSet::InsertResult inserted = expanded_dirs.Insert(dir_offset, get_dir_end(dir_offset, entries_count));
+            if (inserted == DirRangeSet::InsertResult::REPEATED)
+            {
+                tree_.nodes[current].is_revisit = true;
+                tree_.revisits_count++;
+                continue;
+            }
+            else if (inserted == DirRangeSet::InsertResult::OVERLAPPING)
+            {
+                tree_.nodes[current].is_overlapping = true;
+                tree_.overlaps_count++;
+                continue;
+            }
+
+            // Only the entries left in the budget are appended, the rest of the directory is dropped
+            if (entries_count > max_nodes - tree_.nodes.size())
+            {
+                entries_count = max_nodes - tree_.nodes.size();
+                tree_.nodes[current].is_truncated = true;
+                tree_.truncated_count++;
+            }
+
+            WORD level = tree_.nodes[current].level + 1;
+            tree_.nodes[current].first_child = (DWORD)tree_.nodes.size();
+            tree_.nodes[current].children_count = (DWORD)entries_count;
+            append_entries(dir_offset, entries_count, (DWORD)current, level);
+        }
+    }
+
+    const std::pmr::vector<RsrcPayload>& ResourceDirWrapper::GetPayloads()
+    {
+        if (!payloads_built_)
+        {
+            BuildPayloads();
+            payloads_built_ = true;
+        }
+
+        return payloads_;
+    }
+
+    void ResourceDirWrapper::BuildPayloads()
+    {
+        const RsrcTree& tree = GetRsrcTree();
+        payloads_.clear();
+
+        for (index_t current = 0; current < tree.nodes.size(); current++)
+        {
+            const RsrcNode& node = tree.nodes[current];
+            if (node.is_directory || !node.data_offset)
+                continue;
+
+            RsrcPayload payload = {};
+            payload.node = (DWORD)current;
+            payload.type_node = payload.name_node = payload.lang_node = RsrcNode::kNoParent;
+            ResolvePayload(node.data_offset, payload);
+
+            // Levels only grow going down, the walk up stops at the entries of the root directory
+            for (DWORD ancestor = (DWORD)current; ancestor != RsrcNode::kNoParent; ancestor = tree.nodes[ancestor].parent)
+            {
+                WORD level = tree.nodes[ancestor].level;
+                if (level == TreeLevel::TYPE)
+                    payload.type_node = ancestor;
+                else if (level == TreeLevel::ID)
+                    payload.name_node = ancestor;
+                else if (level == TreeLevel::LANGUAGE)
+                    payload.lang_node = ancestor;
+            }
+
+            payloads_.push_back(payload);
+        }
+    }
+
+    void ResourceDirWrapper::ResolvePayload(offset_t data_entry_offset, RsrcPayload& payload) const
+    {
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        const BYTE* buffer = related_pe_->GetRawFile().Buffer();
+
+        const IMAGE_RESOURCE_DATA_ENTRY* data_entry = (const IMAGE_RESOURCE_DATA_ENTRY*)(buffer + data_entry_offset);
+        payload.rva = data_entry->OffsetToData;
+        payload.size = data_entry->Size;
+        payload.code_page = data_entry->CodePage;
+
+        offset_t raw = related_pe_->RvaToRaw(payload.rva);
+        if (raw && raw < file_size)
+        {
+            payload.raw = raw;
+            payload.data = ByteSpan(buffer + raw, (size_t)std::min<uintmax_t>(payload.size, file_size - raw));
+        }
+    }
+
+    bool ResourceDirWrapper::FindPayload(WORD type, RsrcPayload& payload)
+    {
+        payload = {};
+        payload.node = payload.type_node = payload.name_node = payload.lang_node = RsrcNode::kNoParent;
+
+        if (payloads_built_)
+        {
+            for (const RsrcPayload& candidate : payloads_)
+            {
+                if (candidate.type_node != RsrcNode::kNoParent && !tree_.nodes[candidate.type_node].IsString() && tree_.nodes[candidate.type_node].GetId() == type)
+                {
+                    payload = candidate;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Straight down the type entry and then the first entry of every level, without building the tree.
+        // The depth cap stands in for cycle detection.
+        constexpr uint32_t kMaxLevel = 16;
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        offset_t dir_offset = root_rsrc_dir_offset_;
+
+        for (uint32_t level = TreeLevel::TYPE; root_rsrc_dir_ && level <= kMaxLevel; level++)
+        {
+            if (dir_offset + GetRsrcDirSize() > file_size)
+                return false;
+
+            const IMAGE_RESOURCE_DIRECTORY* dir = (const IMAGE_RESOURCE_DIRECTORY*)related_pe_->GetContentAt(dir_offset, OffsetType::RAW);
+            offset_t entries_offset = dir_offset + GetRsrcDirSize();
+            size_t entries_count = (size_t)dir->NumberOfNamedEntries + dir->NumberOfIdEntries;
+            entries_count = std::min<uintmax_t>(entries_count, (file_size - entries_offset) / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+
+            const IMAGE_RESOURCE_DIRECTORY_ENTRY* entries = (const IMAGE_RESOURCE_DIRECTORY_ENTRY*)(dir + 1);
+            const IMAGE_RESOURCE_DIRECTORY_ENTRY* entry = nullptr;
+            for (index_t i = 0; i < entries_count && !entry; i++)
+            {
+                if (level != TreeLevel::TYPE || (!entries[i].NameIsString && entries[i].Id == type))
+                    entry = &entries[i];
+            }
+
+            if (!entry)
+                return false;
+
+            offset_t target_offset = root_rsrc_dir_offset_ + entry->OffsetToDirectory;
+            if (entry->DataIsDirectory)
+            {
+                dir_offset = target_offset;
+                continue;
+            }
+
+            if (target_offset + sizeof(IMAGE_RESOURCE_DATA_ENTRY) > file_size)
+                return false;
+
+            ResolvePayload(target_offset, payload);
+            return true;
+        }
+
+        return false;
+    }
+
+    const VersionInfo* ResourceDirWrapper::GetVersionInfo()
+    {
+        if (!version_info_built_)
+        {
+            version_info_built_ = true;
+
+            RsrcPayload payload;
+            if (FindPayload(RT::VERSION, payload) && !payload.data.empty())
+            {
+                has_version_info_ = VersionInfoParser::Parse(payload.data, version_info_);
+                version_info_.raw = payload.raw;
+            }
+        }
+
+        return has_version_info_ ? &version_info_ : nullptr;
+    }
+
+    std::string ResourceDirWrapper::GetNodeName(const RsrcNode& node) const
+    {
+        std::string name;
+        GetNodeName(node, name);
+
+        return name;
+    }
+
+    void ResourceDirWrapper::GetNodeName(const RsrcNode& node, std::string& name) const
+    {
+        name.clear();
+
+        if (!node.name_offset)
+            return;
+
+        const IMAGE_RESOURCE_DIR_STRING_U* str_u = (const IMAGE_RESOURCE_DIR_STRING_U*)related_pe_->GetContentAt(node.name_offset, OffsetType::RAW);
+        size_t max_length = (related_pe_->GetRawFileSize() - node.name_offset - sizeof(WORD)) / sizeof(WCHAR);
+
+        AppendUtf16ToUtf8(str_u->NameString, std::min<size_t>(str_u->Length, max_length), name);
+    }
+
     bool ResourceDirWrapper::IsValidWrapper() const
     {
         if (root_rsrc_dir_)
@@ -1,9 +1,78 @@
 #pragma once
 #include <PEFile.h>
 #include <PewTypes.h>
+#include <Utf16.h>
+
+#include "VersionInfo.h"
+
+#include <vector>
+#include <memory_resource>
 
 namespace PewParser {
 
+    // One IMAGE_RESOURCE_DIRECTORY_ENTRY of the flattened resource tree.
+    // The entries of a directory are contiguous, a directory node owns nodes[first_child, first_child + children_count).
+    struct RsrcNode
+    {
+        static constexpr DWORD kNoParent = 0xFFFFFFFF;
+
+        DWORD parent;              // kNoParent for the entries of the root directory
+        DWORD first_child;
+        DWORD children_count;
+        WORD level;                // TreeLevel of the entry, TYPE for the entries of the root directory
+        WORD index;                // position inside its directory
+        DWORD name;                // IMAGE_RESOURCE_DIRECTORY_ENTRY::Name
+        DWORD offset_to_data;      // IMAGE_RESOURCE_DIRECTORY_ENTRY::OffsetToData
+        offset_t entry_offset;     // raw offset of the directory entry
+        offset_t name_offset;      // raw offset of the IMAGE_RESOURCE_DIR_STRING_U, 0 for id entries
+        offset_t data_offset;      // raw offset of the child directory or IMAGE_RESOURCE_DATA_ENTRY, 0 when outside the file
+        bool is_directory;
+        bool is_revisit;           // child directory was already expanded (a cycle or a shared subtree), it has no children here
+        bool is_overlapping;       // child directory shares bytes with an expanded one at another offset, it was not expanded
+        bool is_truncated;         // child directory sits below RsrcTree::kMaxLevel or past the node budget, it was not expanded
+
+        bool IsString() const { return (name & 0x80000000) != 0; }
+        WORD GetId() const { return (WORD)name; }
+    };
+
+    // Whole type / name / language tree built in one iterative pass, in breadth first order so the
+    // entries of the root directory are nodes[0, root_entries_count). Holds at most one node per
+    // IMAGE_RESOURCE_DIRECTORY_ENTRY that fits in the resource directory Size.
+    struct RsrcTree
+    {
+        // Well formed trees stop at the LANGUAGE level (3), deeper directories are left unexpanded
+        static constexpr WORD kMaxLevel = 8;
+
+        RsrcTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : nodes(resource)
+        {
+        }
+
+        std::pmr::vector<RsrcNode> nodes;
+        size_t root_entries_count = 0;
+        size_t revisits_count = 0;
+        size_t overlaps_count = 0;
+        size_t truncated_count = 0;
+
+        size_t GetNodesCount() const { return nodes.size(); }
+    };
+
+    // IMAGE_RESOURCE_DATA_ENTRY of one leaf of the tree, resolved to the payload bytes in the loaded image
+    struct RsrcPayload
+    {
+        DWORD node;                // leaf in RsrcTree::nodes
+        DWORD type_node;           // ancestors at the TYPE / ID / LANGUAGE levels, kNoParent when the leaf sits above that level
+        DWORD name_node;
+        DWORD lang_node;
+        DWORD rva;                 // IMAGE_RESOURCE_DATA_ENTRY::OffsetToData
+        DWORD size;                // IMAGE_RESOURCE_DATA_ENTRY::Size
+        DWORD code_page;
+        offset_t raw;              // 0 when the rva is not backed by the file
+        ByteSpan data;             // no copy, clamped to the end of the file so it can be shorter than size
+
+        bool IsTruncated() const { return data.size() < size; }
+    };
+
     class ResourceDirWrapper
     {
     public:
@@ -54,7 +123,7 @@ namespace PewParser {
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         std::string GetFieldDescription() const;
         FieldType GetFieldType() const { return field_type_; }
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
@@ -69,6 +138,7 @@ namespace PewParser {
 
         std::string GetName() const;
         std::string_view GetType() const;
+        static std::string_view GetTypeName(WORD id);
         DWORD GetNameValue() const;
         offset_t GetNameOffset() const;
         DWORD GetDataValue() const;
@@ -95,6 +165,18 @@ namespace PewParser {
 
         bool IsValidWrapper() const;
 
+        // Built on first use, the tree stays valid while the PEFile is alive
+        const RsrcTree& GetRsrcTree();
+        std::string GetNodeName(const RsrcNode& node) const;
+        // Into the caller's string so a walk over many names reuses one buffer
+        void GetNodeName(const RsrcNode& node, std::string& name) const;
+
+        // Every leaf of GetRsrcTree in node order, built on first use
+        const std::pmr::vector<RsrcPayload>& GetPayloads();
+
+        // First RT_VERSION payload decoded on first use, nullptr when there is none or it is not a VS_VERSIONINFO
+        const VersionInfo* GetVersionInfo();
+
         IMAGE_RESOURCE_DIRECTORY* GetRootRsrcDir() const { return root_rsrc_dir_; }
         IMAGE_RESOURCE_DIRECTORY* GetCurrentRsrcDir() const { return current_rsrc_dir_; }
         IMAGE_RESOURCE_DIRECTORY* GetEntryRsrcDir(index_t entry_index) const;
@@ -102,6 +184,10 @@ namespace PewParser {
         size_t GetRsrcDirSize() const { return sizeof(IMAGE_RESOURCE_DIRECTORY); }
     private:
         void Init();
+        void BuildRsrcTree();
+        void BuildPayloads();
+        void ResolvePayload(offset_t data_entry_offset, RsrcPayload& payload) const;
+        bool FindPayload(WORD type, RsrcPayload& payload);
     private:
         IMAGE_RESOURCE_DIRECTORY* root_rsrc_dir_;
         IMAGE_RESOURCE_DIRECTORY* current_rsrc_dir_;
@@ -115,6 +201,16 @@ namespace PewParser {
         uint32_t current_tree_level_;
         offset_t selected_data_entry_offset_;
 
+        RsrcTree tree_;
+        bool tree_built_;
+
+        std::pmr::vector<RsrcPayload> payloads_;
+        bool payloads_built_;
+
+        VersionInfo version_info_;
+        bool version_info_built_;
+        bool has_version_info_;
+
         PEFile* related_pe_;
     };
 
@@ -0,0 +1,283 @@
+#include "SecurityDirWrapper.h"
+
+#include <PEFile.h>
+#include <Authenticode.h>
+
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace PewParser {
+
+    // DER element, only definite lengths and single byte tags, which is all Authenticode signers emit
+    struct DerElement
+    {
+        BYTE tag;
+        ByteSpan content;
+    };
+
+    static constexpr BYTE kDerInteger = 0x02;
+    static constexpr BYTE kDerSequence = 0x30;
+    static constexpr BYTE kDerSet = 0x31;
+    static constexpr BYTE kDerOid = 0x06;
+    static constexpr BYTE kDerOctetString = 0x04;
+    static constexpr BYTE kDerExplicit0 = 0xA0;
+
+    static constexpr BYTE kOidSignedData[] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02 };                // 1.2.840.113549.1.7.2
+    static constexpr BYTE kOidSpcIndirectData[] = { 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x01, 0x04 };    // 1.3.6.1.4.1.311.2.1.4
+    static constexpr BYTE kOidSha1[] = { 0x2B, 0x0E, 0x03, 0x02, 0x1A };                                              // 1.3.14.3.2.26
+    static constexpr BYTE kOidSha256[] = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01 };                  // 2.16.840.1.101.3.4.2.1
+
+    // Reads the element at offset and moves offset past it, false when it is not tag or does not fit
+    static bool ReadDer(ByteSpan data, size_t& offset, BYTE tag, DerElement& element)
+    {
+        if (offset + 2 > data.size() || data[offset] != tag)
+            return false;
+
+        size_t length = data[offset + 1];
+        size_t header_size = 2;
+
+        if (length & 0x80)
+        {
+            size_t length_bytes = length & 0x7F;
+            if (!length_bytes || length_bytes > sizeof(DWORD) || offset + 2 + length_bytes > data.size())
+                return false;
+
+            length = 0;
+            for (size_t i = 0; i < length_bytes; i++)
+                length = (length << 8) | data[offset + 2 + i];
+
+            header_size += length_bytes;
+        }
+
+        if (length > data.size() - offset - header_size)
+            return false;
+
+        element.tag = tag;
+        element.content = data.subspan(offset + header_size, length);
+        offset += header_size + length;
+
+        return true;
+    }
+
+    template<size_t N>
+    static bool OidEquals(const DerElement& oid, const BYTE (&expected)[N])
+    {
+        return oid.content.size() == N && std::memcmp(oid.content.data(), expected, N) == 0;
+    }
+
+    SecurityDirWrapper::SecurityDirWrapper(PEFile* pe)
+        : related_pe_(pe), security_dir_(nullptr), security_dir_offset_(0), security_dir_size_(0), is_truncated_(false),
+          certificates_(pe->GetMemoryResource()), digest_check_(DigestCheck::NOT_SIGNED), digest_checked_(false)
+    {
+        Init();
+
+        if (security_dir_)
+            ReadCertificates();
+    }
+
+    void SecurityDirWrapper::Init()
+    {
+        // A file offset, RvaToRaw does not apply
+        IMAGE_DATA_DIRECTORY security_dir = related_pe_->GetDataDirectory()[DataDirEntries::SECU];
+        offset_t security_dir_raw = security_dir.VirtualAddress;
+
+        if ((security_dir_raw + 2 * sizeof(DWORD)) <= related_pe_->GetRawFileSize())
+        {
+            security_dir_ = related_pe_->GetContentAt(security_dir_raw, OffsetType::RAW);
+            security_dir_offset_ = security_dir_raw;
+            security_dir_size_ = (size_t)std::min<uintmax_t>(security_dir.Size, related_pe_->GetRawFileSize() - security_dir_raw);
+            is_truncated_ = (security_dir_size_ < security_dir.Size);
+        }
+    }
+
+    void SecurityDirWrapper::ReadCertificates()
+    {
+        offset_t table_end = security_dir_offset_ + security_dir_size_;
+        const size_t header_size = offsetof(WIN_CERTIFICATE, bCertificate);
+
+        for (offset_t offset = security_dir_offset_; offset + header_size <= table_end && certificates_.size() < kMaxCertificates; )
+        {
+            WIN_CERTIFICATE header;
+            std::memcpy(&header, related_pe_->GetContentAt(offset, OffsetType::RAW), header_size);
+
+            // A length below the header would never move forward
+            if (header.dwLength < header_size)
+                break;
+
+            offset_t data_end = std::min<offset_t>(offset + header.dwLength, table_end);
+
+            Certificate certificate;
+            certificate.offset = offset;
+            certificate.length = header.dwLength;
+            certificate.revision = header.wRevision;
+            certificate.type = header.wCertificateType;
+            certificate.data = ByteSpan(related_pe_->GetContentAt(offset + header_size, OffsetType::RAW), (size_t)(data_end - offset - header_size));
+            certificates_.push_back(certificate);
+
+            offset = (offset + header.dwLength + 7) & ~(offset_t)7;
+        }
+    }
+
+    bool SecurityDirWrapper::GetSignedDigest(const Certificate& certificate, Digest& digest)
+    {
+        digest = Digest();
+
+        if (certificate.type != WIN_CERT_TYPE_PKCS_SIGNED_DATA)
+            return false;
+
+        // ContentInfo { signedData, [0] SignedData { version, digestAlgorithms, contentInfo { SpcIndirectData,
+        // [0] SpcIndirectDataContent { data, DigestInfo { AlgorithmIdentifier { oid, ... }, digest } } } ... } }
+        DerElement content_info, oid, explicit_content, signed_data, element, spc_content, digest_info, algorithm, digest_value;
+
+        size_t offset = 0;
+        if (!ReadDer(certificate.data, offset, kDerSequence, content_info))
+            return false;
+
+        offset = 0;
+        if (!ReadDer(content_info.content, offset, kDerOid, oid) || !OidEquals(oid, kOidSignedData) ||
+            !ReadDer(content_info.content, offset, kDerExplicit0, explicit_content))
+            return false;
+
+        offset = 0;
+        if (!ReadDer(explicit_content.content, offset, kDerSequence, signed_data))
+            return false;
+
+        offset = 0;
+        if (!ReadDer(signed_data.content, offset, kDerInteger, element) ||         // version
+            !ReadDer(signed_data.content, offset, kDerSet, element) ||             // digestAlgorithms
+            !ReadDer(signed_data.content, offset, kDerSequence, content_info))
+            return false;
+
+        offset = 0;
+        if (!ReadDer(content_info.content, offset, kDerOid, oid) || !OidEquals(oid, kOidSpcIndirectData) ||
+            !ReadDer(content_info.content, offset, kDerExplicit0, explicit_content))
+            return false;
+
+        offset = 0;
+        if (!ReadDer(explicit_content.content, offset, kDerSequence, spc_content))
+            return false;
+
+        offset = 0;
+        if (!ReadDer(spc_content.content, offset, kDerSequence, element) ||        // SpcAttributeTypeAndOptionalValue
+            !ReadDer(spc_content.content, offset, kDerSequence, digest_info))
+            return false;
+
+        offset = 0;
+        if (!ReadDer(digest_info.content, offset, kDerSequence, algorithm) ||
+            !ReadDer(digest_info.content, offset, kDerOctetString, digest_value))
+            return false;
+
+        size_t algorithm_offset = 0;
+        if (!ReadDer(algorithm.content, algorithm_offset, kDerOid, oid))
+            return false;
+
+        if (OidEquals(oid, kOidSha1))
+            digest.algorithm = DigestAlgorithm::SHA1;
+        else if (OidEquals(oid, kOidSha256))
+            digest.algorithm = DigestAlgorithm::SHA256;
+        else
+            return true;
+
+        if (digest_value.content.size() != GetDigestSize(digest.algorithm))
+        {
+            digest = Digest();
+            return false;
+        }
+
+        digest.size = digest_value.content.size();
+        std::memcpy(digest.bytes, digest_value.content.data(), digest.size);
+
+        return true;
+    }
+
+    SecurityDirWrapper::DigestCheck SecurityDirWrapper::CheckImageDigest() const
+    {
+        if (!digest_checked_)
+        {
+            digest_check_ = ComputeDigestCheck();
+            digest_checked_ = true;
+        }
+
+        return digest_check_;
+    }
+
+    SecurityDirWrapper::DigestCheck SecurityDirWrapper::ComputeDigestCheck() const
+    {
+        Digest signed_digests[2];
+        size_t signed_count = 0;
+        bool has_unsupported = false;
+
+        for (const Certificate& certificate : certificates_)
+        {
+            Digest digest;
+            if (!GetSignedDigest(certificate, digest))
+                continue;
+
+            if (digest.algorithm == DigestAlgorithm::UNKNOWN)
+                has_unsupported = true;
+            else if (signed_count < 2)
+                signed_digests[signed_count++] = digest;
+        }
+
+        if (!signed_count)
+            return has_unsupported ? DigestCheck::UNSUPPORTED : DigestCheck::NOT_SIGNED;
+
+        Digest image_digests[2];
+        for (size_t i = 0; i < signed_count; i++)
+            image_digests[i].algorithm = signed_digests[i].algorithm;
+
+        AuthenticodeHasher(related_pe_).Compute(image_digests, signed_count);
+
+        for (size_t i = 0; i < signed_count; i++)
+        {
+            if (image_digests[i] != signed_digests[i])
+                return DigestCheck::MISMATCH;
+        }
+
+        return DigestCheck::MATCH;
+    }
+
+    std::string_view SecurityDirWrapper::GetDigestCheckName(DigestCheck check)
+    {
+        switch (check)
+        {
+            case DigestCheck::NOT_SIGNED:     return "not-signed";
+            case DigestCheck::MATCH:          return "match";
+            case DigestCheck::MISMATCH:       return "mismatch";
+            case DigestCheck::UNSUPPORTED:    return "unsupported";
+            default:                          return "unknown";
+        }
+    }
+
+    std::string_view SecurityDirWrapper::GetRevisionName(WORD revision)
+    {
+        switch (revision)
+        {
+            case WIN_CERT_REVISION_1_0:    return "1.0";
+            case WIN_CERT_REVISION_2_0:    return "2.0";
+            default:                       return "UnKnown";
+        }
+    }
+
+    std::string_view SecurityDirWrapper::GetTypeName(WORD type)
+    {
+        switch (type)
+        {
+            case WIN_CERT_TYPE_X509:                return "X.509";
+            case WIN_CERT_TYPE_PKCS_SIGNED_DATA:    return "PKCS SignedData";
+            case WIN_CERT_TYPE_RESERVED_1:          return "Reserved";
+            case WIN_CERT_TYPE_TS_STACK_SIGNED:     return "TS Stack Signed";
+            default:                                return "UnKnown";
+        }
+    }
+
+    bool SecurityDirWrapper::IsValidWrapper() const
+    {
+        if (security_dir_)
+            return true;
+
+        return false;
+    }
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <PEFile.h>
+#include <PewTypes.h>
+
+#include <Hash/Digest.h>
+
+#include <vector>
+#include <string_view>
+#include <memory_resource>
+
+namespace PewParser {
+
+    // Attribute certificate table. Unlike every other directory its VirtualAddress is a file offset,
+    // the table is not mapped into the image. Entries are WIN_CERTIFICATE headers aligned to 8 bytes.
+    class SecurityDirWrapper
+    {
+    public:
+        static constexpr size_t kMaxCertificates = 0x1000;
+
+        struct Certificate
+        {
+            offset_t offset;      // of the WIN_CERTIFICATE header
+            DWORD length;         // dwLength, header included
+            WORD revision;
+            WORD type;
+            ByteSpan data;        // bCertificate, clamped to the table
+        };
+
+        enum class DigestCheck
+        {
+            NOT_SIGNED = 0,       // no PKCS SignedData certificate with a readable digest
+            MATCH,
+            MISMATCH,
+            UNSUPPORTED           // signed with an algorithm AuthenticodeHasher does not implement
+        };
+    public:
+        SecurityDirWrapper(PEFile* pe);
+
+        const std::pmr::vector<Certificate>& GetCertificates() const { return certificates_; }
+        size_t GetCertificatesCount() const { return certificates_.size(); }
+
+        // Image digest stored in a PKCS SignedData certificate (SpcIndirectDataContent), false when it has none.
+        // Algorithms other than SHA-1 / SHA-256 come back as UNKNOWN with an empty digest.
+        static bool GetSignedDigest(const Certificate& certificate, Digest& digest);
+
+        // Hashes the image for every signed digest and compares them on first use, the cost is a full read of the file.
+        // Later calls return the stored result.
+        DigestCheck CheckImageDigest() const;
+        static std::string_view GetDigestCheckName(DigestCheck check);
+
+        static std::string_view GetRevisionName(WORD revision);
+        static std::string_view GetTypeName(WORD type);
+
+        bool IsValidWrapper() const;
+
+        offset_t GetSecurityDirOffset() const { return security_dir_offset_; }
+        size_t GetSecurityDirSize() const { return security_dir_size_; }
+        // true when Size runs past the end of the file
+        bool IsTruncated() const { return is_truncated_; }
+    private:
+        void Init();
+        void ReadCertificates();
+        DigestCheck ComputeDigestCheck() const;
+    private:
+        const BYTE* security_dir_;
+        offset_t security_dir_offset_;
+        size_t security_dir_size_;
+        bool is_truncated_;
+
+        std::pmr::vector<Certificate> certificates_;
+
+        mutable DigestCheck digest_check_;
+        mutable bool digest_checked_;
+
+        PEFile* related_pe_;
+    };
+
+}
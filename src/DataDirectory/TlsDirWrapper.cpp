@@ -0,0 +1,137 @@
+#include "TlsDirWrapper.h"
+
+#include <PEFile.h>
+
+#include <cstring>
+#include <algorithm>
+
+namespace PewParser {
+
+    TlsDirWrapper::TlsDirWrapper(PEFile* pe)
+        : related_pe_(pe), tls_dir_(nullptr), tls_dir_offset_(0), is_x32_(pe->GetPEType() == PEType::x32PE),
+          callbacks_(pe->GetMemoryResource()), callbacks_offset_(0), is_callbacks_terminated_(false),
+          raw_data_offset_(0), raw_data_size_(0), is_raw_data_truncated_(false)
+    {
+        Init();
+
+        if (tls_dir_)
+        {
+            ReadCallbacks();
+            ResolveRawData();
+        }
+    }
+
+    void TlsDirWrapper::Init()
+    {
+        offset_t tls_dir_rva = related_pe_->GetDataDirectory()[DataDirEntries::TLS].VirtualAddress;
+        offset_t tls_dir_raw = related_pe_->RvaToRaw(tls_dir_rva);
+
+        if (tls_dir_raw && (tls_dir_raw + GetTlsDirSize()) <= related_pe_->GetRawFileSize())
+        {
+            tls_dir_ = related_pe_->GetContentAt(tls_dir_raw, OffsetType::RAW);
+            tls_dir_offset_ = tls_dir_raw;
+        }
+        else if (!tls_dir_raw && (tls_dir_rva + GetTlsDirSize()) <= related_pe_->GetRawFileSize())
+        {
+            tls_dir_ = related_pe_->GetContentAt(tls_dir_rva, OffsetType::RAW);
+            tls_dir_offset_ = tls_dir_rva;
+        }
+    }
+
+    void TlsDirWrapper::ReadCallbacks()
+    {
+        callbacks_offset_ = related_pe_->VaToRaw(GetAddressOfCallBacks());
+        if (!callbacks_offset_ || callbacks_offset_ >= related_pe_->GetRawFileSize())
+        {
+            callbacks_offset_ = 0;
+            return;
+        }
+
+        size_t slot_size = is_x32_ ? sizeof(DWORD) : sizeof(ULONGLONG);
+        size_t slots_count = std::min<uintmax_t>((related_pe_->GetRawFileSize() - callbacks_offset_) / slot_size, kMaxCallbacks);
+        const BYTE* slots = related_pe_->GetContentAt(callbacks_offset_, OffsetType::RAW);
+
+        for (index_t slot = 0; slot < slots_count; slot++)
+        {
+            ULONGLONG callback = 0;
+            std::memcpy(&callback, slots + slot * slot_size, slot_size);
+
+            if (!callback)
+            {
+                is_callbacks_terminated_ = true;
+                break;
+            }
+
+            callbacks_.push_back(callback);
+        }
+    }
+
+    void TlsDirWrapper::ResolveRawData()
+    {
+        ULONGLONG start = GetStartAddressOfRawData();
+        ULONGLONG end = GetEndAddressOfRawData();
+
+        raw_data_offset_ = related_pe_->VaToRaw(start);
+        if (!raw_data_offset_ || raw_data_offset_ >= related_pe_->GetRawFileSize() || end <= start)
+        {
+            raw_data_offset_ = 0;
+            return;
+        }
+
+        uintmax_t available = related_pe_->GetRawFileSize() - raw_data_offset_;
+        raw_data_size_ = (size_t)std::min<uintmax_t>(end - start, available);
+        is_raw_data_truncated_ = (end - start > available);
+    }
+
+    ULONGLONG TlsDirWrapper::GetStartAddressOfRawData() const
+    {
+        return is_x32_ ? ((IMAGE_TLS_DIRECTORY32*)tls_dir_)->StartAddressOfRawData : ((IMAGE_TLS_DIRECTORY64*)tls_dir_)->StartAddressOfRawData;
+    }
+
+    ULONGLONG TlsDirWrapper::GetEndAddressOfRawData() const
+    {
+        return is_x32_ ? ((IMAGE_TLS_DIRECTORY32*)tls_dir_)->EndAddressOfRawData : ((IMAGE_TLS_DIRECTORY64*)tls_dir_)->EndAddressOfRawData;
+    }
+
+    ULONGLONG TlsDirWrapper::GetAddressOfIndex() const
+    {
+        return is_x32_ ? ((IMAGE_TLS_DIRECTORY32*)tls_dir_)->AddressOfIndex : ((IMAGE_TLS_DIRECTORY64*)tls_dir_)->AddressOfIndex;
+    }
+
+    ULONGLONG TlsDirWrapper::GetAddressOfCallBacks() const
+    {
+        return is_x32_ ? ((IMAGE_TLS_DIRECTORY32*)tls_dir_)->AddressOfCallBacks : ((IMAGE_TLS_DIRECTORY64*)tls_dir_)->AddressOfCallBacks;
+    }
+
+    DWORD TlsDirWrapper::GetSizeOfZeroFill() const
+    {
+        return is_x32_ ? ((IMAGE_TLS_DIRECTORY32*)tls_dir_)->SizeOfZeroFill : ((IMAGE_TLS_DIRECTORY64*)tls_dir_)->SizeOfZeroFill;
+    }
+
+    DWORD TlsDirWrapper::GetCharacteristics() const
+    {
+        return is_x32_ ? ((IMAGE_TLS_DIRECTORY32*)tls_dir_)->Characteristics : ((IMAGE_TLS_DIRECTORY64*)tls_dir_)->Characteristics;
+    }
+
+    ByteSpan TlsDirWrapper::GetRawData() const
+    {
+        if (!raw_data_size_)
+            return ByteSpan();
+
+        return ByteSpan(related_pe_->GetContentAt(raw_data_offset_, OffsetType::RAW), raw_data_size_);
+    }
+
+    size_t TlsDirWrapper::GetTlsDirSize() const
+    {
+        return is_x32_ ? sizeof(IMAGE_TLS_DIRECTORY32) : sizeof(IMAGE_TLS_DIRECTORY64);
+    }
+
+    bool TlsDirWrapper::IsValidWrapper() const
+    {
+        if (tls_dir_)
+            return true;
+
+        return false;
+    }
+
+}
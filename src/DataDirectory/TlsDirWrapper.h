@@ -0,0 +1,64 @@
+#pragma once
+#include <PEFile.h>
+#include <PewTypes.h>
+
+#include <vector>
+#include <memory_resource>
+
+namespace PewParser {
+
+    // IMAGE_TLS_DIRECTORY32 / 64 with its VAs resolved to file offsets. Callbacks are read up to the null entry,
+    // the end of the file or kMaxCallbacks, whichever comes first.
+    class TlsDirWrapper
+    {
+    public:
+        static constexpr size_t kMaxCallbacks = 0x10000;
+    public:
+        TlsDirWrapper(PEFile* pe);
+
+        // Directory fields, widened to 64 bits for PE32
+        ULONGLONG GetStartAddressOfRawData() const;
+        ULONGLONG GetEndAddressOfRawData() const;
+        ULONGLONG GetAddressOfIndex() const;
+        ULONGLONG GetAddressOfCallBacks() const;
+        DWORD GetSizeOfZeroFill() const;
+        DWORD GetCharacteristics() const;
+
+        // VAs of the callbacks, as stored in the file
+        const std::pmr::vector<ULONGLONG>& GetCallbacks() const { return callbacks_; }
+        offset_t GetCallbacksOffset() const { return callbacks_offset_; }
+        // false when the array was cut before its null entry
+        bool IsCallbacksTerminated() const { return is_callbacks_terminated_; }
+
+        // Template data [StartAddressOfRawData, EndAddressOfRawData) clamped to the file, empty when it does not resolve
+        ByteSpan GetRawData() const;
+        offset_t GetRawDataOffset() const { return raw_data_offset_; }
+        size_t GetRawDataSize() const { return raw_data_size_; }
+        bool IsRawDataTruncated() const { return is_raw_data_truncated_; }
+
+        bool IsValidWrapper() const;
+
+        const void* GetTlsDir() const { return tls_dir_; }
+        offset_t GetTlsDirOffset() const { return tls_dir_offset_; }
+        size_t GetTlsDirSize() const;
+    private:
+        void Init();
+        void ReadCallbacks();
+        void ResolveRawData();
+    private:
+        const void* tls_dir_;
+        offset_t tls_dir_offset_;
+        bool is_x32_;
+
+        std::pmr::vector<ULONGLONG> callbacks_;
+        offset_t callbacks_offset_;
+        bool is_callbacks_terminated_;
+
+        offset_t raw_data_offset_;
+        size_t raw_data_size_;
+        bool is_raw_data_truncated_;
+
+        PEFile* related_pe_;
+    };
+
+}
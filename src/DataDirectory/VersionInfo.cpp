@@ -0,0 +1,210 @@
+#include "VersionInfo.h"
+
+#include <Utf16.h>
+
+#include <cstring>
+#include <algorithm>
+
+namespace PewParser {
+
+    // Header shared by every block of the resource: wLength, wValueLength, wType, szKey, padding, Value, padding, Children
+    struct VersionBlock
+    {
+        size_t end;                // clamped to the parent block
+        WORD value_length;
+        WORD type;                 // 1 for text values, wValueLength then counts WCHARs
+        const WCHAR* key;
+        size_t key_length;
+        size_t value_begin;
+        size_t children_begin;
+    };
+
+    static size_t Align4(size_t offset)
+    {
+        return (offset + 3) & ~(size_t)3;
+    }
+
+    // Reads the block at offset, false when its header or key does not fit before limit
+    static bool ReadBlock(ByteSpan data, size_t offset, size_t limit, VersionBlock& block)
+    {
+        if (offset + 3 * sizeof(WORD) > limit)
+            return false;
+
+        WORD length;
+        std::memcpy(&length, data.data() + offset, sizeof(WORD));
+        std::memcpy(&block.value_length, data.data() + offset + sizeof(WORD), sizeof(WORD));
+        std::memcpy(&block.type, data.data() + offset + 2 * sizeof(WORD), sizeof(WORD));
+
+        if (length < 3 * sizeof(WORD))
+            return false;
+
+        block.end = std::min<size_t>(offset + length, limit);
+
+        size_t key_begin = offset + 3 * sizeof(WORD);
+        size_t key_end = key_begin;
+        while (key_end + sizeof(WCHAR) <= block.end && (data[key_end] | data[key_end + 1]))
+            key_end += sizeof(WCHAR);
+
+        if (key_end + sizeof(WCHAR) > block.end)
+            return false;
+
+        block.key = (const WCHAR*)(data.data() + key_begin);
+        block.key_length = (key_end - key_begin) / sizeof(WCHAR);
+        block.value_begin = std::min(Align4(key_end + sizeof(WCHAR)), block.end);
+
+        size_t value_size = (block.type == 1) ? block.value_length * sizeof(WCHAR) : block.value_length;
+        block.children_begin = std::min(Align4(block.value_begin + value_size), block.end);
+
+        return true;
+    }
+
+    // Structural keys are plain ASCII, compared without decoding
+    static bool KeyEquals(const VersionBlock& block, std::string_view key)
+    {
+        if (block.key_length != key.size())
+            return false;
+
+        const BYTE* key_bytes = (const BYTE*)block.key;
+        for (size_t i = 0; i < key.size(); i++)
+        {
+            if (key_bytes[i * 2] != (BYTE)key[i] || key_bytes[i * 2 + 1] != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    static uint32_t AppendUtf16(VersionInfo& info, const WCHAR* src, size_t length)
+    {
+        AppendUtf16ToUtf8(src, length, info.text);
+
+        return (uint32_t)info.text.size();
+    }
+
+    // Text value of a String block, stops at the first null since some linkers count wValueLength in bytes
+    static size_t TextValueLength(ByteSpan data, const VersionBlock& block)
+    {
+        size_t max_length = std::min<size_t>(block.value_length, (block.end - block.value_begin) / sizeof(WCHAR));
+
+        size_t length = 0;
+        while (length < max_length && (data[block.value_begin + length * 2] | data[block.value_begin + length * 2 + 1]))
+            length++;
+
+        return length;
+    }
+
+    static void ParseStringFileInfo(ByteSpan data, const VersionBlock& string_file_info, VersionInfo& info)
+    {
+        VersionBlock table_block;
+        for (size_t table_offset = string_file_info.children_begin; ReadBlock(data, table_offset, string_file_info.end, table_block); table_offset = Align4(table_block.end))
+        {
+            VersionInfo::StringTable table = {};
+            table.key_begin = (uint32_t)info.text.size();
+            table.key_end = AppendUtf16(info, table_block.key, table_block.key_length);
+            table.first_string = (uint32_t)info.strings.size();
+
+            VersionBlock string_block;
+            for (size_t string_offset = table_block.children_begin; ReadBlock(data, string_offset, table_block.end, string_block); string_offset = Align4(string_block.end))
+            {
+                VersionInfo::String string = {};
+                string.key_begin = (uint32_t)info.text.size();
+                string.value_begin = AppendUtf16(info, string_block.key, string_block.key_length);
+                string.value_end = AppendUtf16(info, (const WCHAR*)(data.data() + string_block.value_begin), TextValueLength(data, string_block));
+
+                info.strings.push_back(string);
+            }
+
+            table.strings_count = (uint32_t)(info.strings.size() - table.first_string);
+            info.string_tables.push_back(table);
+        }
+    }
+
+    static void ParseVarFileInfo(ByteSpan data, const VersionBlock& var_file_info, VersionInfo& info)
+    {
+        VersionBlock var_block;
+        for (size_t var_offset = var_file_info.children_begin; ReadBlock(data, var_offset, var_file_info.end, var_block); var_offset = Align4(var_block.end))
+        {
+            if (!KeyEquals(var_block, "Translation"))
+                continue;
+
+            size_t value_end = std::min<size_t>(var_block.value_begin + var_block.value_length, var_block.end);
+            for (size_t offset = var_block.value_begin; offset + sizeof(DWORD) <= value_end; offset += sizeof(DWORD))
+            {
+                DWORD translation;
+                std::memcpy(&translation, data.data() + offset, sizeof(DWORD));
+                info.translations.push_back(translation);
+            }
+        }
+    }
+
+    static std::string VersionString(DWORD ms, DWORD ls)
+    {
+        return std::to_string(ms >> 16) + "." + std::to_string(ms & 0xFFFF) + "." + std::to_string(ls >> 16) + "." + std::to_string(ls & 0xFFFF);
+    }
+
+    std::string_view VersionInfo::GetString(std::string_view key) const
+    {
+        for (const String& string : strings)
+        {
+            if (GetKey(string) == key)
+                return GetValue(string);
+        }
+
+        return std::string_view();
+    }
+
+    std::string VersionInfo::GetFileVersion() const
+    {
+        if (!has_fixed_info)
+            return std::string();
+
+        return VersionString(fixed_info.dwFileVersionMS, fixed_info.dwFileVersionLS);
+    }
+
+    std::string VersionInfo::GetProductVersion() const
+    {
+        if (!has_fixed_info)
+            return std::string();
+
+        return VersionString(fixed_info.dwProductVersionMS, fixed_info.dwProductVersionLS);
+    }
+
+    void VersionInfo::Clear()
+    {
+        raw = 0;
+        has_fixed_info = false;
+        fixed_info = {};
+        text.clear();
+        string_tables.clear();
+        strings.clear();
+        translations.clear();
+    }
+
+    bool VersionInfoParser::Parse(ByteSpan data, VersionInfo& info)
+    {
+        info.Clear();
+
+        VersionBlock root;
+        if (!ReadBlock(data, 0, data.size(), root) || !KeyEquals(root, "VS_VERSION_INFO"))
+            return false;
+
+        if (root.value_length >= sizeof(VS_FIXEDFILEINFO) && root.value_begin + sizeof(VS_FIXEDFILEINFO) <= root.end)
+        {
+            std::memcpy(&info.fixed_info, data.data() + root.value_begin, sizeof(VS_FIXEDFILEINFO));
+            info.has_fixed_info = (info.fixed_info.dwSignature == VS_FFI_SIGNATURE);
+        }
+
+        // Every block is at least 6 bytes long, so each loop moves forward until it leaves its parent
+        VersionBlock child;
+        for (size_t offset = root.children_begin; ReadBlock(data, offset, root.end, child); offset = Align4(child.end))
+        {
+            if (KeyEquals(child, "StringFileInfo"))
+                ParseStringFileInfo(data, child, info);
+            else if (KeyEquals(child, "VarFileInfo"))
+                ParseVarFileInfo(data, child, info);
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <PEFormat.h>
+#include <PewTypes.h>
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <memory_resource>
+
+namespace PewParser {
+
+    // Decoded VS_VERSIONINFO resource. Keys and values are converted to UTF-8 once and stored back to back in text,
+    // the tables only hold offsets into it.
+    struct VersionInfo
+    {
+        struct StringTable
+        {
+            uint32_t key_begin;        // language / code page key, e.g. "040904B0"
+            uint32_t key_end;
+            uint32_t first_string;
+            uint32_t strings_count;
+        };
+
+        struct String
+        {
+            uint32_t key_begin;        // key is text[key_begin, value_begin), value is text[value_begin, value_end)
+            uint32_t value_begin;
+            uint32_t value_end;
+        };
+
+        VersionInfo(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : text(resource), string_tables(resource), strings(resource), translations(resource)
+        {
+        }
+
+        offset_t raw = 0;
+        bool has_fixed_info = false;
+        VS_FIXEDFILEINFO fixed_info = {};
+
+        std::pmr::string text;
+        std::pmr::vector<StringTable> string_tables;
+        std::pmr::vector<String> strings;
+        std::pmr::vector<DWORD> translations;    // VarFileInfo\Translation, language in the low word, code page in the high word
+
+        std::string_view GetTableKey(const StringTable& table) const { return std::string_view(text).substr(table.key_begin, table.key_end - table.key_begin); }
+        std::string_view GetKey(const String& string) const { return std::string_view(text).substr(string.key_begin, string.value_begin - string.key_begin); }
+        std::string_view GetValue(const String& string) const { return std::string_view(text).substr(string.value_begin, string.value_end - string.value_begin); }
+
+        // Value from the first string table that has the key, empty when none has it
+        std::string_view GetString(std::string_view key) const;
+
+        // "major.minor.build.revision" from the fixed info, empty without it
+        std::string GetFileVersion() const;
+        std::string GetProductVersion() const;
+
+        void Clear();
+    };
+
+    class VersionInfoParser
+    {
+    public:
+        // data is the whole RT_VERSION payload, false when it does not start with a VS_VERSION_INFO block
+        static bool Parse(ByteSpan data, VersionInfo& info);
+    };
+
+}
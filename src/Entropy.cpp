@@ -0,0 +1,172 @@
+#include "Entropy.h"
+#include "Simd.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+namespace PewParser {
+
+    static constexpr size_t kCountTables = 4;
+    // The tables of a chunk add up to at most the chunk size for any value, so the merge can sum them in 32 bits
+    static constexpr size_t kMaxChunkSize = (size_t)1 << 31;
+    // The running sum of the sliding windows is rebuilt from the counts this often so rounding does not pile up
+    static constexpr size_t kResyncWindows = 1024;
+
+    static void CountChunk(const BYTE* data, size_t size, uint32_t (*tables)[kByteValuesCount])
+    {
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            uint64_t bytes;
+            std::memcpy(&bytes, data + i, sizeof(bytes));
+
+            tables[0][bytes & 0xFF]++;
+            tables[1][(bytes >> 8) & 0xFF]++;
+            tables[2][(bytes >> 16) & 0xFF]++;
+            tables[3][(bytes >> 24) & 0xFF]++;
+            tables[0][(bytes >> 32) & 0xFF]++;
+            tables[1][(bytes >> 40) & 0xFF]++;
+            tables[2][(bytes >> 48) & 0xFF]++;
+            tables[3][bytes >> 56]++;
+        }
+
+        for (; i < size; i++)
+            tables[0][data[i]]++;
+    }
+
+    static void MergeTables(const uint32_t (*tables)[kByteValuesCount], uint64_t* counts)
+    {
+#if defined(PEW_SIMD_X64)
+        const __m128i zero = _mm_setzero_si128();
+        for (size_t value = 0; value < kByteValuesCount; value += 4)
+        {
+            __m128i sum = _mm_loadu_si128((const __m128i*)(tables[0] + value));
+            for (size_t table = 1; table < kCountTables; table++)
+                sum = _mm_add_epi32(sum, _mm_loadu_si128((const __m128i*)(tables[table] + value)));
+
+            __m128i low = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(counts + value)), _mm_unpacklo_epi32(sum, zero));
+            __m128i high = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(counts + value + 2)), _mm_unpackhi_epi32(sum, zero));
+            _mm_storeu_si128((__m128i*)(counts + value), low);
+            _mm_storeu_si128((__m128i*)(counts + value + 2), high);
+        }
+#else
+        for (size_t value = 0; value < kByteValuesCount; value++)
+        {
+            for (size_t table = 0; table < kCountTables; table++)
+                counts[value] += tables[table][value];
+        }
+#endif
+    }
+
+    void CountBytes(const BYTE* data, size_t size, uint64_t* counts)
+    {
+        for (size_t chunk = 0; chunk < size; chunk += kMaxChunkSize)
+        {
+            uint32_t tables[kCountTables][kByteValuesCount] = {};
+            CountChunk(data + chunk, std::min(size - chunk, kMaxChunkSize), tables);
+            MergeTables(tables, counts);
+        }
+    }
+
+    double ComputeEntropy(const uint64_t* counts, uint64_t total)
+    {
+        if (!total)
+            return 0.0;
+
+        // H = log2(n) - sum(c * log2(c)) / n
+        double sum = 0.0;
+        for (size_t value = 0; value < kByteValuesCount; value++)
+        {
+            if (counts[value])
+                sum += (double)counts[value] * std::log2((double)counts[value]);
+        }
+
+        return std::max(0.0, std::log2((double)total) - sum / (double)total);
+    }
+
+    double ComputeEntropy(const BYTE* data, size_t size)
+    {
+        uint64_t counts[kByteValuesCount] = {};
+        CountBytes(data, size, counts);
+
+        return ComputeEntropy(counts, size);
+    }
+
+    size_t GetEntropyWindowsCount(size_t size, size_t window, size_t step)
+    {
+        window = std::min(window, kMaxEntropyWindow);
+        if (!size || !window || !step)
+            return 0;
+
+        if (size <= window)
+            return 1;
+
+        return (size - window) / step + 1;
+    }
+
+    void ComputeWindowedEntropy(const BYTE* data, size_t size, size_t window, size_t step, double* entropies, std::pmr::memory_resource* resource)
+    {
+        window = std::min(window, kMaxEntropyWindow);
+        size_t windows_count = GetEntropyWindowsCount(size, window, step);
+        if (!windows_count)
+            return;
+
+        if (size <= window)
+        {
+            entropies[0] = ComputeEntropy(data, size);
+            return;
+        }
+
+        // c * log2(c) for every count a window can hold, so no window calls log2 per byte value
+        std::pmr::vector<double> count_terms(window + 1, resource);
+        for (size_t count = 2; count <= window; count++)
+            count_terms[count] = (double)count * std::log2((double)count);
+
+        uint64_t counts[kByteValuesCount] = {};
+        auto sum_terms = [&]() {
+            double terms = 0.0;
+            for (size_t value = 0; value < kByteValuesCount; value++)
+                terms += count_terms[counts[value]];
+            return terms;
+        };
+
+        const double log_window = std::log2((double)window);
+
+        CountBytes(data, window, counts);
+        double sum = sum_terms();
+        entropies[0] = std::max(0.0, log_window - sum / (double)window);
+
+        // Each window is reached from the previous one by swapping the bytes only one of them holds, one pair at
+        // a time. Overlapping windows swap step bytes, disjoint ones (step >= window) swap the whole window.
+        const size_t swapped = std::min(step, window);
+
+        for (size_t i = 1; i < windows_count; i++)
+        {
+            const BYTE* leaving = data + (i - 1) * step;
+            const BYTE* entering = (step < window) ? leaving + window : data + i * step;
+
+            for (size_t j = 0; j < swapped; j++)
+            {
+                // Runs of one value swap with themselves, skipping them also skips a dependent increment chain
+                if (leaving[j] == entering[j])
+                    continue;
+
+                uint64_t& old_count = counts[leaving[j]];
+                sum += count_terms[old_count - 1] - count_terms[old_count];
+                old_count--;
+
+                uint64_t& new_count = counts[entering[j]];
+                sum += count_terms[new_count + 1] - count_terms[new_count];
+                new_count++;
+            }
+
+            if (i % kResyncWindows == 0)
+                sum = sum_terms();
+
+            entropies[i] = std::max(0.0, log_window - sum / (double)window);
+        }
+    }
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "PEFormat.h"
+#include "PewTypes.h"
+
+#include <memory_resource>
+
+namespace PewParser {
+
+    static constexpr size_t kByteValuesCount = 256;
+    // Larger windows are clamped, the per window tables grow with the window size
+    static constexpr size_t kMaxEntropyWindow = 1 << 20;
+
+    // Adds the occurrences of every byte value in data to counts. Bytes are spread over several count tables so
+    // runs of the same value do not wait on the increment before them, the tables are merged with vector adds.
+    void CountBytes(const BYTE* data, size_t size, uint64_t* counts);
+
+    // Shannon entropy in bits per byte (0 to 8), 0 for empty input
+    double ComputeEntropy(const uint64_t* counts, uint64_t total);
+    double ComputeEntropy(const BYTE* data, size_t size);
+
+    // Windows of window bytes starting every step bytes, a trailing partial window is dropped and an input shorter
+    // than window is one window. Every window after the first is derived from the previous one instead of recounted.
+    size_t GetEntropyWindowsCount(size_t size, size_t window, size_t step);
+    // The per window table is allocated from resource, the PEFile arena when called for its sections
+    void ComputeWindowedEntropy(const BYTE* data, size_t size, size_t window, size_t step, double* entropies,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+}
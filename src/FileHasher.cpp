@@ -0,0 +1,127 @@
+#include "FileHasher.h"
+
+#include "PEFile.h"
+#include "Hash/MultiDigest.h"
+
+#include <atomic>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+
+namespace PewParser {
+
+    FileHasher::FileHasher(PEFile* pe)
+        : file_(pe->GetRawFile().Buffer(), (size_t)pe->GetRawFileSize()), sections_(pe->GetMemoryResource())
+    {
+        SectionHdrsWrapper* section_hdrs_wrapper = pe->GetSectionHdrsWrapper();
+
+        size_t sections_count = section_hdrs_wrapper->GetNumOfSections();
+        sections_.reserve(sections_count);
+        for (index_t section = 0; section < sections_count; section++)
+            sections_.push_back(section_hdrs_wrapper->GetSectionRawData(section));
+    }
+
+    static void FinalSectionDigest(Sha256& sha256, Digest& digest)
+    {
+        digest.algorithm = DigestAlgorithm::SHA256;
+        digest.size = Sha256::kDigestSize;
+        sha256.Final(digest.bytes);
+    }
+
+    void FileHasher::Compute(Digest* digests, size_t digests_count, Digest* section_digests, size_t threads_count) const
+    {
+        if (section_digests && !sections_.empty() && threads_count > 1 && file_.size() >= kParallelMinSize)
+            ComputeParallel(digests, digests_count, section_digests, threads_count);
+        else
+            ComputeOnePass(digests, digests_count, section_digests);
+    }
+
+    void FileHasher::ComputeOnePass(Digest* digests, size_t digests_count, Digest* section_digests) const
+    {
+        MultiDigest file_hasher(digests, digests_count);
+
+        // Sections by raw offset, so each chunk only looks at the sections it can overlap
+        std::pmr::memory_resource* resource = sections_.get_allocator().resource();
+        size_t sections_count = section_digests ? sections_.size() : 0;
+        std::pmr::vector<Sha256> section_hashers(sections_count, resource);
+        std::pmr::vector<index_t> pending(resource);
+        std::pmr::vector<index_t> active(resource);
+        for (index_t section = 0; section < sections_count; section++)
+        {
+            if (sections_[section].empty())
+                FinalSectionDigest(section_hashers[section], section_digests[section]);
+            else
+                pending.push_back(section);
+        }
+
+        std::sort(pending.begin(), pending.end(), [this](index_t lhs, index_t rhs) { return sections_[lhs].data() < sections_[rhs].data(); });
+
+        size_t next_pending = 0;
+        for (size_t chunk = 0; chunk < file_.size(); chunk += kChunkSize)
+        {
+            size_t chunk_end = std::min(chunk + kChunkSize, file_.size());
+            file_hasher.Update(file_.data() + chunk, chunk_end - chunk);
+
+            while (next_pending < pending.size() && (size_t)(sections_[pending[next_pending]].data() - file_.data()) < chunk_end)
+                active.push_back(pending[next_pending++]);
+
+            for (size_t i = 0; i < active.size();)
+            {
+                index_t section = active[i];
+                size_t section_begin = (size_t)(sections_[section].data() - file_.data());
+                size_t section_end = section_begin + sections_[section].size();
+
+                size_t begin = std::max(chunk, section_begin);
+                size_t end = std::min(chunk_end, section_end);
+                section_hashers[section].Update(file_.data() + begin, end - begin);
+
+                if (end == section_end)
+                {
+                    FinalSectionDigest(section_hashers[section], section_digests[section]);
+                    active[i] = active.back();
+                    active.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+
+        file_hasher.Final(digests, digests_count);
+    }
+
+    void FileHasher::ComputeParallel(Digest* digests, size_t digests_count, Digest* section_digests, size_t threads_count) const
+    {
+        // Workers take sections one at a time, so one huge section does not leave the others queued behind it
+        std::atomic<size_t> next_section(0);
+        auto hash_sections = [this, section_digests, &next_section]()
+        {
+            for (index_t section = next_section++; section < sections_.size(); section = next_section++)
+            {
+                Sha256 sha256;
+                if (!sections_[section].empty())
+                    sha256.Update(sections_[section].data(), sections_[section].size());
+                FinalSectionDigest(sha256, section_digests[section]);
+            }
+        };
+
+        size_t workers_count = std::min(threads_count - 1, sections_.size());
+        std::pmr::vector<std::thread> workers(sections_.get_allocator().resource());
+        workers.reserve(workers_count);
+        for (size_t i = 0; i < workers_count; i++)
+            workers.emplace_back(hash_sections);
+
+        MultiDigest file_hasher(digests, digests_count);
+        for (size_t chunk = 0; chunk < file_.size(); chunk += kChunkSize)
+            file_hasher.Update(file_.data() + chunk, std::min(kChunkSize, file_.size() - chunk));
+        file_hasher.Final(digests, digests_count);
+
+        // Whatever is left once the file digests are done is shared with the workers
+        hash_sections();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+}
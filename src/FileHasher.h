@@ -0,0 +1,40 @@
+#pragma once
+#include "PEFormat.h"
+#include "PewTypes.h"
+
+#include "Hash/Digest.h"
+
+#include <vector>
+#include <memory_resource>
+
+namespace PewParser {
+
+    class PEFile;
+
+    // Whole file digests plus a SHA-256 of the raw data of every section. The file is walked once in kChunkSize
+    // pieces, small enough to stay in L2 while every file digest and every section overlapping the piece consume it.
+    // Big files can hash the sections on worker threads instead while the calling thread does the file digests.
+    class FileHasher
+    {
+    public:
+        static constexpr size_t kChunkSize = 64 * 1024;
+        // Below this the thread start up costs more than the section hashing it saves
+        static constexpr size_t kParallelMinSize = 8 * 1024 * 1024;
+    public:
+        FileHasher(PEFile* pe);
+
+        size_t GetSectionsCount() const { return sections_.size(); }
+        ByteSpan GetSection(index_t section) const { return sections_[section]; }
+
+        // digests[i].algorithm picks what goes in digests[i] like AuthenticodeHasher::Compute. section_digests gets
+        // GetSectionsCount() SHA-256 entries, or nullptr to skip the sections.
+        void Compute(Digest* digests, size_t digests_count, Digest* section_digests, size_t threads_count = 1) const;
+    private:
+        void ComputeOnePass(Digest* digests, size_t digests_count, Digest* section_digests) const;
+        void ComputeParallel(Digest* digests, size_t digests_count, Digest* section_digests, size_t threads_count) const;
+    private:
+        ByteSpan file_;
+        std::pmr::vector<ByteSpan> sections_;
+    };
+
+}
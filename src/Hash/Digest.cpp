@@ -0,0 +1,48 @@
+#include "Digest.h"
+
+#include <cstring>
+
+namespace PewParser {
+
+    bool Digest::operator==(const Digest& other) const
+    {
+        return algorithm == other.algorithm && size == other.size && std::memcmp(bytes, other.bytes, size) == 0;
+    }
+
+    std::string Digest::ToHex() const
+    {
+        static constexpr char kHexDigits[] = "0123456789abcdef";
+
+        std::string hex(size * 2, '0');
+        for (size_t i = 0; i < size; i++)
+        {
+            hex[i * 2] = kHexDigits[bytes[i] >> 4];
+            hex[i * 2 + 1] = kHexDigits[bytes[i] & 0xF];
+        }
+
+        return hex;
+    }
+
+    size_t GetDigestSize(DigestAlgorithm algorithm)
+    {
+        switch (algorithm)
+        {
+            case DigestAlgorithm::SHA1:      return 20;
+            case DigestAlgorithm::SHA256:    return 32;
+            case DigestAlgorithm::MD5:       return 16;
+            default:                         return 0;
+        }
+    }
+
+    std::string_view GetDigestAlgorithmName(DigestAlgorithm algorithm)
+    {
+        switch (algorithm)
+        {
+            case DigestAlgorithm::SHA1:      return "SHA-1";
+            case DigestAlgorithm::SHA256:    return "SHA-256";
+            case DigestAlgorithm::MD5:       return "MD5";
+            default:                         return "UnKnown";
+        }
+    }
+
+}
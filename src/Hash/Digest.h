@@ -0,0 +1,35 @@
+#pragma once
+#include <PEFormat.h>
+
+#include <string>
+#include <string_view>
+
+namespace PewParser {
+
+    enum class DigestAlgorithm
+    {
+        UNKNOWN = 0,
+        SHA1,
+        SHA256,
+        MD5
+    };
+
+    struct Digest
+    {
+        static constexpr size_t kMaxSize = 32;
+
+        DigestAlgorithm algorithm = DigestAlgorithm::UNKNOWN;
+        size_t size = 0;
+        BYTE bytes[kMaxSize] = {};
+
+        bool operator==(const Digest& other) const;
+        bool operator!=(const Digest& other) const { return !(*this == other); }
+
+        // Lowercase hex, empty for an unknown algorithm
+        std::string ToHex() const;
+    };
+
+    size_t GetDigestSize(DigestAlgorithm algorithm);
+    std::string_view GetDigestAlgorithmName(DigestAlgorithm algorithm);
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <PEFormat.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace PewParser {
+
+    // Block handling shared by the 64 byte block hashes. compress(blocks, blocks_count) gets whole blocks only.
+
+    static inline uint32_t LoadBigEndian32(const BYTE* src)
+    {
+        return ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | (uint32_t)src[3];
+    }
+
+    static inline uint32_t LoadLittleEndian32(const BYTE* src)
+    {
+        return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+    }
+
+    static inline void StoreLittleEndian32(BYTE* dst, uint32_t value)
+    {
+        dst[0] = (BYTE)value;
+        dst[1] = (BYTE)(value >> 8);
+        dst[2] = (BYTE)(value >> 16);
+        dst[3] = (BYTE)(value >> 24);
+    }
+
+    static inline void StoreBigEndian32(BYTE* dst, uint32_t value)
+    {
+        dst[0] = (BYTE)(value >> 24);
+        dst[1] = (BYTE)(value >> 16);
+        dst[2] = (BYTE)(value >> 8);
+        dst[3] = (BYTE)value;
+    }
+
+    static inline uint32_t RotateLeft32(uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); }
+    static inline uint32_t RotateRight32(uint32_t value, int bits) { return (value >> bits) | (value << (32 - bits)); }
+
+    // Tops up the partial block first, then compresses every whole block in place and keeps the tail
+    template<size_t kBlockSize, typename Compress>
+    static inline void FeedBlocks(BYTE (&buffer)[kBlockSize], size_t& buffered, uint64_t& length, const BYTE* data, size_t size, Compress compress)
+    {
+        length += size;
+
+        if (buffered)
+        {
+            size_t take = std::min(kBlockSize - buffered, size);
+            std::memcpy(buffer + buffered, data, take);
+            buffered += take;
+            data += take;
+            size -= take;
+
+            if (buffered < kBlockSize)
+                return;
+
+            compress(buffer, 1);
+            buffered = 0;
+        }
+
+        size_t blocks_count = size / kBlockSize;
+        if (blocks_count)
+            compress(data, blocks_count);
+
+        buffered = size % kBlockSize;
+        std::memcpy(buffer, data + blocks_count * kBlockSize, buffered);
+    }
+
+    // 0x80, zeros, then the message length in bits as a 64 bit value, big endian except for MD5
+    template<size_t kBlockSize, typename Compress>
+    static inline void PadBlocks(BYTE (&buffer)[kBlockSize], size_t buffered, uint64_t length, Compress compress, bool little_endian_length = false)
+    {
+        buffer[buffered++] = 0x80;
+        if (buffered > kBlockSize - sizeof(uint64_t))
+        {
+            std::memset(buffer + buffered, 0, kBlockSize - buffered);
+            compress(buffer, 1);
+            buffered = 0;
+        }
+
+        std::memset(buffer + buffered, 0, kBlockSize - sizeof(uint64_t) - buffered);
+
+        uint64_t bits = length * 8;
+        if (little_endian_length)
+        {
+            StoreLittleEndian32(buffer + kBlockSize - 8, (uint32_t)bits);
+            StoreLittleEndian32(buffer + kBlockSize - 4, (uint32_t)(bits >> 32));
+        }
+        else
+        {
+            StoreBigEndian32(buffer + kBlockSize - 8, (uint32_t)(bits >> 32));
+            StoreBigEndian32(buffer + kBlockSize - 4, (uint32_t)bits);
+        }
+        compress(buffer, 1);
+    }
+
+}
@@ -0,0 +1,100 @@
+#include "Md5.h"
+#include "HashBlocks.h"
+
+#include <Simd.h>
+
+namespace PewParser {
+
+    static constexpr uint32_t kRoundConstants[64] = {
+        0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE, 0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501,
+        0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE, 0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821,
+        0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA, 0xD62F105D, 0x02441453, 0xD8A1E681, 0xE7D3FBC8,
+        0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED, 0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A,
+        0xFFFA3942, 0x8771F681, 0x6D9D6122, 0xFDE5380C, 0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70,
+        0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05, 0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665,
+        0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039, 0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+        0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1, 0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391
+    };
+
+    Md5::Md5()
+    {
+        Reset();
+    }
+
+    void Md5::Reset()
+    {
+        static constexpr uint32_t kInitialState[4] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 };
+
+        std::memcpy(state_, kInitialState, sizeof(state_));
+        length_ = 0;
+        buffered_ = 0;
+    }
+
+    void Md5::Update(const BYTE* data, size_t size)
+    {
+        FeedBlocks(buffer_, buffered_, length_, data, size, [this](const BYTE* blocks, size_t blocks_count) { Compress(blocks, blocks_count); });
+    }
+
+    void Md5::Final(BYTE* digest)
+    {
+        PadBlocks(buffer_, buffered_, length_, [this](const BYTE* blocks, size_t blocks_count) { Compress(blocks, blocks_count); }, true);
+
+        for (size_t i = 0; i < 4; i++)
+            StoreLittleEndian32(digest + i * sizeof(uint32_t), state_[i]);
+    }
+
+    // One round of a 16 round stage, the stage function and the message word order are picked at compile time
+    template<int kStage>
+    static PEW_FORCE_INLINE void Round(uint32_t& a, uint32_t b, uint32_t c, uint32_t d, const uint32_t* m, size_t i, int shift)
+    {
+        static constexpr size_t kMessageStep[4] = { 1, 5, 3, 7 };
+        static constexpr size_t kMessageStart[4] = { 0, 1, 5, 0 };
+
+        uint32_t f;
+        if (kStage == 0)
+            f = d ^ (b & (c ^ d));
+        else if (kStage == 1)
+            f = c ^ (d & (b ^ c));
+        else if (kStage == 2)
+            f = b ^ c ^ d;
+        else
+            f = c ^ (b | ~d);
+
+        size_t round = kStage * 16 + i;
+        a = b + RotateLeft32(a + f + kRoundConstants[round] + m[(kMessageStart[kStage] + kMessageStep[kStage] * i) % 16], shift);
+    }
+
+    template<int kStage>
+    static PEW_FORCE_INLINE void Stage(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d, const uint32_t* m)
+    {
+        static constexpr int kShifts[4][4] = { { 7, 12, 17, 22 }, { 5, 9, 14, 20 }, { 4, 11, 16, 23 }, { 6, 10, 15, 21 } };
+
+        for (size_t i = 0; i < 16; i += 4)
+        {
+            Round<kStage>(a, b, c, d, m, i, kShifts[kStage][0]);
+            Round<kStage>(d, a, b, c, m, i + 1, kShifts[kStage][1]);
+            Round<kStage>(c, d, a, b, m, i + 2, kShifts[kStage][2]);
+            Round<kStage>(b, c, d, a, m, i + 3, kShifts[kStage][3]);
+        }
+    }
+
+    void Md5::Compress(const BYTE* blocks, size_t blocks_count)
+    {
+        for (size_t block = 0; block < blocks_count; block++, blocks += kBlockSize)
+        {
+            uint32_t m[16];
+            for (size_t i = 0; i < 16; i++)
+                m[i] = LoadLittleEndian32(blocks + i * sizeof(uint32_t));
+
+            uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+
+            Stage<0>(a, b, c, d, m);
+            Stage<1>(a, b, c, d, m);
+            Stage<2>(a, b, c, d, m);
+            Stage<3>(a, b, c, d, m);
+
+            state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+        }
+    }
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <PEFormat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PewParser {
+
+    // RFC 1321 MD5, same interface as Sha256. Only for file identification, it has no hardware path.
+    class Md5
+    {
+    public:
+        static constexpr size_t kDigestSize = 16;
+        static constexpr size_t kBlockSize = 64;
+    public:
+        Md5();
+
+        void Reset();
+        void Update(const BYTE* data, size_t size);
+        void Final(BYTE* digest);
+    private:
+        void Compress(const BYTE* blocks, size_t blocks_count);
+    private:
+        uint32_t state_[4];
+        uint64_t length_;
+        BYTE buffer_[kBlockSize];
+        size_t buffered_;
+    };
+
+}
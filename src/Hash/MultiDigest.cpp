@@ -0,0 +1,71 @@
+#include "MultiDigest.h"
+
+#include <algorithm>
+
+namespace PewParser {
+
+    MultiDigest::MultiDigest(const Digest* digests, size_t digests_count)
+    {
+        for (size_t i = 0; i < digests_count; i++)
+            Enable(digests[i].algorithm);
+    }
+
+    void MultiDigest::Enable(DigestAlgorithm algorithm)
+    {
+        switch (algorithm)
+        {
+            case DigestAlgorithm::MD5:       use_md5_ = true; break;
+            case DigestAlgorithm::SHA1:      use_sha1_ = true; break;
+            case DigestAlgorithm::SHA256:    use_sha256_ = true; break;
+            default:                         break;
+        }
+    }
+
+    bool MultiDigest::IsEnabled(DigestAlgorithm algorithm) const
+    {
+        switch (algorithm)
+        {
+            case DigestAlgorithm::MD5:       return use_md5_;
+            case DigestAlgorithm::SHA1:      return use_sha1_;
+            case DigestAlgorithm::SHA256:    return use_sha256_;
+            default:                         return false;
+        }
+    }
+
+    void MultiDigest::Update(const BYTE* data, size_t size)
+    {
+        if (use_md5_)
+            md5_.Update(data, size);
+        if (use_sha1_)
+            sha1_.Update(data, size);
+        if (use_sha256_)
+            sha256_.Update(data, size);
+    }
+
+    void MultiDigest::Final(Digest* digests, size_t digests_count)
+    {
+        BYTE md5_digest[Md5::kDigestSize];
+        BYTE sha1_digest[Sha1::kDigestSize];
+        BYTE sha256_digest[Sha256::kDigestSize];
+        if (use_md5_)
+            md5_.Final(md5_digest);
+        if (use_sha1_)
+            sha1_.Final(sha1_digest);
+        if (use_sha256_)
+            sha256_.Final(sha256_digest);
+
+        for (size_t i = 0; i < digests_count; i++)
+        {
+            Digest& digest = digests[i];
+            digest.size = IsEnabled(digest.algorithm) ? GetDigestSize(digest.algorithm) : 0;
+
+            if (digest.algorithm == DigestAlgorithm::MD5 && use_md5_)
+                std::copy(md5_digest, md5_digest + digest.size, digest.bytes);
+            else if (digest.algorithm == DigestAlgorithm::SHA1 && use_sha1_)
+                std::copy(sha1_digest, sha1_digest + digest.size, digest.bytes);
+            else if (digest.algorithm == DigestAlgorithm::SHA256 && use_sha256_)
+                std::copy(sha256_digest, sha256_digest + digest.size, digest.bytes);
+        }
+    }
+
+}
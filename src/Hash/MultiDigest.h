@@ -0,0 +1,35 @@
+#pragma once
+#include <PEFormat.h>
+
+#include "Digest.h"
+#include "Md5.h"
+#include "Sha1.h"
+#include "Sha256.h"
+
+namespace PewParser {
+
+    // Feeds one stream to every enabled algorithm, so the caller reads each chunk once for all of them
+    class MultiDigest
+    {
+    public:
+        MultiDigest() = default;
+        // Enables the algorithm of every entry, unknown ones are ignored
+        MultiDigest(const Digest* digests, size_t digests_count);
+
+        void Enable(DigestAlgorithm algorithm);
+        bool IsEnabled(DigestAlgorithm algorithm) const;
+
+        void Update(const BYTE* data, size_t size);
+        // digests[i].algorithm picks what goes in digests[i], algorithms that were not enabled are left empty.
+        // Every algorithm is finalized once however many entries ask for it.
+        void Final(Digest* digests, size_t digests_count);
+    private:
+        Md5 md5_;
+        Sha1 sha1_;
+        Sha256 sha256_;
+        bool use_md5_ = false;
+        bool use_sha1_ = false;
+        bool use_sha256_ = false;
+    };
+
+}
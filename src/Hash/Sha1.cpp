@@ -0,0 +1,159 @@
+#include "Sha1.h"
+#include "HashBlocks.h"
+
+#include <Simd.h>
+
+#include <utility>
+
+namespace PewParser {
+
+    Sha1::Sha1()
+        : Sha1(true)
+    {
+    }
+
+    Sha1::Sha1(bool use_sha_extensions)
+        : use_sha_extensions_(use_sha_extensions && HasShaExtensions())
+    {
+        Reset();
+    }
+
+    void Sha1::Reset()
+    {
+        static constexpr uint32_t kInitialState[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+        std::memcpy(state_, kInitialState, sizeof(state_));
+        length_ = 0;
+        buffered_ = 0;
+    }
+
+    void Sha1::Update(const BYTE* data, size_t size)
+    {
+        FeedBlocks(buffer_, buffered_, length_, data, size, [this](const BYTE* blocks, size_t blocks_count) { Compress(blocks, blocks_count); });
+    }
+
+    void Sha1::Final(BYTE* digest)
+    {
+        PadBlocks(buffer_, buffered_, length_, [this](const BYTE* blocks, size_t blocks_count) { Compress(blocks, blocks_count); });
+
+        for (size_t i = 0; i < 5; i++)
+            StoreBigEndian32(digest + i * sizeof(uint32_t), state_[i]);
+    }
+
+    // Rounds of one 20 round stage, the stage function is picked at compile time
+    template<int kStage>
+    static PEW_FORCE_INLINE void Round(uint32_t a, uint32_t& b, uint32_t c, uint32_t d, uint32_t& e, uint32_t w)
+    {
+        static constexpr uint32_t kConstants[4] = { 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6 };
+
+        uint32_t f;
+        if (kStage == 0)
+            f = d ^ (b & (c ^ d));
+        else if (kStage == 2)
+            f = (b & c) | (d & (b | c));
+        else
+            f = b ^ c ^ d;
+
+        e += RotateLeft32(a, 5) + f + kConstants[kStage] + w;
+        b = RotateLeft32(b, 30);
+    }
+
+    template<int kStage>
+    static PEW_FORCE_INLINE void Stage(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d, uint32_t& e, const uint32_t* w)
+    {
+        for (size_t i = 0; i < 20; i += 5)
+        {
+            Round<kStage>(a, b, c, d, e, w[i]);
+            Round<kStage>(e, a, b, c, d, w[i + 1]);
+            Round<kStage>(d, e, a, b, c, w[i + 2]);
+            Round<kStage>(c, d, e, a, b, w[i + 3]);
+            Round<kStage>(b, c, d, e, a, w[i + 4]);
+        }
+    }
+
+#if defined(PEW_SIMD_X64)
+    // Four rounds of the SHA-NI kernel. The E inputs alternate between e[0] and e[1], and the schedule
+    // for a word is spread over three groups (msg1, xor, msg2) so only four message vectors are live.
+    template<size_t kGroup>
+    static PEW_TARGET_SHA PEW_FORCE_INLINE void ShaNiGroup(__m128i& abcd, __m128i (&e)[2], __m128i (&m)[4], const BYTE* block, __m128i byte_swap)
+    {
+        if (kGroup < 4)
+            m[kGroup] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(block + kGroup * 16)), byte_swap);
+
+        if (kGroup == 0)
+            e[0] = _mm_add_epi32(e[0], m[0]);
+        else
+            e[kGroup % 2] = _mm_sha1nexte_epu32(e[kGroup % 2], m[kGroup % 4]);
+
+        if (kGroup >= 3 && kGroup <= 18)
+            m[(kGroup + 1) % 4] = _mm_sha1msg2_epu32(m[(kGroup + 1) % 4], m[kGroup % 4]);
+
+        e[(kGroup + 1) % 2] = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e[kGroup % 2], kGroup / 5);
+
+        if (kGroup >= 1 && kGroup <= 16)
+            m[(kGroup + 3) % 4] = _mm_sha1msg1_epu32(m[(kGroup + 3) % 4], m[kGroup % 4]);
+        if (kGroup >= 2 && kGroup <= 17)
+            m[(kGroup + 2) % 4] = _mm_xor_si128(m[(kGroup + 2) % 4], m[kGroup % 4]);
+    }
+
+    template<size_t... kGroups>
+    static PEW_TARGET_SHA PEW_FORCE_INLINE void ShaNiGroups(__m128i& abcd, __m128i (&e)[2], const BYTE* block, __m128i byte_swap, std::index_sequence<kGroups...>)
+    {
+        __m128i m[4];
+        (ShaNiGroup<kGroups>(abcd, e, m, block, byte_swap), ...);
+    }
+
+    // A sits in the top lane of abcd and E in the top lane of e[0]
+    static PEW_TARGET_SHA void CompressShaNi(uint32_t* state, const BYTE* blocks, size_t blocks_count)
+    {
+        const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL);
+
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1B);
+        __m128i e[2] = { _mm_set_epi32((int)state[4], 0, 0, 0), _mm_setzero_si128() };
+
+        for (size_t block = 0; block < blocks_count; block++, blocks += Sha1::kBlockSize)
+        {
+            __m128i abcd_save = abcd;
+            __m128i e_save = e[0];
+
+            ShaNiGroups(abcd, e, blocks, byte_swap, std::make_index_sequence<20>());
+
+            e[0] = _mm_sha1nexte_epu32(e[0], e_save);
+            abcd = _mm_add_epi32(abcd, abcd_save);
+        }
+
+        _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1B));
+        state[4] = (uint32_t)_mm_extract_epi32(e[0], 3);
+    }
+#endif
+
+    void Sha1::Compress(const BYTE* blocks, size_t blocks_count)
+    {
+#if defined(PEW_SIMD_X64)
+        if (use_sha_extensions_)
+        {
+            CompressShaNi(state_, blocks, blocks_count);
+            return;
+        }
+#endif
+        for (size_t block = 0; block < blocks_count; block++, blocks += kBlockSize)
+        {
+            uint32_t w[80];
+            for (size_t i = 0; i < 16; i++)
+                w[i] = LoadBigEndian32(blocks + i * sizeof(uint32_t));
+            for (size_t i = 16; i < 80; i++)
+                w[i] = RotateLeft32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+            uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3], e = state_[4];
+
+            Stage<0>(a, b, c, d, e, w);
+            Stage<1>(a, b, c, d, e, w + 20);
+            Stage<2>(a, b, c, d, e, w + 40);
+            Stage<3>(a, b, c, d, e, w + 60);
+
+            state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d; state_[4] += e;
+        }
+    }
+
+}
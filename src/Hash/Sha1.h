@@ -0,0 +1,32 @@
+#pragma once
+#include <PEFormat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PewParser {
+
+    // FIPS 180-4 SHA-1, same interface as Sha256. Only kept for Authenticode signatures that still use it.
+    class Sha1
+    {
+    public:
+        static constexpr size_t kDigestSize = 20;
+        static constexpr size_t kBlockSize = 64;
+    public:
+        Sha1();
+        explicit Sha1(bool use_sha_extensions);
+
+        void Reset();
+        void Update(const BYTE* data, size_t size);
+        void Final(BYTE* digest);
+    private:
+        void Compress(const BYTE* blocks, size_t blocks_count);
+    private:
+        bool use_sha_extensions_;
+        uint32_t state_[5];
+        uint64_t length_;
+        BYTE buffer_[kBlockSize];
+        size_t buffered_;
+    };
+
+}
@@ -0,0 +1,163 @@
+#include "Sha256.h"
+#include "HashBlocks.h"
+
+#include <Simd.h>
+
+#include <utility>
+
+namespace PewParser {
+
+    static constexpr uint32_t kRoundConstants[64] = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+    };
+
+    Sha256::Sha256()
+        : Sha256(true)
+    {
+    }
+
+    Sha256::Sha256(bool use_sha_extensions)
+        : use_sha_extensions_(use_sha_extensions && HasShaExtensions())
+    {
+        Reset();
+    }
+
+    void Sha256::Reset()
+    {
+        static constexpr uint32_t kInitialState[8] = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+
+        std::memcpy(state_, kInitialState, sizeof(state_));
+        length_ = 0;
+        buffered_ = 0;
+    }
+
+    void Sha256::Update(const BYTE* data, size_t size)
+    {
+        FeedBlocks(buffer_, buffered_, length_, data, size, [this](const BYTE* blocks, size_t blocks_count) { Compress(blocks, blocks_count); });
+    }
+
+    void Sha256::Final(BYTE* digest)
+    {
+        PadBlocks(buffer_, buffered_, length_, [this](const BYTE* blocks, size_t blocks_count) { Compress(blocks, blocks_count); });
+
+        for (size_t i = 0; i < 8; i++)
+            StoreBigEndian32(digest + i * sizeof(uint32_t), state_[i]);
+    }
+
+    // One round with the working variables renamed instead of shifted, eight calls cover a full rotation
+    static PEW_FORCE_INLINE void Round(uint32_t a, uint32_t b, uint32_t c, uint32_t& d, uint32_t e, uint32_t f, uint32_t g, uint32_t& h, uint32_t k_w)
+    {
+        uint32_t t1 = h + (RotateRight32(e, 6) ^ RotateRight32(e, 11) ^ RotateRight32(e, 25)) + (g ^ (e & (f ^ g))) + k_w;
+        uint32_t t2 = (RotateRight32(a, 2) ^ RotateRight32(a, 13) ^ RotateRight32(a, 22)) + ((a & b) | (c & (a | b)));
+        d += t1;
+        h = t1 + t2;
+    }
+
+#if defined(PEW_SIMD_X64)
+    // Four rounds of the SHA-NI kernel. Each group also finishes the schedule word three groups ahead
+    // (msg2) and starts the one after it (msg1), so the 16 groups only ever keep four message vectors.
+    template<size_t kGroup>
+    static PEW_TARGET_SHA PEW_FORCE_INLINE void ShaNiGroup(__m128i& state0, __m128i& state1, __m128i (&m)[4], const BYTE* block, __m128i byte_swap)
+    {
+        if (kGroup < 4)
+            m[kGroup] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(block + kGroup * 16)), byte_swap);
+
+        __m128i msg = _mm_add_epi32(m[kGroup % 4], _mm_loadu_si128((const __m128i*)(kRoundConstants + kGroup * 4)));
+        state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+
+        if (kGroup >= 3 && kGroup <= 14)
+        {
+            __m128i& next = m[(kGroup + 1) % 4];
+            next = _mm_add_epi32(next, _mm_alignr_epi8(m[kGroup % 4], m[(kGroup + 3) % 4], 4));
+            next = _mm_sha256msg2_epu32(next, m[kGroup % 4]);
+        }
+        if (kGroup >= 1 && kGroup <= 12)
+            m[(kGroup + 3) % 4] = _mm_sha256msg1_epu32(m[(kGroup + 3) % 4], m[kGroup % 4]);
+    }
+
+    template<size_t... kGroups>
+    static PEW_TARGET_SHA PEW_FORCE_INLINE void ShaNiGroups(__m128i& state0, __m128i& state1, const BYTE* block, __m128i byte_swap, std::index_sequence<kGroups...>)
+    {
+        __m128i m[4];
+        (ShaNiGroup<kGroups>(state0, state1, m, block, byte_swap), ...);
+    }
+
+    // The instructions keep the state as ABEF / CDGH instead of ABCD / EFGH
+    static PEW_TARGET_SHA void CompressShaNi(uint32_t* state, const BYTE* blocks, size_t blocks_count)
+    {
+        const __m128i byte_swap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+        __m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0xB1);
+        __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(state + 4)), 0x1B);
+        __m128i state0 = _mm_alignr_epi8(cdab, efgh, 8);
+        __m128i state1 = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+        for (size_t block = 0; block < blocks_count; block++, blocks += Sha256::kBlockSize)
+        {
+            __m128i abef_save = state0;
+            __m128i cdgh_save = state1;
+
+            ShaNiGroups(state0, state1, blocks, byte_swap, std::make_index_sequence<16>());
+
+            state0 = _mm_add_epi32(state0, abef_save);
+            state1 = _mm_add_epi32(state1, cdgh_save);
+        }
+
+        __m128i feba = _mm_shuffle_epi32(state0, 0x1B);
+        __m128i dchg = _mm_shuffle_epi32(state1, 0xB1);
+        _mm_storeu_si128((__m128i*)state, _mm_blend_epi16(feba, dchg, 0xF0));
+        _mm_storeu_si128((__m128i*)(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+    }
+#endif
+
+    void Sha256::Compress(const BYTE* blocks, size_t blocks_count)
+    {
+#if defined(PEW_SIMD_X64)
+        if (use_sha_extensions_)
+        {
+            CompressShaNi(state_, blocks, blocks_count);
+            return;
+        }
+#endif
+        for (size_t block = 0; block < blocks_count; block++, blocks += kBlockSize)
+        {
+            uint32_t w[64];
+            for (size_t i = 0; i < 16; i++)
+                w[i] = LoadBigEndian32(blocks + i * sizeof(uint32_t));
+
+            for (size_t i = 16; i < 64; i++)
+            {
+                uint32_t s0 = RotateRight32(w[i - 15], 7) ^ RotateRight32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = RotateRight32(w[i - 2], 17) ^ RotateRight32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+            uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+
+            for (size_t i = 0; i < 64; i += 8)
+            {
+                Round(a, b, c, d, e, f, g, h, kRoundConstants[i] + w[i]);
+                Round(h, a, b, c, d, e, f, g, kRoundConstants[i + 1] + w[i + 1]);
+                Round(g, h, a, b, c, d, e, f, kRoundConstants[i + 2] + w[i + 2]);
+                Round(f, g, h, a, b, c, d, e, kRoundConstants[i + 3] + w[i + 3]);
+                Round(e, f, g, h, a, b, c, d, kRoundConstants[i + 4] + w[i + 4]);
+                Round(d, e, f, g, h, a, b, c, kRoundConstants[i + 5] + w[i + 5]);
+                Round(c, d, e, f, g, h, a, b, kRoundConstants[i + 6] + w[i + 6]);
+                Round(b, c, d, e, f, g, h, a, kRoundConstants[i + 7] + w[i + 7]);
+            }
+
+            state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+            state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+        }
+    }
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <PEFormat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PewParser {
+
+    // FIPS 180-4 SHA-256, whole blocks are compressed straight from the input without copying
+    class Sha256
+    {
+    public:
+        static constexpr size_t kDigestSize = 32;
+        static constexpr size_t kBlockSize = 64;
+    public:
+        Sha256();
+        // The SHA-NI path is only taken when the CPU has it, false forces the portable rounds
+        explicit Sha256(bool use_sha_extensions);
+
+        void Reset();
+        void Update(const BYTE* data, size_t size);
+        // Writes kDigestSize bytes, the object has to be Reset() before hashing again
+        void Final(BYTE* digest);
+    private:
+        void Compress(const BYTE* blocks, size_t blocks_count);
+    private:
+        bool use_sha_extensions_;
+        uint32_t state_[8];
+        uint64_t length_;
+        BYTE buffer_[kBlockSize];
+        size_t buffered_;
+    };
+
+}
@@ -7,7 +7,7 @@ namespace PewParser {
     DosHdrWrapper::DosHdrWrapper(PEFile* pe)
         : related_pe_(pe)
     {
-        dos_hdr_ = (IMAGE_DOS_HEADER*)pe->GetRawFile().Buffer();
+        dos_hdr_ = (const IMAGE_DOS_HEADER*)pe->GetRawFile().Buffer();
         field_offset_ = 0;
         field_index_ = Fields::MAGIC;
     }
@@ -39,7 +39,7 @@ namespace PewParser {
         };
     }
 
-    BYTE* DosHdrWrapper::GetFieldValue() const
+    const BYTE* DosHdrWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
@@ -38,7 +38,7 @@ namespace PewParser {
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
         
         void LoadNextField();
@@ -46,10 +46,10 @@ namespace PewParser {
 
         offset_t GetNtHdrsOffset() const { return dos_hdr_->e_lfanew; }
 
-        IMAGE_DOS_HEADER* GetDosHdr() const { return dos_hdr_; }
+        const IMAGE_DOS_HEADER* GetDosHdr() const { return dos_hdr_; }
         size_t GetDosHdrSize() const { return sizeof(IMAGE_DOS_HEADER); }
     private:
-        IMAGE_DOS_HEADER* dos_hdr_;
+        const IMAGE_DOS_HEADER* dos_hdr_;
 
         FieldOffset field_offset_;
         FieldIndex field_index_;
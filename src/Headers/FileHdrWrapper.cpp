@@ -6,7 +6,7 @@
 namespace PewParser {
 
     FileHdrWrapper::FileHdrWrapper(PEFile* pe)
-        : related_pe_(pe), file_hdr_offset_(pe->GetFileHdrOffset())
+        : related_pe_(pe), file_hdr_offset_(pe->GetFileHdrOffset()), characteristics_(pe->GetMemoryResource())
     {
         file_hdr_ = (IMAGE_FILE_HEADER*)pe->GetContentAt(file_hdr_offset_, OffsetType::RAW);
         field_offset_= file_hdr_offset_;
@@ -31,7 +31,7 @@ namespace PewParser {
         }
     }
 
-    BYTE* FileHdrWrapper::GetFieldValue() const
+    const BYTE* FileHdrWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
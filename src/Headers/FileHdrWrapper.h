@@ -4,6 +4,7 @@
 
 #include <string>
 #include <map>
+#include <memory_resource>
 
 namespace PewParser {
 
@@ -27,7 +28,7 @@ namespace PewParser {
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         std::string GetFieldDescription() const;
         FieldType GetFieldType() const { return field_type_; }
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
@@ -56,7 +57,7 @@ namespace PewParser {
         FieldIndex field_index_;
         FieldType field_type_;
 
-        std::map<WORD, std::string_view> characteristics_;
+        std::pmr::map<WORD, std::string_view> characteristics_;
 
         PEFile* related_pe_;
     };
@@ -2,11 +2,15 @@
 
 #include <PEFile.h>
 #include <PEUtils.h>
+#include <Checksum.h>
+
+#include <cstddef>
 
 namespace PewParser {
 
     OptionalHdrWrapper::OptionalHdrWrapper(PEFile* pe)
-        : related_pe_(pe), optional_hdr32_(nullptr), optional_hdr64_(nullptr), optional_hdr_offset_(pe->GetOptionalHdrOffset())
+        : related_pe_(pe), optional_hdr32_(nullptr), optional_hdr64_(nullptr), optional_hdr_offset_(pe->GetOptionalHdrOffset()),
+        dll_characteristics_(pe->GetMemoryResource()), computed_checksum_(0), checksum_computed_(false)
     {
         if(pe->GetPEType() == PEType::x32PE)
             optional_hdr32_ = (IMAGE_OPTIONAL_HEADER32*)pe->GetContentAt(optional_hdr_offset_, OffsetType::RAW);
@@ -60,7 +64,7 @@ namespace PewParser {
         }
     }
 
-    BYTE* OptionalHdrWrapper::GetFieldValue() const
+    const BYTE* OptionalHdrWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
@@ -83,6 +87,55 @@ namespace PewParser {
         return false;
     }
 
+    DWORD OptionalHdrWrapper::GetChecksum() const
+    {
+        if (optional_hdr32_)
+            return optional_hdr32_->CheckSum;
+
+        return optional_hdr64_->CheckSum;
+    }
+
+    DWORD OptionalHdrWrapper::ComputeChecksum() const
+    {
+        if (!checksum_computed_)
+        {
+            const RawFile& raw_file = related_pe_->GetRawFile();
+            computed_checksum_ = ComputeImageChecksum(raw_file.Buffer(), (size_t)related_pe_->GetRawFileSize(), optional_hdr_offset_ + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum));
+            checksum_computed_ = true;
+        }
+
+        return computed_checksum_;
+    }
+
+    OptionalHdrWrapper::ChecksumCheck OptionalHdrWrapper::VerifyChecksum() const
+    {
+        // Skips reading the file when there is nothing to compare against
+        if (!GetChecksum())
+            return ChecksumCheck::NOT_SET;
+
+        return VerifyChecksum(ComputeChecksum());
+    }
+
+    OptionalHdrWrapper::ChecksumCheck OptionalHdrWrapper::VerifyChecksum(DWORD computed_checksum) const
+    {
+        DWORD checksum = GetChecksum();
+        if (!checksum)
+            return ChecksumCheck::NOT_SET;
+
+        return (checksum == computed_checksum) ? ChecksumCheck::MATCH : ChecksumCheck::MISMATCH;
+    }
+
+    std::string_view OptionalHdrWrapper::GetChecksumCheckName(ChecksumCheck check)
+    {
+        switch (check)
+        {
+            case ChecksumCheck::NOT_SET:    return "not-set";
+            case ChecksumCheck::MATCH:      return "match";
+            case ChecksumCheck::MISMATCH:   return "mismatch";
+            default:                        return "UnKnown";
+        }
+    }
+
     void OptionalHdrWrapper::UpdateDllCharacteristics()
     {
         if(!dll_characteristics_.empty())
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <map>
+#include <memory_resource>
 
 namespace PewParser {
 
@@ -47,12 +48,19 @@ namespace PewParser {
             DATA_DIR,
             FIELDS_COUNT
         };
+
+        enum class ChecksumCheck
+        {
+            NOT_SET = 0,          // CheckSum is 0, the loader only checks it for drivers and boot images
+            MATCH,
+            MISMATCH
+        };
     public:
         OptionalHdrWrapper(PEFile* pe);
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         std::string_view GetFieldDescription() const;
         FieldType GetFieldType() const { return field_type_; }
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
@@ -67,6 +75,13 @@ namespace PewParser {
 
         IMAGE_DATA_DIRECTORY* GetDataDir() const;
 
+        DWORD GetChecksum() const;
+        // Computed over the whole file on first use, later calls return the stored value
+        DWORD ComputeChecksum() const;
+        ChecksumCheck VerifyChecksum() const;
+        ChecksumCheck VerifyChecksum(DWORD computed_checksum) const;
+        static std::string_view GetChecksumCheckName(ChecksumCheck check);
+
         void LoadNextField();
         void Reset();
 
@@ -88,7 +103,10 @@ namespace PewParser {
 
         index_t data_dir_entry_;
 
-        std::map<WORD, std::string_view> dll_characteristics_;
+        std::pmr::map<WORD, std::string_view> dll_characteristics_;
+
+        mutable DWORD computed_checksum_;
+        mutable bool checksum_computed_;
 
         PEFile* related_pe_;
     };
@@ -1,13 +1,15 @@
 #include "SectionHdrsWrapper.h"
 
 #include <PEFile.h>
+#include <Entropy.h>
 
 #include <cstring>
+#include <algorithm>
 
 namespace PewParser {
 
     SectionHdrsWrapper::SectionHdrsWrapper(PEFile* pe)
-        : related_pe_(pe), root_section_hdr_offset_(pe->GetSectionHdrsOffset())
+        : related_pe_(pe), root_section_hdr_offset_(pe->GetSectionHdrsOffset()), entropies_(pe->GetMemoryResource())
     {
         root_section_hdr_ = (IMAGE_SECTION_HEADER*)pe->GetContentAt(root_section_hdr_offset_, OffsetType::RAW);
         current_section_hdr_ = root_section_hdr_;
@@ -35,7 +37,7 @@ namespace PewParser {
         }
     }
 
-    BYTE* SectionHdrsWrapper::GetFieldValue() const
+    const BYTE* SectionHdrsWrapper::GetFieldValue() const
     {
         return related_pe_->GetContentAt(field_offset_, OffsetType::RAW);
     }
@@ -62,7 +64,63 @@ namespace PewParser {
 
     size_t SectionHdrsWrapper::GetNumOfSections() const
     {
-        return related_pe_->GetNumOfSections();
+        // NumberOfSections is not trusted, only headers that fit in the file are reported
+        uintmax_t file_size = related_pe_->GetRawFileSize();
+        size_t available = (root_section_hdr_offset_ < file_size) ? (size_t)((file_size - root_section_hdr_offset_) / GetSectionHdrSize()) : 0;
+
+        return std::min(related_pe_->GetNumOfSections(), available);
+    }
+
+    ByteSpan SectionHdrsWrapper::GetSectionRawData(index_t section_index) const
+    {
+        IMAGE_SECTION_HEADER* target_section_hdr = root_section_hdr_ + section_index;
+
+        ByteSpan file(related_pe_->GetRawFile().Buffer(), (size_t)related_pe_->GetRawFileSize());
+        return file.subspan(target_section_hdr->PointerToRawData, target_section_hdr->SizeOfRawData);
+    }
+
+    SectionHdrsWrapper::SectionEntropy& SectionHdrsWrapper::GetStoredEntropy(index_t section_index) const
+    {
+        if (section_index >= entropies_.size())
+            entropies_.resize(std::max<size_t>(GetNumOfSections(), section_index + 1), SectionEntropy{});
+
+        return entropies_[section_index];
+    }
+
+    double SectionHdrsWrapper::GetSectionEntropy(index_t section_index) const
+    {
+        SectionEntropy& stored = GetStoredEntropy(section_index);
+        if (!stored.has_entropy)
+        {
+            ByteSpan raw_data = GetSectionRawData(section_index);
+            stored.entropy = ComputeEntropy(raw_data.data(), raw_data.size());
+            stored.has_entropy = true;
+        }
+
+        return stored.entropy;
+    }
+
+    std::pmr::vector<double> SectionHdrsWrapper::GetSectionEntropyMap(index_t section_index) const
+    {
+        ByteSpan raw_data = GetSectionRawData(section_index);
+
+        std::pmr::vector<double> entropies(GetEntropyWindowsCount(raw_data.size(), kEntropyWindowSize, kEntropyWindowStep), related_pe_->GetMemoryResource());
+        ComputeWindowedEntropy(raw_data.data(), raw_data.size(), kEntropyWindowSize, kEntropyWindowStep, entropies.data(), related_pe_->GetMemoryResource());
+
+        return entropies;
+    }
+
+    double SectionHdrsWrapper::GetSectionMaxWindowEntropy(index_t section_index) const
+    {
+        SectionEntropy& stored = GetStoredEntropy(section_index);
+        if (!stored.has_max_window_entropy)
+        {
+            std::pmr::vector<double> entropies = GetSectionEntropyMap(section_index);
+            stored.max_window_entropy = entropies.empty() ? 0.0 : *std::max_element(entropies.begin(), entropies.end());
+            stored.has_max_window_entropy = true;
+        }
+
+        return stored.max_window_entropy;
     }
 
     std::map<DWORD, std::string_view> SectionHdrsWrapper::GetCharacteristics(index_t section_index) const
@@ -111,7 +169,7 @@ namespace PewParser {
 
     size_t SectionHdrsWrapper::GetAllSectionsSize() const
     {
-        return related_pe_->GetNumOfSections() * GetSectionHdrSize();
+        return GetNumOfSections() * GetSectionHdrSize();
     }
 
     void SectionHdrsWrapper::LoadNextField()
@@ -4,6 +4,8 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <memory_resource>
 
 namespace PewParser {
 
@@ -26,12 +28,16 @@ namespace PewParser {
             FIELDS_COUNT
         };
 
+        // Windows of the entropy map, small enough to single out a packed blob inside an otherwise plain section
+        static constexpr size_t kEntropyWindowSize = 256;
+        static constexpr size_t kEntropyWindowStep = 64;
+
     public:
         SectionHdrsWrapper(PEFile* pe);
 
         FieldOffset GetFieldOffset() const { return field_offset_; }
         std::string_view GetFieldName() const;
-        BYTE* GetFieldValue() const;
+        const BYTE* GetFieldValue() const;
         FieldType GetFieldType() const { return field_type_; }
         size_t GetFieldsCount() const { return Fields::FIELDS_COUNT; }
 
@@ -43,6 +49,16 @@ namespace PewParser {
 
         std::map<DWORD, std::string_view> GetCharacteristics(index_t section_index) const;
 
+        // Raw data of the section clamped to the end of the file
+        ByteSpan GetSectionRawData(index_t section_index) const;
+        // Shannon entropy of the raw data in bits per byte, 0 for a section without raw data.
+        // Computed on first use, later calls return the stored value.
+        double GetSectionEntropy(index_t section_index) const;
+        // Entropy of every kEntropyWindowSize byte window, one window every kEntropyWindowStep bytes
+        std::pmr::vector<double> GetSectionEntropyMap(index_t section_index) const;
+        // Largest window of GetSectionEntropyMap, stored like GetSectionEntropy
+        double GetSectionMaxWindowEntropy(index_t section_index) const;
+
         void LoadNextField();
         void Reset();
 
@@ -52,6 +68,16 @@ namespace PewParser {
         offset_t GetCurrentSectionHdrOffset() const { return current_section_hdr_offset_; }
         size_t GetSectionHdrSize() const { return sizeof(IMAGE_SECTION_HEADER); }
         size_t GetAllSectionsSize() const;
+    private:
+        struct SectionEntropy
+        {
+            double entropy;
+            double max_window_entropy;
+            bool has_entropy;
+            bool has_max_window_entropy;
+        };
+
+        SectionEntropy& GetStoredEntropy(index_t section_index) const;
     private:
         IMAGE_SECTION_HEADER* root_section_hdr_;
         IMAGE_SECTION_HEADER* current_section_hdr_;
@@ -62,6 +88,8 @@ namespace PewParser {
         FieldIndex field_index_;
         FieldType field_type_;
 
+        mutable std::pmr::vector<SectionEntropy> entropies_;
+
         PEFile* related_pe_;
     };
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "Helper.h"
+
+#include <fstream>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace PewParser {
+
+    RawFile LoadFile(const std::filesystem::path& filepath, RawFile::Backing backing)
+    {
+        if (backing == RawFile::Backing::MAPPED)
+        {
+            RawFile raw_file = MapFile(filepath);
+            if (raw_file)
+                return raw_file;
+        }
+
+        return ReadWholeFile(filepath);
+    }
+
+    RawFile MapFile(const std::filesystem::path& filepath)
+    {
+        std::string filename = filepath.filename().u8string();
+        BYTE* buffer = nullptr;
+        uintmax_t filesize = 0;
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return RawFile();
+
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping)
+            {
+                buffer = (BYTE*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                filesize = size.QuadPart;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = open(filepath.c_str(), O_RDONLY);
+        if (fd == -1)
+            return RawFile();
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                buffer = (BYTE*)mapping;
+                filesize = st.st_size;
+
+                // Default readahead is kept: the checksum, digest, entropy and hash passes read the whole image
+                // front to back. The headers are always read first so ask for the first page right away.
+                madvise(mapping, (size_t)st.st_size < 4096 ? st.st_size : 4096, MADV_WILLNEED);
+            }
+        }
+        close(fd);
+#endif
+
+        if (!buffer)
+            return RawFile();
+
+        return RawFile(filepath, filename, filesize, buffer, RawFile::Backing::MAPPED);
+    }
+
+    RawFile ReadWholeFile(const std::filesystem::path& filepath)
+    {
+        std::ifstream file(filepath, std::ios::binary);
+        if (file.is_open())
+        {
+            std::string filename = filepath.filename().u8string();
+            std::error_code ec;
+            uintmax_t filesize = std::filesystem::file_size(filepath, ec);
+            if (ec)
+                return RawFile();
+
+            BYTE* buffer = new BYTE[filesize];
+            file.read((char*)buffer, filesize);
+            file.close();
+
+            return RawFile(filepath, filename, filesize, buffer);
+        }
+
+        return RawFile();
+    }
+
+}
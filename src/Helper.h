@@ -1,27 +1,15 @@
 #pragma once
 #include "RawFile.h"
 
-#include <fstream>
 #include <filesystem>
 
 namespace PewParser {
 
-    static RawFile LoadFile(const std::filesystem::path& filepath)
-    {
-        std::ifstream file(filepath, std::ios::binary);
-        if (file.is_open())
-        {
-            std::string filename = filepath.filename().u8string();
-            uintmax_t filesize = std::filesystem::file_size(filepath);
+    // Maps the file read-only by default, pages are only read from disk once touched.
+    // Falls back to reading the whole file into a heap buffer when mapping is not possible.
+    RawFile LoadFile(const std::filesystem::path& filepath, RawFile::Backing backing = RawFile::Backing::MAPPED);
 
-            BYTE* buffer = new BYTE[filesize];
-            file.read((char*)buffer, filesize);
-            file.close();
-
-            return RawFile(filepath, filename, filesize, buffer);
-        }
-
-        return RawFile();
-    }
+    RawFile MapFile(const std::filesystem::path& filepath);
+    RawFile ReadWholeFile(const std::filesystem::path& filepath);
 
 }
@@ -0,0 +1,262 @@
+#include "ImageMapper.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace PewParser {
+
+    static constexpr size_t kPageSize = 0x1000;
+
+    ImageMapper::MappedImage::MappedImage(MappedImage&& other) noexcept
+        : mapper_(other.mapper_), buffer_(std::move(other.buffer_)), size_(other.size_), image_base_(other.image_base_), stats_(other.stats_)
+    {
+        other.mapper_ = nullptr;
+        other.size_ = 0;
+    }
+
+    ImageMapper::MappedImage& ImageMapper::MappedImage::operator=(MappedImage&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+
+            mapper_ = other.mapper_;
+            buffer_ = std::move(other.buffer_);
+            size_ = other.size_;
+            image_base_ = other.image_base_;
+            stats_ = other.stats_;
+
+            other.mapper_ = nullptr;
+            other.size_ = 0;
+        }
+
+        return *this;
+    }
+
+    ImageMapper::MappedImage::~MappedImage()
+    {
+        Release();
+    }
+
+    void ImageMapper::MappedImage::Release()
+    {
+        if (mapper_ && buffer_)
+            mapper_->Recycle(std::move(buffer_));
+
+        buffer_.reset();
+        mapper_ = nullptr;
+        size_ = 0;
+    }
+
+    ImageMapper::ImageMapper(size_t max_image_size)
+        : max_image_size_(max_image_size)
+    {
+    }
+
+    // Smallest pooled buffer that fits, otherwise the biggest one is grown
+    std::unique_ptr<ImageMapper::Buffer> ImageMapper::Acquire(size_t size)
+    {
+        auto best = pool_.end();
+        for (auto it = pool_.begin(); it != pool_.end(); ++it)
+        {
+            bool fits = (*it)->capacity >= size;
+            if (best == pool_.end())
+                best = it;
+            else if (fits && ((*best)->capacity < size || (*it)->capacity < (*best)->capacity))
+                best = it;
+            else if (!fits && (*best)->capacity < size && (*it)->capacity > (*best)->capacity)
+                best = it;
+        }
+
+        std::unique_ptr<Buffer> buffer;
+        if (best != pool_.end())
+        {
+            buffer = std::move(*best);
+            pool_.erase(best);
+        }
+        else
+            buffer = std::make_unique<Buffer>();
+
+        if (buffer->capacity < size)
+        {
+            buffer->data.reset(new BYTE[size]);
+            buffer->capacity = size;
+        }
+
+        return buffer;
+    }
+
+    void ImageMapper::Recycle(std::unique_ptr<Buffer> buffer)
+    {
+        pool_.push_back(std::move(buffer));
+    }
+
+    ULONGLONG ImageMapper::GetPreferredBase(PEFile* pe)
+    {
+        return pe->GetImageBase();
+    }
+
+    // Regions are copied in address order and only the gaps between them are zeroed, so every byte is written once
+    size_t ImageMapper::MapSections(PEFile* pe, BYTE* image, size_t image_size, Stats& stats)
+    {
+        uintmax_t file_size = pe->GetRawFileSize();
+        const BYTE* file = pe->GetContentAt(0, OffsetType::RAW);
+
+        OptionalHdrWrapper* optional_hdr_wrapper = pe->GetOptionalHdrWrapper();
+        DWORD headers_size = (optional_hdr_wrapper->GetOptionalHdrType() == OptHdrType::x32)
+            ? ((IMAGE_OPTIONAL_HEADER32*)optional_hdr_wrapper->GetOptionalHdr())->SizeOfHeaders
+            : ((IMAGE_OPTIONAL_HEADER64*)optional_hdr_wrapper->GetOptionalHdr())->SizeOfHeaders;
+
+        SectionHdrsWrapper* section_hdrs_wrapper = pe->GetSectionHdrsWrapper();
+        IMAGE_SECTION_HEADER* section_hdr = section_hdrs_wrapper->GetRootSectionHdr();
+        size_t sections_count = section_hdr ? section_hdrs_wrapper->GetNumOfSections() : 0;
+
+        size_t headers_copied = (size_t)std::min<uintmax_t>({ headers_size, file_size, image_size });
+
+        regions_.clear();
+        regions_.push_back({ 0, headers_copied, file });
+
+        for (size_t i = 0; i < sections_count; i++, section_hdr++)
+        {
+            size_t begin = section_hdr->VirtualAddress;
+            if (begin >= image_size || section_hdr->PointerToRawData >= file_size)
+                continue;
+
+            // The loader copies SizeOfRawData bytes, cut to VirtualSize when that is set
+            size_t size = section_hdr->SizeOfRawData;
+            if (section_hdr->Misc.VirtualSize)
+                size = std::min<size_t>(size, section_hdr->Misc.VirtualSize);
+
+            size = (size_t)std::min<uintmax_t>({ size, image_size - begin, file_size - section_hdr->PointerToRawData });
+            if (!size)
+                continue;
+
+            regions_.push_back({ begin, size, file + section_hdr->PointerToRawData });
+            stats.sections_count++;
+        }
+
+        // Stable insertion sort, section tables are nearly always in address order already and stable_sort would allocate
+        auto by_address = [](const Region& a, const Region& b) { return a.begin < b.begin; };
+        for (auto it = regions_.begin(); it != regions_.end(); ++it)
+            std::rotate(std::upper_bound(regions_.begin(), it, *it, by_address), it, it + 1);
+
+        size_t zeroed_until = 0;
+        for (const Region& region : regions_)
+        {
+            if (region.begin > zeroed_until)
+                std::memset(image + zeroed_until, 0, region.begin - zeroed_until);
+
+            std::memcpy(image + region.begin, region.src, region.size);
+            zeroed_until = std::max(zeroed_until, region.begin + region.size);
+        }
+
+        if (zeroed_until < image_size)
+            std::memset(image + zeroed_until, 0, image_size - zeroed_until);
+
+        return headers_copied;
+    }
+
+    // Checked is only needed for blocks whose page is not entirely inside the image.
+    // Counters stay local, stores through the image would otherwise force them back to memory on every fixup.
+    template<bool Checked>
+    static void ApplyBlock(BYTE* image, size_t image_size, size_t page_rva, const DWORD* rvas, const BYTE* types, size_t count,
+        ULONGLONG delta, size_t& applied, size_t& skipped)
+    {
+        size_t applied_count = 0;
+        size_t skipped_count = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            BYTE type = types[i];
+            size_t target = page_rva + (DWORD)(rvas[i] - (DWORD)page_rva);
+
+            if (type == IMAGE_REL_BASED_DIR64 && (!Checked || target + sizeof(ULONGLONG) <= image_size))
+            {
+                ULONGLONG value;
+                std::memcpy(&value, image + target, sizeof(value));
+                value += delta;
+                std::memcpy(image + target, &value, sizeof(value));
+                applied_count++;
+            }
+            else if (type == IMAGE_REL_BASED_HIGHLOW && (!Checked || target + sizeof(DWORD) <= image_size))
+            {
+                DWORD value;
+                std::memcpy(&value, image + target, sizeof(value));
+                value += (DWORD)delta;
+                std::memcpy(image + target, &value, sizeof(value));
+                applied_count++;
+            }
+            else if (type != IMAGE_REL_BASED_ABSOLUTE)
+                skipped_count++;
+        }
+
+        applied += applied_count;
+        skipped += skipped_count;
+    }
+
+    void ImageMapper::ApplyRelocs(PEFile* pe, BYTE* image, size_t image_size, ULONGLONG delta, Stats& stats)
+    {
+        RelocDirWrapper* reloc_dir_wrapper = pe->GetRelocDirWrapper();
+        if (!reloc_dir_wrapper || !reloc_dir_wrapper->IsValidWrapper())
+            return;
+
+        const RelocTable& table = reloc_dir_wrapper->GetRelocTable();
+
+        for (index_t block = 0; block < table.GetBlocksCount(); block++)
+        {
+            size_t page_rva = table.page_rvas[block];
+            index_t first = table.entry_begin[block];
+            size_t count = table.GetEntriesCount(block);
+
+            if (page_rva + kPageSize - 1 + sizeof(ULONGLONG) <= image_size)
+                ApplyBlock<false>(image, image_size, page_rva, table.rvas.data() + first, table.types.data() + first, count, delta, stats.fixups_applied, stats.fixups_skipped);
+            else
+                ApplyBlock<true>(image, image_size, page_rva, table.rvas.data() + first, table.types.data() + first, count, delta, stats.fixups_applied, stats.fixups_skipped);
+        }
+
+        stats.rebased = true;
+    }
+
+    ImageMapper::MappedImage ImageMapper::Map(PEFile* pe, ULONGLONG image_base)
+    {
+        MappedImage mapped;
+
+        OptionalHdrWrapper* optional_hdr_wrapper = pe->GetOptionalHdrWrapper();
+        bool is_x32 = (optional_hdr_wrapper->GetOptionalHdrType() == OptHdrType::x32);
+        size_t image_size = is_x32 ? ((IMAGE_OPTIONAL_HEADER32*)optional_hdr_wrapper->GetOptionalHdr())->SizeOfImage
+            : ((IMAGE_OPTIONAL_HEADER64*)optional_hdr_wrapper->GetOptionalHdr())->SizeOfImage;
+
+        if (!image_size || image_size > max_image_size_)
+            return mapped;
+
+        mapped.mapper_ = this;
+        mapped.buffer_ = Acquire(image_size);
+        mapped.size_ = image_size;
+        mapped.image_base_ = image_base;
+
+        BYTE* image = mapped.buffer_->data.get();
+        size_t headers_copied = MapSections(pe, image, image_size, mapped.stats_);
+
+        ULONGLONG delta = image_base - GetPreferredBase(pe);
+        if (delta)
+            ApplyRelocs(pe, image, image_size, delta, mapped.stats_);
+        else
+            mapped.stats_.rebased = true;
+
+        // The loader writes the actual base back into the mapped optional header
+        size_t image_base_offset = pe->GetOptionalHdrOffset() + (is_x32 ? offsetof(IMAGE_OPTIONAL_HEADER32, ImageBase) : offsetof(IMAGE_OPTIONAL_HEADER64, ImageBase));
+        if (mapped.stats_.rebased && image_base_offset + (is_x32 ? sizeof(DWORD) : sizeof(ULONGLONG)) <= headers_copied)
+        {
+            if (is_x32)
+            {
+                DWORD image_base32 = (DWORD)image_base;
+                std::memcpy(image + image_base_offset, &image_base32, sizeof(image_base32));
+            }
+            else
+                std::memcpy(image + image_base_offset, &image_base, sizeof(image_base));
+        }
+
+        return mapped;
+    }
+
+}
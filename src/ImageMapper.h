@@ -0,0 +1,95 @@
+#pragma once
+#include "PEFile.h"
+#include "PewTypes.h"
+
+#include <memory>
+#include <vector>
+
+namespace PewParser {
+
+    // Lays a PE out as the loader maps it (headers, then every section at its VirtualAddress, everything else zeroed)
+    // and applies its base relocations for a chosen base.
+    // Output buffers are pooled by the mapper: a MappedImage hands its buffer back when destroyed, so rebasing module
+    // after module reuses the same few allocations. Not thread-safe, use one mapper per thread.
+    class ImageMapper
+    {
+    public:
+        static constexpr size_t kDefaultMaxImageSize = 512 * 1024 * 1024;
+
+        struct Stats
+        {
+            size_t sections_count = 0;
+            size_t fixups_applied = 0;
+            size_t fixups_skipped = 0;      // types other than HIGHLOW / DIR64, or targets outside the image
+            bool rebased = false;           // false when the base moved and the PE has no relocations
+        };
+
+        class MappedImage
+        {
+        public:
+            MappedImage() = default;
+            MappedImage(MappedImage&& other) noexcept;
+            MappedImage& operator=(MappedImage&& other) noexcept;
+            ~MappedImage();
+
+            MappedImage(const MappedImage&) = delete;
+            MappedImage& operator=(const MappedImage&) = delete;
+
+            explicit operator bool() const { return buffer_ != nullptr; }
+
+            ByteSpan GetImage() const { return ByteSpan(buffer_ ? buffer_->data.get() : nullptr, size_); }
+            ULONGLONG GetImageBase() const { return image_base_; }
+            const Stats& GetStats() const { return stats_; }
+        private:
+            friend class ImageMapper;
+
+            struct Buffer
+            {
+                std::unique_ptr<BYTE[]> data;
+                size_t capacity = 0;
+            };
+
+            void Release();
+        private:
+            ImageMapper* mapper_ = nullptr;
+            std::unique_ptr<Buffer> buffer_;
+            size_t size_ = 0;
+            ULONGLONG image_base_ = 0;
+            Stats stats_;
+        };
+    public:
+        ImageMapper(size_t max_image_size = kDefaultMaxImageSize);
+
+        ImageMapper(const ImageMapper&) = delete;
+        ImageMapper& operator=(const ImageMapper&) = delete;
+
+        // Empty MappedImage when SizeOfImage is 0 or above the limit. Every MappedImage must be destroyed before the mapper.
+        MappedImage Map(PEFile* pe, ULONGLONG image_base);
+
+        size_t GetPooledCount() const { return pool_.size(); }
+        size_t GetMaxImageSize() const { return max_image_size_; }
+
+        static ULONGLONG GetPreferredBase(PEFile* pe);
+    private:
+        using Buffer = MappedImage::Buffer;
+
+        struct Region
+        {
+            size_t begin;
+            size_t size;
+            const BYTE* src;
+        };
+
+        std::unique_ptr<Buffer> Acquire(size_t size);
+        void Recycle(std::unique_ptr<Buffer> buffer);
+
+        // Returns how many bytes of the headers were copied
+        size_t MapSections(PEFile* pe, BYTE* image, size_t image_size, Stats& stats);
+        static void ApplyRelocs(PEFile* pe, BYTE* image, size_t image_size, ULONGLONG delta, Stats& stats);
+    private:
+        size_t max_image_size_;
+        std::vector<std::unique_ptr<Buffer>> pool_;
+        std::vector<Region> regions_;
+    };
+
+}
@@ -1,9 +1,29 @@
 #include "PEFile.h"
 
+#include <algorithm>
+
 namespace PewParser {
 
-    PEFile::PEFile(const RawFile& raw_file, PEType type)
-        : raw_file_(raw_file), pe_type_(type)
+    template<typename Wrapper>
+    static Wrapper* NewWrapper(std::pmr::memory_resource* resource, PEFile* pe)
+    {
+        return new (resource->allocate(sizeof(Wrapper), alignof(Wrapper))) Wrapper(pe);
+    }
+
+    template<typename Wrapper>
+    static void DeleteWrapper(std::pmr::memory_resource* resource, Wrapper* wrapper)
+    {
+        if (!wrapper)
+            return;
+
+        wrapper->~Wrapper();
+        resource->deallocate(wrapper, sizeof(Wrapper), alignof(Wrapper));
+    }
+
+    PEFile::PEFile(const RawFile& raw_file, PEType type, Arena* arena)
+        : raw_file_(raw_file), pe_type_(type),
+        memory_resource_(arena ? arena->GetResource() : std::pmr::new_delete_resource()),
+        section_index_(memory_resource_), last_section_hit_(0), sections_overlap_(false)
     {
         NullWrappers();
         InitWrappers();
@@ -11,8 +31,8 @@ namespace PewParser {
 
     PEFile::~PEFile()
     {
+        DeleteWrappers();
         raw_file_.Delete();
-        NullWrappers();
     }
 
 
@@ -30,21 +50,57 @@ namespace PewParser {
 
     offset_t PEFile::RvaToRaw(offset_t rva) const
     {
-        offset_t raw = 0;
+        if (section_index_.empty())
+            return 0;
 
-        DWORD sum_addr = 0;
-        IMAGE_SECTION_HEADER* section_hdr = section_hdrs_wrapper_->GetRootSectionHdr();
+        // Without overlaps at most one section covers rva, so the cached one is right whenever it covers it
+        const SectionInterval& last_hit = section_index_[last_section_hit_];
+        if (!sections_overlap_ && rva >= last_hit.rva_begin && rva < last_hit.rva_end)
+            return last_hit.raw_begin + (rva - last_hit.rva_begin);
+
+        // First section that starts after rva, only the ones before it can cover rva
+        auto end = std::upper_bound(section_index_.begin(), section_index_.end(), rva,
+            [](offset_t value, const SectionInterval& interval) { return value < interval.rva_begin; });
+
+        if (end == section_index_.begin())
+            return 0;
 
-        for (size_t i = 0; i < GetNumOfSections(); i++)
+        auto it = end - 1;
+        if (sections_overlap_)
         {
-            sum_addr = section_hdr->VirtualAddress + section_hdr->SizeOfRawData;
+            // Same pick as a walk of the section table: the first section in table order that covers rva
+            it = end;
+            for (auto candidate = section_index_.begin(); candidate != end; ++candidate)
+            {
+                if (rva < candidate->rva_end && (it == end || candidate->table_index < it->table_index))
+                    it = candidate;
+            }
 
-            if (rva >= section_hdr->VirtualAddress && (rva <= sum_addr))
-                return raw = section_hdr->PointerToRawData + (rva - section_hdr->VirtualAddress);
-            section_hdr++;
+            if (it == end)
+                return 0;
         }
+        else if (rva >= it->rva_end)
+            return 0;
+
+        last_section_hit_ = it - section_index_.begin();
+        return it->raw_begin + (rva - it->rva_begin);
+    }
+
+    offset_t PEFile::VaToRaw(ULONGLONG va) const
+    {
+        ULONGLONG image_base = GetImageBase();
+        if (va < image_base || va - image_base > 0xFFFFFFFF)
+            return 0;
+
+        return RvaToRaw((offset_t)(va - image_base));
+    }
 
-        return raw;
+    ULONGLONG PEFile::GetImageBase() const
+    {
+        if (optional_hdr_wrapper_->GetOptionalHdrType() == OptHdrType::x32)
+            return ((IMAGE_OPTIONAL_HEADER32*)optional_hdr_wrapper_->GetOptionalHdr())->ImageBase;
+
+        return ((IMAGE_OPTIONAL_HEADER64*)optional_hdr_wrapper_->GetOptionalHdr())->ImageBase;
     }
 
     IMAGE_DATA_DIRECTORY* PEFile::GetDataDirectory() const
@@ -52,12 +108,12 @@ namespace PewParser {
         return optional_hdr_wrapper_->GetDataDir();
     }
 
-    BYTE* PEFile::GetContentAt(offset_t offset, OffsetType type) const
+    const BYTE* PEFile::GetContentAt(offset_t offset, OffsetType type) const
     {
         if (type == OffsetType::RVA)
         {
             offset_t raw_offset = RvaToRaw(offset);
-            if (raw_offset)
+            if (raw_offset && raw_offset < GetRawFileSize())
                 return (raw_file_.Buffer() + raw_offset);
         }
         else if (offset <= GetRawFileSize())
@@ -76,31 +132,152 @@ namespace PewParser {
         data_dir_wrappers_.fill(nullptr);
     }
 
+    void PEFile::DeleteWrappers()
+    {
+        DeleteWrapper(memory_resource_, (ExportDirWrapper*)data_dir_wrappers_[DataDirEntries::EXP]);
+        DeleteWrapper(memory_resource_, (ImportDirWrapper*)data_dir_wrappers_[DataDirEntries::IMP]);
+        DeleteWrapper(memory_resource_, (ResourceDirWrapper*)data_dir_wrappers_[DataDirEntries::RSRC]);
+        DeleteWrapper(memory_resource_, (BoundImportDirWrapper*)data_dir_wrappers_[DataDirEntries::BOUNDIMP]);
+        DeleteWrapper(memory_resource_, (DebugDirWrapper*)data_dir_wrappers_[DataDirEntries::DBG]);
+        DeleteWrapper(memory_resource_, (RelocDirWrapper*)data_dir_wrappers_[DataDirEntries::BRELOC]);
+        DeleteWrapper(memory_resource_, (ExceptionDirWrapper*)data_dir_wrappers_[DataDirEntries::EXPTN]);
+        DeleteWrapper(memory_resource_, (TlsDirWrapper*)data_dir_wrappers_[DataDirEntries::TLS]);
+        DeleteWrapper(memory_resource_, (LoadConfigDirWrapper*)data_dir_wrappers_[DataDirEntries::LDCFG]);
+        DeleteWrapper(memory_resource_, (DelayImportDirWrapper*)data_dir_wrappers_[DataDirEntries::DLYIMP]);
+        DeleteWrapper(memory_resource_, (SecurityDirWrapper*)data_dir_wrappers_[DataDirEntries::SECU]);
+
+        DeleteWrapper(memory_resource_, section_hdrs_wrapper_);
+        DeleteWrapper(memory_resource_, optional_hdr_wrapper_);
+        DeleteWrapper(memory_resource_, file_hdr_wrapper_);
+        DeleteWrapper(memory_resource_, dos_hdr_wrapper_);
+
+        NullWrappers();
+    }
+
     void PEFile::InitWrappers()
     {
-        dos_hdr_wrapper_ = new DosHdrWrapper(this);
-        file_hdr_wrapper_ = new FileHdrWrapper(this);
-        optional_hdr_wrapper_ = new OptionalHdrWrapper(this);
-        section_hdrs_wrapper_ = new SectionHdrsWrapper(this);
+        dos_hdr_wrapper_ = NewWrapper<DosHdrWrapper>(memory_resource_, this);
+        file_hdr_wrapper_ = NewWrapper<FileHdrWrapper>(memory_resource_, this);
+        optional_hdr_wrapper_ = NewWrapper<OptionalHdrWrapper>(memory_resource_, this);
+        section_hdrs_wrapper_ = NewWrapper<SectionHdrsWrapper>(memory_resource_, this);
+
+        BuildSectionIndex();
+    }
+
+    void PEFile::BuildSectionIndex()
+    {
+        section_index_.clear();
+        last_section_hit_ = 0;
+        sections_overlap_ = false;
+
+        IMAGE_SECTION_HEADER* section_hdr = section_hdrs_wrapper_->GetRootSectionHdr();
+        if (!section_hdr)
+            return;
+
+        // Already clamped to the headers that fit in the file
+        size_t sections_count = section_hdrs_wrapper_->GetNumOfSections();
+
+        DWORD section_alignment = 0;
+        if (optional_hdr_wrapper_->GetOptionalHdrType() == OptHdrType::x32)
+            section_alignment = ((IMAGE_OPTIONAL_HEADER32*)optional_hdr_wrapper_->GetOptionalHdr())->SectionAlignment;
+        else
+            section_alignment = ((IMAGE_OPTIONAL_HEADER64*)optional_hdr_wrapper_->GetOptionalHdr())->SectionAlignment;
+
+        section_index_.reserve(sections_count);
+        for (size_t i = 0; i < sections_count; i++, section_hdr++)
+        {
+            // Only the raw backed part of a section maps to file bytes, the loader zero fills the tail up to VirtualSize.
+            // Raw data past the aligned VirtualSize is not mapped either, a VirtualSize of 0 means SizeOfRawData.
+            uintmax_t span = section_hdr->SizeOfRawData;
+            if (section_hdr->Misc.VirtualSize)
+            {
+                uintmax_t virtual_size = section_hdr->Misc.VirtualSize;
+                if (section_alignment)
+                    virtual_size = (virtual_size + section_alignment - 1) / section_alignment * section_alignment;
+                span = std::min(span, virtual_size);
+            }
+            if (!span)
+                continue;
+
+            offset_t rva_end = std::min<offset_t>((offset_t)section_hdr->VirtualAddress + span, 0xFFFFFFFF);
+
+            section_index_.push_back({ section_hdr->VirtualAddress, (DWORD)rva_end, section_hdr->PointerToRawData, (DWORD)i });
+        }
+
+        // stable_sort keeps the section table order for sections sharing a start address
+        std::stable_sort(section_index_.begin(), section_index_.end(),
+            [](const SectionInterval& a, const SectionInterval& b) { return a.rva_begin < b.rva_begin; });
+
+        DWORD max_rva_end = 0;
+        for (const SectionInterval& interval : section_index_)
+        {
+            if (interval.rva_begin < max_rva_end)
+                sections_overlap_ = true;
+            max_rva_end = std::max(max_rva_end, interval.rva_end);
+        }
+    }
+
+    template<typename Wrapper>
+    Wrapper* PEFile::GetDataDirWrapper(DataDirEntries entry) const
+    {
+        if (!data_dir_wrappers_[entry] && GetDataDirectory()[entry].VirtualAddress > 0)
+            data_dir_wrappers_[entry] = NewWrapper<Wrapper>(memory_resource_, const_cast<PEFile*>(this));
+
+        return (Wrapper*)data_dir_wrappers_[entry];
+    }
+
+    ExportDirWrapper* PEFile::GetExportDirWrapper() const
+    {
+        return GetDataDirWrapper<ExportDirWrapper>(DataDirEntries::EXP);
+    }
+
+    ImportDirWrapper* PEFile::GetImportDirWrapper() const
+    {
+        return GetDataDirWrapper<ImportDirWrapper>(DataDirEntries::IMP);
+    }
+
+    ResourceDirWrapper* PEFile::GetResourceDirWrapper() const
+    {
+        return GetDataDirWrapper<ResourceDirWrapper>(DataDirEntries::RSRC);
+    }
+
+    BoundImportDirWrapper* PEFile::GetBoundImportDirWrapper() const
+    {
+        return GetDataDirWrapper<BoundImportDirWrapper>(DataDirEntries::BOUNDIMP);
+    }
+
+    DebugDirWrapper* PEFile::GetDebugDirWrapper() const
+    {
+        return GetDataDirWrapper<DebugDirWrapper>(DataDirEntries::DBG);
+    }
 
-        InitDataDirWrappers();
+    RelocDirWrapper* PEFile::GetRelocDirWrapper() const
+    {
+        return GetDataDirWrapper<RelocDirWrapper>(DataDirEntries::BRELOC);
     }
 
-    void PEFile::InitDataDirWrappers()
+    ExceptionDirWrapper* PEFile::GetExceptionDirWrapper() const
     {
-        if (GetDataDirectory()[DataDirEntries::EXP].VirtualAddress > 0)
-            data_dir_wrappers_[DataDirEntries::EXP] = new ExportDirWrapper(this);
+        return GetDataDirWrapper<ExceptionDirWrapper>(DataDirEntries::EXPTN);
+    }
 
-        if (GetDataDirectory()[DataDirEntries::IMP].VirtualAddress > 0)
-            data_dir_wrappers_[DataDirEntries::IMP] = new ImportDirWrapper(this);
+    TlsDirWrapper* PEFile::GetTlsDirWrapper() const
+    {
+        return GetDataDirWrapper<TlsDirWrapper>(DataDirEntries::TLS);
+    }
 
-        if (GetDataDirectory()[DataDirEntries::RSRC].VirtualAddress > 0)
-            data_dir_wrappers_[DataDirEntries::RSRC] = new ResourceDirWrapper(this);
+    LoadConfigDirWrapper* PEFile::GetLoadConfigDirWrapper() const
+    {
+        return GetDataDirWrapper<LoadConfigDirWrapper>(DataDirEntries::LDCFG);
+    }
 
-        if (GetDataDirectory()[DataDirEntries::BOUNDIMP].VirtualAddress > 0)
-            data_dir_wrappers_[DataDirEntries::BOUNDIMP] = new BoundImportDirWrapper(this);
+    DelayImportDirWrapper* PEFile::GetDelayImportDirWrapper() const
+    {
+        return GetDataDirWrapper<DelayImportDirWrapper>(DataDirEntries::DLYIMP);
+    }
 
-        if (GetDataDirectory()[DataDirEntries::DBG].VirtualAddress > 0)
-            data_dir_wrappers_[DataDirEntries::DBG] = new DebugDirWrapper(this);
+    SecurityDirWrapper* PEFile::GetSecurityDirWrapper() const
+    {
+        return GetDataDirWrapper<SecurityDirWrapper>(DataDirEntries::SECU);
     }
 }
@@ -6,22 +6,52 @@
 #include "DataDirectory/DataDirectory.h"
 
 #include "RawFile.h"
+#include "Arena.h"
 
 #include <array>
+#include <vector>
+#include <memory_resource>
 
 namespace PewParser {
 
+    class ExportDirWrapper;
+    class ImportDirWrapper;
+    class ResourceDirWrapper;
+    class BoundImportDirWrapper;
+    class DebugDirWrapper;
+    class RelocDirWrapper;
+    class ExceptionDirWrapper;
+    class TlsDirWrapper;
+    class LoadConfigDirWrapper;
+    class DelayImportDirWrapper;
+    class SecurityDirWrapper;
+
     class PEFile
     {
     public:
-        PEFile(const RawFile& raw_file, PEType type);
+        // With an arena every wrapper and cache of this PEFile is allocated from it,
+        // the arena must outlive the PEFile and can be reset once the PEFile is destroyed
+        PEFile(const RawFile& raw_file, PEType type, Arena* arena = nullptr);
         ~PEFile();
 
         DosHdrWrapper* GetDosHdrWrapper() const { return dos_hdr_wrapper_; }
         FileHdrWrapper* GetFileHdrWrapper() const { return file_hdr_wrapper_; }
         OptionalHdrWrapper* GetOptionalHdrWrapper() const { return optional_hdr_wrapper_; }
         SectionHdrsWrapper* GetSectionHdrsWrapper() { return section_hdrs_wrapper_; }
-        const void* GetDataDirEntryWrapper(uint32_t entry) const { return data_dir_wrappers_[entry]; }
+
+        // Data directory wrappers are built on first request, nullptr when the PE has no such directory.
+        // Not thread-safe, a PEFile is meant to be used by one thread at a time.
+        ExportDirWrapper* GetExportDirWrapper() const;
+        ImportDirWrapper* GetImportDirWrapper() const;
+        ResourceDirWrapper* GetResourceDirWrapper() const;
+        BoundImportDirWrapper* GetBoundImportDirWrapper() const;
+        DebugDirWrapper* GetDebugDirWrapper() const;
+        RelocDirWrapper* GetRelocDirWrapper() const;
+        ExceptionDirWrapper* GetExceptionDirWrapper() const;
+        TlsDirWrapper* GetTlsDirWrapper() const;
+        LoadConfigDirWrapper* GetLoadConfigDirWrapper() const;
+        DelayImportDirWrapper* GetDelayImportDirWrapper() const;
+        SecurityDirWrapper* GetSecurityDirWrapper() const;
 
         offset_t GetNtHdrsOffset() const { return dos_hdr_wrapper_->GetNtHdrsOffset(); }
         offset_t GetFileHdrOffset() const { return GetNtHdrsOffset() + sizeof(DWORD); }
@@ -37,8 +67,12 @@ namespace PewParser {
         size_t GetNumOfDataDirEntries() const { return data_dir_wrappers_.size(); }
 
         offset_t RvaToRaw(offset_t rva) const;
+        // VA at the preferred ImageBase, 0 when it is below the base or does not map to the file
+        offset_t VaToRaw(ULONGLONG va) const;
+
+        ULONGLONG GetImageBase() const;
 
-        BYTE* GetContentAt(offset_t offset, OffsetType type) const;
+        const BYTE* GetContentAt(offset_t offset, OffsetType type) const;
 
         IMAGE_DATA_DIRECTORY* GetDataDirectory() const;
 
@@ -47,20 +81,39 @@ namespace PewParser {
         RawFile& GetRawFile() { return raw_file_; }
         const RawFile& GetRawFile() const { return raw_file_; }
         uintmax_t GetRawFileSize() const { return raw_file_.Size(); }
+
+        std::pmr::memory_resource* GetMemoryResource() const { return memory_resource_; }
+    private:
+        struct SectionInterval
+        {
+            DWORD rva_begin;
+            DWORD rva_end;
+            DWORD raw_begin;
+            DWORD table_index;     // position in the section table
+        };
     private:
         void NullWrappers();
+        void DeleteWrappers();
         void InitWrappers();
-        void InitDataDirWrappers();
+        template<typename Wrapper>
+        Wrapper* GetDataDirWrapper(DataDirEntries entry) const;
+        void BuildSectionIndex();
     private:
         RawFile raw_file_;
         PEType pe_type_;
+        std::pmr::memory_resource* memory_resource_;
 
         DosHdrWrapper* dos_hdr_wrapper_;
         FileHdrWrapper* file_hdr_wrapper_;
         OptionalHdrWrapper* optional_hdr_wrapper_;
         SectionHdrsWrapper* section_hdrs_wrapper_;
 
-        std::array<void*, IMAGE_NUMBEROF_DIRECTORY_ENTRIES> data_dir_wrappers_;
+        mutable std::array<void*, IMAGE_NUMBEROF_DIRECTORY_ENTRIES> data_dir_wrappers_;
+
+        std::pmr::vector<SectionInterval> section_index_;
+        mutable index_t last_section_hit_;
+        // RvaToRaw only falls back to a table order search when some sections overlap
+        bool sections_overlap_;
     };
 
 }
@@ -2212,6 +2212,58 @@ typedef struct IMAGE_COR20_HEADER
 
 #endif // __IMAGE_COR20_HEADER_DEFINED__
 
+//
+// Version Resource Format (verrsrc.h)
+//
+
+#define VS_FFI_SIGNATURE            0xFEEF04BDL
+#define VS_FFI_STRUCVERSION         0x00010000L
+#define VS_FFI_FILEFLAGSMASK        0x0000003FL
+
+#define VS_FF_DEBUG                 0x00000001L
+#define VS_FF_PRERELEASE            0x00000002L
+#define VS_FF_PATCHED               0x00000004L
+#define VS_FF_PRIVATEBUILD          0x00000008L
+#define VS_FF_INFOINFERRED          0x00000010L
+#define VS_FF_SPECIALBUILD          0x00000020L
+
+typedef struct tagVS_FIXEDFILEINFO
+{
+    DWORD   dwSignature;            // e.g. 0xfeef04bd
+    DWORD   dwStrucVersion;         // e.g. 0x00000042 = "0.42"
+    DWORD   dwFileVersionMS;        // e.g. 0x00030075 = "3.75"
+    DWORD   dwFileVersionLS;        // e.g. 0x00000031 = "0.31"
+    DWORD   dwProductVersionMS;     // e.g. 0x00030010 = "3.10"
+    DWORD   dwProductVersionLS;     // e.g. 0x00000031 = "0.31"
+    DWORD   dwFileFlagsMask;        // = 0x3F for version "0.42"
+    DWORD   dwFileFlags;            // e.g. VFF_DEBUG | VFF_PRERELEASE
+    DWORD   dwFileOS;               // e.g. VOS_DOS_WINDOWS16
+    DWORD   dwFileType;             // e.g. VFT_DRIVER
+    DWORD   dwFileSubtype;          // e.g. VFT2_DRV_KEYBOARD
+    DWORD   dwFileDateMS;           // e.g. 0
+    DWORD   dwFileDateLS;           // e.g. 0
+} VS_FIXEDFILEINFO;
+
+//
+// Attribute Certificate Table (wintrust.h)
+//
+
+#define WIN_CERT_REVISION_1_0               (0x0100)
+#define WIN_CERT_REVISION_2_0               (0x0200)
+
+#define WIN_CERT_TYPE_X509                  (0x0001)   // bCertificate contains an X.509 Certificate
+#define WIN_CERT_TYPE_PKCS_SIGNED_DATA      (0x0002)   // bCertificate contains a PKCS SignedData structure
+#define WIN_CERT_TYPE_RESERVED_1            (0x0003)   // Reserved
+#define WIN_CERT_TYPE_TS_STACK_SIGNED       (0x0004)   // Terminal Server Protocol Stack Certificate signing
+
+typedef struct _WIN_CERTIFICATE
+{
+    DWORD       dwLength;
+    WORD        wRevision;
+    WORD        wCertificateType;   // WIN_CERT_TYPE_xxx
+    BYTE        bCertificate[1];
+} WIN_CERTIFICATE, * LPWIN_CERTIFICATE;
+
 #pragma pack(pop)
 //
 // End Image Format
@@ -1,17 +1,26 @@
 #include "PEParser.h"
 
+#include <array>
+#include <algorithm>
 #include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
 
 namespace PewParser {
 
+    // Enough for the DOS header, NT headers and the section table of almost every PE
+    static constexpr size_t kProbeSize = 4096;
+
     PEType PEParser::ValidatePE(const RawFile& raw_file)
     {
-        BYTE* buffer = raw_file.Buffer();
+        const BYTE* buffer = raw_file.Buffer();
         uintmax_t size = raw_file.Size();
 
-        size_t hdrs_size32 = sizeof(IMAGE_DOS_HEADER) + sizeof(IMAGE_NT_HEADERS32) + sizeof(IMAGE_SECTION_HEADER);
-        size_t hdrs_size64 = sizeof(IMAGE_DOS_HEADER) + sizeof(IMAGE_NT_HEADERS64) + sizeof(IMAGE_SECTION_HEADER);
-
         if (!buffer)
             return PEType::NotPE;
 
@@ -21,31 +30,230 @@ namespace PewParser {
         IMAGE_DOS_HEADER dos_hdr;
         std::memcpy(&dos_hdr, buffer, sizeof(IMAGE_DOS_HEADER));
 
-        if (dos_hdr.e_magic == IMAGE_DOS_SIGNATURE)
+        if (dos_hdr.e_magic != IMAGE_DOS_SIGNATURE)
+            return PEType::NotPE;
+
+        DWORD nt_hdrs_offset = (DWORD)dos_hdr.e_lfanew;
+        if (nt_hdrs_offset >= size)
+            return PEType::NotPE;
+
+        return ValidateNtHdrs(buffer + nt_hdrs_offset, (size_t)(size - nt_hdrs_offset), nt_hdrs_offset, size);
+    }
+
+    PEType PEParser::ValidateNtHdrs(const BYTE* nt_hdrs, size_t available, offset_t nt_hdrs_offset, uintmax_t file_size)
+    {
+        if (available < sizeof(DWORD))
+            return PEType::NotPE;
+
+        DWORD signature;
+        std::memcpy(&signature, nt_hdrs, sizeof(DWORD));
+        if (signature != IMAGE_NT_SIGNATURE)
+            return PEType::NotPE;
+
+        DWORD optional_hdr_offset = sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER);
+        if (available < optional_hdr_offset + sizeof(WORD))
+            return PEType::Corrupted;
+
+        WORD magic;
+        std::memcpy(&magic, nt_hdrs + optional_hdr_offset, sizeof(WORD));
+
+        size_t nt_hdrs_size = 0;
+        PEType type = PEType::Corrupted;
+        if (magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC)
+        {
+            nt_hdrs_size = sizeof(IMAGE_NT_HEADERS32);
+            type = PEType::x32PE;
+        }
+        else if (magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC)
+        {
+            nt_hdrs_size = sizeof(IMAGE_NT_HEADERS64);
+            type = PEType::x64PE;
+        }
+        else
+            return PEType::Corrupted;
+
+        // Every later optional header read assumes the whole NT headers are inside the file
+        if ((uintmax_t)nt_hdrs_offset + nt_hdrs_size > file_size || available < nt_hdrs_size)
+            return PEType::Corrupted;
+
+        return type;
+    }
+
+    // Single handle for the whole probe, every read is positional
+    class ProbeReader
+    {
+    public:
+        explicit ProbeReader(const std::filesystem::path& filepath)
+            : size_(0)
         {
-            DWORD signature;
-            std::memcpy(&signature, buffer + dos_hdr.e_lfanew, sizeof(DWORD));
-            if (signature == IMAGE_NT_SIGNATURE)
+#if defined(_WIN32)
+            std::error_code ec;
+            size_ = std::filesystem::file_size(filepath, ec);
+            if (!ec)
+                file_.open(filepath, std::ios::binary);
+#else
+            fd_ = open(filepath.c_str(), O_RDONLY);
+
+            struct stat file_stat;
+            if (fd_ != -1 && fstat(fd_, &file_stat) == 0 && S_ISREG(file_stat.st_mode))
+                size_ = (uintmax_t)file_stat.st_size;
+            else if (fd_ != -1)
             {
-                DWORD file_hdr_offset = dos_hdr.e_lfanew + sizeof(DWORD);
-                DWORD optional_hdr_offset = file_hdr_offset + sizeof(IMAGE_FILE_HEADER);
-
-                WORD magic;
-                std::memcpy(&magic, buffer + optional_hdr_offset, sizeof(WORD));
-                if (magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC && size > hdrs_size32)
-                        return PEType::x32PE;
-                else if (magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC && size > hdrs_size64)
-                    return PEType::x64PE;
-                else
-                    return PEType::Corrupted;
+                close(fd_);
+                fd_ = -1;
             }
-            return PEType::NotPE;
+#endif
+        }
+
+        ~ProbeReader()
+        {
+#if !defined(_WIN32)
+            if (fd_ != -1)
+                close(fd_);
+#endif
+        }
+
+        bool IsOpen() const
+        {
+#if defined(_WIN32)
+            return file_.is_open();
+#else
+            return fd_ != -1;
+#endif
+        }
+
+        uintmax_t Size() const { return size_; }
+
+        size_t ReadAt(uintmax_t offset, BYTE* buffer, size_t size)
+        {
+            if (offset >= size_)
+                return 0;
+
+            size = (size_t)std::min<uintmax_t>(size, size_ - offset);
+#if defined(_WIN32)
+            file_.clear();
+            file_.seekg((std::streamoff)offset);
+            file_.read((char*)buffer, size);
+            return (size_t)file_.gcount();
+#else
+            ssize_t read_bytes = pread(fd_, buffer, size, (off_t)offset);
+            return (read_bytes > 0) ? (size_t)read_bytes : 0;
+#endif
+        }
+    private:
+#if defined(_WIN32)
+        std::ifstream file_;
+#else
+        int fd_;
+#endif
+        uintmax_t size_;
+    };
+
+    PEProbe PEParser::ProbePE(const std::filesystem::path& filepath)
+    {
+        PEProbe probe;
+
+        ProbeReader reader(filepath);
+        if (!reader.IsOpen())
+            return probe;
+
+        probe.file_size = reader.Size();
+
+        std::array<BYTE, kProbeSize> hdrs_buffer;
+        size_t read_bytes = reader.ReadAt(0, hdrs_buffer.data(), hdrs_buffer.size());
+
+        if (read_bytes < (sizeof(IMAGE_DOS_HEADER) + sizeof(IMAGE_NT_HEADERS32::Signature)))
+            return probe;
+
+        IMAGE_DOS_HEADER dos_hdr;
+        std::memcpy(&dos_hdr, hdrs_buffer.data(), sizeof(IMAGE_DOS_HEADER));
+
+        if (dos_hdr.e_magic != IMAGE_DOS_SIGNATURE)
+            return probe;
+
+        DWORD nt_hdrs_offset = (DWORD)dos_hdr.e_lfanew;
+        if (nt_hdrs_offset >= probe.file_size)
+            return probe;
+
+        // NT headers are usually inside the first read, otherwise do one more bounded read at e_lfanew
+        std::array<BYTE, sizeof(IMAGE_NT_HEADERS64)> nt_hdrs_buffer;
+        const BYTE* nt_hdrs = nullptr;
+        size_t available = 0;
+
+        if (nt_hdrs_offset + sizeof(IMAGE_NT_HEADERS64) <= read_bytes)
+        {
+            nt_hdrs = hdrs_buffer.data() + nt_hdrs_offset;
+            available = read_bytes - nt_hdrs_offset;
         }
         else
-            return PEType::NotPE;
+        {
+            nt_hdrs = nt_hdrs_buffer.data();
+            available = reader.ReadAt(nt_hdrs_offset, nt_hdrs_buffer.data(), nt_hdrs_buffer.size());
+        }
+
+        probe.type = ValidateNtHdrs(nt_hdrs, available, nt_hdrs_offset, probe.file_size);
+
+        IMAGE_FILE_HEADER file_hdr;
+        if (probe.type == PEType::x32PE)
+        {
+            IMAGE_NT_HEADERS32 nt_hdrs32;
+            std::memcpy(&nt_hdrs32, nt_hdrs, sizeof(IMAGE_NT_HEADERS32));
+            file_hdr = nt_hdrs32.FileHeader;
+            probe.subsystem = nt_hdrs32.OptionalHeader.Subsystem;
+        }
+        else if (probe.type == PEType::x64PE)
+        {
+            IMAGE_NT_HEADERS64 nt_hdrs64;
+            std::memcpy(&nt_hdrs64, nt_hdrs, sizeof(IMAGE_NT_HEADERS64));
+            file_hdr = nt_hdrs64.FileHeader;
+            probe.subsystem = nt_hdrs64.OptionalHeader.Subsystem;
+        }
+        else
+            return probe;
+
+        probe.machine = file_hdr.Machine;
+        probe.sections_count = file_hdr.NumberOfSections;
+
+        // Same bound as SectionHdrsWrapper::GetNumOfSections, only headers that fit in the file are read
+        uintmax_t section_hdrs_offset = (uintmax_t)nt_hdrs_offset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER) + file_hdr.SizeOfOptionalHeader;
+        size_t present = (section_hdrs_offset < probe.file_size) ? (size_t)((probe.file_size - section_hdrs_offset) / sizeof(IMAGE_SECTION_HEADER)) : 0;
+        size_t sections_count = std::min<size_t>(probe.sections_count, present);
+
+        // The section table is walked in kProbeSize chunks, reusing the first read when it already covers it
+        constexpr size_t kSectionsPerChunk = kProbeSize / sizeof(IMAGE_SECTION_HEADER);
+        for (size_t i = 0; i < sections_count; i += kSectionsPerChunk)
+        {
+            size_t chunk_count = std::min(sections_count - i, kSectionsPerChunk);
+            uintmax_t chunk_offset = section_hdrs_offset + i * sizeof(IMAGE_SECTION_HEADER);
+            size_t chunk_size = chunk_count * sizeof(IMAGE_SECTION_HEADER);
+
+            const BYTE* chunk = nullptr;
+            if (chunk_offset + chunk_size <= read_bytes)
+                chunk = hdrs_buffer.data() + chunk_offset;
+            else
+            {
+                // The first read is not needed past this point, reuse it for the rest of the table
+                read_bytes = 0;
+                if (reader.ReadAt(chunk_offset, hdrs_buffer.data(), chunk_size) != chunk_size)
+                    break;
+                chunk = hdrs_buffer.data();
+            }
+
+            for (size_t j = 0; j < chunk_count; j++)
+            {
+                IMAGE_SECTION_HEADER section_hdr;
+                std::memcpy(&section_hdr, chunk + j * sizeof(IMAGE_SECTION_HEADER), sizeof(IMAGE_SECTION_HEADER));
+
+                probe.present_sections_count++;
+                if (section_hdr.SizeOfRawData)
+                    probe.raw_data_end = std::max<uintmax_t>(probe.raw_data_end, (uintmax_t)section_hdr.PointerToRawData + section_hdr.SizeOfRawData);
+            }
+        }
+
+        return probe;
     }
 
-    PEFile* PEParser::MakePE(const RawFile& raw_file, PEType type)
+    PEFile* PEParser::MakePE(const RawFile& raw_file, PEType type, Arena* arena)
     {
         if(type == PEType::NotPE || type == PEType::Corrupted)
             return nullptr;
@@ -53,6 +261,6 @@ namespace PewParser {
         if(!raw_file)
             return nullptr;
 
-        return new PEFile(raw_file, type);
+        return new PEFile(raw_file, type, arena);
     }
 }
@@ -1,13 +1,30 @@
 #pragma once
 #include "PEFile.h"
 
+#include <filesystem>
+
 namespace PewParser {
 
+    struct PEProbe
+    {
+        PEType type = PEType::NotPE;
+        WORD machine = 0;
+        WORD subsystem = 0;
+        WORD sections_count = 0;
+        // Section headers that fit in the file and the end of the furthest section raw data, anything past it is overlay
+        WORD present_sections_count = 0;
+        uintmax_t raw_data_end = 0;
+        uintmax_t file_size = 0;
+    };
+
     class PEParser
     {
     public:
         static PEType ValidatePE(const RawFile& raw_file);
-        static PEFile* MakePE(const RawFile& raw_file, PEType type);
+        static PEProbe ProbePE(const std::filesystem::path& filepath);
+        static PEFile* MakePE(const RawFile& raw_file, PEType type, Arena* arena = nullptr);
+    private:
+        static PEType ValidateNtHdrs(const BYTE* nt_hdrs, size_t available, offset_t nt_hdrs_offset, uintmax_t file_size);
     };
 
-}
\ No newline at end of file
+}
@@ -7,9 +7,14 @@ namespace PewParser {
     std::string PEUtils::TimeDateStampConverter(DWORD time)
     {
         time_t time_v = (time_t)time;
-        tm* gmt = gmtime(&time_v);
+        tm gmt = {};
+#if defined(_WIN32)
+        gmtime_s(&gmt, &time_v);
+#else
+        gmtime_r(&time_v, &gmt);
+#endif
         char format_buffer[50];
-        strftime(format_buffer, 50, "%A, %d/%m/%Y %H:%M:%S UTC", gmt);
+        strftime(format_buffer, 50, "%A, %d/%m/%Y %H:%M:%S UTC", &gmt);
         return format_buffer;
     }
-}
\ No newline at end of file
+}
\ No newline at end of file
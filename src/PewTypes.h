@@ -10,6 +10,34 @@ namespace PewParser {
     typedef uint32_t FieldIndex;
     typedef size_t index_t;
 
+    // Read only view into the loaded image, mirrors std::span<const uint8_t> which is C++20
+    class ByteSpan
+    {
+    public:
+        constexpr ByteSpan() : data_(nullptr), size_(0) {}
+        constexpr ByteSpan(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        constexpr const uint8_t* data() const { return data_; }
+        constexpr size_t size() const { return size_; }
+        constexpr bool empty() const { return size_ == 0; }
+
+        constexpr const uint8_t* begin() const { return data_; }
+        constexpr const uint8_t* end() const { return data_ + size_; }
+        constexpr const uint8_t& operator[](size_t index) const { return data_[index]; }
+
+        // Clamped to the end of the view
+        constexpr ByteSpan subspan(size_t offset, size_t count = SIZE_MAX) const
+        {
+            if (offset > size_)
+                return ByteSpan();
+
+            return ByteSpan(data_ + offset, (count < size_ - offset) ? count : size_ - offset);
+        }
+    private:
+        const uint8_t* data_;
+        size_t size_;
+    };
+
     enum class OffsetType
     {
         RAW = 0,
@@ -1,21 +1,40 @@
 #include "RawFile.h"
 
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 namespace PewParser {
 
     RawFile::RawFile()
-        : filepath_(), filename_(), filesize_(0), buffer_(nullptr)
+        : filepath_(), filename_(), filesize_(0), buffer_(nullptr), backing_(Backing::HEAP)
     {
     }
 
-    RawFile::RawFile(const std::filesystem::path& filepath, const std::string& filename, uintmax_t filesize, BYTE* buffer)
-        : filepath_(filepath), filename_(filename), filesize_(filesize), buffer_(buffer)
+    RawFile::RawFile(const std::filesystem::path& filepath, const std::string& filename, uintmax_t filesize, BYTE* buffer, Backing backing)
+        : filepath_(filepath), filename_(filename), filesize_(filesize), buffer_(buffer), backing_(backing)
     {
     }
 
     void RawFile::Delete()
     {
-        if(buffer_)
-            delete buffer_;
+        if (!buffer_)
+            return;
+
+        if (backing_ == Backing::MAPPED)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(buffer_);
+#else
+            munmap(buffer_, filesize_);
+#endif
+        }
+        else if (backing_ == Backing::HEAP)
+            delete[] buffer_;
+
+        buffer_ = nullptr;
     }
 
     RawFile::operator bool() const
@@ -8,14 +8,24 @@ namespace PewParser {
 
     class RawFile
     {
+    public:
+        enum class Backing
+        {
+            HEAP = 0,
+            MAPPED,
+            BORROWED    // caller owned memory, Delete() only forgets it
+        };
     public:
         RawFile();
-        RawFile(const std::filesystem::path& filepath, const std::string& filename, uintmax_t filesize, BYTE* buffer);
+        RawFile(const std::filesystem::path& filepath, const std::string& filename, uintmax_t filesize, BYTE* buffer, Backing backing = Backing::HEAP);
 
         std::filesystem::path Path() const { return filepath_; }
         std::string Name() const { return filename_; }
         uintmax_t Size() const { return filesize_; }
-        BYTE* Buffer() const { return buffer_; }
+        const BYTE* Buffer() const { return buffer_; }
+        Backing GetBacking() const { return backing_; }
+
+        bool IsMapped() const { return backing_ == Backing::MAPPED; }
 
         void Delete();
 
@@ -26,6 +36,7 @@ namespace PewParser {
         std::string filename_;
         uintmax_t filesize_;
         BYTE* buffer_;
+        Backing backing_;
     };
 
 }
@@ -0,0 +1,230 @@
+#include "JsonWriter.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace PewParser {
+
+    static constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+    JsonWriter::JsonWriter(size_t reserve_size)
+        : need_comma_(false)
+    {
+        buffer_.reserve(reserve_size);
+    }
+
+    void JsonWriter::Clear()
+    {
+        buffer_.clear();
+        need_comma_ = false;
+    }
+
+    void JsonWriter::Separator()
+    {
+        if (need_comma_)
+            buffer_ += ',';
+    }
+
+    void JsonWriter::BeginObject()
+    {
+        Separator();
+        buffer_ += '{';
+        need_comma_ = false;
+    }
+
+    void JsonWriter::EndObject()
+    {
+        buffer_ += '}';
+        need_comma_ = true;
+    }
+
+    void JsonWriter::BeginArray()
+    {
+        Separator();
+        buffer_ += '[';
+        need_comma_ = false;
+    }
+
+    void JsonWriter::EndArray()
+    {
+        buffer_ += ']';
+        need_comma_ = true;
+    }
+
+    void JsonWriter::Key(std::string_view key)
+    {
+        Separator();
+        buffer_ += '"';
+        AppendEscaped(key);
+        buffer_ += "\":";
+        need_comma_ = false;
+    }
+
+    void JsonWriter::String(std::string_view value)
+    {
+        Separator();
+        buffer_ += '"';
+        AppendEscaped(value);
+        buffer_ += '"';
+        need_comma_ = true;
+    }
+
+    void JsonWriter::UInt(uint64_t value)
+    {
+        Separator();
+
+        char digits[20];
+        char* end = digits + sizeof(digits);
+        char* it = end;
+        do
+        {
+            *--it = (char)('0' + (value % 10));
+            value /= 10;
+        } while (value);
+
+        buffer_.append(it, end - it);
+        need_comma_ = true;
+    }
+
+    void JsonWriter::Hex(uint64_t value)
+    {
+        Separator();
+
+        char digits[16];
+        char* end = digits + sizeof(digits);
+        char* it = end;
+        do
+        {
+            *--it = kHexDigits[value & 0xF];
+            value >>= 4;
+        } while (value);
+
+        buffer_ += "\"0x";
+        buffer_.append(it, end - it);
+        buffer_ += '"';
+        need_comma_ = true;
+    }
+
+    void JsonWriter::Double(double value, int decimals)
+    {
+        char digits[64];
+        int length = std::isfinite(value) ? snprintf(digits, sizeof(digits), "%.*f", decimals, value) : -1;
+        if (length <= 0 || (size_t)length >= sizeof(digits))
+        {
+            Null();
+            return;
+        }
+
+        Separator();
+        buffer_.append(digits, length);
+        need_comma_ = true;
+    }
+
+    void JsonWriter::Bool(bool value)
+    {
+        Separator();
+        buffer_ += value ? "true" : "false";
+        need_comma_ = true;
+    }
+
+    void JsonWriter::Null()
+    {
+        Separator();
+        buffer_ += "null";
+        need_comma_ = true;
+    }
+
+    void JsonWriter::EndRecord()
+    {
+        buffer_ += '\n';
+        need_comma_ = false;
+    }
+
+    // Length of the well formed UTF-8 sequence starting at value[0], 0 for a stray, overlong, surrogate or out of range lead byte
+    static size_t GetUtf8SequenceLength(const unsigned char* value, size_t available)
+    {
+        unsigned char lead = value[0];
+
+        size_t length = 0;
+        unsigned char second_min = 0x80;
+        unsigned char second_max = 0xBF;
+
+        if (lead >= 0xC2 && lead <= 0xDF)
+            length = 2;
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 3;
+            if (lead == 0xE0)
+                second_min = 0xA0;
+            else if (lead == 0xED)
+                second_max = 0x9F;
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 4;
+            if (lead == 0xF0)
+                second_min = 0x90;
+            else if (lead == 0xF4)
+                second_max = 0x8F;
+        }
+        else
+            return 0;
+
+        if (available < length || value[1] < second_min || value[1] > second_max)
+            return 0;
+
+        for (size_t i = 2; i < length; i++)
+        {
+            if ((value[i] & 0xC0) != 0x80)
+                return 0;
+        }
+
+        return length;
+    }
+
+    void JsonWriter::AppendEscaped(std::string_view value)
+    {
+        const unsigned char* data = (const unsigned char*)value.data();
+        size_t run_begin = 0;
+
+        for (size_t i = 0; i < value.size(); i++)
+        {
+            unsigned char c = data[i];
+            if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\')
+                continue;
+
+            // Well formed UTF-8 is copied as is
+            if (c >= 0x80)
+            {
+                size_t length = GetUtf8SequenceLength(data + i, value.size() - i);
+                if (length)
+                {
+                    i += length - 1;
+                    continue;
+                }
+            }
+
+            buffer_.append(value.data() + run_begin, i - run_begin);
+            run_begin = i + 1;
+
+            switch (c)
+            {
+                case '"':     buffer_ += "\\\"";    break;
+                case '\\':    buffer_ += "\\\\";    break;
+                case '\n':    buffer_ += "\\n";     break;
+                case '\r':    buffer_ += "\\r";     break;
+                case '\t':    buffer_ += "\\t";     break;
+                default:
+                {
+                    // Control characters, and raw bytes that are not UTF-8 (section names, export names) as the
+                    // code point of the same value so the record stays valid and the byte can still be recovered
+                    char escaped[6] = { '\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xF] };
+                    buffer_.append(escaped, sizeof(escaped));
+                }
+            }
+        }
+
+        buffer_.append(value.data() + run_begin, value.size() - run_begin);
+    }
+
+}
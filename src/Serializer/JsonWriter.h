@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace PewParser {
+
+    // Minimal streaming JSON writer for NDJSON records.
+    // The buffer keeps its capacity across Clear() so one writer can be reused for every file.
+    class JsonWriter
+    {
+    public:
+        JsonWriter(size_t reserve_size = 64 * 1024);
+
+        void Clear();
+
+        void BeginObject();
+        void EndObject();
+        void BeginArray();
+        void EndArray();
+
+        void Key(std::string_view key);
+
+        void String(std::string_view value);
+        void UInt(uint64_t value);
+        void Hex(uint64_t value);
+        // Fixed point with decimals digits, NaN, infinities and values too long to format are written as null
+        void Double(double value, int decimals = 4);
+        void Bool(bool value);
+        void Null();
+
+        void EndRecord();
+
+        std::string_view View() const { return buffer_; }
+        size_t Size() const { return buffer_.size(); }
+    private:
+        void Separator();
+        void AppendEscaped(std::string_view value);
+    private:
+        std::string buffer_;
+        bool need_comma_;
+    };
+
+}
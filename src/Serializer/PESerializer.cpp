@@ -0,0 +1,670 @@
+#include "PESerializer.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace PewParser {
+
+    static uint64_t ReadFieldValue(const BYTE* value, FieldType type)
+    {
+        if (!value)
+            return 0;
+
+        switch (type)
+        {
+            case FieldType::BYTE:         return *value;
+            case FieldType::WORD:         { WORD v; std::memcpy(&v, value, sizeof(v)); return v; }
+            case FieldType::DWORD:        { DWORD v; std::memcpy(&v, value, sizeof(v)); return v; }
+            case FieldType::ULONGLONG:    { ULONGLONG v; std::memcpy(&v, value, sizeof(v)); return v; }
+            default:                      return 0;
+        }
+    }
+
+    static void WriteField(JsonWriter& writer, FieldOffset offset, std::string_view name, uint64_t value)
+    {
+        writer.BeginObject();
+        writer.Key("offset");    writer.Hex(offset);
+        writer.Key("name");      writer.String(name);
+        writer.Key("value");     writer.Hex(value);
+        writer.EndObject();
+    }
+
+    // "functions" array of one library, shared by the regular and delay imports
+    static void WriteImportFunctions(JsonWriter& writer, const ImportTable& import_table, index_t library)
+    {
+        writer.Key("functions");
+        writer.BeginArray();
+        for (index_t func = import_table.func_begin[library]; func < import_table.func_begin[library + 1]; func++)
+        {
+            writer.BeginObject();
+            writer.Key("thunk");
+            writer.Hex(import_table.thunk_rvas[func]);
+
+            if (import_table.by_ordinal[func])
+            {
+                writer.Key("ordinal");
+                writer.Hex(import_table.ordinals[func]);
+            }
+            else
+            {
+                writer.Key("hint");    writer.Hex(import_table.hints[func]);
+                writer.Key("name");    writer.String(import_table.names[func]);
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+    }
+
+    static void WriteField(JsonWriter& writer, FieldOffset offset, std::string_view name, uint64_t value, std::string_view description)
+    {
+        writer.BeginObject();
+        writer.Key("offset");         writer.Hex(offset);
+        writer.Key("name");           writer.String(name);
+        writer.Key("value");          writer.Hex(value);
+        writer.Key("description");    writer.String(description);
+        writer.EndObject();
+    }
+
+    template<typename Wrapper>
+    static void WriteFields(Wrapper* wrapper, JsonWriter& writer)
+    {
+        writer.BeginArray();
+        for (size_t field = 0; field < wrapper->GetFieldsCount(); field++)
+        {
+            uint64_t value = ReadFieldValue(wrapper->GetFieldValue(), wrapper->GetFieldType());
+
+            if (wrapper->IsFieldDescribed())
+                WriteField(writer, wrapper->GetFieldOffset(), wrapper->GetFieldName(), value, wrapper->GetFieldDescription());
+            else
+                WriteField(writer, wrapper->GetFieldOffset(), wrapper->GetFieldName(), value);
+
+            wrapper->LoadNextField();
+        }
+        wrapper->Reset();
+        writer.EndArray();
+    }
+
+    template<typename Map>
+    static void WriteFlags(const Map& flags, JsonWriter& writer)
+    {
+        writer.BeginArray();
+        for (const auto& [value, description] : flags)
+        {
+            writer.BeginObject();
+            writer.Key("value");          writer.Hex(value);
+            writer.Key("description");    writer.String(description);
+            writer.EndObject();
+        }
+        writer.EndArray();
+    }
+
+    void PESerializer::SerializePE(PEFile* pe, JsonWriter& writer, DWORD passes)
+    {
+        writer.Key("type");
+        writer.String(pe->GetPEType() == PEType::x64PE ? "PE32+" : "PE32");
+        writer.Key("size");
+        writer.UInt(pe->GetRawFileSize());
+
+        SerializeDosHdr(pe, writer);
+        SerializeFileHdr(pe, writer);
+        SerializeOptHdr(pe, writer, passes);
+        SerializeSecHdrs(pe, writer, passes);
+        SerializeExportDir(pe, writer);
+        SerializeExports(pe, writer);
+        SerializeImports(pe, writer);
+        SerializeDelayImports(pe, writer);
+        SerializeRsrcDir(pe, writer);
+        SerializeDebugDir(pe, writer);
+        SerializeBoundImportsDir(pe, writer);
+        SerializeRelocs(pe, writer);
+        SerializeExceptions(pe, writer);
+        SerializeTlsDir(pe, writer);
+        SerializeLoadConfigDir(pe, writer);
+        SerializeSecurityDir(pe, writer, passes);
+    }
+
+    void PESerializer::SerializeDosHdr(PEFile* pe, JsonWriter& writer)
+    {
+        DosHdrWrapper* dos_hdr_wrapper = pe->GetDosHdrWrapper();
+        const IMAGE_DOS_HEADER* dos_hdr = dos_hdr_wrapper->GetDosHdr();
+
+        writer.Key("dos_hdr");
+        writer.BeginArray();
+        for (size_t field = 0; field < dos_hdr_wrapper->GetFieldsCount(); field++)
+        {
+            if (field == DosHdrWrapper::Fields::RES || field == DosHdrWrapper::Fields::RES2)
+            {
+                const WORD* res = (field == DosHdrWrapper::Fields::RES) ? dos_hdr->e_res : dos_hdr->e_res2;
+                size_t res_count = (field == DosHdrWrapper::Fields::RES) ? std::size(dos_hdr->e_res) : std::size(dos_hdr->e_res2);
+
+                writer.BeginObject();
+                writer.Key("offset");    writer.Hex(dos_hdr_wrapper->GetFieldOffset());
+                writer.Key("name");      writer.String(dos_hdr_wrapper->GetFieldName());
+                writer.Key("value");
+                writer.BeginArray();
+                for (size_t i = 0; i < res_count; i++)
+                    writer.Hex(res[i]);
+                writer.EndArray();
+                writer.EndObject();
+            }
+            else
+            {
+                FieldType type = (field == DosHdrWrapper::Fields::LFANEW) ? FieldType::DWORD : FieldType::WORD;
+                WriteField(writer, dos_hdr_wrapper->GetFieldOffset(), dos_hdr_wrapper->GetFieldName(), ReadFieldValue(dos_hdr_wrapper->GetFieldValue(), type));
+            }
+
+            dos_hdr_wrapper->LoadNextField();
+        }
+        dos_hdr_wrapper->Reset();
+        writer.EndArray();
+    }
+
+    void PESerializer::SerializeFileHdr(PEFile* pe, JsonWriter& writer)
+    {
+        FileHdrWrapper* file_hdr_wrapper = pe->GetFileHdrWrapper();
+
+        writer.Key("file_hdr");
+        WriteFields(file_hdr_wrapper, writer);
+
+        writer.Key("characteristics");
+        WriteFlags(file_hdr_wrapper->GetCharacteristics(), writer);
+    }
+
+    void PESerializer::SerializeOptHdr(PEFile* pe, JsonWriter& writer, DWORD passes)
+    {
+        OptionalHdrWrapper* optional_hdr_wrapper = pe->GetOptionalHdrWrapper();
+        OptHdrType opt_hdr_type = optional_hdr_wrapper->GetOptionalHdrType();
+
+        writer.Key("optional_hdr");
+        writer.BeginArray();
+        for (size_t field = 0; field < optional_hdr_wrapper->GetFieldsCount(); field++)
+        {
+            if (field == OptionalHdrWrapper::Fields::DATA_BASE && opt_hdr_type == OptHdrType::x64)
+            {
+                optional_hdr_wrapper->LoadNextField();
+                continue;
+            }
+            else if (field == OptionalHdrWrapper::Fields::DATA_DIR)
+                break;
+
+            uint64_t value = ReadFieldValue(optional_hdr_wrapper->GetFieldValue(), optional_hdr_wrapper->GetFieldType());
+
+            if (optional_hdr_wrapper->IsFieldDescribed())
+                WriteField(writer, optional_hdr_wrapper->GetFieldOffset(), optional_hdr_wrapper->GetFieldName(), value, optional_hdr_wrapper->GetFieldDescription());
+            else
+                WriteField(writer, optional_hdr_wrapper->GetFieldOffset(), optional_hdr_wrapper->GetFieldName(), value);
+
+            optional_hdr_wrapper->LoadNextField();
+        }
+        writer.EndArray();
+
+        writer.Key("dll_characteristics");
+        WriteFlags(optional_hdr_wrapper->GetDllCharacteristics(), writer);
+
+        if (passes & CHECKSUM_PASS)
+        {
+            DWORD computed_checksum = optional_hdr_wrapper->ComputeChecksum();
+            writer.Key("checksum");
+            writer.BeginObject();
+            writer.Key("computed");    writer.Hex(computed_checksum);
+            writer.Key("check");       writer.String(OptionalHdrWrapper::GetChecksumCheckName(optional_hdr_wrapper->VerifyChecksum(computed_checksum)));
+            writer.EndObject();
+        }
+
+        writer.Key("data_directory");
+        writer.BeginArray();
+        for (size_t entry = 0; entry < optional_hdr_wrapper->GetDataDirEntriesCount(); entry++)
+        {
+            IMAGE_DATA_DIRECTORY* data_dir_entry = (IMAGE_DATA_DIRECTORY*)optional_hdr_wrapper->GetFieldValue();
+
+            writer.BeginObject();
+            writer.Key("offset");     writer.Hex(optional_hdr_wrapper->GetFieldOffset());
+            writer.Key("name");       writer.String(optional_hdr_wrapper->GetDataDirEntryName());
+            writer.Key("address");    writer.Hex(data_dir_entry->VirtualAddress);
+            writer.Key("size");       writer.Hex(data_dir_entry->Size);
+            writer.EndObject();
+
+            optional_hdr_wrapper->LoadNextField();
+        }
+        writer.EndArray();
+
+        optional_hdr_wrapper->Reset();
+    }
+
+    void PESerializer::SerializeSecHdrs(PEFile* pe, JsonWriter& writer, DWORD passes)
+    {
+        SectionHdrsWrapper* section_hdrs_wrapper = pe->GetSectionHdrsWrapper();
+        IMAGE_SECTION_HEADER* section_hdr = section_hdrs_wrapper->GetRootSectionHdr();
+
+        writer.Key("section_hdrs");
+        writer.BeginArray();
+        for (size_t i = 0; section_hdr && i < section_hdrs_wrapper->GetNumOfSections(); i++, section_hdr++)
+        {
+            char sec_name[IMAGE_SIZEOF_SHORT_NAME + 1] = { 0 };
+            std::memcpy(sec_name, section_hdr->Name, IMAGE_SIZEOF_SHORT_NAME);
+
+            writer.BeginObject();
+            writer.Key("offset");             writer.Hex(section_hdrs_wrapper->GetRootSectionHdrOffset() + i * section_hdrs_wrapper->GetSectionHdrSize());
+            writer.Key("name");               writer.String(sec_name);
+            writer.Key("raw");                writer.Hex(section_hdr->PointerToRawData);
+            writer.Key("raw_size");           writer.Hex(section_hdr->SizeOfRawData);
+            writer.Key("rva");                writer.Hex(section_hdr->VirtualAddress);
+            writer.Key("rva_size");           writer.Hex(section_hdr->Misc.VirtualSize);
+            writer.Key("characteristics");    writer.Hex(section_hdr->Characteristics);
+            writer.Key("reloc_ptr");          writer.Hex(section_hdr->PointerToRelocations);
+            writer.Key("line_num_ptr");       writer.Hex(section_hdr->PointerToLinenumbers);
+            writer.Key("reloc_num");          writer.Hex(section_hdr->NumberOfRelocations);
+            writer.Key("line_nums");          writer.Hex(section_hdr->NumberOfLinenumbers);
+            if (passes & ENTROPY_PASS)
+            {
+                writer.Key("entropy");            writer.Double(section_hdrs_wrapper->GetSectionEntropy(i));
+                writer.Key("max_window_entropy"); writer.Double(section_hdrs_wrapper->GetSectionMaxWindowEntropy(i));
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+    }
+
+    void PESerializer::SerializeExportDir(PEFile* pe, JsonWriter& writer)
+    {
+        ExportDirWrapper* export_dir_wrapper = pe->GetExportDirWrapper();
+
+        if (!export_dir_wrapper || !export_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("export_dir");
+        WriteFields(export_dir_wrapper, writer);
+    }
+
+    void PESerializer::SerializeExports(PEFile* pe, JsonWriter& writer)
+    {
+        ExportDirWrapper* export_dir_wrapper = pe->GetExportDirWrapper();
+
+        if (!export_dir_wrapper || !export_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("exports");
+        writer.BeginArray();
+        for (size_t i = 0; i < export_dir_wrapper->GetNumOfFunctions(); i++)
+        {
+            writer.BeginObject();
+            writer.Key("offset");     writer.Hex(export_dir_wrapper->GetOffset());
+            writer.Key("ordinal");    writer.Hex(export_dir_wrapper->GetOrdinal());
+            writer.Key("rva");        writer.Hex(export_dir_wrapper->GetFuncRVA());
+
+            if (!export_dir_wrapper->IsByOrdinal())
+            {
+                writer.Key("name");
+                writer.String(export_dir_wrapper->GetFuncName());
+            }
+
+            if (export_dir_wrapper->IsForwarder())
+            {
+                writer.Key("forwarder");
+                writer.String(export_dir_wrapper->GetForwarderName());
+            }
+            writer.EndObject();
+
+            export_dir_wrapper->LoadNextEATEntry();
+        }
+        export_dir_wrapper->ResetEATEntry();
+        writer.EndArray();
+    }
+
+    void PESerializer::SerializeImports(PEFile* pe, JsonWriter& writer)
+    {
+        ImportDirWrapper* import_dir_wrapper = pe->GetImportDirWrapper();
+
+        if (!import_dir_wrapper || !import_dir_wrapper->IsValidWrapper())
+            return;
+
+        const ImportTable& import_table = import_dir_wrapper->GetImportTable();
+
+        writer.Key("imports");
+        writer.BeginArray();
+        for (size_t i = 0; i < import_table.GetLibrariesCount(); i++)
+        {
+            writer.BeginObject();
+            writer.Key("offset");    writer.Hex(import_dir_wrapper->GetRootDescriptorOffset() + i * import_dir_wrapper->GetDescriptorSize());
+            writer.Key("name");      writer.String(import_table.library_names[i]);
+            WriteImportFunctions(writer, import_table, i);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.Key("imports_truncated");
+        writer.Bool(import_table.is_truncated);
+    }
+
+    void PESerializer::SerializeDelayImports(PEFile* pe, JsonWriter& writer)
+    {
+        DelayImportDirWrapper* delay_import_dir_wrapper = pe->GetDelayImportDirWrapper();
+
+        if (!delay_import_dir_wrapper || !delay_import_dir_wrapper->IsValidWrapper())
+            return;
+
+        const ImportTable& import_table = delay_import_dir_wrapper->GetImportTable();
+
+        writer.Key("delay_imports");
+        writer.BeginArray();
+        for (size_t i = 0; i < import_table.GetLibrariesCount(); i++)
+        {
+            writer.BeginObject();
+            writer.Key("offset");       writer.Hex(delay_import_dir_wrapper->GetRootDescriptorOffset() + i * delay_import_dir_wrapper->GetDescriptorSize());
+            writer.Key("name");         writer.String(import_table.library_names[i]);
+            writer.Key("rva_based");    writer.Bool(delay_import_dir_wrapper->IsRvaBased(i));
+            WriteImportFunctions(writer, import_table, i);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.Key("delay_imports_truncated");
+        writer.Bool(import_table.is_truncated);
+    }
+
+    void PESerializer::SerializeRsrcDir(PEFile* pe, JsonWriter& writer)
+    {
+        ResourceDirWrapper* rsrc_dir_wrapper = pe->GetResourceDirWrapper();
+
+        if (!rsrc_dir_wrapper || !rsrc_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("rsrc_dir");
+        WriteFields(rsrc_dir_wrapper, writer);
+
+        // Every node of the flattened tree in its breadth first order, parent indexes point into the same array
+        const RsrcTree& rsrc_tree = rsrc_dir_wrapper->GetRsrcTree();
+
+        writer.Key("rsrc_entries");
+        writer.BeginArray();
+        std::string name;
+        for (const RsrcNode& node : rsrc_tree.nodes)
+        {
+            writer.BeginObject();
+            writer.Key("parent");
+            if (node.parent == RsrcNode::kNoParent)
+                writer.Null();
+            else
+                writer.UInt(node.parent);
+            writer.Key("level");    writer.UInt(node.level);
+            if (node.IsString())
+            {
+                rsrc_dir_wrapper->GetNodeName(node, name);
+                writer.Key("name");           writer.String(name);
+                writer.Key("name_offset");    writer.Hex(node.name_offset);
+            }
+            else
+            {
+                writer.Key("id");    writer.Hex(node.GetId());
+                if (node.is_directory && node.level == ResourceDirWrapper::TreeLevel::TYPE)
+                {
+                    writer.Key("type");
+                    writer.String(ResourceDirWrapper::GetTypeName(node.GetId()));
+                }
+            }
+            writer.Key("directory");    writer.Bool(node.is_directory);
+            writer.Key("value");        writer.Hex(node.offset_to_data);
+            writer.Key("offset");       writer.Hex(node.data_offset);
+            writer.Key("entries");      writer.UInt(node.children_count);
+            if (node.is_revisit)
+            {
+                writer.Key("revisit");
+                writer.Bool(true);
+            }
+            if (node.is_overlapping)
+            {
+                writer.Key("overlapping");
+                writer.Bool(true);
+            }
+            if (node.is_truncated)
+            {
+                writer.Key("truncated");
+                writer.Bool(true);
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        const VersionInfo* version_info = rsrc_dir_wrapper->GetVersionInfo();
+        if (!version_info)
+            return;
+
+        writer.Key("version_info");
+        writer.BeginObject();
+        if (version_info->has_fixed_info)
+        {
+            writer.Key("file_version");       writer.String(version_info->GetFileVersion());
+            writer.Key("product_version");    writer.String(version_info->GetProductVersion());
+            writer.Key("file_flags");         writer.Hex(version_info->fixed_info.dwFileFlags & version_info->fixed_info.dwFileFlagsMask);
+        }
+
+        writer.Key("translations");
+        writer.BeginArray();
+        for (DWORD translation : version_info->translations)
+            writer.Hex(translation);
+        writer.EndArray();
+
+        writer.Key("string_tables");
+        writer.BeginArray();
+        for (const VersionInfo::StringTable& table : version_info->string_tables)
+        {
+            writer.BeginObject();
+            writer.Key("key");    writer.String(version_info->GetTableKey(table));
+            writer.Key("strings");
+            writer.BeginObject();
+            for (index_t string = table.first_string; string < table.first_string + table.strings_count; string++)
+            {
+                writer.Key(version_info->GetKey(version_info->strings[string]));
+                writer.String(version_info->GetValue(version_info->strings[string]));
+            }
+            writer.EndObject();
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+
+    void PESerializer::SerializeDebugDir(PEFile* pe, JsonWriter& writer)
+    {
+        DebugDirWrapper* debug_dir_wrapper = pe->GetDebugDirWrapper();
+
+        if (!debug_dir_wrapper || !debug_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("debug_dir");
+        WriteFields(debug_dir_wrapper, writer);
+    }
+
+    void PESerializer::SerializeBoundImportsDir(PEFile* pe, JsonWriter& writer)
+    {
+        BoundImportDirWrapper* bound_import_dir_wrapper = pe->GetBoundImportDirWrapper();
+
+        if (!bound_import_dir_wrapper || !bound_import_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("bound_imports");
+        writer.BeginArray();
+        for (size_t i = 0; i < bound_import_dir_wrapper->GetLiberiresCount(); i++)
+        {
+            writer.BeginObject();
+            writer.Key("offset");    writer.Hex(bound_import_dir_wrapper->GetFieldOffset());
+            writer.Key("name");      writer.String(bound_import_dir_wrapper->GetLiberaryName());
+
+            for (size_t field = 0; field < bound_import_dir_wrapper->GetFieldsCount(); field++)
+            {
+                writer.Key(bound_import_dir_wrapper->GetFieldName());
+                writer.Hex(ReadFieldValue(bound_import_dir_wrapper->GetFieldValue(), bound_import_dir_wrapper->GetFieldType()));
+
+                bound_import_dir_wrapper->LoadNextField();
+            }
+            writer.EndObject();
+
+            bound_import_dir_wrapper->LoadNextLiberary();
+        }
+        bound_import_dir_wrapper->Reset();
+        writer.EndArray();
+    }
+
+    void PESerializer::SerializeRelocs(PEFile* pe, JsonWriter& writer)
+    {
+        RelocDirWrapper* reloc_dir_wrapper = pe->GetRelocDirWrapper();
+
+        if (!reloc_dir_wrapper || !reloc_dir_wrapper->IsValidWrapper())
+            return;
+
+        const RelocTable& reloc_table = reloc_dir_wrapper->GetRelocTable();
+
+        writer.Key("relocs");
+        writer.BeginObject();
+        writer.Key("offset");         writer.Hex(reloc_dir_wrapper->GetRootBlockOffset());
+        writer.Key("blocks");         writer.UInt(reloc_table.GetBlocksCount());
+        writer.Key("entries");        writer.UInt(reloc_table.GetTotalEntriesCount());
+        writer.Key("fixups");         writer.UInt(reloc_table.GetFixupsCount());
+        writer.Key("chain_valid");    writer.Bool(reloc_table.is_chain_valid);
+
+        writer.Key("types");
+        writer.BeginObject();
+        for (size_t type = 0; type < reloc_table.type_counts.size(); type++)
+        {
+            if (!reloc_table.type_counts[type])
+                continue;
+
+            writer.Key(RelocDirWrapper::GetTypeName((BYTE)type));
+            writer.UInt(reloc_table.type_counts[type]);
+        }
+        writer.EndObject();
+        writer.EndObject();
+    }
+
+    void PESerializer::SerializeExceptions(PEFile* pe, JsonWriter& writer)
+    {
+        ExceptionDirWrapper* exception_dir_wrapper = pe->GetExceptionDirWrapper();
+
+        if (!exception_dir_wrapper || !exception_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("exceptions");
+        writer.BeginObject();
+        writer.Key("offset");         writer.Hex(exception_dir_wrapper->GetRootEntryOffset());
+        writer.Key("entries");        writer.UInt(exception_dir_wrapper->GetEntriesCount());
+        writer.Key("functions");      writer.UInt(exception_dir_wrapper->GetFunctionsCount());
+        writer.Key("sorted");         writer.Bool(exception_dir_wrapper->IsInPlace());
+        writer.EndObject();
+    }
+
+    void PESerializer::SerializeSecurityDir(PEFile* pe, JsonWriter& writer, DWORD passes)
+    {
+        SecurityDirWrapper* security_dir_wrapper = pe->GetSecurityDirWrapper();
+
+        if (!security_dir_wrapper || !security_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("security_dir");
+        writer.BeginObject();
+        writer.Key("offset");       writer.Hex(security_dir_wrapper->GetSecurityDirOffset());
+        writer.Key("size");         writer.UInt(security_dir_wrapper->GetSecurityDirSize());
+        writer.Key("truncated");    writer.Bool(security_dir_wrapper->IsTruncated());
+
+        writer.Key("certificates");
+        writer.BeginArray();
+        for (const SecurityDirWrapper::Certificate& certificate : security_dir_wrapper->GetCertificates())
+        {
+            writer.BeginObject();
+            writer.Key("offset");      writer.Hex(certificate.offset);
+            writer.Key("length");      writer.UInt(certificate.length);
+            writer.Key("revision");    writer.Hex(certificate.revision);
+            writer.Key("type");        writer.String(SecurityDirWrapper::GetTypeName(certificate.type));
+
+            Digest signed_digest;
+            if (SecurityDirWrapper::GetSignedDigest(certificate, signed_digest))
+            {
+                writer.Key("digest_algorithm");    writer.String(GetDigestAlgorithmName(signed_digest.algorithm));
+                writer.Key("signed_digest");       writer.String(signed_digest.ToHex());
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        if (passes & AUTHENTICODE_PASS)
+        {
+            writer.Key("digest_check");
+            writer.String(SecurityDirWrapper::GetDigestCheckName(security_dir_wrapper->CheckImageDigest()));
+        }
+        writer.EndObject();
+    }
+
+    void PESerializer::SerializeTlsDir(PEFile* pe, JsonWriter& writer)
+    {
+        TlsDirWrapper* tls_dir_wrapper = pe->GetTlsDirWrapper();
+
+        if (!tls_dir_wrapper || !tls_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("tls_dir");
+        writer.BeginObject();
+        writer.Key("offset");             writer.Hex(tls_dir_wrapper->GetTlsDirOffset());
+        writer.Key("raw_data_start");     writer.Hex(tls_dir_wrapper->GetStartAddressOfRawData());
+        writer.Key("raw_data_end");       writer.Hex(tls_dir_wrapper->GetEndAddressOfRawData());
+        writer.Key("raw_data_offset");    writer.Hex(tls_dir_wrapper->GetRawDataOffset());
+        writer.Key("raw_data_size");      writer.UInt(tls_dir_wrapper->GetRawDataSize());
+        writer.Key("index");              writer.Hex(tls_dir_wrapper->GetAddressOfIndex());
+        writer.Key("zero_fill");          writer.UInt(tls_dir_wrapper->GetSizeOfZeroFill());
+        writer.Key("characteristics");    writer.Hex(tls_dir_wrapper->GetCharacteristics());
+
+        writer.Key("callbacks");
+        writer.BeginArray();
+        for (ULONGLONG callback : tls_dir_wrapper->GetCallbacks())
+            writer.Hex(callback);
+        writer.EndArray();
+        writer.Key("callbacks_terminated");    writer.Bool(tls_dir_wrapper->IsCallbacksTerminated());
+        writer.EndObject();
+    }
+
+    void PESerializer::SerializeLoadConfigDir(PEFile* pe, JsonWriter& writer)
+    {
+        LoadConfigDirWrapper* load_config_dir_wrapper = pe->GetLoadConfigDirWrapper();
+
+        if (!load_config_dir_wrapper || !load_config_dir_wrapper->IsValidWrapper())
+            return;
+
+        writer.Key("load_config");
+        writer.BeginObject();
+        writer.Key("offset");             writer.Hex(load_config_dir_wrapper->GetLoadConfigDirOffset());
+        writer.Key("size");               writer.UInt(load_config_dir_wrapper->GetDeclaredSize());
+        writer.Key("truncated");          writer.Bool(load_config_dir_wrapper->IsTruncated());
+        writer.Key("security_cookie");    writer.Hex(load_config_dir_wrapper->GetSecurityCookie());
+        writer.Key("guard_flags");        writer.Hex(load_config_dir_wrapper->GetGuardFlags());
+
+        writer.Key("tables");
+        writer.BeginObject();
+        for (size_t table = 0; table < LoadConfigDirWrapper::TABLES_COUNT; table++)
+        {
+            const LoadConfigTable& entries = load_config_dir_wrapper->GetTable((LoadConfigDirWrapper::Tables)table);
+            if (!entries.raw)
+                continue;
+
+            writer.Key(LoadConfigDirWrapper::GetTableName((LoadConfigDirWrapper::Tables)table));
+            writer.BeginObject();
+            writer.Key("offset");         writer.Hex(entries.raw);
+            writer.Key("entries");        writer.UInt(entries.count);
+            writer.Key("stride");         writer.UInt(entries.stride);
+            writer.Key("truncated");      writer.Bool(entries.is_truncated);
+            writer.EndObject();
+        }
+        writer.EndObject();
+
+        if (load_config_dir_wrapper->GetDynamicRelocTableOffset())
+        {
+            writer.Key("dynamic_relocs");
+            writer.BeginObject();
+            writer.Key("offset");         writer.Hex(load_config_dir_wrapper->GetDynamicRelocTableOffset());
+            writer.Key("version");        writer.UInt(load_config_dir_wrapper->GetDynamicRelocVersion());
+            writer.Key("symbols");
+            writer.BeginArray();
+            for (const DynamicRelocation& relocation : load_config_dir_wrapper->GetDynamicRelocations())
+                writer.Hex(relocation.symbol);
+            writer.EndArray();
+            writer.EndObject();
+        }
+        writer.EndObject();
+    }
+
+}
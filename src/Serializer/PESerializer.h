@@ -0,0 +1,44 @@
+#pragma once
+#include <PEFile.h>
+
+#include "JsonWriter.h"
+
+namespace PewParser {
+
+    // Writes wrapper fields as JSON members into the object currently open in the writer.
+    // Every header entry is {"offset", "name", "value"[, "description"]}, offsets and values in hex.
+    class PESerializer
+    {
+    public:
+        // Members that cost a full read of the file or of every section, the ones left out of passes are not written
+        enum Passes : DWORD
+        {
+            ENTROPY_PASS = 0x1,        // section entropy and max window entropy
+            CHECKSUM_PASS = 0x2,       // recomputed optional header CheckSum
+            AUTHENTICODE_PASS = 0x4,   // recomputed image digest of signed files
+            HASHES_PASS = 0x8,         // file and section digests, only written by the scanner
+            ALL_PASSES = 0xF
+        };
+    public:
+        static void SerializePE(PEFile* pe, JsonWriter& writer, DWORD passes = ALL_PASSES);
+
+        static void SerializeDosHdr(PEFile* pe, JsonWriter& writer);
+        static void SerializeFileHdr(PEFile* pe, JsonWriter& writer);
+        static void SerializeOptHdr(PEFile* pe, JsonWriter& writer, DWORD passes = ALL_PASSES);
+        static void SerializeSecHdrs(PEFile* pe, JsonWriter& writer, DWORD passes = ALL_PASSES);
+        //DataDir
+        static void SerializeExportDir(PEFile* pe, JsonWriter& writer);
+        static void SerializeExports(PEFile* pe, JsonWriter& writer);
+        static void SerializeImports(PEFile* pe, JsonWriter& writer);
+        static void SerializeDelayImports(PEFile* pe, JsonWriter& writer);
+        static void SerializeRsrcDir(PEFile* pe, JsonWriter& writer);
+        static void SerializeDebugDir(PEFile* pe, JsonWriter& writer);
+        static void SerializeBoundImportsDir(PEFile* pe, JsonWriter& writer);
+        static void SerializeRelocs(PEFile* pe, JsonWriter& writer);
+        static void SerializeExceptions(PEFile* pe, JsonWriter& writer);
+        static void SerializeTlsDir(PEFile* pe, JsonWriter& writer);
+        static void SerializeLoadConfigDir(PEFile* pe, JsonWriter& writer);
+        static void SerializeSecurityDir(PEFile* pe, JsonWriter& writer, DWORD passes = ALL_PASSES);
+    };
+
+}
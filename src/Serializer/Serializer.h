@@ -0,0 +1,4 @@
+#pragma once
+
+#include "JsonWriter.h"
+#include "PESerializer.h"
@@ -0,0 +1,78 @@
+#include "Simd.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(PEW_SIMD_X64)
+#include <cpuid.h>
+#endif
+
+namespace PewParser {
+
+#if defined(PEW_SIMD_X64)
+    static bool CpuHasAvx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        bool os_saves_ymm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6);
+
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && (info[1] & (1 << 5));
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    // SHA-1 / SHA-256 instructions, the kernels also use SSSE3 shuffles and SSE4.1 inserts
+    static bool CpuHasShaExtensions()
+    {
+        unsigned int leaf1[4] = {};
+        unsigned int leaf7[4] = {};
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        leaf1[2] = (unsigned int)info[2];
+        __cpuidex(info, 7, 0);
+        leaf7[1] = (unsigned int)info[1];
+#else
+        if (__get_cpuid_max(0, nullptr) < 7)
+            return false;
+
+        __get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+        __get_cpuid_count(7, 0, &leaf7[0], &leaf7[1], &leaf7[2], &leaf7[3]);
+#endif
+        bool has_ssse3 = leaf1[2] & (1 << 9);
+        bool has_sse41 = leaf1[2] & (1 << 19);
+        return has_ssse3 && has_sse41 && (leaf7[1] & (1 << 29));
+    }
+#endif
+
+    SimdIsa GetSimdIsa()
+    {
+#if defined(PEW_SIMD_X64)
+        static const SimdIsa isa = CpuHasAvx2() ? SimdIsa::AVX2 : SimdIsa::SSE2;
+        return isa;
+#else
+        return SimdIsa::SCALAR;
+#endif
+    }
+
+    bool HasShaExtensions()
+    {
+#if defined(PEW_SIMD_X64)
+        static const bool has_sha = CpuHasShaExtensions();
+        return has_sha;
+#else
+        return false;
+#endif
+    }
+
+}
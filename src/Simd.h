@@ -0,0 +1,34 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PEW_SIMD_X64
+#include <immintrin.h>
+#endif
+
+// Helpers are forced inline so AVX2 paths get VEX encoded copies instead of calling into legacy SSE code
+#if defined(__GNUC__) || defined(__clang__)
+#define PEW_TARGET_AVX2 __attribute__((target("avx2")))
+#define PEW_TARGET_SHA __attribute__((target("sha,ssse3,sse4.1")))
+#define PEW_FORCE_INLINE inline __attribute__((always_inline))
+#else
+#define PEW_TARGET_AVX2
+#define PEW_TARGET_SHA
+#define PEW_FORCE_INLINE __forceinline
+#endif
+
+namespace PewParser {
+
+    enum class SimdIsa
+    {
+        SCALAR = 0,
+        SSE2,
+        AVX2
+    };
+
+    // Widest implementation the CPU supports, picked once
+    SimdIsa GetSimdIsa();
+
+    // SHA-1 / SHA-256 instructions (SHA-NI), independent of the vector width
+    bool HasShaExtensions();
+
+}
@@ -2,8 +2,17 @@
 #include "Log.h"
 
 #include "Tables.h"
+#include "RsrcDumper.h"
 
+#include <Serializer/Serializer.h>
+#include <Authenticode.h>
+#include <FileHasher.h>
+
+#include <vector>
+#include <cstdio>
 #include <cstring>
+#include <thread>
+#include <algorithm>
 
 namespace PewParser {
 
@@ -21,12 +30,12 @@ namespace PewParser {
         return lower;
     }
 
-    static std::string GetTrancatedStr(size_t max_size, const std::string& str)
+    static std::string GetTrancatedStr(size_t max_size, std::string_view str)
     {
         if(str.length() > max_size)
             return std::string(str.substr(0, max_size));
 
-        return str;
+        return std::string(str);
     }
 
     Commands::Commands(PEFile* pe)
@@ -45,16 +54,26 @@ namespace PewParser {
         else if (lower == "exportdir")       return Command::EXPORT_DIR;
         else if (lower == "exports")         return Command::EXPORTS;
         else if (lower == "imports")         return Command::IMPORTS;
+        else if (lower == "delayimports")    return Command::DELAY_IMPORTS;
         else if (lower == "rsrc")            return Command::RSRC_DIR;
+        else if (lower == "rsrcdump")        return Command::RSRC_DUMP;
+        else if (lower == "version")         return Command::VERSION_INFO;
         else if (lower == "boundimports")    return Command::BOUND_IMPORTS;
         else if (lower == "debug")           return Command::DEBUG_DIR;
+        else if (lower == "relocs")          return Command::RELOCS;
+        else if (lower == "exceptions")      return Command::EXCEPTIONS;
+        else if (lower == "tls")             return Command::TLS;
+        else if (lower == "loadconfig")      return Command::LOAD_CONFIG;
+        else if (lower == "security")        return Command::SECURITY;
+        else if (lower == "hashes")          return Command::HASHES;
+        else if (lower == "json")            return Command::JSON;
         else                                 return Command::INVALID;
     }
 
     void Commands::PrintDosHdr()
     {
         DosHdrWrapper* dos_hdr_wrapper = loaded_pe_->GetDosHdrWrapper();
-        IMAGE_DOS_HEADER* dos_hdr = dos_hdr_wrapper->GetDosHdr();
+        const IMAGE_DOS_HEADER* dos_hdr = dos_hdr_wrapper->GetDosHdr();
 
         std::stringstream Res;
         std::stringstream Res2;
@@ -137,6 +156,12 @@ namespace PewParser {
         OptionalHdrWrapper* optional_hdr_wrapper = loaded_pe_->GetOptionalHdrWrapper();
         OptHdrType opt_hdr_type = optional_hdr_wrapper->GetOptionalHdrType();
 
+        DWORD computed_checksum = optional_hdr_wrapper->ComputeChecksum();
+        bool checksum_mismatch = (optional_hdr_wrapper->VerifyChecksum(computed_checksum) == OptionalHdrWrapper::ChecksumCheck::MISMATCH);
+
+        char checksum_description[OPTIONAL_HDR_DESCRIPTION_W];
+        snprintf(checksum_description, sizeof(checksum_description), checksum_mismatch ? "Mismatch, computed %08X" : "Computed %08X", computed_checksum);
+
         std::cout << std::left << std::uppercase << std::hex << "\n";
         DisplayTable<kOptionalHdrTable.size()>(kOptionalHdrTable);
 
@@ -218,12 +243,17 @@ namespace PewParser {
 
             if (optional_hdr_wrapper->IsFieldDescribed())
                 std::cout << optional_hdr_wrapper->GetFieldDescription();
+            else if (field == OptionalHdrWrapper::Fields::CHECKSUM)
+                std::cout << checksum_description;
 
             std::cout << "" << Logger::ResetColor() << std::endl;
 
             optional_hdr_wrapper->LoadNextField();
         }
         optional_hdr_wrapper->Reset();
+
+        if (checksum_mismatch)
+            PEW_WARN("CheckSum does not match the file\n");
     }
 
     void Commands::PrintSecHdrs()
@@ -242,6 +272,12 @@ namespace PewParser {
                 char sec_name[IMAGE_SIZEOF_SHORT_NAME + 1] = { 0 };
                 std::memcpy(sec_name, section_hdr->Name, IMAGE_SIZEOF_SHORT_NAME);
 
+                // The stream is in hex mode, the entropies are formatted separately
+                char entropy[SECTION_HDRS_ENTROPY_W];
+                char window_entropy[SECTION_HDRS_WINDOW_ENTROPY_W];
+                snprintf(entropy, sizeof(entropy), "%.3f", section_hdrs_wrapper->GetSectionEntropy(i));
+                snprintf(window_entropy, sizeof(window_entropy), "%.3f", section_hdrs_wrapper->GetSectionMaxWindowEntropy(i));
+
                 std::cout << " " << Logger::CustomBgColor((i % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD) << Logger::TextColor(Logger::Color::BLACK);
                 std::cout << std::setw(SECTION_HDRS_NAME_W) << sec_name;
                 std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(SECTION_HDRS_R_ADDR_W) << section_hdr->PointerToRawData << Logger::TextColor(Logger::Color::BLACK);
@@ -252,7 +288,8 @@ namespace PewParser {
                 std::cout << std::setw(SECTION_HDRS_REL_PTR_W) << section_hdr->PointerToRelocations;
                 std::cout << std::setw(SECTION_HDRS_LNUM_PTR_W) << section_hdr->PointerToLinenumbers;
                 std::cout << std::setw(SECTION_HDRS_NUM_OF_REL_W) << section_hdr->NumberOfRelocations;
-                std::cout << std::setw(SECTION_HDRS_NUM_OF_LNUM_W) << section_hdr->NumberOfLinenumbers << Logger::ResetColor() << std::endl;
+                std::cout << std::setw(SECTION_HDRS_NUM_OF_LNUM_W) << section_hdr->NumberOfLinenumbers;
+                std::cout << std::setw(SECTION_HDRS_ENTROPY_W) << entropy << std::setw(SECTION_HDRS_WINDOW_ENTROPY_W) << window_entropy << Logger::ResetColor() << std::endl;
                 section_hdr++;
             }
             std::cout << std::endl;
@@ -263,7 +300,7 @@ namespace PewParser {
 
     void Commands::PrintExportDir()
     {
-        ExportDirWrapper* export_dir_wrapper = (ExportDirWrapper*)loaded_pe_->GetDataDirEntryWrapper(DataDirEntries::EXP);
+        ExportDirWrapper* export_dir_wrapper = loaded_pe_->GetExportDirWrapper();
 
         if (export_dir_wrapper)
         {
@@ -309,7 +346,7 @@ namespace PewParser {
 
     void Commands::PrintExports()
     {
-        ExportDirWrapper* export_dir_wrapper = (ExportDirWrapper*)loaded_pe_->GetDataDirEntryWrapper(DataDirEntries::EXP);
+        ExportDirWrapper* export_dir_wrapper = loaded_pe_->GetExportDirWrapper();
 
         if (export_dir_wrapper)
         {
@@ -358,26 +395,31 @@ namespace PewParser {
 
     void Commands::PrintImports()
     {
-        ImportDirWrapper* import_dir_wrapper = (ImportDirWrapper*)loaded_pe_->GetDataDirEntryWrapper(DataDirEntries::IMP);
+        ImportDirWrapper* import_dir_wrapper = loaded_pe_->GetImportDirWrapper();
 
         if (import_dir_wrapper)
         {
             if (import_dir_wrapper->IsValidWrapper())
             {
-                std::cout << "\n Imports [" << std::dec << import_dir_wrapper->GetLiberiresCount() << " entiries]" << std::endl;
+                const ImportTable& import_table = import_dir_wrapper->GetImportTable();
+                size_t libraries_count = import_table.GetLibrariesCount();
+
+                std::cout << "\n Imports [" << std::dec << libraries_count << " entiries]" << std::endl;
 
                 std::cout << std::left << std::uppercase << std::hex << "\n";
                 DisplayTable<kImportsTable.size()>(kImportsTable);
 
-                for (size_t i = 0; i < import_dir_wrapper->GetLiberiresCount(); i++)
+                for (size_t i = 0; i < libraries_count; i++)
                 {
+                    std::string_view library_name = import_table.library_names[i];
+
                     std::cout << " " << Logger::CustomBgColor((i % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
                     std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(OFFSET_W) << import_dir_wrapper->GetFieldOffset() << Logger::TextColor(Logger::Color::BLACK);
-                    std::cout << std::setw(IMPORT_DIR_FUNCTIONSCOUNT_W) << std::dec << import_dir_wrapper->GetFuncCount(i) << std::hex;
-                    if(import_dir_wrapper->GetLibraryName(i).size() > IMPORT_DIR_NAME_W - 3)
-                        std::cout << std::setw(IMPORT_DIR_NAME_W - 3) << GetTrancatedStr(IMPORT_DIR_NAME_W - 3, import_dir_wrapper->GetLibraryName(i)) << Logger::CustomTextColor(Logger::CustomPEColors::LONG_STR_DOTS) << std::setw(3) << "..." << Logger::TextColor(Logger::Color::BLACK);
+                    std::cout << std::setw(IMPORT_DIR_FUNCTIONSCOUNT_W) << std::dec << import_table.GetFuncCount(i) << std::hex;
+                    if(library_name.size() > IMPORT_DIR_NAME_W - 3)
+                        std::cout << std::setw(IMPORT_DIR_NAME_W - 3) << GetTrancatedStr(IMPORT_DIR_NAME_W - 3, library_name) << Logger::CustomTextColor(Logger::CustomPEColors::LONG_STR_DOTS) << std::setw(3) << "..." << Logger::TextColor(Logger::Color::BLACK);
                     else
-                        std::cout << std::setw(IMPORT_DIR_NAME_W) << import_dir_wrapper->GetLibraryName(i);
+                        std::cout << std::setw(IMPORT_DIR_NAME_W) << library_name;
 
                     std::cout << Logger::ResetColor() << std::endl;
                         
@@ -385,6 +427,9 @@ namespace PewParser {
                 }
                 import_dir_wrapper->Reset();
 
+                if (import_table.is_truncated)
+                    PEW_WARN("Import table is truncated (shared lookup tables or too many entries)\n");
+
                 std::cout << std::endl;
             }
             else
@@ -394,9 +439,54 @@ namespace PewParser {
             std::cerr << "PE has no Import Directory" << std::endl;
     }
 
+    void Commands::PrintDelayImports()
+    {
+        DelayImportDirWrapper* delay_import_dir_wrapper = loaded_pe_->GetDelayImportDirWrapper();
+
+        if (delay_import_dir_wrapper)
+        {
+            if (delay_import_dir_wrapper->IsValidWrapper())
+            {
+                const ImportTable& import_table = delay_import_dir_wrapper->GetImportTable();
+                size_t libraries_count = import_table.GetLibrariesCount();
+
+                std::cout << "\n Delay Imports [" << std::dec << libraries_count << " entiries]" << std::endl;
+
+                std::cout << std::left << std::uppercase << std::hex << "\n";
+                DisplayTable<kDelayImportsTable.size()>(kDelayImportsTable);
+
+                for (size_t i = 0; i < libraries_count; i++)
+                {
+                    std::string_view library_name = import_table.library_names[i];
+                    offset_t descriptor_offset = delay_import_dir_wrapper->GetRootDescriptorOffset() + i * delay_import_dir_wrapper->GetDescriptorSize();
+
+                    std::cout << " " << Logger::CustomBgColor((i % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
+                    std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(OFFSET_W) << descriptor_offset << Logger::TextColor(Logger::Color::BLACK);
+                    std::cout << std::setw(IMPORT_DIR_FUNCTIONSCOUNT_W) << std::dec << import_table.GetFuncCount(i) << std::hex;
+                    std::cout << std::setw(DELAY_IMPORT_ADDRESSING_W) << (delay_import_dir_wrapper->IsRvaBased(i) ? "RVA" : "VA");
+                    if(library_name.size() > IMPORT_DIR_NAME_W - 3)
+                        std::cout << std::setw(IMPORT_DIR_NAME_W - 3) << GetTrancatedStr(IMPORT_DIR_NAME_W - 3, library_name) << Logger::CustomTextColor(Logger::CustomPEColors::LONG_STR_DOTS) << std::setw(3) << "..." << Logger::TextColor(Logger::Color::BLACK);
+                    else
+                        std::cout << std::setw(IMPORT_DIR_NAME_W) << library_name;
+
+                    std::cout << Logger::ResetColor() << std::endl;
+                }
+
+                if (import_table.is_truncated)
+                    PEW_WARN("Delay import table is truncated (shared lookup tables or too many entries)\n");
+
+                std::cout << std::endl;
+            }
+            else
+                PEW_ERROR("Invalid Delay Import Directory\n");
+        }
+        else
+            PEW_ERROR("PE has no Delay Import Directory\n");
+    }
+
     void Commands::PrintBoundImportsDir()
     {
-        BoundImportDirWrapper* bound_import_dir_wrapper = (BoundImportDirWrapper*)loaded_pe_->GetDataDirEntryWrapper(DataDirEntries::BOUNDIMP);
+        BoundImportDirWrapper* bound_import_dir_wrapper = loaded_pe_->GetBoundImportDirWrapper();
 
         if (bound_import_dir_wrapper)
         {
@@ -447,7 +537,7 @@ namespace PewParser {
 
     void Commands::PrintRsrcDir()
     {
-        ResourceDirWrapper* rsrc_dir_wrapper = (ResourceDirWrapper*)loaded_pe_->GetDataDirEntryWrapper(DataDirEntries::RSRC);
+        ResourceDirWrapper* rsrc_dir_wrapper = loaded_pe_->GetResourceDirWrapper();
 
         if (rsrc_dir_wrapper)
         {
@@ -479,57 +569,77 @@ namespace PewParser {
                 }
                 rsrc_dir_wrapper->Reset();
 
-                if (rsrc_dir_wrapper->GetEntriesCount())
+                const RsrcTree& rsrc_tree = rsrc_dir_wrapper->GetRsrcTree();
+
+                if (rsrc_tree.root_entries_count)
                 {
                     DisplayTable<kRsrcDirEntriesTable.size()>(kRsrcDirEntriesTable);
 
-                    for (size_t entry = 0; entry < rsrc_dir_wrapper->GetEntriesCount(); entry++)
+                    // Depth first over the flattened tree, children are pushed in reverse to keep the directory order
+                    std::pmr::vector<index_t> pending(loaded_pe_->GetMemoryResource());
+                    for (index_t node = rsrc_tree.root_entries_count; node > 0; node--)
+                        pending.push_back(node - 1);
+
+                    std::string name;
+                    for (size_t row = 0; !pending.empty(); row++)
                     {
-                        std::cout << " " << Logger::CustomBgColor((entry % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
-                        if (rsrc_dir_wrapper->IsDirectory())
+                        const RsrcNode& node = rsrc_tree.nodes[pending.back()];
+                        pending.pop_back();
+
+                        for (DWORD child = node.children_count; child > 0; child--)
+                            pending.push_back(node.first_child + child - 1);
+
+                        std::string indent(std::min<size_t>((node.level - ResourceDirWrapper::TreeLevel::TYPE) * 2, RSRC_DIR_ENTRY_TYPE_W - 6), ' ');
+                        size_t type_w = RSRC_DIR_ENTRY_TYPE_W - 2 - indent.size();
+
+                        std::cout << " " << Logger::CustomBgColor((row % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
+                        std::cout << indent;
+                        if (node.is_directory)
                         {
                             std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RSRC_ENTRY_ARROW) << "> " << Logger::TextColor(Logger::Color::BLACK);
-                            if (rsrc_dir_wrapper->IsString())
-                                std::cout << std::setw(RSRC_DIR_ENTRY_TYPE_W - 2) << rsrc_dir_wrapper->GetName();
-                            else
+                            if (node.IsString())
                             {
-                                WORD rsrc_id = rsrc_dir_wrapper->GetId(); /// check user-defined
-
-                                std::cout << std::setw(RSRC_DIR_ENTRY_TYPE_W - 2) << rsrc_dir_wrapper->GetType();
+                                rsrc_dir_wrapper->GetNodeName(node, name);
+                                std::cout << std::setw(type_w) << GetTrancatedStr(type_w, name);
                             }
+                            else if (node.level == ResourceDirWrapper::TreeLevel::TYPE)
+                                std::cout << std::setw(type_w) << ResourceDirWrapper::GetTypeName(node.GetId());
+                            else
+                                std::cout << std::setw(type_w) << node.GetId();
                         }
                         else
-                            std::cout << std::setw(RSRC_DIR_ENTRY_TYPE_W - 2) << rsrc_dir_wrapper->GetId();
+                            std::cout << std::setw(type_w) << node.GetId();
 
-                        if (rsrc_dir_wrapper->IsString())
+                        if (node.IsString())
                         {
                             std::stringstream ss;
-                            ss << "Name[" << entry << "]";
+                            ss << "Name[" << node.index << "]";
                             std::cout << std::setw(RSRC_DIR_ENTRY_ENTRIES_W) << ss.str();
-                            std::cout << std::setw(RSRC_DIR_ENTRY_NAME_ID_W) << rsrc_dir_wrapper->GetNameValue();
-                            std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(RSRC_DIR_ENTRY_OFFSET_W) << rsrc_dir_wrapper->GetNameOffset() << Logger::TextColor(Logger::Color::BLACK);
+                            std::cout << std::setw(RSRC_DIR_ENTRY_NAME_ID_W) << node.name;
+                            std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(RSRC_DIR_ENTRY_OFFSET_W) << node.name_offset << Logger::TextColor(Logger::Color::BLACK);
                         }
                         else
                         {
-                            WORD rsrc_id = rsrc_dir_wrapper->GetId();
-                            {
-                                std::stringstream ss;
-                                ss << "Id[" << entry << "]";
-                                std::cout << std::setw(RSRC_DIR_ENTRY_ENTRIES_W) << ss.str();
-                                std::cout << std::setw(RSRC_DIR_ENTRY_NAME_ID_W) << rsrc_id;
-                                std::cout << Logger::CustomBgColor(Logger::CustomPEColors::DISABLED_COLUMN) << std::setw(RSRC_DIR_ENTRY_OFFSET_W) << "" << Logger::CustomBgColor((entry % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
-                            }
+                            std::stringstream ss;
+                            ss << "Id[" << node.index << "]";
+                            std::cout << std::setw(RSRC_DIR_ENTRY_ENTRIES_W) << ss.str();
+                            std::cout << std::setw(RSRC_DIR_ENTRY_NAME_ID_W) << node.GetId();
+                            std::cout << Logger::CustomBgColor(Logger::CustomPEColors::DISABLED_COLUMN) << std::setw(RSRC_DIR_ENTRY_OFFSET_W) << "" << Logger::CustomBgColor((row % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
                         }
 
-                        std::cout << std::setw(RSRC_DIR_ENTRY_DIR_DATA_W) << rsrc_dir_wrapper->GetDataValue();
-                        std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(RSRC_DIR_ENTRY_OFFSET_W) << rsrc_dir_wrapper->GetDataOffset() << Logger::TextColor(Logger::Color::BLACK);
-                        std::cout << std::setw(RSRC_DIR_ENTRY_ENTRIES_COUNT_W) << std::dec << rsrc_dir_wrapper->GetEntriesCount(entry) << std::hex;
+                        std::cout << std::setw(RSRC_DIR_ENTRY_DIR_DATA_W) << node.offset_to_data;
+                        std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(RSRC_DIR_ENTRY_OFFSET_W) << node.data_offset << Logger::TextColor(Logger::Color::BLACK);
+                        std::cout << std::setw(RSRC_DIR_ENTRY_ENTRIES_COUNT_W) << std::dec << node.children_count << std::hex;
 
                         std::cout << Logger::ResetColor() << std::endl;
-
-                        rsrc_dir_wrapper->LoadNextEntry();
                     }
-                    rsrc_dir_wrapper->ClearEntry();
+
+                    if (rsrc_tree.revisits_count)
+                        PEW_WARN("Rsrc dirs linked twice: %zu\n", rsrc_tree.revisits_count);
+                    if (rsrc_tree.overlaps_count)
+                        PEW_WARN("Rsrc dirs overlapping others: %zu\n", rsrc_tree.overlaps_count);
+                    if (rsrc_tree.truncated_count)
+                        PEW_WARN("Rsrc dirs nested deeper than %u levels or past the entries budget: %zu\n", (unsigned)RsrcTree::kMaxLevel, rsrc_tree.truncated_count);
 
                     std::cout << std::endl;
                 }
@@ -541,9 +651,61 @@ namespace PewParser {
             PEW_ERROR("PE has no Resource Directory\n");
     }
 
+    void Commands::PrintVersionInfo()
+    {
+        ResourceDirWrapper* rsrc_dir_wrapper = loaded_pe_->GetResourceDirWrapper();
+        const VersionInfo* version_info = (rsrc_dir_wrapper && rsrc_dir_wrapper->IsValidWrapper()) ? rsrc_dir_wrapper->GetVersionInfo() : nullptr;
+
+        if (!version_info)
+        {
+            PEW_ERROR("PE has no Version Info\n");
+            return;
+        }
+
+        size_t row = 0;
+        auto print_row = [&row](std::string_view name, std::string_view value) {
+            std::cout << " " << Logger::CustomBgColor((row++ % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD) << Logger::TextColor(Logger::Color::BLACK);
+            std::cout << std::setw(VERSION_INFO_NAME_W) << GetTrancatedStr(VERSION_INFO_NAME_W - 1, name);
+            std::cout << std::setw(VERSION_INFO_VALUE_W) << GetTrancatedStr(VERSION_INFO_VALUE_W - 1, value);
+            std::cout << Logger::ResetColor() << std::endl;
+        };
+
+        auto hex = [](DWORD value, int width) {
+            std::stringstream stream;
+            stream << std::uppercase << std::hex << std::setfill('0') << std::setw(width) << value;
+            return stream.str();
+        };
+
+        std::cout << std::left << std::uppercase << std::hex << "\n";
+        DisplayTable<kVersionInfoTable.size()>(kVersionInfoTable);
+
+        if (version_info->has_fixed_info)
+        {
+            const VS_FIXEDFILEINFO& fixed_info = version_info->fixed_info;
+            print_row("FileVersion", version_info->GetFileVersion());
+            print_row("ProductVersion", version_info->GetProductVersion());
+            print_row("FileFlags", hex(fixed_info.dwFileFlags & fixed_info.dwFileFlagsMask, 8));
+            print_row("FileOS", hex(fixed_info.dwFileOS, 8));
+            print_row("FileType", hex(fixed_info.dwFileType, 8));
+        }
+
+        for (DWORD translation : version_info->translations)
+            print_row("Translation", hex(translation & 0xFFFF, 4) + " " + hex(translation >> 16, 4));
+
+        for (const VersionInfo::StringTable& table : version_info->string_tables)
+        {
+            print_row("[" + std::string(version_info->GetTableKey(table)) + "]", "");
+
+            for (index_t string = table.first_string; string < table.first_string + table.strings_count; string++)
+                print_row("  " + std::string(version_info->GetKey(version_info->strings[string])), version_info->GetValue(version_info->strings[string]));
+        }
+
+        std::cout << std::endl;
+    }
+
     void Commands::PrintDebugDir()
     {
-        DebugDirWrapper* debug_dir_wrapper = (DebugDirWrapper*)loaded_pe_->GetDataDirEntryWrapper(DataDirEntries::DBG);
+        DebugDirWrapper* debug_dir_wrapper = loaded_pe_->GetDebugDirWrapper();
 
         if (debug_dir_wrapper)
         {
@@ -589,6 +751,357 @@ namespace PewParser {
             PEW_ERROR("PE has no Debug Directory\n");
     }
 
+    void Commands::PrintRelocs()
+    {
+        RelocDirWrapper* reloc_dir_wrapper = loaded_pe_->GetRelocDirWrapper();
+
+        if (reloc_dir_wrapper)
+        {
+            if (reloc_dir_wrapper->IsValidWrapper())
+            {
+                const RelocTable& reloc_table = reloc_dir_wrapper->GetRelocTable();
+
+                std::cout << std::left << std::uppercase << std::hex << "\n";
+                DisplayTable<kRelocBlocksTable.size()>(kRelocBlocksTable);
+
+                for (size_t block = 0; block < reloc_table.GetBlocksCount(); block++)
+                {
+                    std::cout << " " << Logger::CustomBgColor((block % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
+                    std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(OFFSET_W) << reloc_table.block_offsets[block] << Logger::TextColor(Logger::Color::BLACK);
+                    std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RVA) << std::setw(RELOC_BLOCK_PAGE_W) << reloc_table.page_rvas[block] << Logger::TextColor(Logger::Color::BLACK);
+                    std::cout << std::setw(RELOC_BLOCK_ENTRIES_W) << std::dec << reloc_table.GetEntriesCount(block) << std::hex;
+                    std::cout << Logger::ResetColor() << std::endl;
+                }
+
+                std::cout << std::dec << "\n Blocks: " << reloc_table.GetBlocksCount() << ", fixups: " << reloc_table.GetFixupsCount()
+                    << ", per page: " << std::fixed << std::setprecision(2) << reloc_dir_wrapper->GetDensity() << std::defaultfloat << "\n";
+
+                for (size_t type = 0; type < reloc_table.type_counts.size(); type++)
+                {
+                    if (reloc_table.type_counts[type])
+                        std::cout << "  " << std::setw(RELOC_TYPE_NAME_W) << RelocDirWrapper::GetTypeName((BYTE)type) << reloc_table.type_counts[type] << "\n";
+                }
+                std::cout << std::hex;
+
+                if (!reloc_table.is_chain_valid)
+                    PEW_WARN("Reloc block chain is broken\n");
+
+                std::cout << std::endl;
+            }
+            else
+                PEW_ERROR("Invalid Reloc Directory\n");
+        }
+        else
+            PEW_ERROR("PE has no Reloc Directory\n");
+    }
+
+    void Commands::PrintExceptions()
+    {
+        ExceptionDirWrapper* exception_dir_wrapper = loaded_pe_->GetExceptionDirWrapper();
+
+        if (exception_dir_wrapper)
+        {
+            if (exception_dir_wrapper->IsValidWrapper())
+            {
+                std::cout << std::left << std::uppercase << std::hex << "\n";
+                DisplayTable<kExceptionDirTable.size()>(kExceptionDirTable);
+
+                UnwindInfo unwind_info;
+                for (size_t function = 0; function < exception_dir_wrapper->GetFunctionsCount(); function++)
+                {
+                    const IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY& entry = exception_dir_wrapper->GetFunction(function);
+                    bool has_unwind_info = exception_dir_wrapper->GetUnwindInfo(function, unwind_info);
+
+                    std::cout << " " << Logger::CustomBgColor((function % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
+                    std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RVA) << std::setw(EXCEPTION_DIR_RVA_W) << entry.BeginAddress;
+                    std::cout << std::setw(EXCEPTION_DIR_RVA_W) << entry.EndAddress;
+                    std::cout << std::setw(EXCEPTION_DIR_RVA_W) << entry.UnwindInfoAddress << Logger::TextColor(Logger::Color::BLACK);
+
+                    if (has_unwind_info)
+                    {
+                        std::cout << std::setw(EXCEPTION_DIR_FLAGS_W) << (DWORD)unwind_info.flags;
+                        std::cout << std::setw(EXCEPTION_DIR_PROLOG_W) << (DWORD)unwind_info.prolog_size;
+                        std::cout << std::setw(EXCEPTION_DIR_CODES_W) << (DWORD)unwind_info.codes_count;
+                    }
+                    else
+                        std::cout << std::setw(EXCEPTION_DIR_FLAGS_W + EXCEPTION_DIR_PROLOG_W + EXCEPTION_DIR_CODES_W) << "-";
+
+                    std::cout << Logger::ResetColor() << std::endl;
+                }
+
+                std::cout << std::dec << "\n Functions: " << exception_dir_wrapper->GetFunctionsCount() << " of " << exception_dir_wrapper->GetEntriesCount() << " entries" << std::hex << "\n";
+
+                if (!exception_dir_wrapper->IsInPlace())
+                    PEW_WARN("Function table is not sorted\n");
+
+                std::cout << std::endl;
+            }
+            else
+                PEW_ERROR("Invalid Exception Directory\n");
+        }
+        else
+            PEW_ERROR("PE has no Exception Directory\n");
+    }
+
+    void Commands::PrintTlsDir()
+    {
+        TlsDirWrapper* tls_dir_wrapper = loaded_pe_->GetTlsDirWrapper();
+
+        if (tls_dir_wrapper)
+        {
+            if (tls_dir_wrapper->IsValidWrapper())
+            {
+                size_t row = 0;
+                auto print_row = [&row](std::string_view name, ULONGLONG value, offset_t raw) {
+                    std::cout << " " << Logger::CustomBgColor((row++ % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD) << Logger::TextColor(Logger::Color::BLACK);
+                    std::cout << std::setw(TLS_DIR_NAME_W) << name << std::setw(TLS_DIR_VALUE_W) << value;
+                    std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(OFFSET_W);
+                    if (raw)
+                        std::cout << raw;
+                    else
+                        std::cout << "-";
+                    std::cout << Logger::ResetColor() << std::endl;
+                };
+
+                std::cout << std::left << std::uppercase << std::hex << "\n";
+                DisplayTable<kTlsDirTable.size()>(kTlsDirTable);
+
+                print_row("StartAddressOfRawData", tls_dir_wrapper->GetStartAddressOfRawData(), tls_dir_wrapper->GetRawDataOffset());
+                print_row("EndAddressOfRawData", tls_dir_wrapper->GetEndAddressOfRawData(), 0);
+                print_row("AddressOfIndex", tls_dir_wrapper->GetAddressOfIndex(), loaded_pe_->VaToRaw(tls_dir_wrapper->GetAddressOfIndex()));
+                print_row("AddressOfCallBacks", tls_dir_wrapper->GetAddressOfCallBacks(), tls_dir_wrapper->GetCallbacksOffset());
+                print_row("SizeOfZeroFill", tls_dir_wrapper->GetSizeOfZeroFill(), 0);
+                print_row("Characteristics", tls_dir_wrapper->GetCharacteristics(), 0);
+
+                const auto& callbacks = tls_dir_wrapper->GetCallbacks();
+                std::cout << std::dec << "\n Callbacks: " << callbacks.size() << ", template data: " << tls_dir_wrapper->GetRawDataSize() << " bytes" << std::hex << "\n";
+
+                for (size_t callback = 0; callback < callbacks.size(); callback++)
+                    print_row("Callback #" + std::to_string(callback), callbacks[callback], loaded_pe_->VaToRaw(callbacks[callback]));
+
+                if (!tls_dir_wrapper->IsCallbacksTerminated() && tls_dir_wrapper->GetCallbacksOffset())
+                    PEW_WARN("TLS callbacks are not terminated\n");
+                if (tls_dir_wrapper->IsRawDataTruncated())
+                    PEW_WARN("TLS template data is truncated\n");
+
+                std::cout << std::endl;
+            }
+            else
+                PEW_ERROR("Invalid TLS Directory\n");
+        }
+        else
+            PEW_ERROR("PE has no TLS Directory\n");
+    }
+
+    void Commands::PrintLoadConfigDir()
+    {
+        LoadConfigDirWrapper* load_config_dir_wrapper = loaded_pe_->GetLoadConfigDirWrapper();
+
+        if (load_config_dir_wrapper)
+        {
+            if (load_config_dir_wrapper->IsValidWrapper())
+            {
+                size_t row = 0;
+                auto begin_row = [&row]() {
+                    std::cout << " " << Logger::CustomBgColor((row++ % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD) << Logger::TextColor(Logger::Color::BLACK);
+                };
+                auto end_row = [](offset_t raw) {
+                    std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(OFFSET_W);
+                    if (raw)
+                        std::cout << raw;
+                    else
+                        std::cout << "-";
+                    std::cout << Logger::ResetColor() << std::endl;
+                };
+                auto print_row = [&](std::string_view name, ULONGLONG value, offset_t raw) {
+                    begin_row();
+                    std::cout << std::setw(LOAD_CONFIG_NAME_W) << name << std::setw(LOAD_CONFIG_VALUE_W) << value;
+                    end_row(raw);
+                };
+
+                std::cout << std::left << std::uppercase << std::hex << "\n";
+                DisplayTable<kLoadConfigDirTable.size()>(kLoadConfigDirTable);
+
+                print_row("Size", load_config_dir_wrapper->GetDeclaredSize(), load_config_dir_wrapper->GetLoadConfigDirOffset());
+                print_row("TimeDateStamp", load_config_dir_wrapper->GetTimeDateStamp(), 0);
+                print_row("SecurityCookie", load_config_dir_wrapper->GetSecurityCookie(), loaded_pe_->VaToRaw(load_config_dir_wrapper->GetSecurityCookie()));
+                print_row("GuardCFCheckFunctionPointer", load_config_dir_wrapper->GetGuardCFCheckFunctionPointer(), loaded_pe_->VaToRaw(load_config_dir_wrapper->GetGuardCFCheckFunctionPointer()));
+                print_row("GuardCFDispatchFunctionPointer", load_config_dir_wrapper->GetGuardCFDispatchFunctionPointer(), loaded_pe_->VaToRaw(load_config_dir_wrapper->GetGuardCFDispatchFunctionPointer()));
+                print_row("GuardFlags", load_config_dir_wrapper->GetGuardFlags(), 0);
+                print_row("CHPEMetadataPointer", load_config_dir_wrapper->GetChpeMetadataPointer(), load_config_dir_wrapper->GetChpeMetadataOffset());
+                print_row("DynamicValueRelocTable", load_config_dir_wrapper->GetDynamicRelocVersion(), load_config_dir_wrapper->GetDynamicRelocTableOffset());
+
+                std::cout << "\n";
+                DisplayTable<kLoadConfigTablesTable.size()>(kLoadConfigTablesTable);
+
+                std::cout << std::dec;
+                for (size_t table = 0; table < LoadConfigDirWrapper::TABLES_COUNT; table++)
+                {
+                    const LoadConfigTable& entries = load_config_dir_wrapper->GetTable((LoadConfigDirWrapper::Tables)table);
+
+                    begin_row();
+                    std::cout << std::setw(LOAD_CONFIG_NAME_W) << LoadConfigDirWrapper::GetTableName((LoadConfigDirWrapper::Tables)table);
+                    std::cout << std::setw(LOAD_CONFIG_ENTRIES_W) << entries.count << std::setw(LOAD_CONFIG_STRIDE_W) << entries.stride << std::hex;
+                    end_row(entries.raw);
+                    std::cout << std::dec;
+                }
+
+                std::cout << "\n Dynamic relocations: " << load_config_dir_wrapper->GetDynamicRelocations().size() << std::hex << "\n";
+
+                if (load_config_dir_wrapper->IsTruncated())
+                    PEW_WARN("Load config directory is truncated\n");
+                for (size_t table = 0; table < LoadConfigDirWrapper::TABLES_COUNT; table++)
+                {
+                    if (load_config_dir_wrapper->GetTable((LoadConfigDirWrapper::Tables)table).is_truncated)
+                        PEW_WARN("%s is truncated\n", LoadConfigDirWrapper::GetTableName((LoadConfigDirWrapper::Tables)table).data());
+                }
+                if (load_config_dir_wrapper->GetDynamicRelocTableOffset() && !load_config_dir_wrapper->IsDynamicRelocTableValid())
+                    PEW_WARN("Unknown dynamic relocation table version\n");
+
+                std::cout << std::endl;
+            }
+            else
+                PEW_ERROR("Invalid Load Config Directory\n");
+        }
+        else
+            PEW_ERROR("PE has no Load Config Directory\n");
+    }
+
+    void Commands::PrintSecurityDir()
+    {
+        SecurityDirWrapper* security_dir_wrapper = loaded_pe_->GetSecurityDirWrapper();
+
+        if (security_dir_wrapper)
+        {
+            if (security_dir_wrapper->IsValidWrapper())
+            {
+                const auto& certificates = security_dir_wrapper->GetCertificates();
+
+                std::cout << "\n Certificate Table [" << std::dec << certificates.size() << " certificates]" << std::endl;
+
+                std::cout << std::left << std::uppercase << std::hex << "\n";
+                DisplayTable<kSecurityDirTable.size()>(kSecurityDirTable);
+
+                std::pmr::vector<Digest> signed_digests(loaded_pe_->GetMemoryResource());
+                for (size_t i = 0; i < certificates.size(); i++)
+                {
+                    Digest signed_digest;
+                    bool is_signed = SecurityDirWrapper::GetSignedDigest(certificates[i], signed_digest);
+                    if (is_signed && signed_digest.algorithm != DigestAlgorithm::UNKNOWN)
+                        signed_digests.push_back(signed_digest);
+
+                    std::cout << " " << Logger::CustomBgColor((i % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD);
+                    std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(OFFSET_W) << certificates[i].offset << Logger::TextColor(Logger::Color::BLACK);
+                    std::cout << std::setw(SECURITY_LENGTH_W) << certificates[i].length;
+                    std::cout << std::setw(SECURITY_REVISION_W) << SecurityDirWrapper::GetRevisionName(certificates[i].revision);
+                    std::cout << std::setw(SECURITY_TYPE_W) << SecurityDirWrapper::GetTypeName(certificates[i].type);
+                    std::cout << std::setw(SECURITY_DIGEST_W) << (is_signed ? GetDigestAlgorithmName(signed_digest.algorithm) : "-");
+                    std::cout << Logger::ResetColor() << std::endl;
+                }
+
+                // Every signed algorithm is computed in the same pass over the image
+                std::pmr::vector<Digest> image_digests(signed_digests.size(), loaded_pe_->GetMemoryResource());
+                for (size_t i = 0; i < signed_digests.size(); i++)
+                    image_digests[i].algorithm = signed_digests[i].algorithm;
+
+                if (!image_digests.empty())
+                    AuthenticodeHasher(loaded_pe_).Compute(image_digests.data(), image_digests.size());
+
+                for (size_t i = 0; i < signed_digests.size(); i++)
+                {
+                    std::cout << "\n " << GetDigestAlgorithmName(signed_digests[i].algorithm) << " signed: " << signed_digests[i].ToHex();
+                    std::cout << "\n " << GetDigestAlgorithmName(signed_digests[i].algorithm) << " image:  " << image_digests[i].ToHex() << "\n";
+
+                    if (image_digests[i] != signed_digests[i])
+                        PEW_WARN("Image digest does not match the signed digest\n");
+                }
+
+                if (security_dir_wrapper->IsTruncated())
+                    PEW_WARN("Certificate table is truncated\n");
+
+                std::cout << std::endl;
+            }
+            else
+                PEW_ERROR("Invalid Security Directory\n");
+        }
+        else
+            PEW_ERROR("PE has no Security Directory\n");
+    }
+
+    void Commands::PrintHashes()
+    {
+        FileHasher hasher(loaded_pe_);
+
+        Digest digests[3];
+        digests[0].algorithm = DigestAlgorithm::MD5;
+        digests[1].algorithm = DigestAlgorithm::SHA1;
+        digests[2].algorithm = DigestAlgorithm::SHA256;
+
+        // Nothing else runs in the terminal, big files may take every core for their sections
+        std::pmr::vector<Digest> section_digests(hasher.GetSectionsCount(), loaded_pe_->GetMemoryResource());
+        hasher.Compute(digests, 3, section_digests.data(), std::max(1u, std::thread::hardware_concurrency()));
+
+        std::cout << "\n";
+        for (const Digest& digest : digests)
+            std::cout << " " << std::left << std::setw(HASHES_NAME_W) << GetDigestAlgorithmName(digest.algorithm) << digest.ToHex() << "\n";
+
+        if (!section_digests.empty())
+        {
+            std::cout << std::left << std::uppercase << std::hex << "\n";
+            DisplayTable<kHashesTable.size()>(kHashesTable);
+
+            SectionHdrsWrapper* section_hdrs_wrapper = loaded_pe_->GetSectionHdrsWrapper();
+            for (size_t i = 0; i < section_digests.size(); i++)
+            {
+                std::cout << " " << Logger::CustomBgColor((i % 2 == 0) ? Logger::CustomPEColors::COLUMN_EVEN : Logger::CustomPEColors::COLUMN_ODD) << Logger::TextColor(Logger::Color::BLACK);
+                std::cout << std::setw(SECTION_HDRS_NAME_W) << section_hdrs_wrapper->GetSectionName(i);
+                std::cout << Logger::CustomTextColor(Logger::CustomPEColors::RAW) << std::setw(OFFSET_W) << (section_hdrs_wrapper->GetRootSectionHdr() + i)->PointerToRawData << Logger::TextColor(Logger::Color::BLACK);
+                std::cout << std::setw(HASHES_SIZE_W) << hasher.GetSection(i).size();
+                std::cout << std::setw(HASHES_DIGEST_W) << section_digests[i].ToHex() << Logger::ResetColor() << std::endl;
+            }
+        }
+
+        std::cout << std::endl;
+    }
+
+    void Commands::PrintJson()
+    {
+        JsonWriter writer;
+
+        writer.BeginObject();
+        writer.Key("path");
+        writer.String(loaded_pe_->GetRawFile().Path().u8string());
+        PESerializer::SerializePE(loaded_pe_, writer);
+        writer.EndObject();
+        writer.EndRecord();
+
+        std::cout.write(writer.View().data(), writer.View().size());
+        std::cout.flush();
+    }
+
+    void Commands::DumpRsrc(const std::filesystem::path& out_dir)
+    {
+        ResourceDirWrapper* rsrc_dir_wrapper = loaded_pe_->GetResourceDirWrapper();
+        if (!rsrc_dir_wrapper || !rsrc_dir_wrapper->IsValidWrapper())
+        {
+            PEW_ERROR("PE has no Resource Directory\n");
+            return;
+        }
+
+        RsrcDumper dumper(loaded_pe_);
+        RsrcDumper::Stats stats = dumper.Dump(out_dir);
+
+        std::cout << std::dec << "\n Dumped " << stats.dumped_count << " / " << stats.payloads_count << " resources, "
+            << stats.bytes_count << " bytes to " << out_dir.u8string() << std::hex << "\n";
+
+        if (stats.truncated_count)
+            PEW_WARN("%zu payloads cut by end of file\n", stats.truncated_count);
+        if (stats.failed_count)
+            PEW_ERROR("%zu payloads not written\n", stats.failed_count);
+
+        std::cout << std::endl;
+    }
+
     void Commands::Listen()
     {
         listening_ = true;
@@ -609,9 +1122,19 @@ namespace PewParser {
                 case Command::EXPORT_DIR:       PrintExportDir();          break;
                 case Command::EXPORTS:          PrintExports();            break;
                 case Command::IMPORTS:          PrintImports();            break;
+                case Command::DELAY_IMPORTS:    PrintDelayImports();       break;
                 case Command::RSRC_DIR:         PrintRsrcDir();            break;
+                case Command::VERSION_INFO:     PrintVersionInfo();        break;
+                case Command::RSRC_DUMP:        DumpRsrc(loaded_pe_->GetRawFile().Name() + ".rsrc");    break;
                 case Command::DEBUG_DIR:        PrintDebugDir();           break;
                 case Command::BOUND_IMPORTS:    PrintBoundImportsDir();    break;
+                case Command::RELOCS:           PrintRelocs();             break;
+                case Command::EXCEPTIONS:       PrintExceptions();         break;
+                case Command::TLS:              PrintTlsDir();             break;
+                case Command::LOAD_CONFIG:      PrintLoadConfigDir();      break;
+                case Command::SECURITY:         PrintSecurityDir();        break;
+                case Command::HASHES:           PrintHashes();             break;
+                case Command::JSON:             PrintJson();               break;
                 default:
                     PEW_ERROR("Invalid Command\n");
             }
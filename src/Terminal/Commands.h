@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <iostream>
+#include <filesystem>
 
 #include <PEFile.h>
 
@@ -15,7 +16,9 @@ namespace PewParser {
         {
             DOS_HDR = 0, FILE_HDR, OPT_HDR, SEC_HDRS,
             EXPORT_DIR, EXPORTS, IMPORTS,
-            RSRC_DIR, DEBUG_DIR, BOUND_IMPORTS,
+            RSRC_DIR, RSRC_DUMP, VERSION_INFO, DEBUG_DIR, BOUND_IMPORTS, RELOCS, EXCEPTIONS, TLS, LOAD_CONFIG, DELAY_IMPORTS, SECURITY,
+            HASHES,
+            JSON,
             INVALID
         };
     public:
@@ -29,9 +32,23 @@ namespace PewParser {
         void PrintExportDir();
         void PrintExports();
         void PrintImports();
+        void PrintDelayImports();
         void PrintRsrcDir();
+        void PrintVersionInfo();
         void PrintDebugDir();
         void PrintBoundImportsDir();
+        void PrintRelocs();
+        void PrintExceptions();
+        void PrintTlsDir();
+        void PrintLoadConfigDir();
+        void PrintSecurityDir();
+
+        void PrintHashes();
+
+        void PrintJson();
+
+        // Every resource payload to its own file under out_dir
+        void DumpRsrc(const std::filesystem::path& out_dir);
 
         Command ParseCommands(const std::string& cmd);
 
@@ -145,9 +145,9 @@ namespace PewParser {
         template<typename... Args>
         static void Log(const char* prefix, Color color, const char* fmt, Args&&... args)
         {
-            char fmt_buffer[64] = {};
+            char fmt_buffer[256] = {};
 
-            sprintf(fmt_buffer, "%s[%s] %s %s%s", TextColor(color), GetTime().c_str(), prefix, fmt, ResetColor());
+            snprintf(fmt_buffer, sizeof(fmt_buffer), "%s[%s] %s %s%s", TextColor(color), GetTime().c_str(), prefix, fmt, ResetColor());
             printf(fmt_buffer, std::forward<Args&&>(args)...);
         }
 
@@ -2,11 +2,151 @@
 
 #include "Platform.h"
 #include "Terminal.h"
+#include "Scanner.h"
+#include "Commands.h"
+
+#include <fstream>
+
+static int PewScan(int argc, arg_t* argv[])
+{
+    using namespace PewParser;
+
+    std::filesystem::path root(argv[2]);
+    size_t threads_count = 0;
+    Scanner::OutputFormat format = Scanner::OutputFormat::TSV;
+    DWORD passes = PESerializer::ALL_PASSES;
+    size_t hash_threads_count = 0;
+
+    for (int i = 3; i < argc; i++)
+    {
+        std::string arg = std::filesystem::path(argv[i]).u8string();
+
+        if (arg == "--ndjson")
+            format = Scanner::OutputFormat::NDJSON;
+        else if (arg == "--no-entropy")
+            passes &= ~PESerializer::ENTROPY_PASS;
+        else if (arg == "--no-checksum")
+            passes &= ~PESerializer::CHECKSUM_PASS;
+        else if (arg == "--no-authenticode")
+            passes &= ~PESerializer::AUTHENTICODE_PASS;
+        else if (arg == "--no-hashes")
+            passes &= ~PESerializer::HASHES_PASS;
+        else if (arg == "--triage")
+            passes = 0;
+        else if (arg == "--hash-threads" && i + 1 < argc)
+            hash_threads_count = std::strtoul(std::filesystem::path(argv[++i]).u8string().c_str(), nullptr, 10);
+        else
+            threads_count = std::strtoul(arg.c_str(), nullptr, 10);
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    Scanner scanner(root, threads_count, format, passes, hash_threads_count);
+    scanner.Run(std::cout);
+
+    return 0;
+}
+
+static int PewRsrcDump(int argc, arg_t* argv[])
+{
+    using namespace PewParser;
+
+    std::filesystem::path filepath(argv[2]);
+    std::filesystem::path out_dir = (argc > 3) ? std::filesystem::path(argv[3]) : std::filesystem::path(filepath.filename().u8string() + ".rsrc");
+
+    RawFile raw_file = LoadFile(filepath);
+    if (!raw_file)
+    {
+        PEW_ERROR("Failed to load file\n");
+        return 1;
+    }
+
+    PEType pe_type = PEParser::ValidatePE(raw_file);
+    if (pe_type == PEType::NotPE || pe_type == PEType::Corrupted)
+    {
+        PEW_ERROR("File is not a valid PE\n");
+        raw_file.Delete();
+        return 1;
+    }
+
+    PEFile* pe = PEParser::MakePE(raw_file, pe_type);
+    Commands commands(pe);
+    commands.DumpRsrc(out_dir);
+    delete pe;
+
+    return 0;
+}
+
+static int PewRebase(int argc, arg_t* argv[])
+{
+    using namespace PewParser;
+
+    std::filesystem::path filepath(argv[2]);
+    ULONGLONG image_base = std::strtoull(std::filesystem::path(argv[3]).u8string().c_str(), nullptr, 16);
+    std::filesystem::path out_path = (argc > 4) ? std::filesystem::path(argv[4]) : std::filesystem::path(filepath.filename().u8string() + ".mapped");
+
+    RawFile raw_file = LoadFile(filepath);
+    if (!raw_file)
+    {
+        PEW_ERROR("Failed to load file\n");
+        return 1;
+    }
+
+    PEType pe_type = PEParser::ValidatePE(raw_file);
+    if (pe_type == PEType::NotPE || pe_type == PEType::Corrupted)
+    {
+        PEW_ERROR("File is not a valid PE\n");
+        raw_file.Delete();
+        return 1;
+    }
+
+    PEFile* pe = PEParser::MakePE(raw_file, pe_type);
+    int result = 1;
+
+    ImageMapper mapper;
+    {
+        ImageMapper::MappedImage mapped = mapper.Map(pe, image_base);
+
+        if (!mapped)
+            PEW_ERROR("SizeOfImage is 0 or too big\n");
+        else
+        {
+            std::ofstream out(out_path, std::ios::binary);
+            out.write((const char*)mapped.GetImage().data(), mapped.GetImage().size());
+
+            if (!out)
+                PEW_ERROR("Failed to write image\n");
+            else
+            {
+                const ImageMapper::Stats& stats = mapped.GetStats();
+                std::cout << std::dec << "\n Mapped " << stats.sections_count << " sections, " << stats.fixups_applied << " fixups applied, "
+                    << stats.fixups_skipped << " skipped, " << mapped.GetImage().size() << " bytes to " << out_path.u8string() << "\n" << std::endl;
+
+                if (!stats.rebased)
+                    PEW_WARN("No relocs, base not applied\n");
+
+                result = 0;
+            }
+        }
+    }
+
+    delete pe;
+    return result;
+}
 
 int PewMain(int argc, arg_t* argv[])
 {
     using namespace PewParser;
 
+    if (argc > 2 && std::filesystem::path(argv[1]) == "scan")
+        return PewScan(argc, argv);
+
+    if (argc > 2 && std::filesystem::path(argv[1]) == "rsrcdump")
+        return PewRsrcDump(argc, argv);
+
+    if (argc > 3 && std::filesystem::path(argv[1]) == "rebase")
+        return PewRebase(argc, argv);
+
     Terminal terminal;
 
     if (argc > 1)
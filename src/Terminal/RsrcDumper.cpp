@@ -0,0 +1,197 @@
+#include "RsrcDumper.h"
+
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+namespace PewParser {
+
+    static std::string SanitizeFilename(const std::string& name)
+    {
+        std::string sanitized;
+
+        for (char c : name)
+        {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.')
+                sanitized += c;
+            else
+                sanitized += '_';
+        }
+
+        return sanitized.empty() ? "_" : sanitized;
+    }
+
+    static std::string NodeComponent(ResourceDirWrapper* rsrc_dir_wrapper, DWORD node_index, bool is_type)
+    {
+        if (node_index == RsrcNode::kNoParent)
+            return "-";
+
+        const RsrcNode& node = rsrc_dir_wrapper->GetRsrcTree().nodes[node_index];
+        if (node.IsString())
+            return SanitizeFilename(rsrc_dir_wrapper->GetNodeName(node));
+
+        if (is_type)
+        {
+            std::string_view type_name = ResourceDirWrapper::GetTypeName(node.GetId());
+            if (type_name != ResourceDirWrapper::GetTypeName(0))
+                return SanitizeFilename(std::string(type_name));
+        }
+
+        return std::to_string(node.GetId());
+    }
+
+#if !defined(_WIN32)
+    static bool WriteAll(int fd, const BYTE* data, size_t size)
+    {
+        while (size)
+        {
+            ssize_t written = write(fd, data, size);
+            if (written <= 0)
+                return false;
+
+            data += written;
+            size -= written;
+        }
+
+        return true;
+    }
+#endif
+
+    RsrcDumper::RsrcDumper(PEFile* pe)
+        : pe_(pe)
+    {
+    }
+
+    std::string RsrcDumper::GetPayloadFilename(ResourceDirWrapper* rsrc_dir_wrapper, index_t index, const RsrcPayload& payload)
+    {
+        return std::to_string(index) + "_" + NodeComponent(rsrc_dir_wrapper, payload.type_node, true) + "_" +
+            NodeComponent(rsrc_dir_wrapper, payload.name_node, false) + "_" + NodeComponent(rsrc_dir_wrapper, payload.lang_node, false) + ".bin";
+    }
+
+    RsrcDumper::Stats RsrcDumper::Dump(const std::filesystem::path& out_dir)
+    {
+        Stats stats;
+
+        ResourceDirWrapper* rsrc_dir_wrapper = pe_->GetResourceDirWrapper();
+        if (!rsrc_dir_wrapper || !rsrc_dir_wrapper->IsValidWrapper())
+            return stats;
+
+        const std::pmr::vector<RsrcPayload>& payloads = rsrc_dir_wrapper->GetPayloads();
+        stats.payloads_count = payloads.size();
+
+        std::error_code ec;
+        std::filesystem::create_directories(out_dir, ec);
+        if (ec)
+        {
+            stats.failed_count = payloads.size();
+            return stats;
+        }
+
+        // The source file is only used when it still matches what was parsed
+        int src_fd = -1;
+#if !defined(_WIN32)
+        const RawFile& raw_file = pe_->GetRawFile();
+        if (raw_file.GetBacking() != RawFile::Backing::BORROWED && !raw_file.Path().empty())
+        {
+            src_fd = open(raw_file.Path().c_str(), O_RDONLY);
+
+            struct stat st;
+            if (src_fd != -1 && (fstat(src_fd, &st) != 0 || (uintmax_t)st.st_size != raw_file.Size()))
+            {
+                close(src_fd);
+                src_fd = -1;
+            }
+        }
+#endif
+
+        for (index_t index = 0; index < payloads.size(); index++)
+        {
+            const RsrcPayload& payload = payloads[index];
+
+            // Nothing to write when the rva is not backed by the file
+            if (!payload.raw && payload.size)
+            {
+                stats.failed_count++;
+                continue;
+            }
+
+            if (!WritePayload(src_fd, payload, out_dir / GetPayloadFilename(rsrc_dir_wrapper, index, payload)))
+            {
+                stats.failed_count++;
+                continue;
+            }
+
+            stats.dumped_count++;
+            stats.bytes_count += payload.data.size();
+            if (payload.IsTruncated())
+                stats.truncated_count++;
+        }
+
+#if !defined(_WIN32)
+        if (src_fd != -1)
+            close(src_fd);
+#endif
+
+        return stats;
+    }
+
+    bool RsrcDumper::WritePayload(int src_fd, const RsrcPayload& payload, const std::filesystem::path& dst)
+    {
+#if defined(_WIN32)
+        std::ofstream file(dst, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        file.write((const char*)payload.data.data(), payload.data.size());
+        return file.good();
+#else
+        int dst_fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (dst_fd == -1)
+            return false;
+
+        size_t remaining = payload.data.size();
+
+#if defined(__linux__)
+        if (src_fd != -1)
+        {
+            // Same filesystem copies can be reflinks, copy_file_range fails with EXDEV / EINVAL / ENOSYS on older
+            // kernels or across filesystems and sendfile picks up where it stopped
+            loff_t src_offset = payload.raw;
+            while (remaining)
+            {
+                ssize_t copied = copy_file_range(src_fd, &src_offset, dst_fd, nullptr, remaining, 0);
+                if (copied <= 0)
+                    break;
+
+                remaining -= copied;
+            }
+
+            off_t send_offset = src_offset;
+            while (remaining)
+            {
+                ssize_t sent = sendfile(dst_fd, src_fd, &send_offset, remaining);
+                if (sent <= 0)
+                    break;
+
+                remaining -= sent;
+            }
+        }
+#endif
+
+        // Rest of the payload from the loaded image
+        bool written = WriteAll(dst_fd, payload.data.data() + (payload.data.size() - remaining), remaining);
+        close(dst_fd);
+
+        return written;
+#endif
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <PEFile.h>
+
+#include <string>
+#include <filesystem>
+
+namespace PewParser {
+
+    // Writes every resource payload of a PE to its own file.
+    // Payloads are copied from the source file inside the kernel (copy_file_range, then sendfile) when the PE was
+    // loaded from disk, the mapped bytes are only written through userspace as a fallback.
+    class RsrcDumper
+    {
+    public:
+        struct Stats
+        {
+            size_t payloads_count = 0;
+            size_t dumped_count = 0;
+            size_t truncated_count = 0;     // payloads cut by the end of the file, the part inside the file is written
+            size_t failed_count = 0;
+            uintmax_t bytes_count = 0;
+        };
+    public:
+        RsrcDumper(PEFile* pe);
+
+        // Files are named <index>_<type>_<name>_<lang>.bin
+        Stats Dump(const std::filesystem::path& out_dir);
+
+        static std::string GetPayloadFilename(ResourceDirWrapper* rsrc_dir_wrapper, index_t index, const RsrcPayload& payload);
+    private:
+        bool WritePayload(int src_fd, const RsrcPayload& payload, const std::filesystem::path& dst);
+    private:
+        PEFile* pe_;
+    };
+
+}
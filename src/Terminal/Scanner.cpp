@@ -0,0 +1,414 @@
+#include "Scanner.h"
+
+#include <PEParser.h>
+#include <Helper.h>
+#include <FileHasher.h>
+
+#include <thread>
+#include <algorithm>
+#include <cinttypes>
+
+namespace PewParser {
+
+    static std::string_view StatusName(Scanner::Status status)
+    {
+        switch (status)
+        {
+            case Scanner::Status::OK:             return "ok";
+            case Scanner::Status::LOAD_FAILED:    return "load-failed";
+            case Scanner::Status::NOT_PE:         return "not-pe";
+            case Scanner::Status::CORRUPTED:      return "corrupted";
+            case Scanner::Status::FAILED:         return "error";
+            default:                              return "unknown";
+        }
+    }
+
+    static std::string_view TypeName(PEType type)
+    {
+        switch (type)
+        {
+            case PEType::x32PE:    return "PE32";
+            case PEType::x64PE:    return "PE32+";
+            default:               return "-";
+        }
+    }
+
+    static constexpr const char* kRecordHeader = "#path\tstatus\ttype\tsize\tmachine\tsubsystem\ttimestamp\tsections\tlibraries\timports\texports\trsrc_entries\tbound_imports\tdebug\ttls\ttls_callbacks\ttls_data_offset\ttls_data_size\tdelay_libraries\tdelay_imports\tcertificates\tauthenticode\tchecksum\tmax_entropy\tmd5\tsha1\tsha256\n";
+
+    static void BeginJsonRecord(JsonWriter& writer, const std::filesystem::path& filepath, Scanner::Status status)
+    {
+        writer.BeginObject();
+        writer.Key("path");
+        writer.String(filepath.u8string());
+        writer.Key("status");
+        writer.String(StatusName(status));
+    }
+
+    static void WriteJsonHashes(JsonWriter& writer, const Scanner::Record& record)
+    {
+        writer.Key("hashes");
+        writer.BeginObject();
+        writer.Key("md5");       writer.String(record.md5.ToHex());
+        writer.Key("sha1");      writer.String(record.sha1.ToHex());
+        writer.Key("sha256");    writer.String(record.sha256.ToHex());
+
+        writer.Key("sections_sha256");
+        writer.BeginArray();
+        for (const Digest& digest : record.sections_sha256)
+            writer.String(digest.ToHex());
+        writer.EndArray();
+        writer.EndObject();
+    }
+
+    static void EndJsonRecord(JsonWriter& writer)
+    {
+        writer.EndObject();
+        writer.EndRecord();
+    }
+
+    Scanner::Scanner(const std::filesystem::path& root, size_t threads_count, OutputFormat format, DWORD passes, size_t hash_threads_count)
+        : root_(root), threads_count_(threads_count), format_(format), passes_(passes), hash_threads_count_(hash_threads_count), next_line_(0), out_(nullptr)
+    {
+        if (!threads_count_)
+            threads_count_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    void Scanner::CollectFiles()
+    {
+        files_.clear();
+
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(root_, ec))
+        {
+            files_.push_back(root_);
+            return;
+        }
+
+        auto options = std::filesystem::directory_options::skip_permission_denied;
+        for (std::filesystem::recursive_directory_iterator it(root_, options, ec), end; it != end; it.increment(ec))
+        {
+            if (ec)
+                break;
+
+            if (it->is_regular_file(ec))
+                files_.push_back(it->path());
+        }
+    }
+
+    size_t Scanner::Run(std::ostream& out)
+    {
+        CollectFiles();
+
+        out_ = &out;
+        if (format_ == OutputFormat::TSV)
+            *out_ << kRecordHeader;
+        next_line_ = 0;
+        pending_lines_.assign(files_.size(), std::string());
+        ready_lines_.assign(files_.size(), false);
+
+        size_t workers_count = std::min(threads_count_, std::max<size_t>(files_.size(), 1));
+        // Fewer files than threads leaves threads over, each worker gets its share of them for the section hashes
+        size_t hash_threads_count = hash_threads_count_ ? hash_threads_count_ : std::max<size_t>(threads_count_ / workers_count, 1);
+
+        // Deal the files round-robin so all workers advance through neighbouring indices,
+        // which keeps the reorder window of the ordered sink small
+        queues_.clear();
+        for (size_t i = 0; i < workers_count; i++)
+            queues_.push_back(std::make_unique<TaskQueue>());
+
+        for (index_t task = 0; task < files_.size(); task++)
+            queues_[task % workers_count]->tasks.push_back(task);
+
+        std::vector<std::thread> workers;
+        workers.reserve(workers_count);
+        for (index_t i = 0; i < workers_count; i++)
+            workers.emplace_back(&Scanner::Worker, this, i, hash_threads_count);
+
+        for (auto& worker : workers)
+            worker.join();
+
+        out.flush();
+        out_ = nullptr;
+
+        return files_.size();
+    }
+
+    bool Scanner::PopTask(index_t worker_index, index_t& task)
+    {
+        {
+            TaskQueue& own = *queues_[worker_index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = own.tasks.front();
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        // Own queue is drained, steal from the back of the others
+        for (size_t i = 1; i < queues_.size(); i++)
+        {
+            TaskQueue& victim = *queues_[(worker_index + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Scanner::Worker(index_t worker_index, size_t hash_threads_count)
+    {
+        JsonWriter writer;
+        Arena arena;
+
+        index_t task = 0;
+        std::string line;
+        while (PopTask(worker_index, task))
+        {
+            const std::filesystem::path& filepath = files_[task];
+
+            try
+            {
+                if (format_ == OutputFormat::NDJSON)
+                {
+                    writer.Clear();
+                    ScanFile(filepath, &writer, &arena, passes_, hash_threads_count);
+                }
+                else
+                    line = FormatRecord(filepath, ScanFile(filepath, nullptr, &arena, passes_, hash_threads_count));
+            }
+            catch (...)
+            {
+                // One hostile file must not end the scan, its line still goes out so the ordered sink keeps moving
+                arena.Reset();
+
+                Record record;
+                record.status = Status::FAILED;
+                if (format_ == OutputFormat::NDJSON)
+                {
+                    writer.Clear();
+                    BeginJsonRecord(writer, filepath, record.status);
+                    EndJsonRecord(writer);
+                }
+                else
+                    line = FormatRecord(filepath, record);
+            }
+
+            Submit(task, (format_ == OutputFormat::NDJSON) ? writer.View() : std::string_view(line));
+        }
+    }
+
+    void Scanner::Submit(index_t task, std::string_view line)
+    {
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+
+        // In order results go straight to the sink, only out of order ones are copied aside
+        if (task == next_line_)
+        {
+            out_->write(line.data(), line.size());
+            next_line_++;
+        }
+        else
+        {
+            pending_lines_[task] = line;
+            ready_lines_[task] = true;
+        }
+
+        while (next_line_ < ready_lines_.size() && ready_lines_[next_line_])
+        {
+            *out_ << pending_lines_[next_line_];
+            std::string().swap(pending_lines_[next_line_]);
+            next_line_++;
+        }
+    }
+
+    Scanner::Record Scanner::ScanFile(const std::filesystem::path& filepath, JsonWriter* writer, Arena* arena, DWORD passes, size_t hash_threads_count)
+    {
+        Record record;
+        record.passes = passes;
+
+        RawFile raw_file = LoadFile(filepath);
+        if (!raw_file)
+        {
+            if (writer)
+            {
+                BeginJsonRecord(*writer, filepath, record.status);
+                EndJsonRecord(*writer);
+            }
+            return record;
+        }
+
+        record.file_size = raw_file.Size();
+        record.type = PEParser::ValidatePE(raw_file);
+
+        if (record.type == PEType::NotPE || record.type == PEType::Corrupted)
+        {
+            record.status = (record.type == PEType::NotPE) ? Status::NOT_PE : Status::CORRUPTED;
+            raw_file.Delete();
+
+            if (writer)
+            {
+                BeginJsonRecord(*writer, filepath, record.status);
+                EndJsonRecord(*writer);
+            }
+            return record;
+        }
+
+        {
+            PEFile pe(raw_file, record.type, arena);
+            ExtractRecord(&pe, record, writer != nullptr, hash_threads_count);
+            record.status = Status::OK;
+
+            if (writer)
+            {
+                BeginJsonRecord(*writer, filepath, record.status);
+                PESerializer::SerializePE(&pe, *writer, passes);
+                if (passes & PESerializer::HASHES_PASS)
+                    WriteJsonHashes(*writer, record);
+                EndJsonRecord(*writer);
+            }
+        }
+
+        if (arena)
+            arena->Reset();
+
+        return record;
+    }
+
+    void Scanner::ExtractRecord(PEFile* pe, Record& record, bool hash_sections, size_t hash_threads_count)
+    {
+        IMAGE_FILE_HEADER* file_hdr = pe->GetFileHdrWrapper()->GetFileHdr();
+        record.machine = file_hdr->Machine;
+        record.timestamp = file_hdr->TimeDateStamp;
+        record.sections_count = pe->GetNumOfSections();
+
+        if (record.passes & PESerializer::ENTROPY_PASS)
+        {
+            SectionHdrsWrapper* section_hdrs_wrapper = pe->GetSectionHdrsWrapper();
+            for (index_t section = 0; section < section_hdrs_wrapper->GetNumOfSections(); section++)
+                record.max_section_entropy = std::max(record.max_section_entropy, section_hdrs_wrapper->GetSectionEntropy(section));
+        }
+
+        OptionalHdrWrapper* optional_hdr_wrapper = pe->GetOptionalHdrWrapper();
+        if (optional_hdr_wrapper->GetOptionalHdrType() == OptHdrType::x32)
+            record.subsystem = ((IMAGE_OPTIONAL_HEADER32*)optional_hdr_wrapper->GetOptionalHdr())->Subsystem;
+        else
+            record.subsystem = ((IMAGE_OPTIONAL_HEADER64*)optional_hdr_wrapper->GetOptionalHdr())->Subsystem;
+        if (record.passes & PESerializer::CHECKSUM_PASS)
+            record.checksum_check = optional_hdr_wrapper->VerifyChecksum();
+
+        ImportDirWrapper* import_dir_wrapper = pe->GetImportDirWrapper();
+        if (import_dir_wrapper && import_dir_wrapper->IsValidWrapper())
+        {
+            record.libraries_count = import_dir_wrapper->GetImportTable().GetLibrariesCount();
+            record.imports_count = import_dir_wrapper->GetImportTable().GetTotalFuncCount();
+        }
+
+        DelayImportDirWrapper* delay_import_dir_wrapper = pe->GetDelayImportDirWrapper();
+        if (delay_import_dir_wrapper && delay_import_dir_wrapper->IsValidWrapper())
+        {
+            record.delay_libraries_count = delay_import_dir_wrapper->GetImportTable().GetLibrariesCount();
+            record.delay_imports_count = delay_import_dir_wrapper->GetImportTable().GetTotalFuncCount();
+        }
+
+        ExportDirWrapper* export_dir_wrapper = pe->GetExportDirWrapper();
+        if (export_dir_wrapper && export_dir_wrapper->IsValidWrapper())
+            record.exports_count = export_dir_wrapper->GetNumOfFunctions();
+
+        ResourceDirWrapper* rsrc_dir_wrapper = pe->GetResourceDirWrapper();
+        if (rsrc_dir_wrapper && rsrc_dir_wrapper->IsValidWrapper())
+            record.rsrc_entries_count = rsrc_dir_wrapper->GetEntriesCount();
+
+        BoundImportDirWrapper* bound_import_dir_wrapper = pe->GetBoundImportDirWrapper();
+        if (bound_import_dir_wrapper && bound_import_dir_wrapper->IsValidWrapper())
+            record.bound_imports_count = bound_import_dir_wrapper->GetLiberiresCount();
+
+        DebugDirWrapper* debug_dir_wrapper = pe->GetDebugDirWrapper();
+        record.has_debug_dir = (debug_dir_wrapper && debug_dir_wrapper->IsValidWrapper());
+
+        TlsDirWrapper* tls_dir_wrapper = pe->GetTlsDirWrapper();
+        if (tls_dir_wrapper && tls_dir_wrapper->IsValidWrapper())
+        {
+            record.has_tls_dir = true;
+            record.tls_callbacks_count = tls_dir_wrapper->GetCallbacks().size();
+            record.tls_raw_data_offset = tls_dir_wrapper->GetRawDataOffset();
+            record.tls_raw_data_size = tls_dir_wrapper->GetRawDataSize();
+        }
+
+        SecurityDirWrapper* security_dir_wrapper = pe->GetSecurityDirWrapper();
+        if (security_dir_wrapper && security_dir_wrapper->IsValidWrapper())
+        {
+            record.certificates_count = security_dir_wrapper->GetCertificatesCount();
+            if (record.passes & PESerializer::AUTHENTICODE_PASS)
+                record.digest_check = security_dir_wrapper->CheckImageDigest();
+        }
+
+        if (!(record.passes & PESerializer::HASHES_PASS))
+            return;
+
+        // Section hashes go to hash_threads_count threads when the file is big enough, see FileHasher::Compute
+        FileHasher file_hasher(pe);
+        Digest digests[3];
+        digests[0].algorithm = DigestAlgorithm::MD5;
+        digests[1].algorithm = DigestAlgorithm::SHA1;
+        digests[2].algorithm = DigestAlgorithm::SHA256;
+        if (hash_sections)
+            record.sections_sha256.resize(file_hasher.GetSectionsCount());
+
+        file_hasher.Compute(digests, 3, hash_sections ? record.sections_sha256.data() : nullptr, hash_threads_count);
+        record.md5 = digests[0];
+        record.sha1 = digests[1];
+        record.sha256 = digests[2];
+    }
+
+    std::string Scanner::FormatRecord(const std::filesystem::path& filepath, const Record& record)
+    {
+        std::string line = filepath.u8string();
+        line += '\t';
+        line += StatusName(record.status);
+
+        if (record.status != Status::OK)
+        {
+            line += '\n';
+            return line;
+        }
+
+        char max_entropy[32] = "-";
+        if (record.passes & PESerializer::ENTROPY_PASS)
+            snprintf(max_entropy, sizeof(max_entropy), "%.3f", record.max_section_entropy);
+
+        std::string_view digest_check = (record.passes & PESerializer::AUTHENTICODE_PASS) ? SecurityDirWrapper::GetDigestCheckName(record.digest_check) : "-";
+        std::string_view checksum_check = (record.passes & PESerializer::CHECKSUM_PASS) ? OptionalHdrWrapper::GetChecksumCheckName(record.checksum_check) : "-";
+
+        char fields[512] = { 0 };
+        snprintf(fields, sizeof(fields), "\t%s\t%" PRIuMAX "\t%X\t%u\t%X\t%zu\t%zu\t%zu\t%zu\t%zu\t%zu\t%d\t%d\t%zu\t%" PRIXMAX "\t%zu\t%zu\t%zu\t%zu\t%s\t%s\t%s",
+            TypeName(record.type).data(), record.file_size, record.machine, record.subsystem, record.timestamp,
+            record.sections_count, record.libraries_count, record.imports_count, record.exports_count,
+            record.rsrc_entries_count, record.bound_imports_count, record.has_debug_dir ? 1 : 0,
+            record.has_tls_dir ? 1 : 0, record.tls_callbacks_count, (uintmax_t)record.tls_raw_data_offset, record.tls_raw_data_size,
+            record.delay_libraries_count, record.delay_imports_count,
+            record.certificates_count, digest_check.data(), checksum_check.data(), max_entropy);
+
+        line += fields;
+        if (record.passes & PESerializer::HASHES_PASS)
+        {
+            line += '\t';
+            line += record.md5.ToHex();
+            line += '\t';
+            line += record.sha1.ToHex();
+            line += '\t';
+            line += record.sha256.ToHex();
+        }
+        else
+            line += "\t-\t-\t-";
+        line += '\n';
+        return line;
+    }
+
+}
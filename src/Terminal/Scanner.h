@@ -0,0 +1,117 @@
+#pragma once
+#include <PEFile.h>
+#include <Serializer/Serializer.h>
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <filesystem>
+
+namespace PewParser {
+
+    class Scanner
+    {
+    public:
+        enum class OutputFormat
+        {
+            TSV = 0,
+            NDJSON
+        };
+
+        enum class Status
+        {
+            OK = 0,
+            LOAD_FAILED,
+            NOT_PE,
+            CORRUPTED,
+            FAILED      // the parser threw on this file, the record holds nothing else
+        };
+
+        struct Record
+        {
+            Status status = Status::LOAD_FAILED;
+            PEType type = PEType::NotPE;
+            DWORD passes = PESerializer::ALL_PASSES;     // columns of the passes left out are written as "-"
+            uintmax_t file_size = 0;
+
+            WORD machine = 0;
+            WORD subsystem = 0;
+            DWORD timestamp = 0;
+            size_t sections_count = 0;
+            double max_section_entropy = 0.0;
+            OptionalHdrWrapper::ChecksumCheck checksum_check = OptionalHdrWrapper::ChecksumCheck::NOT_SET;
+
+            size_t libraries_count = 0;
+            size_t imports_count = 0;
+            size_t delay_libraries_count = 0;
+            size_t delay_imports_count = 0;
+            size_t exports_count = 0;
+            size_t rsrc_entries_count = 0;
+            size_t bound_imports_count = 0;
+            bool has_debug_dir = false;
+
+            bool has_tls_dir = false;
+            size_t tls_callbacks_count = 0;
+            offset_t tls_raw_data_offset = 0;
+            size_t tls_raw_data_size = 0;
+
+            size_t certificates_count = 0;
+            SecurityDirWrapper::DigestCheck digest_check = SecurityDirWrapper::DigestCheck::NOT_SIGNED;
+
+            Digest md5;
+            Digest sha1;
+            Digest sha256;
+            // Only filled for NDJSON records, the TSV line has no room for it
+            std::vector<Digest> sections_sha256;
+        };
+    public:
+        // passes selects the full file passes of every record, PESerializer::Passes flags. hash_threads_count is the
+        // number of threads hashing the sections of one big file, 0 hands it the threads the scan workers leave idle.
+        Scanner(const std::filesystem::path& root, size_t threads_count, OutputFormat format = OutputFormat::TSV, DWORD passes = PESerializer::ALL_PASSES,
+            size_t hash_threads_count = 0);
+
+        // Scans every regular file under root and writes one record per file to out, in directory walk order
+        size_t Run(std::ostream& out);
+
+        size_t GetFilesCount() const { return files_.size(); }
+        size_t GetThreadsCount() const { return threads_count_; }
+        size_t GetHashThreadsCount() const { return hash_threads_count_; }
+
+        // When a writer is given the full NDJSON record of the file is appended to it,
+        // when an arena is given the parse state comes from it and it is reset before returning
+        static Record ScanFile(const std::filesystem::path& filepath, JsonWriter* writer = nullptr, Arena* arena = nullptr, DWORD passes = PESerializer::ALL_PASSES,
+            size_t hash_threads_count = 1);
+        static void ExtractRecord(PEFile* pe, Record& record, bool hash_sections = false, size_t hash_threads_count = 1);
+        static std::string FormatRecord(const std::filesystem::path& filepath, const Record& record);
+    private:
+        struct TaskQueue
+        {
+            std::mutex mutex;
+            std::deque<index_t> tasks;
+        };
+    private:
+        void CollectFiles();
+        void Worker(index_t worker_index, size_t hash_threads_count);
+        bool PopTask(index_t worker_index, index_t& task);
+        void Submit(index_t task, std::string_view line);
+    private:
+        std::filesystem::path root_;
+        size_t threads_count_;
+        OutputFormat format_;
+        DWORD passes_;
+        size_t hash_threads_count_;
+
+        std::vector<std::filesystem::path> files_;
+        std::vector<std::unique_ptr<TaskQueue>> queues_;
+
+        std::mutex sink_mutex_;
+        std::vector<std::string> pending_lines_;
+        std::vector<bool> ready_lines_;
+        index_t next_line_;
+        std::ostream* out_;
+    };
+
+}
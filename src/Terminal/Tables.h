@@ -52,7 +52,7 @@ namespace PewParser {
         {OPTIONAL_HDR_DESCRIPTION_W, "Size"}}
     };
 
-    constexpr std::array<TableRow, 10> kSectionHdrsTable =
+    constexpr std::array<TableRow, 12> kSectionHdrsTable =
     {
         {{SECTION_HDRS_NAME_W, "Name"},
         {SECTION_HDRS_R_ADDR_W, "RAW"},
@@ -63,7 +63,9 @@ namespace PewParser {
         {SECTION_HDRS_REL_PTR_W, "Reloc Ptr"},
         {SECTION_HDRS_LNUM_PTR_W, "Line Num Ptr"},
         {SECTION_HDRS_NUM_OF_REL_W, "Reloc Num"},
-        {SECTION_HDRS_NUM_OF_LNUM_W, "Line Nums"}}
+        {SECTION_HDRS_NUM_OF_LNUM_W, "Line Nums"},
+        {SECTION_HDRS_ENTROPY_W, "Entropy"},
+        {SECTION_HDRS_WINDOW_ENTROPY_W, "Max Window"}}
     };
 
     constexpr std::array<TableRow, 4> kExportDirTable =
@@ -87,6 +89,14 @@ namespace PewParser {
         {IMPORT_DIR_FUNCTIONSCOUNT_W, "Func Count"},
         {IMPORT_DIR_NAME_W, "Name"}},
     };
+
+    constexpr std::array<TableRow, 4> kDelayImportsTable =
+    {
+        {{OFFSET_W, "Offset"},
+        {IMPORT_DIR_FUNCTIONSCOUNT_W, "Func Count"},
+        {DELAY_IMPORT_ADDRESSING_W, "Fields"},
+        {IMPORT_DIR_NAME_W, "Name"}},
+    };
 /*
 constexpr std::array<TableRow, 6> kExportsTableFull =
 {
@@ -141,6 +151,68 @@ constexpr std::array<TableRow, 9> kImportsTableFull =
         {RSRC_DIR_ENTRY_ENTRIES_COUNT_W, "Entries Count"}}
     };
 
+    constexpr std::array<TableRow, 2> kVersionInfoTable =
+    {
+        {{VERSION_INFO_NAME_W, "Name"},
+        {VERSION_INFO_VALUE_W, "Value"}}
+    };
+
+    constexpr std::array<TableRow, 3> kRelocBlocksTable =
+    {
+        {{OFFSET_W, "Offset"},
+        {RELOC_BLOCK_PAGE_W, "Page RVA"},
+        {RELOC_BLOCK_ENTRIES_W, "Entries"}}
+    };
+
+    constexpr std::array<TableRow, 6> kExceptionDirTable =
+    {
+        {{EXCEPTION_DIR_RVA_W, "Begin"},
+        {EXCEPTION_DIR_RVA_W, "End"},
+        {EXCEPTION_DIR_RVA_W, "Unwind Info"},
+        {EXCEPTION_DIR_FLAGS_W, "Flags"},
+        {EXCEPTION_DIR_PROLOG_W, "Prolog"},
+        {EXCEPTION_DIR_CODES_W, "Codes"}}
+    };
+
+    constexpr std::array<TableRow, 3> kTlsDirTable =
+    {
+        {{TLS_DIR_NAME_W, "Name"},
+        {TLS_DIR_VALUE_W, "Value"},
+        {OFFSET_W, "Offset"}}
+    };
+
+    constexpr std::array<TableRow, 3> kLoadConfigDirTable =
+    {
+        {{LOAD_CONFIG_NAME_W, "Name"},
+        {LOAD_CONFIG_VALUE_W, "Value"},
+        {OFFSET_W, "Offset"}}
+    };
+
+    constexpr std::array<TableRow, 4> kLoadConfigTablesTable =
+    {
+        {{LOAD_CONFIG_NAME_W, "Table"},
+        {LOAD_CONFIG_ENTRIES_W, "Entries"},
+        {LOAD_CONFIG_STRIDE_W, "Stride"},
+        {OFFSET_W, "Offset"}}
+    };
+
+    constexpr std::array<TableRow, 5> kSecurityDirTable =
+    {
+        {{OFFSET_W, "Offset"},
+        {SECURITY_LENGTH_W, "Length"},
+        {SECURITY_REVISION_W, "Revision"},
+        {SECURITY_TYPE_W, "Type"},
+        {SECURITY_DIGEST_W, "Digest"}}
+    };
+
+    constexpr std::array<TableRow, 4> kHashesTable =
+    {
+        {{SECTION_HDRS_NAME_W, "Name"},
+        {OFFSET_W, "RAW"},
+        {HASHES_SIZE_W, "RAW Size"},
+        {HASHES_DIGEST_W, "SHA-256"}}
+    };
+
     constexpr std::array<TableRow, 4> kDebugDirTable =
     {
         {{OFFSET_W, "Offset"},
@@ -23,6 +23,8 @@
 #define SECTION_HDRS_LNUM_PTR_W 14
 #define SECTION_HDRS_NUM_OF_REL_W 11
 #define SECTION_HDRS_NUM_OF_LNUM_W 11
+#define SECTION_HDRS_ENTROPY_W 9
+#define SECTION_HDRS_WINDOW_ENTROPY_W 12
 
 #define EXPORT_DIR_NAME_W 23
 #define EXPORT_DIR_VALUE_W 10
@@ -41,6 +43,8 @@
 #define IMPORT_DIR_FORWARDER_W 10
 #define IMPORT_DIR_OFT_NAMERVA_FT_W 10
 
+#define DELAY_IMPORT_ADDRESSING_W 8
+
 #define BOUND_IMPORT_OFFSET_W 8
 #define BOUND_IMPORT_NAME_W 20
 #define BOUND_IMPORT_TIMEDATESTAMP_W 15
@@ -61,3 +65,32 @@
 #define RSRC_DIR_ENTRY_OFFSET_W 10
 #define RSRC_DIR_ENTRY_DIR_DATA_W 16
 #define RSRC_DIR_ENTRY_ENTRIES_COUNT_W 15
+
+#define VERSION_INFO_NAME_W 24
+#define VERSION_INFO_VALUE_W 60
+
+#define RELOC_BLOCK_PAGE_W 10
+#define RELOC_BLOCK_ENTRIES_W 10
+#define RELOC_TYPE_NAME_W 20
+
+#define EXCEPTION_DIR_RVA_W 12
+#define EXCEPTION_DIR_FLAGS_W 6
+#define EXCEPTION_DIR_PROLOG_W 8
+#define EXCEPTION_DIR_CODES_W 6
+
+#define TLS_DIR_NAME_W 24
+#define TLS_DIR_VALUE_W 20
+
+#define LOAD_CONFIG_NAME_W 32
+#define LOAD_CONFIG_VALUE_W 20
+#define LOAD_CONFIG_ENTRIES_W 10
+#define LOAD_CONFIG_STRIDE_W 8
+
+#define SECURITY_LENGTH_W 10
+#define SECURITY_REVISION_W 10
+#define SECURITY_TYPE_W 18
+#define SECURITY_DIGEST_W 10
+
+#define HASHES_NAME_W 9
+#define HASHES_SIZE_W 10
+#define HASHES_DIGEST_W 66
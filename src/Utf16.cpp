@@ -0,0 +1,241 @@
+#include "Utf16.h"
+
+#include <cstring>
+
+namespace PewParser {
+
+    static PEW_FORCE_INLINE WORD LoadUnit(const BYTE* src, size_t index)
+    {
+        WORD unit;
+        std::memcpy(&unit, src + index * sizeof(WORD), sizeof(WORD));
+        return unit;
+    }
+
+    // Converts the unit at index (and its low surrogate), returns how many units were consumed
+    static PEW_FORCE_INLINE size_t ScalarStep(const BYTE* src, size_t index, size_t len, char*& out, bool& valid)
+    {
+        uint32_t unit = LoadUnit(src, index);
+
+        if (unit < 0x80)
+        {
+            *out++ = (char)unit;
+            return 1;
+        }
+
+        if (unit < 0x800)
+        {
+            *out++ = (char)(0xC0 | (unit >> 6));
+            *out++ = (char)(0x80 | (unit & 0x3F));
+            return 1;
+        }
+
+        if (unit < 0xD800 || unit > 0xDFFF)
+        {
+            *out++ = (char)(0xE0 | (unit >> 12));
+            *out++ = (char)(0x80 | ((unit >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (unit & 0x3F));
+            return 1;
+        }
+
+        uint32_t next = (index + 1 < len) ? LoadUnit(src, index + 1) : 0;
+        if (unit <= 0xDBFF && next >= 0xDC00 && next <= 0xDFFF)
+        {
+            uint32_t code_point = 0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00);
+            *out++ = (char)(0xF0 | (code_point >> 18));
+            *out++ = (char)(0x80 | ((code_point >> 12) & 0x3F));
+            *out++ = (char)(0x80 | ((code_point >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (code_point & 0x3F));
+            return 2;
+        }
+
+        // Lone high or low surrogate
+        valid = false;
+        *out++ = (char)0xEF;
+        *out++ = (char)0xBF;
+        *out++ = (char)0xBD;
+        return 1;
+    }
+
+    static PEW_FORCE_INLINE size_t TranscodeScalar(const BYTE* src, size_t index, size_t len, char*& out, bool& valid)
+    {
+        while (index < len)
+            index += ScalarStep(src, index, len, out, valid);
+
+        return index;
+    }
+
+#if defined(PEW_SIMD_X64)
+    // Blocks of 8 units that are all 1 byte or all 2 byte sequences are converted in registers,
+    // anything else (mixed lengths, surrogates) goes through ScalarStep one block at a time
+    static PEW_FORCE_INLINE bool Sse2Block(__m128i in, char*& out)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i is_ascii = _mm_cmpeq_epi16(_mm_and_si128(in, _mm_set1_epi16((short)0xFF80)), zero);
+
+        int ascii_mask = _mm_movemask_epi8(is_ascii);
+        if (ascii_mask == 0xFFFF)
+        {
+            _mm_storel_epi64((__m128i*)out, _mm_packus_epi16(in, in));
+            out += 8;
+            return true;
+        }
+
+        __m128i below_800 = _mm_cmpeq_epi16(_mm_and_si128(in, _mm_set1_epi16((short)0xF800)), zero);
+        if (ascii_mask == 0 && _mm_movemask_epi8(below_800) == 0xFFFF)
+        {
+            // 110xxxxx 10xxxxxx, the lead byte goes first so it is the low byte of every 16 bit lane
+            __m128i lead = _mm_or_si128(_mm_srli_epi16(in, 6), _mm_set1_epi16(0xC0));
+            __m128i trail = _mm_or_si128(_mm_and_si128(in, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+            _mm_storeu_si128((__m128i*)out, _mm_or_si128(lead, _mm_slli_epi16(trail, 8)));
+            out += 16;
+            return true;
+        }
+
+        return false;
+    }
+
+    static size_t TranscodeSse2(const BYTE* src, size_t len, char* dst, bool& valid)
+    {
+        char* out = dst;
+        size_t index = 0;
+
+        while (index + 8 <= len)
+        {
+            if (Sse2Block(_mm_loadu_si128((const __m128i*)(src + index * sizeof(WORD))), out))
+            {
+                index += 8;
+                continue;
+            }
+
+            // A surrogate pair may straddle the block end, ScalarStep then consumes one unit past it
+            for (size_t block_end = index + 8; index < block_end; )
+                index += ScalarStep(src, index, len, out, valid);
+        }
+
+        TranscodeScalar(src, index, len, out, valid);
+        return out - dst;
+    }
+
+    // 3 byte sequences are interleaved from two registers with pshufb (SSSE3, implied by AVX2)
+    PEW_TARGET_AVX2 static PEW_FORCE_INLINE bool ThreeByteBlock(__m128i in, char*& out)
+    {
+        __m128i high_bits = _mm_and_si128(in, _mm_set1_epi16((short)0xF800));
+        __m128i below_800 = _mm_cmpeq_epi16(high_bits, _mm_setzero_si128());
+        __m128i surrogate = _mm_cmpeq_epi16(high_bits, _mm_set1_epi16((short)0xD800));
+        if (_mm_movemask_epi8(_mm_or_si128(below_800, surrogate)) != 0)
+            return false;
+
+        // 1110xxxx 10xxxxxx 10xxxxxx
+        __m128i lead = _mm_or_si128(_mm_srli_epi16(in, 12), _mm_set1_epi16(0xE0));
+        __m128i middle = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(in, 6), _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+        __m128i last = _mm_or_si128(_mm_and_si128(in, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+
+        __m128i lead_middle = _mm_or_si128(lead, _mm_slli_epi16(middle, 8));
+        __m128i lasts = _mm_packus_epi16(last, last);
+
+        const __m128i first_from_pairs = _mm_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, 8, 9, -1, 10);
+        const __m128i first_from_lasts = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+        const __m128i second_from_pairs = _mm_setr_epi8(11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i second_from_lasts = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+
+        _mm_storeu_si128((__m128i*)out, _mm_or_si128(_mm_shuffle_epi8(lead_middle, first_from_pairs), _mm_shuffle_epi8(lasts, first_from_lasts)));
+        _mm_storel_epi64((__m128i*)(out + 16), _mm_or_si128(_mm_shuffle_epi8(lead_middle, second_from_pairs), _mm_shuffle_epi8(lasts, second_from_lasts)));
+        out += 24;
+        return true;
+    }
+
+    PEW_TARGET_AVX2 static size_t TranscodeAvx2(const BYTE* src, size_t len, char* dst, bool& valid)
+    {
+        const __m256i non_ascii = _mm256_set1_epi16((short)0xFF80);
+        const __m256i non_two_bytes = _mm256_set1_epi16((short)0xF800);
+
+        char* out = dst;
+        size_t index = 0;
+
+        while (index + 8 <= len)
+        {
+            if (index + 16 <= len)
+            {
+                __m256i wide = _mm256_loadu_si256((const __m256i*)(src + index * sizeof(WORD)));
+
+                // ASCII, packus works per 128 bit lane and the permute joins both halves
+                if (_mm256_testz_si256(wide, non_ascii))
+                {
+                    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(wide, wide), 0xD8);
+                    _mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(packed));
+                    out += 16;
+                    index += 16;
+                    continue;
+                }
+
+                // Only 2 byte sequences, every unit stays in its own 16 bit lane
+                __m256i is_ascii = _mm256_cmpeq_epi16(_mm256_and_si256(wide, non_ascii), _mm256_setzero_si256());
+                if (_mm256_testz_si256(wide, non_two_bytes) && _mm256_movemask_epi8(is_ascii) == 0)
+                {
+                    __m256i lead = _mm256_or_si256(_mm256_srli_epi16(wide, 6), _mm256_set1_epi16(0xC0));
+                    __m256i trail = _mm256_or_si256(_mm256_and_si256(wide, _mm256_set1_epi16(0x3F)), _mm256_set1_epi16(0x80));
+                    _mm256_storeu_si256((__m256i*)out, _mm256_or_si256(lead, _mm256_slli_epi16(trail, 8)));
+                    out += 32;
+                    index += 16;
+                    continue;
+                }
+            }
+
+            __m128i in = _mm_loadu_si128((const __m128i*)(src + index * sizeof(WORD)));
+            if (Sse2Block(in, out) || ThreeByteBlock(in, out))
+            {
+                index += 8;
+                continue;
+            }
+
+            for (size_t block_end = index + 8; index < block_end; )
+                index += ScalarStep(src, index, len, out, valid);
+        }
+
+        TranscodeScalar(src, index, len, out, valid);
+        return out - dst;
+    }
+#endif
+
+    size_t Utf16ToUtf8(SimdIsa isa, const WCHAR* src, size_t len, char* dst, bool* valid)
+    {
+        bool is_valid = true;
+        size_t written = 0;
+
+        switch (isa)
+        {
+#if defined(PEW_SIMD_X64)
+            case SimdIsa::AVX2:    written = TranscodeAvx2((const BYTE*)src, len, dst, is_valid);      break;
+            case SimdIsa::SSE2:    written = TranscodeSse2((const BYTE*)src, len, dst, is_valid);      break;
+#endif
+            default:
+            {
+                char* out = dst;
+                TranscodeScalar((const BYTE*)src, 0, len, out, is_valid);
+                written = out - dst;
+                break;
+            }
+        }
+
+        if (valid)
+            *valid = is_valid;
+
+        return written;
+    }
+
+    size_t Utf16ToUtf8(const WCHAR* src, size_t len, char* dst, bool* valid)
+    {
+        return Utf16ToUtf8(GetSimdIsa(), src, len, dst, valid);
+    }
+
+    std::string Utf16ToUtf8(const WCHAR* src, int len)
+    {
+        std::string dst;
+
+        if (src && len > 0)
+            AppendUtf16ToUtf8(src, (size_t)len, dst);
+
+        return dst;
+    }
+
+}
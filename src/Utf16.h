@@ -0,0 +1,28 @@
+#pragma once
+#include "PEFormat.h"
+#include "Simd.h"
+
+#include <string>
+
+namespace PewParser {
+
+    // Every UTF-16 unit becomes at most 3 UTF-8 bytes, a surrogate pair (2 units) becomes 4
+    constexpr size_t Utf8MaxSize(size_t utf16_length) { return utf16_length * 3; }
+
+    // Little endian UTF-16 to UTF-8 into dst, which must hold Utf8MaxSize(len) bytes. src needs no alignment.
+    // Unpaired surrogates are written as U+FFFD and clear valid. Returns the number of bytes written.
+    size_t Utf16ToUtf8(const WCHAR* src, size_t len, char* dst, bool* valid = nullptr);
+    size_t Utf16ToUtf8(SimdIsa isa, const WCHAR* src, size_t len, char* dst, bool* valid = nullptr);
+
+    std::string Utf16ToUtf8(const WCHAR* src, int len);
+
+    // Appends to dst without a temporary string, dst is a std::string or std::pmr::string
+    template<typename String>
+    void AppendUtf16ToUtf8(const WCHAR* src, size_t len, String& dst)
+    {
+        size_t old_size = dst.size();
+        dst.resize(old_size + Utf8MaxSize(len));
+        dst.resize(old_size + Utf16ToUtf8(src, len, &dst[old_size]));
+    }
+
+}
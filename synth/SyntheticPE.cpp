@@ -0,0 +1,1239 @@
+#include "SyntheticPE.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace PewParser {
+
+    static constexpr DWORD kFileAlignment = 0x200;
+    static constexpr DWORD kSectionAlignment = 0x1000;
+    static constexpr DWORD kTextSize = 0x1000;
+    static constexpr DWORD kTimeDateStamp = 0x5F000000;
+    static constexpr ULONGLONG kImageBase64 = 0x140000000;
+    static constexpr ULONGLONG kImageBase32 = 0x400000;
+    static constexpr size_t kFixupsPerPage = kSectionAlignment / sizeof(ULONGLONG);
+    static constexpr size_t kTlsTemplateSize = 64;
+    static constexpr size_t kLoadConfigVersions = 4;
+    // Module name offsets of bound import descriptors are WORDs, this keeps the whole directory below 64K
+    static constexpr size_t kMaxBoundLibraries = 1024;
+
+    static DWORD AlignUp(size_t value, size_t alignment)
+    {
+        return (DWORD)((value + alignment - 1) / alignment * alignment);
+    }
+
+    struct Section
+    {
+        std::string name;
+        DWORD characteristics;
+        DWORD rva;
+        std::vector<BYTE> data;
+    };
+
+    // Sections are filled strictly in order, so the RVA of a section is final once the next one is opened
+    class ImageBuilder
+    {
+    public:
+        ImageBuilder(DWORD first_rva, size_t sections_count)
+            : first_rva_(first_rva)
+        {
+            sections_.reserve(sections_count);
+        }
+
+        Section& Open(index_t section_index, const std::string& name, DWORD characteristics)
+        {
+            while (sections_.size() <= section_index)
+            {
+                DWORD rva = first_rva_;
+                if (!sections_.empty())
+                    rva = AlignUp(sections_.back().rva + std::max<size_t>(sections_.back().data.size(), 1), kSectionAlignment);
+
+                sections_.push_back({ name, characteristics, rva, {} });
+            }
+
+            return sections_[section_index];
+        }
+
+        std::vector<Section>& GetSections() { return sections_; }
+
+        // The DWORD at field_rva receives the file offset of target_rva once the raw layout is known
+        void AddRawFixup(DWORD field_rva, DWORD target_rva) { raw_fixups_.push_back({ field_rva, target_rva }); }
+        const std::vector<std::pair<DWORD, DWORD>>& GetRawFixups() const { return raw_fixups_; }
+
+        static DWORD Reserve(Section& section, size_t size, size_t alignment)
+        {
+            size_t offset = AlignUp(section.data.size(), alignment);
+            section.data.resize(offset + size, 0);
+
+            return section.rva + (DWORD)offset;
+        }
+
+        static DWORD Append(Section& section, const void* data, size_t size, size_t alignment)
+        {
+            DWORD rva = Reserve(section, size, alignment);
+            std::memcpy(section.data.data() + (rva - section.rva), data, size);
+
+            return rva;
+        }
+
+        static DWORD AppendString(Section& section, const std::string& str)
+        {
+            return Append(section, str.c_str(), str.size() + 1, 1);
+        }
+
+        template<typename T>
+        static void Put(Section& section, DWORD rva, const T& value)
+        {
+            std::memcpy(section.data.data() + (rva - section.rva), &value, sizeof(T));
+        }
+    private:
+        DWORD first_rva_;
+        std::vector<Section> sections_;
+        std::vector<std::pair<DWORD, DWORD>> raw_fixups_;
+    };
+
+    // Final placement of the image, used to resolve raw fixups and to apply malformations
+    struct ImageLayout
+    {
+        size_t nt_hdrs_offset;
+        size_t section_hdrs_offset;
+        size_t data_dir_offset;
+        DWORD headers_size;
+        DWORD image_size;
+        bool x64;
+        const std::vector<Section>* sections;
+        std::vector<DWORD> raw_offsets;
+
+        offset_t RvaToRaw(DWORD rva) const
+        {
+            for (index_t i = 0; i < sections->size(); i++)
+            {
+                const Section& section = (*sections)[i];
+                if (rva >= section.rva && rva < section.rva + section.data.size())
+                    return raw_offsets[i] + (rva - section.rva);
+            }
+
+            return 0;
+        }
+    };
+
+    template<typename T>
+    static void PutRaw(std::vector<BYTE>& image, offset_t raw_offset, const T& value)
+    {
+        if (raw_offset && raw_offset + sizeof(T) <= image.size())
+            std::memcpy(image.data() + raw_offset, &value, sizeof(T));
+    }
+
+    static void BuildImports(const SyntheticPE::Config& config, Section& section, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        size_t libraries_count = config.libraries_count;
+        size_t funcs_count = config.imports_per_library;
+        size_t thunk_size = config.x64 ? sizeof(ULONGLONG) : sizeof(DWORD);
+
+        if (!libraries_count)
+            return;
+
+        DWORD descriptors_rva = ImageBuilder::Reserve(section, (libraries_count + 1) * sizeof(IMAGE_IMPORT_DESCRIPTOR), sizeof(DWORD));
+
+        for (index_t lib = 0; lib < libraries_count; lib++)
+        {
+            DWORD INT_rva = ImageBuilder::Reserve(section, (funcs_count + 1) * thunk_size, thunk_size);
+            DWORD IAT_rva = ImageBuilder::Reserve(section, (funcs_count + 1) * thunk_size, thunk_size);
+
+            for (index_t func = 0; func < funcs_count; func++)
+            {
+                ULONGLONG thunk = 0;
+
+                if (config.ordinal_import_every && (func % config.ordinal_import_every) == config.ordinal_import_every - 1)
+                    thunk = (config.x64 ? IMAGE_ORDINAL_FLAG64 : IMAGE_ORDINAL_FLAG32) | (WORD)(func + 1);
+                else
+                {
+                    std::string name = SyntheticPE::ImportName(lib, func);
+                    DWORD hint_rva = ImageBuilder::Reserve(section, sizeof(WORD) + name.size() + 1, sizeof(WORD));
+                    ImageBuilder::Put(section, hint_rva, (WORD)func);
+                    std::memcpy(section.data.data() + (hint_rva - section.rva) + sizeof(WORD), name.c_str(), name.size());
+                    thunk = hint_rva;
+                }
+
+                if (config.x64)
+                {
+                    ImageBuilder::Put(section, INT_rva + (DWORD)(func * thunk_size), thunk);
+                    ImageBuilder::Put(section, IAT_rva + (DWORD)(func * thunk_size), thunk);
+                }
+                else
+                {
+                    ImageBuilder::Put(section, INT_rva + (DWORD)(func * thunk_size), (DWORD)thunk);
+                    ImageBuilder::Put(section, IAT_rva + (DWORD)(func * thunk_size), (DWORD)thunk);
+                }
+            }
+
+            IMAGE_IMPORT_DESCRIPTOR descriptor = {};
+            descriptor.OriginalFirstThunk = INT_rva;
+            // -1 marks a new style binding, the actual timestamps are in the bound import directory
+            descriptor.TimeDateStamp = (config.bound_imports && lib < kMaxBoundLibraries) ? 0xFFFFFFFF : 0;
+            descriptor.Name = ImageBuilder::AppendString(section, SyntheticPE::LibraryName(lib));
+            descriptor.FirstThunk = IAT_rva;
+            ImageBuilder::Put(section, descriptors_rva + (DWORD)(lib * sizeof(IMAGE_IMPORT_DESCRIPTOR)), descriptor);
+        }
+
+        data_dir[DataDirEntries::IMP].VirtualAddress = descriptors_rva;
+        data_dir[DataDirEntries::IMP].Size = (DWORD)((libraries_count + 1) * sizeof(IMAGE_IMPORT_DESCRIPTOR));
+    }
+
+    // Descriptors with their forwarder refs inline, a null descriptor, then the module names
+    static std::vector<BYTE> BuildBoundImports(const SyntheticPE::Config& config)
+    {
+        std::vector<BYTE> bound_imports;
+
+        if (!config.bound_imports || !config.libraries_count)
+            return bound_imports;
+
+        size_t libraries_count = std::min(config.libraries_count, kMaxBoundLibraries);
+        size_t forwarders_count = (libraries_count + 3) / 4;
+        size_t names_offset = (libraries_count + forwarders_count + 1) * sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR);
+
+        bound_imports.resize(names_offset, 0);
+
+        auto append_name = [&](const std::string& name) {
+            size_t offset = bound_imports.size();
+            bound_imports.insert(bound_imports.end(), name.c_str(), name.c_str() + name.size() + 1);
+            return (WORD)offset;
+        };
+
+        size_t offset = 0;
+        for (index_t lib = 0; lib < libraries_count; lib++)
+        {
+            bool has_forwarder = (lib % 4) == 0;
+
+            IMAGE_BOUND_IMPORT_DESCRIPTOR descriptor = {};
+            descriptor.TimeDateStamp = kTimeDateStamp + (DWORD)lib;
+            descriptor.OffsetModuleName = append_name(SyntheticPE::LibraryName(lib));
+            descriptor.NumberOfModuleForwarderRefs = has_forwarder ? 1 : 0;
+            std::memcpy(bound_imports.data() + offset, &descriptor, sizeof(descriptor));
+            offset += sizeof(descriptor);
+
+            if (has_forwarder)
+            {
+                char name[32];
+                std::snprintf(name, sizeof(name), "synthfwd%zu.dll", lib);
+
+                IMAGE_BOUND_FORWARDER_REF forwarder_ref = {};
+                forwarder_ref.TimeDateStamp = kTimeDateStamp;
+                forwarder_ref.OffsetModuleName = append_name(name);
+                std::memcpy(bound_imports.data() + offset, &forwarder_ref, sizeof(forwarder_ref));
+                offset += sizeof(forwarder_ref);
+            }
+        }
+
+        bound_imports.resize(AlignUp(bound_imports.size(), sizeof(DWORD)), 0);
+        return bound_imports;
+    }
+
+    static void BuildDelayImports(const SyntheticPE::Config& config, Section& section, DWORD text_rva, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        size_t libraries_count = config.delay_libraries_count;
+        size_t funcs_count = config.imports_per_library;
+        size_t thunk_size = config.x64 ? sizeof(ULONGLONG) : sizeof(DWORD);
+        bool va_based = config.delay_va_based && !config.x64;
+        ULONGLONG image_base = config.x64 ? kImageBase64 : kImageBase32;
+        DWORD address_bias = va_based ? (DWORD)kImageBase32 : 0;
+
+        if (!libraries_count)
+            return;
+
+        DWORD descriptors_rva = ImageBuilder::Reserve(section, (libraries_count + 1) * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR), sizeof(DWORD));
+
+        for (index_t delay_lib = 0; delay_lib < libraries_count; delay_lib++)
+        {
+            index_t lib = config.libraries_count + delay_lib;
+            DWORD INT_rva = ImageBuilder::Reserve(section, (funcs_count + 1) * thunk_size, thunk_size);
+            DWORD IAT_rva = ImageBuilder::Reserve(section, (funcs_count + 1) * thunk_size, thunk_size);
+            DWORD module_rva = ImageBuilder::Reserve(section, thunk_size, thunk_size);
+
+            for (index_t func = 0; func < funcs_count; func++)
+            {
+                ULONGLONG thunk = 0;
+
+                if (config.ordinal_import_every && (func % config.ordinal_import_every) == config.ordinal_import_every - 1)
+                    thunk = (config.x64 ? IMAGE_ORDINAL_FLAG64 : IMAGE_ORDINAL_FLAG32) | (WORD)(func + 1);
+                else
+                {
+                    std::string name = SyntheticPE::ImportName(lib, func);
+                    DWORD hint_rva = ImageBuilder::Reserve(section, sizeof(WORD) + name.size() + 1, sizeof(WORD));
+                    ImageBuilder::Put(section, hint_rva, (WORD)func);
+                    std::memcpy(section.data.data() + (hint_rva - section.rva) + sizeof(WORD), name.c_str(), name.size());
+                    thunk = address_bias + hint_rva;
+                }
+
+                // Until the first call every IAT slot points at the loader thunk, the ret at the start of .text here
+                ULONGLONG loader_thunk = image_base + text_rva;
+                if (config.x64)
+                {
+                    ImageBuilder::Put(section, INT_rva + (DWORD)(func * thunk_size), thunk);
+                    ImageBuilder::Put(section, IAT_rva + (DWORD)(func * thunk_size), loader_thunk);
+                }
+                else
+                {
+                    ImageBuilder::Put(section, INT_rva + (DWORD)(func * thunk_size), (DWORD)thunk);
+                    ImageBuilder::Put(section, IAT_rva + (DWORD)(func * thunk_size), (DWORD)loader_thunk);
+                }
+            }
+
+            IMAGE_DELAYLOAD_DESCRIPTOR descriptor = {};
+            descriptor.Attributes.AllAttributes = va_based ? 0 : 1;
+            descriptor.DllNameRVA = address_bias + ImageBuilder::AppendString(section, SyntheticPE::LibraryName(lib));
+            descriptor.ModuleHandleRVA = address_bias + module_rva;
+            descriptor.ImportAddressTableRVA = address_bias + IAT_rva;
+            descriptor.ImportNameTableRVA = address_bias + INT_rva;
+            ImageBuilder::Put(section, descriptors_rva + (DWORD)(delay_lib * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR)), descriptor);
+        }
+
+        data_dir[DataDirEntries::DLYIMP].VirtualAddress = descriptors_rva;
+        data_dir[DataDirEntries::DLYIMP].Size = (DWORD)((libraries_count + 1) * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR));
+    }
+
+    static void BuildExports(const SyntheticPE::Config& config, Section& section, DWORD text_rva, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        size_t exports_count = config.exports_count;
+        // Name ordinals are WORDs, entries past the first 64K can only be exported by ordinal
+        size_t names_count = std::min<size_t>(exports_count, 0x10000);
+
+        if (!exports_count)
+            return;
+
+        DWORD export_dir_rva = ImageBuilder::Reserve(section, sizeof(IMAGE_EXPORT_DIRECTORY), sizeof(DWORD));
+        DWORD EAT_rva = ImageBuilder::Reserve(section, exports_count * sizeof(DWORD), sizeof(DWORD));
+        DWORD ENT_rva = ImageBuilder::Reserve(section, names_count * sizeof(DWORD), sizeof(DWORD));
+        DWORD ordinals_rva = ImageBuilder::Reserve(section, names_count * sizeof(WORD), sizeof(WORD));
+
+        for (index_t func = 0; func < exports_count; func++)
+            ImageBuilder::Put(section, EAT_rva + (DWORD)(func * sizeof(DWORD)), (DWORD)(text_rva + (func * 16) % kTextSize));
+
+        // Zero padded names keep the ENT sorted the way a linker would emit it
+        for (index_t func = 0; func < names_count; func++)
+        {
+            ImageBuilder::Put(section, ENT_rva + (DWORD)(func * sizeof(DWORD)), ImageBuilder::AppendString(section, SyntheticPE::ExportName(func)));
+            ImageBuilder::Put(section, ordinals_rva + (DWORD)(func * sizeof(WORD)), (WORD)func);
+        }
+
+        IMAGE_EXPORT_DIRECTORY export_dir = {};
+        export_dir.Name = ImageBuilder::AppendString(section, "synthetic.dll");
+        export_dir.Base = 1;
+        export_dir.NumberOfFunctions = (DWORD)exports_count;
+        export_dir.NumberOfNames = (DWORD)names_count;
+        export_dir.AddressOfFunctions = EAT_rva;
+        export_dir.AddressOfNames = ENT_rva;
+        export_dir.AddressOfNameOrdinals = ordinals_rva;
+        ImageBuilder::Put(section, export_dir_rva, export_dir);
+
+        data_dir[DataDirEntries::EXP].VirtualAddress = export_dir_rva;
+        data_dir[DataDirEntries::EXP].Size = (DWORD)(section.rva + section.data.size() - export_dir_rva);
+    }
+
+    static std::vector<BYTE> MakeDebugPayload(DWORD type, index_t entry)
+    {
+        std::vector<BYTE> payload;
+
+        auto put_dword = [&](DWORD value) {
+            payload.insert(payload.end(), (BYTE*)&value, (BYTE*)&value + sizeof(value));
+        };
+        auto put_string = [&](const std::string& str) {
+            payload.insert(payload.end(), str.c_str(), str.c_str() + str.size() + 1);
+        };
+
+        switch (type)
+        {
+            case IMAGE_DEBUG_TYPE_CODEVIEW:
+            {
+                put_dword(0x53445352);    // "RSDS"
+                for (index_t i = 0; i < 16; i++)
+                    payload.push_back((BYTE)(entry * 16 + i));
+                put_dword(1);
+                put_string("synthetic.pdb");
+                break;
+            }
+            case IMAGE_DEBUG_TYPE_VC_FEATURE:
+            {
+                for (DWORD count : { 0u, 120u, 118u, 0u, 4u })
+                    put_dword(count);
+                break;
+            }
+            case IMAGE_DEBUG_TYPE_POGO:
+            {
+                put_dword(0x4C544347);    // "LTCG"
+                put_dword(0x1000);
+                put_dword(kTextSize);
+                put_string(".text$mn");
+                break;
+            }
+            case IMAGE_DEBUG_TYPE_REPRO:
+            {
+                put_dword(32);
+                for (index_t i = 0; i < 32; i++)
+                    payload.push_back((BYTE)(entry + i * 7));
+                break;
+            }
+            default:
+            {
+                put_dword(IMAGE_DLLCHARACTERISTICS_EX_CET_COMPAT);
+                break;
+            }
+        }
+
+        return payload;
+    }
+
+    static void BuildDebug(const SyntheticPE::Config& config, Section& section, ImageBuilder& builder, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        static constexpr DWORD kDebugTypes[] = {
+            IMAGE_DEBUG_TYPE_CODEVIEW, IMAGE_DEBUG_TYPE_VC_FEATURE, IMAGE_DEBUG_TYPE_POGO, IMAGE_DEBUG_TYPE_REPRO, IMAGE_DEBUG_TYPE_EX_DLLCHARACTERISTICS
+        };
+
+        size_t entries_count = config.debug_entries_count;
+
+        if (!entries_count)
+            return;
+
+        DWORD debug_dir_rva = ImageBuilder::Reserve(section, entries_count * sizeof(IMAGE_DEBUG_DIRECTORY), sizeof(DWORD));
+
+        for (index_t entry = 0; entry < entries_count; entry++)
+        {
+            DWORD type = kDebugTypes[entry % (sizeof(kDebugTypes) / sizeof(kDebugTypes[0]))];
+            std::vector<BYTE> payload = MakeDebugPayload(type, entry);
+            DWORD entry_rva = debug_dir_rva + (DWORD)(entry * sizeof(IMAGE_DEBUG_DIRECTORY));
+
+            IMAGE_DEBUG_DIRECTORY debug_dir = {};
+            debug_dir.TimeDateStamp = kTimeDateStamp;
+            debug_dir.Type = type;
+            debug_dir.SizeOfData = (DWORD)payload.size();
+            debug_dir.AddressOfRawData = ImageBuilder::Append(section, payload.data(), payload.size(), sizeof(DWORD));
+            ImageBuilder::Put(section, entry_rva, debug_dir);
+
+            builder.AddRawFixup(entry_rva + offsetof(IMAGE_DEBUG_DIRECTORY, PointerToRawData), debug_dir.AddressOfRawData);
+        }
+
+        data_dir[DataDirEntries::DBG].VirtualAddress = debug_dir_rva;
+        data_dir[DataDirEntries::DBG].Size = (DWORD)(entries_count * sizeof(IMAGE_DEBUG_DIRECTORY));
+    }
+
+    // Depth first, every directory is laid out right before its children. Offsets are relative to the resource root
+    // until the tree is copied into the section, then the data entries are patched to RVAs.
+    class RsrcTreeBuilder
+    {
+    public:
+        RsrcTreeBuilder(const SyntheticPE::Config& config)
+            : config_(config), leaves_count_(0)
+        {
+        }
+
+        void Build(Section& section, IMAGE_DATA_DIRECTORY* data_dir)
+        {
+            if (!config_.rsrc_types_count || !config_.rsrc_names_per_type || !config_.rsrc_langs_per_name)
+                return;
+
+            BuildDir(0);
+
+            DWORD root_rva = ImageBuilder::Append(section, tree_.data(), tree_.size(), sizeof(DWORD));
+            for (size_t data_entry : data_entries_)
+            {
+                IMAGE_RESOURCE_DATA_ENTRY* entry = (IMAGE_RESOURCE_DATA_ENTRY*)(section.data.data() + (root_rva - section.rva) + data_entry);
+                entry->OffsetToData += root_rva;
+            }
+
+            data_dir[DataDirEntries::RSRC].VirtualAddress = root_rva;
+            data_dir[DataDirEntries::RSRC].Size = (DWORD)tree_.size();
+        }
+    private:
+        size_t GetDepth() const { return 3 + config_.rsrc_extra_depth; }
+
+        size_t GetEntriesCount(size_t level) const
+        {
+            switch (level)
+            {
+                case 0:     return config_.rsrc_types_count;
+                case 1:     return config_.rsrc_names_per_type;
+                case 2:     return config_.rsrc_langs_per_name;
+                default:    return 1;
+            }
+        }
+
+        size_t Reserve(size_t size, size_t alignment)
+        {
+            size_t offset = AlignUp(tree_.size(), alignment);
+            tree_.resize(offset + size, 0);
+
+            return offset;
+        }
+
+        template<typename T>
+        void Put(size_t offset, const T& value)
+        {
+            std::memcpy(tree_.data() + offset, &value, sizeof(T));
+        }
+
+        size_t AppendName(const std::string& name)
+        {
+            size_t offset = Reserve(sizeof(WORD) + name.size() * sizeof(WCHAR), sizeof(WORD));
+            Put(offset, (WORD)name.size());
+
+            for (index_t i = 0; i < name.size(); i++)
+                Put(offset + sizeof(WORD) + i * sizeof(WCHAR), (WCHAR)name[i]);
+
+            return offset;
+        }
+
+        size_t BuildLeaf()
+        {
+            size_t payload_size = config_.rsrc_payload_size;
+            size_t data_entry = Reserve(sizeof(IMAGE_RESOURCE_DATA_ENTRY), sizeof(DWORD));
+            size_t payload = Reserve(std::max<size_t>(payload_size, 1), 8);
+            std::memset(tree_.data() + payload, (int)(leaves_count_++ & 0xFF), payload_size);
+
+            IMAGE_RESOURCE_DATA_ENTRY data = {};
+            data.OffsetToData = (DWORD)payload;
+            data.Size = (DWORD)payload_size;
+            Put(data_entry, data);
+            data_entries_.push_back(data_entry);
+
+            return data_entry;
+        }
+
+        size_t BuildDir(size_t level)
+        {
+            size_t entries_count = GetEntriesCount(level);
+            bool named = (level == 1) && config_.rsrc_named_entries;
+            size_t dir = Reserve(sizeof(IMAGE_RESOURCE_DIRECTORY) + entries_count * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY), sizeof(DWORD));
+
+            IMAGE_RESOURCE_DIRECTORY rsrc_dir = {};
+            if (named)
+                rsrc_dir.NumberOfNamedEntries = (WORD)entries_count;
+            else
+                rsrc_dir.NumberOfIdEntries = (WORD)entries_count;
+            Put(dir, rsrc_dir);
+
+            for (index_t entry_index = 0; entry_index < entries_count; entry_index++)
+            {
+                IMAGE_RESOURCE_DIRECTORY_ENTRY entry = {};
+
+                // Zero padded names keep the named entries sorted the way rc emits them
+                if (named)
+                    entry.Name = 0x80000000 | (DWORD)AppendName(SyntheticPE::RsrcName(entry_index));
+                else if (level == 2)
+                    entry.Name = (DWORD)(0x409 + entry_index);
+                else
+                    entry.Name = (DWORD)(entry_index + 1);
+
+                if (level + 1 < GetDepth())
+                    entry.OffsetToData = 0x80000000 | (DWORD)BuildDir(level + 1);
+                else
+                    entry.OffsetToData = (DWORD)BuildLeaf();
+
+                Put(dir + sizeof(IMAGE_RESOURCE_DIRECTORY) + entry_index * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY), entry);
+            }
+
+            return dir;
+        }
+    private:
+        const SyntheticPE::Config& config_;
+        std::vector<BYTE> tree_;
+        std::vector<size_t> data_entries_;
+        size_t leaves_count_;
+    };
+
+    template<typename OptionalHdr>
+    static void FillOptionalHdr(OptionalHdr& optional_hdr, const std::vector<Section>& sections, DWORD headers_size, const IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        const Section& last = sections.back();
+
+        optional_hdr.MajorLinkerVersion = 14;
+        optional_hdr.SizeOfCode = AlignUp(sections.front().data.size(), kFileAlignment);
+        optional_hdr.AddressOfEntryPoint = sections.front().rva;
+        optional_hdr.BaseOfCode = sections.front().rva;
+        optional_hdr.SectionAlignment = kSectionAlignment;
+        optional_hdr.FileAlignment = kFileAlignment;
+        optional_hdr.MajorOperatingSystemVersion = 6;
+        optional_hdr.MajorSubsystemVersion = 6;
+        optional_hdr.SizeOfImage = AlignUp(last.rva + std::max<size_t>(last.data.size(), 1), kSectionAlignment);
+        optional_hdr.SizeOfHeaders = headers_size;
+        optional_hdr.Subsystem = IMAGE_SUBSYSTEM_WINDOWS_CUI;
+        optional_hdr.DllCharacteristics = IMAGE_DLLCHARACTERISTICS_DYNAMIC_BASE | IMAGE_DLLCHARACTERISTICS_NX_COMPAT;
+        optional_hdr.SizeOfStackReserve = 0x100000;
+        optional_hdr.SizeOfStackCommit = 0x1000;
+        optional_hdr.SizeOfHeapReserve = 0x100000;
+        optional_hdr.SizeOfHeapCommit = 0x1000;
+        optional_hdr.NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+        std::memcpy(optional_hdr.DataDirectory, data_dir, sizeof(optional_hdr.DataDirectory));
+    }
+
+    // Every slot holds the VA of the first page, so a rebased image is easy to check
+    static void BuildRelocs(const SyntheticPE::Config& config, Section& section, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        size_t relocs_count = config.relocs_count;
+
+        if (!relocs_count)
+            return;
+
+        size_t pages_count = (relocs_count + kFixupsPerPage - 1) / kFixupsPerPage;
+        DWORD targets_rva = ImageBuilder::Reserve(section, pages_count * kSectionAlignment, kSectionAlignment);
+        ULONGLONG target_va = (config.x64 ? kImageBase64 : kImageBase32) + targets_rva;
+        WORD type = config.x64 ? IMAGE_REL_BASED_DIR64 : IMAGE_REL_BASED_HIGHLOW;
+
+        std::vector<BYTE> blocks;
+        for (index_t page = 0; page < pages_count; page++)
+        {
+            DWORD page_rva = targets_rva + (DWORD)(page * kSectionAlignment);
+            size_t fixups_count = std::min(kFixupsPerPage, relocs_count - page * kFixupsPerPage);
+            // Blocks stay DWORD aligned, an odd count gets an ABSOLUTE entry as padding
+            size_t entries_count = fixups_count + (fixups_count & 1);
+
+            IMAGE_BASE_RELOCATION block = {};
+            block.VirtualAddress = page_rva;
+            block.SizeOfBlock = (DWORD)(sizeof(IMAGE_BASE_RELOCATION) + entries_count * sizeof(WORD));
+
+            size_t block_offset = blocks.size();
+            blocks.resize(block_offset + block.SizeOfBlock, 0);
+            std::memcpy(blocks.data() + block_offset, &block, sizeof(block));
+
+            for (index_t slot = 0; slot < fixups_count; slot++)
+            {
+                WORD entry = (WORD)((type << 12) | (slot * sizeof(ULONGLONG)));
+                std::memcpy(blocks.data() + block_offset + sizeof(block) + slot * sizeof(WORD), &entry, sizeof(entry));
+
+                DWORD slot_rva = page_rva + (DWORD)(slot * sizeof(ULONGLONG));
+                if (config.x64)
+                    ImageBuilder::Put(section, slot_rva, target_va);
+                else
+                    ImageBuilder::Put(section, slot_rva, (DWORD)target_va);
+            }
+        }
+
+        data_dir[DataDirEntries::BRELOC].VirtualAddress = ImageBuilder::Append(section, blocks.data(), blocks.size(), sizeof(DWORD));
+        data_dir[DataDirEntries::BRELOC].Size = (DWORD)blocks.size();
+    }
+
+    // Functions are 12 bytes long and 16 bytes apart, so the 4 byte gaps between them belong to no function
+    static void BuildExceptions(const SyntheticPE::Config& config, Section& section, DWORD text_rva, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        if (!config.x64 || !config.functions_count)
+            return;
+
+        // push rbx; sub rsp, 28h
+        const BYTE plain_unwind[] = { 0x01, 0x05, 0x02, 0x00, 0x05, 0x42, 0x01, 0x30 };
+        DWORD plain_rva = ImageBuilder::Append(section, plain_unwind, sizeof(plain_unwind), sizeof(DWORD));
+
+        // UNW_FLAG_EHANDLER, the handler is the first function and its data a zero DWORD
+        BYTE handler_unwind[12] = { 0x09, 0x00, 0x00, 0x00 };
+        std::memcpy(handler_unwind + 4, &text_rva, sizeof(text_rva));
+        DWORD handler_rva = ImageBuilder::Append(section, handler_unwind, sizeof(handler_unwind), sizeof(DWORD));
+
+        // UNW_FLAG_CHAININFO back to the first function
+        IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY first_function = {};
+        first_function.BeginAddress = text_rva;
+        first_function.EndAddress = text_rva + 12;
+        first_function.UnwindInfoAddress = plain_rva;
+
+        BYTE chained_unwind[4 + sizeof(IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY)] = { 0x21, 0x00, 0x00, 0x00 };
+        std::memcpy(chained_unwind + 4, &first_function, sizeof(first_function));
+        DWORD chained_rva = ImageBuilder::Append(section, chained_unwind, sizeof(chained_unwind), sizeof(DWORD));
+
+        const DWORD unwind_rvas[] = { plain_rva, handler_rva, chained_rva };
+
+        std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY> functions(config.functions_count);
+        for (index_t func = 0; func < functions.size(); func++)
+        {
+            functions[func].BeginAddress = text_rva + (DWORD)(func * 16);
+            functions[func].EndAddress = functions[func].BeginAddress + 12;
+            functions[func].UnwindInfoAddress = unwind_rvas[func % 3];
+        }
+
+        size_t table_size = functions.size() * sizeof(IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY);
+        data_dir[DataDirEntries::EXPTN].VirtualAddress = ImageBuilder::Append(section, functions.data(), table_size, sizeof(DWORD));
+        data_dir[DataDirEntries::EXPTN].Size = (DWORD)table_size;
+    }
+
+    template<typename TlsDir, typename Va>
+    static void BuildTlsDir(const SyntheticPE::Config& config, Section& section, DWORD text_rva, Va image_base, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        std::vector<BYTE> template_data(kTlsTemplateSize);
+        for (index_t i = 0; i < template_data.size(); i++)
+            template_data[i] = (BYTE)(i + 1);
+        DWORD template_rva = ImageBuilder::Append(section, template_data.data(), template_data.size(), 16);
+        DWORD index_rva = ImageBuilder::Reserve(section, sizeof(DWORD), sizeof(DWORD));
+
+        // Null terminated, every callback is the ret at the start of .text or one of the functions after it
+        std::vector<Va> callbacks(config.tls_callbacks_count + 1, 0);
+        for (index_t callback = 0; callback < config.tls_callbacks_count; callback++)
+            callbacks[callback] = image_base + text_rva + (Va)((callback * 16) % kTextSize);
+        DWORD callbacks_rva = ImageBuilder::Append(section, callbacks.data(), callbacks.size() * sizeof(Va), sizeof(Va));
+
+        TlsDir tls_dir = {};
+        tls_dir.StartAddressOfRawData = image_base + template_rva;
+        tls_dir.EndAddressOfRawData = image_base + template_rva + (Va)kTlsTemplateSize;
+        tls_dir.AddressOfIndex = image_base + index_rva;
+        tls_dir.AddressOfCallBacks = image_base + callbacks_rva;
+        tls_dir.SizeOfZeroFill = 16;
+
+        data_dir[DataDirEntries::TLS].VirtualAddress = ImageBuilder::Append(section, &tls_dir, sizeof(tls_dir), sizeof(Va));
+        data_dir[DataDirEntries::TLS].Size = sizeof(tls_dir);
+    }
+
+    // Size fields of the linker generations the generator reproduces, see Config::load_config_version
+    template<typename LoadConfig>
+    static size_t LoadConfigSize(size_t version)
+    {
+        const size_t sizes[kLoadConfigVersions] =
+        {
+            offsetof(LoadConfig, SEHandlerCount) + sizeof(LoadConfig::SEHandlerCount),
+            offsetof(LoadConfig, GuardFlags) + sizeof(LoadConfig::GuardFlags),
+            offsetof(LoadConfig, GuardLongJumpTargetCount) + sizeof(LoadConfig::GuardLongJumpTargetCount),
+            sizeof(LoadConfig)
+        };
+
+        return sizes[std::min(version, kLoadConfigVersions) - 1];
+    }
+
+    template<typename LoadConfig, typename Va>
+    static void BuildLoadConfig(const SyntheticPE::Config& config, Section& section, DWORD text_rva, Va image_base, IMAGE_DATA_DIRECTORY* data_dir)
+    {
+        if (!config.load_config_version)
+            return;
+
+        LoadConfig load_config = {};
+        load_config.Size = (DWORD)LoadConfigSize<LoadConfig>(config.load_config_version);
+        load_config.SecurityCookie = image_base + ImageBuilder::Reserve(section, sizeof(Va), sizeof(Va));
+
+        // Handlers and guard targets are the ret at the start of .text or one of the int3 slots after it
+        if (config.se_handlers_count && !config.x64)
+        {
+            std::vector<DWORD> handlers(config.se_handlers_count);
+            for (index_t handler = 0; handler < handlers.size(); handler++)
+                handlers[handler] = text_rva + (DWORD)((handler * 16) % kTextSize);
+
+            load_config.SEHandlerTable = image_base + ImageBuilder::Append(section, handlers.data(), handlers.size() * sizeof(DWORD), sizeof(DWORD));
+            load_config.SEHandlerCount = (Va)handlers.size();
+        }
+
+        if (config.guard_functions_count && config.load_config_version >= 2)
+        {
+            constexpr size_t kStride = sizeof(DWORD) + 1;
+            std::vector<BYTE> functions(config.guard_functions_count * kStride);
+            for (index_t function = 0; function < config.guard_functions_count; function++)
+            {
+                DWORD rva = text_rva + (DWORD)((function * 16) % kTextSize);
+                std::memcpy(functions.data() + function * kStride, &rva, sizeof(DWORD));
+                functions[function * kStride + sizeof(DWORD)] = (BYTE)(function % 2);
+            }
+
+            load_config.GuardCFFunctionTable = image_base + ImageBuilder::Append(section, functions.data(), functions.size(), sizeof(DWORD));
+            load_config.GuardCFFunctionCount = (Va)config.guard_functions_count;
+            load_config.GuardFlags = IMAGE_GUARD_CF_INSTRUMENTED | IMAGE_GUARD_CF_FUNCTION_TABLE_PRESENT | (1u << IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT);
+        }
+
+        data_dir[DataDirEntries::LDCFG].VirtualAddress = ImageBuilder::Append(section, &load_config, load_config.Size, sizeof(Va));
+        data_dir[DataDirEntries::LDCFG].Size = load_config.Size;
+    }
+
+    // The certificate table is addressed by file offset and is not part of any section
+    static void AppendCertificates(const SyntheticPE::Config& config, std::vector<BYTE>& image, const ImageLayout& layout)
+    {
+        const size_t header_size = offsetof(WIN_CERTIFICATE, bCertificate);
+        size_t table_offset = AlignUp(image.size(), 8);
+        image.resize(table_offset, 0);
+
+        for (index_t certificate = 0; certificate < config.certificates_count; certificate++)
+        {
+            // Odd content sizes so the 8 byte alignment between entries is exercised
+            size_t content_size = 1 + (certificate * 37) % 200;
+
+            WIN_CERTIFICATE header = {};
+            header.dwLength = (DWORD)(header_size + content_size);
+            header.wRevision = WIN_CERT_REVISION_2_0;
+            header.wCertificateType = WIN_CERT_TYPE_PKCS_SIGNED_DATA;
+
+            size_t offset = image.size();
+            image.resize(AlignUp(offset + header.dwLength, 8), 0);
+            std::memcpy(image.data() + offset, &header, header_size);
+            for (size_t i = 0; i < content_size; i++)
+                image[offset + header_size + i] = (BYTE)(certificate + i);
+        }
+
+        IMAGE_DATA_DIRECTORY* data_dir = (IMAGE_DATA_DIRECTORY*)(image.data() + layout.data_dir_offset);
+        data_dir[DataDirEntries::SECU].VirtualAddress = (DWORD)table_offset;
+        data_dir[DataDirEntries::SECU].Size = (DWORD)(image.size() - table_offset);
+    }
+
+    // CheckSum sits at the same offset in both optional header flavours
+    static size_t ChecksumOffset(const ImageLayout& layout)
+    {
+        return layout.nt_hdrs_offset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER) + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum);
+    }
+
+    // Word at a time with the carry folded on every add, the textbook form of the algorithm
+    static void WriteChecksum(std::vector<BYTE>& image, const ImageLayout& layout)
+    {
+        size_t checksum_offset = ChecksumOffset(layout);
+        PutRaw(image, checksum_offset, (DWORD)0);
+
+        DWORD sum = 0;
+        for (size_t i = 0; i < image.size(); i += sizeof(WORD))
+        {
+            sum += image[i] | ((i + 1 < image.size()) ? image[i + 1] << 8 : 0);
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        }
+
+        PutRaw(image, checksum_offset, (DWORD)(sum + image.size()));
+    }
+
+    static void Malform(SyntheticPE::Malformation malformation, std::vector<BYTE>& image, const ImageLayout& layout)
+    {
+        IMAGE_DATA_DIRECTORY* data_dir = (IMAGE_DATA_DIRECTORY*)(image.data() + layout.data_dir_offset);
+        size_t file_hdr_offset = layout.nt_hdrs_offset + sizeof(DWORD);
+        size_t last_section_hdr = layout.section_hdrs_offset + (layout.sections->size() - 1) * sizeof(IMAGE_SECTION_HEADER);
+
+        switch (malformation)
+        {
+            case SyntheticPE::Malformation::TRUNCATED:
+            {
+                image.resize(layout.headers_size + (image.size() - layout.headers_size) / 2);
+                break;
+            }
+            case SyntheticPE::Malformation::BAD_E_LFANEW:
+            {
+                PutRaw(image, offsetof(IMAGE_DOS_HEADER, e_lfanew), (LONG)(image.size() + kFileAlignment));
+                break;
+            }
+            case SyntheticPE::Malformation::SECTIONS_COUNT_OVERFLOW:
+            {
+                PutRaw(image, file_hdr_offset + offsetof(IMAGE_FILE_HEADER, NumberOfSections), (WORD)0xFFFF);
+                break;
+            }
+            case SyntheticPE::Malformation::SECTION_OUT_OF_FILE:
+            {
+                PutRaw(image, last_section_hdr + offsetof(IMAGE_SECTION_HEADER, PointerToRawData), (DWORD)0x7FFFFE00);
+                break;
+            }
+            case SyntheticPE::Malformation::DATA_DIRS_OUT_OF_IMAGE:
+            {
+                for (index_t entry = 0; entry < IMAGE_NUMBEROF_DIRECTORY_ENTRIES; entry++)
+                {
+                    if (data_dir[entry].VirtualAddress)
+                        data_dir[entry].VirtualAddress = layout.image_size + (DWORD)(entry * kSectionAlignment);
+                }
+                break;
+            }
+            case SyntheticPE::Malformation::IMPORTS_OUT_OF_FILE:
+            {
+                offset_t descriptor = layout.RvaToRaw(data_dir[DataDirEntries::IMP].VirtualAddress);
+                PutRaw(image, descriptor + offsetof(IMAGE_IMPORT_DESCRIPTOR, OriginalFirstThunk), (DWORD)0x7FFFFF00);
+                PutRaw(image, descriptor + offsetof(IMAGE_IMPORT_DESCRIPTOR, Name), (DWORD)0x7FFFFF80);
+                PutRaw(image, descriptor + offsetof(IMAGE_IMPORT_DESCRIPTOR, FirstThunk), (DWORD)0x7FFFFFC0);
+                break;
+            }
+            case SyntheticPE::Malformation::EXPORT_COUNTS_OVERFLOW:
+            {
+                offset_t export_dir = layout.RvaToRaw(data_dir[DataDirEntries::EXP].VirtualAddress);
+                PutRaw(image, export_dir + offsetof(IMAGE_EXPORT_DIRECTORY, NumberOfFunctions), (DWORD)0x7FFFFFFF);
+                PutRaw(image, export_dir + offsetof(IMAGE_EXPORT_DIRECTORY, NumberOfNames), (DWORD)0x7FFFFFFF);
+                break;
+            }
+            case SyntheticPE::Malformation::RSRC_CYCLE:
+            {
+                offset_t root = layout.RvaToRaw(data_dir[DataDirEntries::RSRC].VirtualAddress);
+                if (!root)
+                    break;
+
+                // Root -> first type directory -> root
+                DWORD type_dir = ((IMAGE_RESOURCE_DIRECTORY_ENTRY*)(image.data() + root + sizeof(IMAGE_RESOURCE_DIRECTORY)))->OffsetToDirectory;
+                offset_t first_entry = root + type_dir + sizeof(IMAGE_RESOURCE_DIRECTORY);
+                PutRaw(image, first_entry + offsetof(IMAGE_RESOURCE_DIRECTORY_ENTRY, OffsetToData), (DWORD)0x80000000);
+                break;
+            }
+            case SyntheticPE::Malformation::RELOC_BLOCK_OVERFLOW:
+            {
+                offset_t first_block = layout.RvaToRaw(data_dir[DataDirEntries::BRELOC].VirtualAddress);
+                PutRaw(image, first_block + offsetof(IMAGE_BASE_RELOCATION, SizeOfBlock), (DWORD)0x7FFFFFF0);
+                break;
+            }
+            case SyntheticPE::Malformation::TLS_CALLBACKS_UNTERMINATED:
+            {
+                offset_t tls_dir = layout.RvaToRaw(data_dir[DataDirEntries::TLS].VirtualAddress);
+                DWORD target_rva = (*layout.sections)[0].rva + 16;
+                if (layout.x64)
+                    PutRaw(image, tls_dir + offsetof(IMAGE_TLS_DIRECTORY64, AddressOfCallBacks), (ULONGLONG)(kImageBase64 + target_rva));
+                else
+                    PutRaw(image, tls_dir + offsetof(IMAGE_TLS_DIRECTORY32, AddressOfCallBacks), (DWORD)(kImageBase32 + target_rva));
+                break;
+            }
+            case SyntheticPE::Malformation::DELAY_IMPORTS_OUT_OF_FILE:
+            {
+                offset_t descriptor = layout.RvaToRaw(data_dir[DataDirEntries::DLYIMP].VirtualAddress);
+                if (!descriptor)
+                    break;
+
+                PutRaw(image, descriptor + offsetof(IMAGE_DELAYLOAD_DESCRIPTOR, DllNameRVA), (DWORD)0x7FFFFF80);
+                PutRaw(image, descriptor + offsetof(IMAGE_DELAYLOAD_DESCRIPTOR, ImportAddressTableRVA), (DWORD)0x7FFFFFC0);
+                PutRaw(image, descriptor + offsetof(IMAGE_DELAYLOAD_DESCRIPTOR, ImportNameTableRVA), (DWORD)0x7FFFFF00);
+                break;
+            }
+            case SyntheticPE::Malformation::CERTIFICATE_LENGTH_OVERFLOW:
+            {
+                offset_t table = data_dir[DataDirEntries::SECU].VirtualAddress;
+                if (!table)
+                    break;
+
+                PutRaw(image, table + offsetof(WIN_CERTIFICATE, dwLength), (DWORD)0x7FFFFFF0);
+                break;
+            }
+            case SyntheticPE::Malformation::CHECKSUM_MISMATCH:
+            {
+                DWORD checksum;
+                std::memcpy(&checksum, image.data() + ChecksumOffset(layout), sizeof(checksum));
+                PutRaw(image, ChecksumOffset(layout), (DWORD)(checksum + 1));
+                break;
+            }
+            case SyntheticPE::Malformation::LOAD_CONFIG_COUNTS_OVERFLOW:
+            {
+                offset_t load_config = layout.RvaToRaw(data_dir[DataDirEntries::LDCFG].VirtualAddress);
+                if (!load_config)
+                    break;
+
+                if (layout.x64)
+                    PutRaw(image, load_config + offsetof(IMAGE_LOAD_CONFIG_DIRECTORY64, GuardCFFunctionCount), (ULONGLONG)0x7FFFFFFF);
+                else
+                    PutRaw(image, load_config + offsetof(IMAGE_LOAD_CONFIG_DIRECTORY32, GuardCFFunctionCount), (DWORD)0x7FFFFFFF);
+                break;
+            }
+            case SyntheticPE::Malformation::FUNCTIONS_UNSORTED:
+            {
+                offset_t first_function = layout.RvaToRaw(data_dir[DataDirEntries::EXPTN].VirtualAddress);
+                size_t functions_count = data_dir[DataDirEntries::EXPTN].Size / sizeof(IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY);
+                if (!first_function || functions_count < 2)
+                    break;
+
+                offset_t last_function = first_function + (functions_count - 1) * sizeof(IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY);
+                IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY first, last;
+                std::memcpy(&first, image.data() + first_function, sizeof(first));
+                std::memcpy(&last, image.data() + last_function, sizeof(last));
+                PutRaw(image, first_function, last);
+                PutRaw(image, last_function, first);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    std::vector<BYTE> SyntheticPE::Build(const Config& config)
+    {
+        size_t sections_count = std::max<size_t>(config.sections_count, 1);
+        size_t optional_hdr_size = config.x64 ? sizeof(IMAGE_OPTIONAL_HEADER64) : sizeof(IMAGE_OPTIONAL_HEADER32);
+        size_t nt_hdrs_offset = sizeof(IMAGE_DOS_HEADER);
+        size_t section_hdrs_offset = nt_hdrs_offset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER) + optional_hdr_size;
+        size_t bound_imports_offset = section_hdrs_offset + sections_count * sizeof(IMAGE_SECTION_HEADER);
+
+        std::vector<BYTE> bound_imports = BuildBoundImports(config);
+        DWORD headers_size = AlignUp(bound_imports_offset + bound_imports.size(), kFileAlignment);
+
+        IMAGE_DATA_DIRECTORY data_dir[IMAGE_NUMBEROF_DIRECTORY_ENTRIES] = {};
+        ImageBuilder builder(AlignUp(headers_size, kSectionAlignment), sections_count);
+
+        index_t rdata_index = std::min<size_t>(1, sections_count - 1);
+        index_t rsrc_index = std::min<size_t>(2, sections_count - 1);
+
+        Section& text = builder.Open(0, ".text", IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ);
+        size_t text_size = std::max<size_t>(kTextSize, AlignUp(config.functions_count * 16, kFileAlignment));
+        DWORD text_rva = ImageBuilder::Reserve(text, text_size, 16);
+        std::memset(text.data.data(), 0xCC, text_size);
+        text.data[0] = 0xC3;
+
+        Section& rdata = builder.Open(rdata_index, ".rdata", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ);
+        BuildImports(config, rdata, data_dir);
+        BuildDelayImports(config, rdata, text_rva, data_dir);
+        BuildExports(config, rdata, text_rva, data_dir);
+        BuildDebug(config, rdata, builder, data_dir);
+        BuildRelocs(config, rdata, data_dir);
+        BuildExceptions(config, rdata, text_rva, data_dir);
+        if (config.tls_dir && config.x64)
+            BuildTlsDir<IMAGE_TLS_DIRECTORY64, ULONGLONG>(config, rdata, text_rva, kImageBase64, data_dir);
+        else if (config.tls_dir)
+            BuildTlsDir<IMAGE_TLS_DIRECTORY32, DWORD>(config, rdata, text_rva, (DWORD)kImageBase32, data_dir);
+        if (config.x64)
+            BuildLoadConfig<IMAGE_LOAD_CONFIG_DIRECTORY64, ULONGLONG>(config, rdata, text_rva, kImageBase64, data_dir);
+        else
+            BuildLoadConfig<IMAGE_LOAD_CONFIG_DIRECTORY32, DWORD>(config, rdata, text_rva, (DWORD)kImageBase32, data_dir);
+
+        Section& rsrc = builder.Open(rsrc_index, ".rsrc", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ);
+        RsrcTreeBuilder(config).Build(rsrc, data_dir);
+
+        for (index_t i = 3; i < sections_count; i++)
+        {
+            char name[IMAGE_SIZEOF_SHORT_NAME + 1];
+            std::snprintf(name, sizeof(name), ".data%zu", i - 3);
+            Section& filler = builder.Open(i, name, IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_WRITE);
+            ImageBuilder::Reserve(filler, kFileAlignment, 1);
+        }
+
+        if (!bound_imports.empty())
+        {
+            // Bound imports are addressed by file offset, the headers map 1:1 so it doubles as the RVA
+            data_dir[DataDirEntries::BOUNDIMP].VirtualAddress = (DWORD)bound_imports_offset;
+            data_dir[DataDirEntries::BOUNDIMP].Size = (DWORD)bound_imports.size();
+        }
+
+        std::vector<Section>& sections = builder.GetSections();
+
+        ImageLayout layout = {};
+        layout.nt_hdrs_offset = nt_hdrs_offset;
+        layout.section_hdrs_offset = section_hdrs_offset;
+        layout.headers_size = headers_size;
+        layout.x64 = config.x64;
+        layout.sections = &sections;
+
+        size_t image_size = headers_size;
+        for (const Section& section : sections)
+        {
+            layout.raw_offsets.push_back(section.data.empty() ? 0 : (DWORD)image_size);
+            image_size += AlignUp(section.data.size(), kFileAlignment);
+        }
+
+        for (const auto& [field_rva, target_rva] : builder.GetRawFixups())
+        {
+            for (Section& section : sections)
+            {
+                if (field_rva >= section.rva && field_rva + sizeof(DWORD) <= section.rva + section.data.size())
+                    ImageBuilder::Put(section, field_rva, (DWORD)layout.RvaToRaw(target_rva));
+            }
+        }
+
+        std::vector<BYTE> image(image_size, 0);
+
+        IMAGE_DOS_HEADER dos_hdr = {};
+        dos_hdr.e_magic = IMAGE_DOS_SIGNATURE;
+        dos_hdr.e_lfanew = (LONG)nt_hdrs_offset;
+        std::memcpy(image.data(), &dos_hdr, sizeof(dos_hdr));
+
+        DWORD signature = IMAGE_NT_SIGNATURE;
+        std::memcpy(image.data() + nt_hdrs_offset, &signature, sizeof(signature));
+
+        IMAGE_FILE_HEADER file_hdr = {};
+        file_hdr.Machine = config.x64 ? IMAGE_FILE_MACHINE_AMD64 : IMAGE_FILE_MACHINE_I386;
+        file_hdr.NumberOfSections = (WORD)sections.size();
+        file_hdr.TimeDateStamp = kTimeDateStamp;
+        file_hdr.SizeOfOptionalHeader = (WORD)optional_hdr_size;
+        file_hdr.Characteristics = IMAGE_FILE_EXECUTABLE_IMAGE | (config.x64 ? IMAGE_FILE_LARGE_ADDRESS_AWARE : IMAGE_FILE_32BIT_MACHINE);
+        if (config.exports_count)
+            file_hdr.Characteristics |= IMAGE_FILE_DLL;
+        std::memcpy(image.data() + nt_hdrs_offset + sizeof(DWORD), &file_hdr, sizeof(file_hdr));
+
+        size_t optional_hdr_offset = nt_hdrs_offset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER);
+        if (config.x64)
+        {
+            IMAGE_OPTIONAL_HEADER64 optional_hdr = {};
+            optional_hdr.Magic = IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+            optional_hdr.ImageBase = kImageBase64;
+            FillOptionalHdr(optional_hdr, sections, headers_size, data_dir);
+            optional_hdr.DllCharacteristics |= IMAGE_DLLCHARACTERISTICS_HIGH_ENTROPY_VA;
+            std::memcpy(image.data() + optional_hdr_offset, &optional_hdr, sizeof(optional_hdr));
+
+            layout.data_dir_offset = optional_hdr_offset + offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory);
+            layout.image_size = optional_hdr.SizeOfImage;
+        }
+        else
+        {
+            IMAGE_OPTIONAL_HEADER32 optional_hdr = {};
+            optional_hdr.Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+            optional_hdr.ImageBase = kImageBase32;
+            FillOptionalHdr(optional_hdr, sections, headers_size, data_dir);
+            optional_hdr.BaseOfData = sections[rdata_index].rva;
+            std::memcpy(image.data() + optional_hdr_offset, &optional_hdr, sizeof(optional_hdr));
+
+            layout.data_dir_offset = optional_hdr_offset + offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory);
+            layout.image_size = optional_hdr.SizeOfImage;
+        }
+
+        for (index_t i = 0; i < sections.size(); i++)
+        {
+            const Section& section = sections[i];
+
+            IMAGE_SECTION_HEADER section_hdr = {};
+            std::memcpy(section_hdr.Name, section.name.c_str(), std::min<size_t>(section.name.size(), IMAGE_SIZEOF_SHORT_NAME));
+            section_hdr.Misc.VirtualSize = (DWORD)std::max<size_t>(section.data.size(), 1);
+            section_hdr.VirtualAddress = section.rva;
+            section_hdr.SizeOfRawData = AlignUp(section.data.size(), kFileAlignment);
+            section_hdr.PointerToRawData = layout.raw_offsets[i];
+            section_hdr.Characteristics = section.characteristics;
+            std::memcpy(image.data() + section_hdrs_offset + i * sizeof(IMAGE_SECTION_HEADER), &section_hdr, sizeof(section_hdr));
+
+            std::memcpy(image.data() + layout.raw_offsets[i], section.data.data(), section.data.size());
+        }
+
+        std::memcpy(image.data() + bound_imports_offset, bound_imports.data(), bound_imports.size());
+
+        if (config.certificates_count)
+            AppendCertificates(config, image, layout);
+
+        if (config.checksum)
+            WriteChecksum(image, layout);
+
+        Malform(config.malformation, image, layout);
+
+        return image;
+    }
+
+    // Integer only draws, so a seed produces the same corpus with any standard library
+    static size_t Draw(std::mt19937_64& rng, size_t min, size_t max)
+    {
+        return min + (size_t)(rng() % (max - min + 1));
+    }
+
+    // Roughly log uniform in [1, max], most draws are small with a long tail up to max
+    static size_t DrawSkewed(std::mt19937_64& rng, size_t max)
+    {
+        size_t bits = 0;
+        while (((size_t)1 << bits) < max)
+            bits++;
+
+        size_t limit = (size_t)1 << Draw(rng, 0, bits);
+        return std::min(Draw(rng, 1, limit), max);
+    }
+
+    static bool Chance(std::mt19937_64& rng, double probability)
+    {
+        return (double)(rng() >> 11) * (1.0 / 9007199254740992.0) < probability;
+    }
+
+    SyntheticPE::Config SyntheticPE::RandomConfig(std::mt19937_64& rng, double malformed_ratio)
+    {
+        Config config;
+
+        config.x64 = Chance(rng, 0.5);
+        config.sections_count = DrawSkewed(rng, 96);
+
+        config.libraries_count = Draw(rng, 0, 32);
+        config.imports_per_library = DrawSkewed(rng, 512);
+        config.ordinal_import_every = Chance(rng, 0.3) ? Draw(rng, 2, 16) : 0;
+        config.bound_imports = Chance(rng, 0.25);
+
+        config.exports_count = Chance(rng, 0.5) ? DrawSkewed(rng, 8192) : 0;
+
+        if (Chance(rng, 0.6))
+        {
+            config.rsrc_types_count = Draw(rng, 1, 16);
+            config.rsrc_names_per_type = DrawSkewed(rng, 64);
+            config.rsrc_langs_per_name = Draw(rng, 1, 3);
+            config.rsrc_extra_depth = Chance(rng, 0.1) ? Draw(rng, 1, 4) : 0;
+            config.rsrc_named_entries = Chance(rng, 0.3);
+            config.rsrc_payload_size = DrawSkewed(rng, 4096);
+        }
+
+        config.debug_entries_count = Draw(rng, 0, 6);
+
+        config.relocs_count = Chance(rng, 0.5) ? DrawSkewed(rng, 16384) : 0;
+
+        config.functions_count = (config.x64 && Chance(rng, 0.5)) ? DrawSkewed(rng, 16384) : 0;
+
+        config.tls_dir = Chance(rng, 0.3);
+        config.tls_callbacks_count = (config.tls_dir && Chance(rng, 0.5)) ? DrawSkewed(rng, 16) : 0;
+
+        config.load_config_version = Chance(rng, 0.5) ? Draw(rng, 1, kLoadConfigVersions) : 0;
+        config.guard_functions_count = (config.load_config_version >= 2 && Chance(rng, 0.7)) ? DrawSkewed(rng, 65536) : 0;
+        config.se_handlers_count = (!config.x64 && config.load_config_version && Chance(rng, 0.5)) ? DrawSkewed(rng, 256) : 0;
+
+        config.delay_libraries_count = Chance(rng, 0.3) ? Draw(rng, 1, 8) : 0;
+        config.delay_va_based = (!config.x64 && config.delay_libraries_count && Chance(rng, 0.3));
+
+        config.certificates_count = Chance(rng, 0.2) ? Draw(rng, 1, 3) : 0;
+
+        config.checksum = Chance(rng, 0.5);
+
+        if (Chance(rng, malformed_ratio))
+        {
+            config.malformation = (Malformation)Draw(rng, 1, (size_t)Malformation::MALFORMATIONS_COUNT - 1);
+
+            // Make sure the targeted structure exists
+            if (config.malformation == Malformation::IMPORTS_OUT_OF_FILE)
+                config.libraries_count = std::max<size_t>(config.libraries_count, 1);
+            else if (config.malformation == Malformation::EXPORT_COUNTS_OVERFLOW)
+                config.exports_count = std::max<size_t>(config.exports_count, 16);
+            else if (config.malformation == Malformation::RSRC_CYCLE)
+                config.rsrc_types_count = std::max<size_t>(config.rsrc_types_count, 1);
+            else if (config.malformation == Malformation::RELOC_BLOCK_OVERFLOW)
+                config.relocs_count = std::max<size_t>(config.relocs_count, 1);
+            else if (config.malformation == Malformation::TLS_CALLBACKS_UNTERMINATED)
+                config.tls_dir = true;
+            else if (config.malformation == Malformation::DELAY_IMPORTS_OUT_OF_FILE)
+                config.delay_libraries_count = std::max<size_t>(config.delay_libraries_count, 1);
+            else if (config.malformation == Malformation::CERTIFICATE_LENGTH_OVERFLOW)
+                config.certificates_count = std::max<size_t>(config.certificates_count, 1);
+            else if (config.malformation == Malformation::CHECKSUM_MISMATCH)
+                config.checksum = true;
+            else if (config.malformation == Malformation::LOAD_CONFIG_COUNTS_OVERFLOW)
+            {
+                config.load_config_version = std::max<size_t>(config.load_config_version, 2);
+                config.guard_functions_count = std::max<size_t>(config.guard_functions_count, 1);
+            }
+            else if (config.malformation == Malformation::FUNCTIONS_UNSORTED)
+            {
+                config.x64 = true;
+                config.functions_count = std::max<size_t>(config.functions_count, 2);
+            }
+        }
+
+        return config;
+    }
+
+    std::string SyntheticPE::LibraryName(index_t library)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "synth%zu.dll", library);
+        return name;
+    }
+
+    std::string SyntheticPE::ImportName(index_t library, index_t func)
+    {
+        char name[48];
+        std::snprintf(name, sizeof(name), "Import_%zu_%zu", library, func);
+        return name;
+    }
+
+    std::string SyntheticPE::ExportName(index_t func)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "Export%06zu", func);
+        return name;
+    }
+
+    std::string SyntheticPE::RsrcName(index_t name)
+    {
+        char str[32];
+        std::snprintf(str, sizeof(str), "NAME_%04zu", name);
+        return str;
+    }
+
+    const char* SyntheticPE::MalformationName(Malformation malformation)
+    {
+        switch (malformation)
+        {
+            case Malformation::NONE:                       return "none";
+            case Malformation::TRUNCATED:                  return "truncated";
+            case Malformation::BAD_E_LFANEW:               return "bad_e_lfanew";
+            case Malformation::SECTIONS_COUNT_OVERFLOW:    return "sections_count_overflow";
+            case Malformation::SECTION_OUT_OF_FILE:        return "section_out_of_file";
+            case Malformation::DATA_DIRS_OUT_OF_IMAGE:     return "data_dirs_out_of_image";
+            case Malformation::IMPORTS_OUT_OF_FILE:        return "imports_out_of_file";
+            case Malformation::EXPORT_COUNTS_OVERFLOW:     return "export_counts_overflow";
+            case Malformation::RSRC_CYCLE:                 return "rsrc_cycle";
+            case Malformation::RELOC_BLOCK_OVERFLOW:       return "reloc_block_overflow";
+            case Malformation::FUNCTIONS_UNSORTED:         return "functions_unsorted";
+            case Malformation::TLS_CALLBACKS_UNTERMINATED: return "tls_callbacks_unterminated";
+            case Malformation::LOAD_CONFIG_COUNTS_OVERFLOW: return "load_config_counts_overflow";
+            case Malformation::DELAY_IMPORTS_OUT_OF_FILE:  return "delay_imports_out_of_file";
+            case Malformation::CERTIFICATE_LENGTH_OVERFLOW: return "certificate_length_overflow";
+            case Malformation::CHECKSUM_MISMATCH:          return "checksum_mismatch";
+            default:                                       return "unknown";
+        }
+    }
+
+}
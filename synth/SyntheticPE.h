@@ -0,0 +1,95 @@
+#pragma once
+#include <PEFormat.h>
+#include <PewTypes.h>
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+namespace PewParser {
+
+    // Builds well formed PE32 / PE32+ images in memory from the PEFormat.h structs.
+    // Layout is .text (code, export targets, functions), .rdata (imports, delay imports, exports, debug entries, relocated pointers and their blocks, function table, TLS, load config), .rsrc, then filler sections,
+    // collapsed into fewer sections when sections_count is smaller than that. Bound imports live in the headers, the certificate table at the end of the file.
+    class SyntheticPE
+    {
+    public:
+        // Applied on top of the well formed image, a variant is a no-op when the structure it targets is absent
+        enum class Malformation
+        {
+            NONE = 0,
+            TRUNCATED,                  // file cut in the middle of the section data
+            BAD_E_LFANEW,               // e_lfanew points past the end of the file
+            SECTIONS_COUNT_OVERFLOW,    // NumberOfSections = 0xFFFF
+            SECTION_OUT_OF_FILE,        // last section PointerToRawData past the end of the file
+            DATA_DIRS_OUT_OF_IMAGE,     // every present data directory points past SizeOfImage
+            IMPORTS_OUT_OF_FILE,        // first import descriptor thunks and name point past the end of the file
+            EXPORT_COUNTS_OVERFLOW,     // NumberOfFunctions / NumberOfNames far larger than the directory
+            RSRC_CYCLE,                 // first type directory links back to the resource root
+            RELOC_BLOCK_OVERFLOW,       // first base relocation block claims to run far past the directory
+            FUNCTIONS_UNSORTED,         // first and last RUNTIME_FUNCTION entries swapped
+            TLS_CALLBACKS_UNTERMINATED, // AddressOfCallBacks points into the 0xCC filled .text, no null entry nearby
+            LOAD_CONFIG_COUNTS_OVERFLOW, // GuardCFFunctionCount far larger than the file
+            DELAY_IMPORTS_OUT_OF_FILE,  // first delay load descriptor name, INT and IAT point past the end of the file
+            CERTIFICATE_LENGTH_OVERFLOW, // first WIN_CERTIFICATE dwLength far past the end of the table
+            CHECKSUM_MISMATCH,          // OptionalHeader.CheckSum off by one
+            MALFORMATIONS_COUNT
+        };
+
+        struct Config
+        {
+            bool x64 = true;
+            size_t sections_count = 3;
+
+            size_t libraries_count = 1;
+            size_t imports_per_library = 8;
+            size_t ordinal_import_every = 8;    // every Nth import is by ordinal, 0 disables
+            bool bound_imports = false;         // bound import descriptors for every library, every 4th one with a forwarder ref
+
+            size_t delay_libraries_count = 0;   // delay load descriptors after the regular libraries, imports_per_library functions each
+            bool delay_va_based = false;        // Visual C++ 6 style descriptors holding VAs, x86 only
+
+            size_t exports_count = 0;
+
+            size_t rsrc_types_count = 0;
+            size_t rsrc_names_per_type = 1;
+            size_t rsrc_langs_per_name = 1;
+            size_t rsrc_extra_depth = 0;        // single entry directories nested below the language level
+            bool rsrc_named_entries = false;    // name level uses IMAGE_RESOURCE_DIR_STRING_U names instead of ids
+            size_t rsrc_payload_size = 64;
+
+            size_t debug_entries_count = 0;     // cycles through CodeView, VC feature, POGO, repro and extended dll characteristics
+
+            size_t relocs_count = 0;            // pointer slots every 8 bytes over dedicated .rdata pages, one block per page
+
+            size_t functions_count = 0;         // x64 only, 12 byte functions every 16 bytes of .text cycling through plain, handler and chained unwind info
+
+            bool tls_dir = false;               // TLS directory with kTlsTemplateSize bytes of template data
+            size_t tls_callbacks_count = 0;     // callbacks into .text, only with tls_dir
+
+            // Load config Size field ends after 1: SEHandlerCount, 2: GuardFlags, 3: GuardLongJumpTargetCount, 4: the whole struct, 0 for none
+            size_t load_config_version = 0;
+            size_t guard_functions_count = 0;   // GuardCFFunctionTable entries with one metadata byte, needs load_config_version >= 2
+            size_t se_handlers_count = 0;       // x86 only, SafeSEH handlers
+
+            size_t certificates_count = 0;      // PKCS SignedData WIN_CERTIFICATE entries after the last section, filler content without a valid signature
+
+            bool checksum = false;              // OptionalHeader.CheckSum of the finished image, computed before any malformation
+
+            Malformation malformation = Malformation::NONE;
+        };
+    public:
+        static std::vector<BYTE> Build(const Config& config);
+
+        // Deterministic for a given generator state, malformed_ratio is the share of images with a malformation
+        static Config RandomConfig(std::mt19937_64& rng, double malformed_ratio);
+
+        static std::string LibraryName(index_t library);
+        static std::string ImportName(index_t library, index_t func);
+        static std::string ExportName(index_t func);
+        static std::string RsrcName(index_t name);
+        static const char* MalformationName(Malformation malformation);
+    };
+
+}
@@ -0,0 +1,211 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    SyntheticPE::Config SignedConfig(bool x64)
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.libraries_count = 3;
+        config.exports_count = 5;
+        config.checksum = true;
+        config.certificates_count = 2;
+
+        return config;
+    }
+
+    std::vector<BYTE> Der(BYTE tag, const std::vector<BYTE>& content)
+    {
+        std::vector<BYTE> element = { tag };
+        if (content.size() < 0x80)
+            element.push_back((BYTE)content.size());
+        else
+        {
+            element.push_back(0x82);
+            element.push_back((BYTE)(content.size() >> 8));
+            element.push_back((BYTE)content.size());
+        }
+
+        element.insert(element.end(), content.begin(), content.end());
+        return element;
+    }
+
+    std::vector<BYTE> Concat(const std::vector<std::vector<BYTE>>& elements)
+    {
+        std::vector<BYTE> bytes;
+        for (const std::vector<BYTE>& element : elements)
+            bytes.insert(bytes.end(), element.begin(), element.end());
+
+        return bytes;
+    }
+
+    // ContentInfo { signedData, [0] SignedData { version, digestAlgorithms, contentInfo { SpcIndirectData,
+    // [0] SpcIndirectDataContent { data, DigestInfo { AlgorithmIdentifier { oid }, digest } } } } }
+    std::vector<BYTE> BuildSignedData(const std::vector<BYTE>& algorithm_oid, const BYTE* digest, size_t digest_size)
+    {
+        const std::vector<BYTE> signed_data_oid = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02 };
+        const std::vector<BYTE> spc_indirect_data_oid = { 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x01, 0x04 };
+
+        std::vector<BYTE> digest_info = Der(0x30, Concat({ Der(0x30, Der(0x06, algorithm_oid)), Der(0x04, std::vector<BYTE>(digest, digest + digest_size)) }));
+        std::vector<BYTE> spc_content = Der(0x30, Concat({ Der(0x30, {}), digest_info }));
+        std::vector<BYTE> content_info = Der(0x30, Concat({ Der(0x06, spc_indirect_data_oid), Der(0xA0, spc_content) }));
+        std::vector<BYTE> signed_data = Der(0x30, Concat({ Der(0x02, { 1 }), Der(0x31, {}), content_info }));
+
+        return Der(0x30, Concat({ Der(0x06, signed_data_oid), Der(0xA0, signed_data) }));
+    }
+
+    // Replaces the certificate table at the end of the image with a single WIN_CERTIFICATE holding content
+    void ReplaceCertificates(std::vector<BYTE>& image, const std::vector<BYTE>& content)
+    {
+        RawFile raw_file(std::filesystem::path(), "signed", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        offset_t entry_offset = (const BYTE*)&pe.GetDataDirectory()[DataDirEntries::SECU] - image.data();
+        offset_t table_offset = pe.GetDataDirectory()[DataDirEntries::SECU].VirtualAddress;
+
+        const size_t header_size = offsetof(WIN_CERTIFICATE, bCertificate);
+        WIN_CERTIFICATE header = {};
+        header.dwLength = (DWORD)(header_size + content.size());
+        header.wRevision = WIN_CERT_REVISION_2_0;
+        header.wCertificateType = WIN_CERT_TYPE_PKCS_SIGNED_DATA;
+
+        image.resize(table_offset);
+        image.resize(table_offset + ((header.dwLength + 7) & ~(size_t)7), 0);
+        std::memcpy(image.data() + table_offset, &header, header_size);
+        std::memcpy(image.data() + table_offset + header_size, content.data(), content.size());
+
+        IMAGE_DATA_DIRECTORY security_dir = { (DWORD)table_offset, (DWORD)(image.size() - table_offset) };
+        std::memcpy(image.data() + entry_offset, &security_dir, sizeof(security_dir));
+    }
+
+    SecurityDirWrapper::DigestCheck CheckDigest(std::vector<BYTE>& image)
+    {
+        RawFile raw_file(std::filesystem::path(), "signed", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        const SecurityDirWrapper* security_dir_wrapper = pe.GetSecurityDirWrapper();
+
+        // The first call hashes, the second returns the stored result
+        SecurityDirWrapper::DigestCheck check = security_dir_wrapper->CheckImageDigest();
+        PEW_CHECK(security_dir_wrapper->CheckImageDigest() == check);
+
+        return check;
+    }
+
+    const std::vector<BYTE> kOidSha1 = { 0x2B, 0x0E, 0x03, 0x02, 0x1A };
+    const std::vector<BYTE> kOidSha256 = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01 };
+    const std::vector<BYTE> kOidMd5 = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x02, 0x05 };
+
+}
+
+PEW_TEST(AuthenticodeKnownDigests)
+{
+    struct KnownAnswer
+    {
+        bool x64;
+        offset_t security_entry;
+        const char* sha1;
+        const char* sha256;
+    };
+
+    // Computed outside the parser over the generated files, minus CheckSum, the security entry and the table
+    const KnownAnswer answers[] = {
+        { false, 0xD8, "536a01e8ddeb50d16a83d1b5fcb9ceac2bc50ed4", "178e29c73a1e891a9f5df30666f59020b33c0f1f46021543926d453ba18203eb" },
+        { true, 0xE8, "b7f3e288748700ea8dc7e5535d5a414f7cf4dee8", "369ec5c6b6e47a33958c1c6db3ceb5cae8abf33c263eb6cdd5a708ded97bdcf6" }
+    };
+
+    for (const KnownAnswer& answer : answers)
+    {
+        std::vector<BYTE> image = SyntheticPE::Build(SignedConfig(answer.x64));
+        PEW_CHECK(image.size() == 0x1640);
+
+        RawFile raw_file(std::filesystem::path(), "authenticode", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        AuthenticodeHasher hasher(&pe);
+
+        // The certificate table ends the file, so nothing follows it
+        PEW_CHECK(hasher.GetRangesCount() == 3);
+        PEW_CHECK(hasher.GetRange(0).begin == 0 && hasher.GetRange(0).end == 0x98);
+        PEW_CHECK(hasher.GetRange(1).begin == 0x9C && hasher.GetRange(1).end == answer.security_entry);
+        PEW_CHECK(hasher.GetRange(2).begin == answer.security_entry + 8 && hasher.GetRange(2).end == 0x1600);
+        PEW_CHECK(hasher.GetHashedSize() == 0x1640 - sizeof(DWORD) - sizeof(IMAGE_DATA_DIRECTORY) - 0x40);
+
+        PEW_CHECK(hasher.Compute(DigestAlgorithm::SHA1).ToHex() == answer.sha1);
+        PEW_CHECK(hasher.Compute(DigestAlgorithm::SHA256).ToHex() == answer.sha256);
+
+        Digest digests[2];
+        digests[0].algorithm = DigestAlgorithm::SHA256;
+        digests[1].algorithm = DigestAlgorithm::SHA1;
+        hasher.Compute(digests, 2);
+        PEW_CHECK(digests[0].ToHex() == answer.sha256 && digests[1].ToHex() == answer.sha1);
+    }
+}
+
+PEW_TEST(AuthenticodeExcludedRanges)
+{
+    std::vector<BYTE> image = SyntheticPE::Build(SignedConfig(true));
+
+    auto digest_of = [](std::vector<BYTE>& bytes)
+    {
+        RawFile raw_file(std::filesystem::path(), "authenticode", bytes.size(), bytes.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        return AuthenticodeHasher(&pe).Compute(DigestAlgorithm::SHA256);
+    };
+
+    Digest reference = digest_of(image);
+
+    // CheckSum and the certificate table do not count, the bytes next to them do
+    const offset_t checksum_offset = 0x98;
+    for (offset_t offset : { checksum_offset, checksum_offset + 3, (offset_t)0x1600, (offset_t)0x1620, (offset_t)0x163F })
+    {
+        std::vector<BYTE> changed = image;
+        changed[offset] ^= 0xFF;
+        PEW_CHECK(digest_of(changed) == reference);
+    }
+
+    for (offset_t offset : { checksum_offset - 1, checksum_offset + 4, (offset_t)0xE8 - 1, (offset_t)0xF0, (offset_t)0x15FF })
+    {
+        std::vector<BYTE> changed = image;
+        changed[offset] ^= 0xFF;
+        PEW_CHECK(digest_of(changed) != reference);
+    }
+}
+
+PEW_TEST(AuthenticodeDigestCheck)
+{
+    for (bool x64 : { false, true })
+    {
+        std::vector<BYTE> image = SyntheticPE::Build(SignedConfig(x64));
+
+        // Synthetic certificates carry no SignedData
+        PEW_CHECK(CheckDigest(image) == SecurityDirWrapper::DigestCheck::NOT_SIGNED);
+
+        Digest sha256;
+        Digest sha1;
+        {
+            RawFile raw_file(std::filesystem::path(), "signed", image.size(), image.data(), RawFile::Backing::BORROWED);
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            sha256 = AuthenticodeHasher(&pe).Compute(DigestAlgorithm::SHA256);
+            sha1 = AuthenticodeHasher(&pe).Compute(DigestAlgorithm::SHA1);
+        }
+
+        // The table is not hashed, so it can hold the digest of the image it is part of
+        ReplaceCertificates(image, BuildSignedData(kOidSha256, sha256.bytes, sha256.size));
+        PEW_CHECK(CheckDigest(image) == SecurityDirWrapper::DigestCheck::MATCH);
+
+        ReplaceCertificates(image, BuildSignedData(kOidSha1, sha1.bytes, sha1.size));
+        PEW_CHECK(CheckDigest(image) == SecurityDirWrapper::DigestCheck::MATCH);
+
+        ReplaceCertificates(image, BuildSignedData(kOidMd5, sha1.bytes, 16));
+        PEW_CHECK(CheckDigest(image) == SecurityDirWrapper::DigestCheck::UNSUPPORTED);
+
+        ReplaceCertificates(image, BuildSignedData(kOidSha256, sha256.bytes, sha256.size));
+        image[0x400] ^= 0x01;
+        PEW_CHECK(CheckDigest(image) == SecurityDirWrapper::DigestCheck::MISMATCH);
+    }
+}
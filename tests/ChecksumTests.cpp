@@ -0,0 +1,125 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    const SimdIsa kIsas[] = { SimdIsa::SCALAR, SimdIsa::SSE2, SimdIsa::AVX2 };
+
+    // Word at a time with the carry folded on every add, the textbook form of the algorithm
+    DWORD ReferenceChecksum(const std::vector<BYTE>& data, offset_t checksum_offset)
+    {
+        DWORD sum = 0;
+        for (size_t i = 0; i < data.size(); i += sizeof(WORD))
+        {
+            DWORD word = 0;
+            for (size_t byte = 0; byte < sizeof(WORD) && i + byte < data.size(); byte++)
+            {
+                if (i + byte < checksum_offset || i + byte >= checksum_offset + sizeof(DWORD))
+                    word |= (DWORD)data[i + byte] << (byte * 8);
+            }
+
+            sum += word;
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        }
+
+        return sum + (DWORD)data.size();
+    }
+
+    void CheckIsas(const std::vector<BYTE>& data, offset_t checksum_offset)
+    {
+        DWORD expected = ReferenceChecksum(data, checksum_offset);
+
+        for (SimdIsa isa : kIsas)
+        {
+            if (isa <= GetSimdIsa())
+                PEW_CHECK(ComputeImageChecksum(isa, data.data(), data.size(), checksum_offset) == expected);
+        }
+    }
+
+}
+
+PEW_TEST(ChecksumKnownAnswers)
+{
+    struct KnownAnswer
+    {
+        bool x64;
+        DWORD checksum;
+    };
+
+    // Computed outside the parser over the generated files
+    const KnownAnswer answers[] = { { false, 0xC281 }, { true, 0x8D83 } };
+
+    for (const KnownAnswer& answer : answers)
+    {
+        SyntheticPE::Config config;
+        config.x64 = answer.x64;
+        config.libraries_count = 3;
+        config.exports_count = 5;
+        config.checksum = true;
+        config.certificates_count = 2;
+        std::vector<BYTE> image = SyntheticPE::Build(config);
+
+        RawFile raw_file(std::filesystem::path(), "checksum", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        const OptionalHdrWrapper* optional_hdr_wrapper = pe.GetOptionalHdrWrapper();
+        offset_t checksum_offset = pe.GetOptionalHdrOffset() + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum);
+
+        for (SimdIsa isa : kIsas)
+        {
+            if (isa <= GetSimdIsa())
+                PEW_CHECK(ComputeImageChecksum(isa, image.data(), image.size(), checksum_offset) == answer.checksum);
+        }
+
+        PEW_CHECK(optional_hdr_wrapper->GetChecksum() == answer.checksum);
+        PEW_CHECK(optional_hdr_wrapper->ComputeChecksum() == answer.checksum);
+        PEW_CHECK(optional_hdr_wrapper->ComputeChecksum() == answer.checksum);
+        PEW_CHECK(optional_hdr_wrapper->VerifyChecksum() == OptionalHdrWrapper::ChecksumCheck::MATCH);
+    }
+}
+
+PEW_TEST(ChecksumVerify)
+{
+    SyntheticPE::Config config;
+    config.checksum = true;
+    config.malformation = SyntheticPE::Malformation::CHECKSUM_MISMATCH;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+    {
+        RawFile raw_file(std::filesystem::path(), "checksum_mismatch", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        PEW_CHECK(pe.GetOptionalHdrWrapper()->VerifyChecksum() == OptionalHdrWrapper::ChecksumCheck::MISMATCH);
+    }
+
+    config = SyntheticPE::Config();
+    image = SyntheticPE::Build(config);
+    {
+        RawFile raw_file(std::filesystem::path(), "checksum_not_set", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        PEW_CHECK(pe.GetOptionalHdrWrapper()->VerifyChecksum() == OptionalHdrWrapper::ChecksumCheck::NOT_SET);
+    }
+}
+
+PEW_TEST(ChecksumSimdMatchesReference)
+{
+    // Every length around the 32 and 64 byte steps, odd sizes and CheckSum at odd offsets or cut by the end
+    std::vector<BYTE> data(300);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (BYTE)(i * 151 + 7);
+
+    for (size_t size = 0; size <= data.size(); size++)
+    {
+        std::vector<BYTE> prefix(data.begin(), data.begin() + size);
+        for (offset_t checksum_offset : { (offset_t)0, (offset_t)0x41, (offset_t)0x98, (offset_t)size - 2, (offset_t)size + 8 })
+            CheckIsas(prefix, checksum_offset);
+    }
+
+    // All ones saturates every lane, 8 MiB and a few bytes spans several flushes of the 32 bit lane sums
+    std::vector<BYTE> ones(8 * 1024 * 1024 + 67, 0xFF);
+    CheckIsas(ones, 0x98);
+    CheckIsas(ones, ones.size() - 3);
+}
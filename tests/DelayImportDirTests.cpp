@@ -0,0 +1,138 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    const size_t kLibrariesCount = 2;
+    const size_t kDelayLibrariesCount = 3;
+    const size_t kImportsPerLibrary = 7;
+    const size_t kOrdinalEvery = 3;
+
+    std::vector<BYTE> BuildDelayImage(bool x64, bool va_based)
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.libraries_count = kLibrariesCount;
+        config.delay_libraries_count = kDelayLibrariesCount;
+        config.delay_va_based = va_based;
+        config.imports_per_library = kImportsPerLibrary;
+        config.ordinal_import_every = kOrdinalEvery;
+
+        return SyntheticPE::Build(config);
+    }
+
+    // Same libraries, functions and IAT slots whichever way the descriptors address them
+    void CheckDelayImports(std::vector<BYTE> image, bool x64, bool va_based)
+    {
+        RawFile raw_file(std::filesystem::path(), "delay_imports", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        DelayImportDirWrapper* delay_import_wrapper = pe.GetDelayImportDirWrapper();
+        const ImportTable& table = delay_import_wrapper->GetImportTable();
+        size_t thunk_size = x64 ? sizeof(ULONGLONG) : sizeof(DWORD);
+
+        PEW_CHECK(delay_import_wrapper->IsValidWrapper());
+        PEW_CHECK(table.GetLibrariesCount() == kDelayLibrariesCount);
+        PEW_CHECK(table.GetTotalFuncCount() == kDelayLibrariesCount * kImportsPerLibrary);
+        PEW_CHECK(!table.is_truncated);
+
+        for (index_t library = 0; library < kDelayLibrariesCount; library++)
+        {
+            const IMAGE_DELAYLOAD_DESCRIPTOR& descriptor = delay_import_wrapper->GetDescriptor(library);
+            index_t synth_library = kLibrariesCount + library;
+
+            PEW_CHECK(delay_import_wrapper->IsRvaBased(library) == (!va_based || library == 1));
+            PEW_CHECK(table.library_names[library] == SyntheticPE::LibraryName(synth_library));
+            PEW_CHECK(table.GetFuncCount(library) == kImportsPerLibrary);
+
+            offset_t iat_rva = delay_import_wrapper->ToRva(library, descriptor.ImportAddressTableRVA);
+            PEW_CHECK(iat_rva && iat_rva < 0x10000);
+
+            for (index_t func = 0; func < kImportsPerLibrary; func++)
+            {
+                index_t entry = table.func_begin[library] + func;
+                PEW_CHECK(table.thunk_rvas[entry] == iat_rva + func * thunk_size);
+
+                if (func % kOrdinalEvery == kOrdinalEvery - 1)
+                {
+                    PEW_CHECK(table.by_ordinal[entry]);
+                    PEW_CHECK(table.ordinals[entry] == func + 1);
+                }
+                else
+                {
+                    PEW_CHECK(!table.by_ordinal[entry]);
+                    PEW_CHECK(table.hints[entry] == func);
+                    PEW_CHECK(table.names[entry] == SyntheticPE::ImportName(synth_library, func));
+                }
+            }
+        }
+    }
+
+}
+
+PEW_TEST(DelayImportsRvaBased)
+{
+    CheckDelayImports(BuildDelayImage(false, false), false, false);
+    CheckDelayImports(BuildDelayImage(true, false), true, false);
+}
+
+PEW_TEST(DelayImportsVaBased)
+{
+    std::vector<BYTE> image = BuildDelayImage(false, true);
+
+    // The second descriptor is rewritten as a version 2 one, with RVAs in its fields and its name thunks
+    offset_t descriptor_offset = 0;
+    ULONGLONG image_base = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "delay_imports", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        DelayImportDirWrapper* delay_import_wrapper = pe.GetDelayImportDirWrapper();
+        PEW_CHECK(!delay_import_wrapper->IsRvaBased(0));
+
+        image_base = pe.GetImageBase();
+        descriptor_offset = delay_import_wrapper->GetRootDescriptorOffset() + sizeof(IMAGE_DELAYLOAD_DESCRIPTOR);
+
+        offset_t int_raw = pe.RvaToRaw(delay_import_wrapper->ToRva(1, delay_import_wrapper->GetDescriptor(1).ImportNameTableRVA));
+        for (index_t func = 0; func < kImportsPerLibrary; func++)
+        {
+            if (func % kOrdinalEvery == kOrdinalEvery - 1)
+                continue;
+
+            DWORD thunk;
+            std::memcpy(&thunk, image.data() + int_raw + func * sizeof(DWORD), sizeof(thunk));
+            thunk -= (DWORD)image_base;
+            std::memcpy(image.data() + int_raw + func * sizeof(DWORD), &thunk, sizeof(thunk));
+        }
+    }
+
+    IMAGE_DELAYLOAD_DESCRIPTOR descriptor;
+    std::memcpy(&descriptor, image.data() + descriptor_offset, sizeof(descriptor));
+    descriptor.Attributes.AllAttributes = 1;
+    descriptor.DllNameRVA -= (DWORD)image_base;
+    descriptor.ModuleHandleRVA -= (DWORD)image_base;
+    descriptor.ImportAddressTableRVA -= (DWORD)image_base;
+    descriptor.ImportNameTableRVA -= (DWORD)image_base;
+    std::memcpy(image.data() + descriptor_offset, &descriptor, sizeof(descriptor));
+
+    CheckDelayImports(image, false, true);
+}
+
+PEW_TEST(DelayImportsVaBelowImageBase)
+{
+    std::vector<BYTE> image = BuildDelayImage(false, true);
+
+    RawFile raw_file(std::filesystem::path(), "delay_imports", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    DelayImportDirWrapper* delay_import_wrapper = pe.GetDelayImportDirWrapper();
+
+    // A VA based field holding an RVA resolves to nothing instead of wrapping around
+    DWORD iat_va = delay_import_wrapper->GetDescriptor(0).ImportAddressTableRVA;
+    PEW_CHECK(delay_import_wrapper->ToRva(0, iat_va) == iat_va - pe.GetImageBase());
+    PEW_CHECK(delay_import_wrapper->ToRva(0, iat_va - (DWORD)pe.GetImageBase()) == 0);
+    PEW_CHECK(delay_import_wrapper->ToRva(0, (DWORD)pe.GetImageBase()) == 0);
+}
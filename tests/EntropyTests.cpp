@@ -0,0 +1,155 @@
+#include <PewParser/PewParser.h>
+#include <Entropy.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace PewParser;
+
+namespace {
+
+    // -sum(p * log2(p)) straight from the definition, counted again for every call
+    double ReferenceEntropy(const BYTE* data, size_t size)
+    {
+        if (!size)
+            return 0.0;
+
+        size_t counts[kByteValuesCount] = {};
+        for (size_t i = 0; i < size; i++)
+            counts[data[i]]++;
+
+        double entropy = 0.0;
+        for (size_t value = 0; value < kByteValuesCount; value++)
+        {
+            if (counts[value])
+            {
+                double p = (double)counts[value] / (double)size;
+                entropy -= p * std::log2(p);
+            }
+        }
+
+        return entropy;
+    }
+
+    bool Near(double a, double b)
+    {
+        return std::fabs(a - b) < 1e-9;
+    }
+
+    void CheckWindows(const std::vector<BYTE>& data, size_t window, size_t step)
+    {
+        size_t windows_count = GetEntropyWindowsCount(data.size(), window, step);
+        std::vector<double> entropies(windows_count);
+        ComputeWindowedEntropy(data.data(), data.size(), window, step, entropies.data());
+
+        for (size_t i = 0; i < windows_count; i++)
+        {
+            size_t size = std::min(window, data.size() - i * step);
+            PEW_CHECK(Near(entropies[i], ReferenceEntropy(data.data() + i * step, size)));
+        }
+    }
+
+}
+
+PEW_TEST(EntropyUniformAndConstant)
+{
+    // Every byte value the same number of times is the 8 bit maximum, one value repeated is 0
+    std::vector<BYTE> uniform(kByteValuesCount * 1000);
+    for (size_t i = 0; i < uniform.size(); i++)
+        uniform[i] = (BYTE)(i * 7);
+    PEW_CHECK(Near(ComputeEntropy(uniform.data(), uniform.size()), 8.0));
+
+    std::vector<BYTE> constant(100000, 0xCC);
+    PEW_CHECK(ComputeEntropy(constant.data(), constant.size()) == 0.0);
+
+    std::vector<BYTE> halves(4096, 0x00);
+    std::fill(halves.begin() + halves.size() / 2, halves.end(), (BYTE)0xFF);
+    PEW_CHECK(Near(ComputeEntropy(halves.data(), halves.size()), 1.0));
+
+    PEW_CHECK(ComputeEntropy(uniform.data(), 0) == 0.0);
+
+    // Odd sizes go through the tail loop of the counter
+    for (size_t size = 1; size < 100; size++)
+        PEW_CHECK(Near(ComputeEntropy(uniform.data() + 3, size), ReferenceEntropy(uniform.data() + 3, size)));
+}
+
+PEW_TEST(EntropyWindowsCount)
+{
+    PEW_CHECK(GetEntropyWindowsCount(0, 256, 64) == 0);
+    PEW_CHECK(GetEntropyWindowsCount(100, 256, 64) == 1);
+    PEW_CHECK(GetEntropyWindowsCount(256, 256, 64) == 1);
+    PEW_CHECK(GetEntropyWindowsCount(256 + 63, 256, 64) == 1);
+    PEW_CHECK(GetEntropyWindowsCount(256 + 64, 256, 64) == 2);
+    PEW_CHECK(GetEntropyWindowsCount(1000, 100, 300) == 4);
+    PEW_CHECK(GetEntropyWindowsCount(1000, 256, 0) == 0);
+}
+
+PEW_TEST(EntropyWindowsUniformAndConstant)
+{
+    // 3000 windows, past the resync every 1024 windows, so rounding left by the running sum would show up
+    const size_t window = 256, step = 64, windows_count = 3000;
+    const size_t size = window + (windows_count - 1) * step;
+
+    std::vector<BYTE> uniform(size);
+    for (size_t i = 0; i < size; i++)
+        uniform[i] = (BYTE)i;
+
+    std::vector<double> entropies(GetEntropyWindowsCount(size, window, step));
+    PEW_CHECK(entropies.size() == windows_count);
+    ComputeWindowedEntropy(uniform.data(), size, window, step, entropies.data());
+    PEW_CHECK(std::all_of(entropies.begin(), entropies.end(), [](double entropy) { return Near(entropy, 8.0); }));
+
+    std::vector<BYTE> constant(size, 0x90);
+    ComputeWindowedEntropy(constant.data(), size, window, step, entropies.data());
+    PEW_CHECK(std::all_of(entropies.begin(), entropies.end(), [](double entropy) { return entropy == 0.0; }));
+}
+
+PEW_TEST(EntropyWindowsMatchReference)
+{
+    // Runs and noise mixed so windows keep changing, long enough to resync a few times
+    std::vector<BYTE> data(256 + 4000 * 64 + 17);
+    uint32_t state = 0x12345678;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        state = state * 1103515245 + 12345;
+        data[i] = ((i / 4096) % 3 == 0) ? (BYTE)(i / 512) : (BYTE)(state >> 24) & (BYTE)((i / 1024) | 0x0F);
+    }
+
+    CheckWindows(data, 256, 64);
+    CheckWindows(data, 256, 1);
+    // Disjoint windows swap the whole window, a gap between them skips bytes
+    CheckWindows(data, 256, 256);
+    CheckWindows(data, 100, 300);
+    // One window when the input is not longer than the window
+    CheckWindows(std::vector<BYTE>(data.begin(), data.begin() + 200), 256, 64);
+}
+
+PEW_TEST(EntropySections)
+{
+    SyntheticPE::Config config;
+    config.libraries_count = 3;
+    config.exports_count = 5;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "entropy", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    const SectionHdrsWrapper* section_hdrs_wrapper = pe.GetSectionHdrsWrapper();
+
+    for (index_t section = 0; section < section_hdrs_wrapper->GetNumOfSections(); section++)
+    {
+        ByteSpan raw_data = section_hdrs_wrapper->GetSectionRawData(section);
+        double entropy = ReferenceEntropy(raw_data.data(), raw_data.size());
+
+        std::pmr::vector<double> entropies = section_hdrs_wrapper->GetSectionEntropyMap(section);
+        double max_window_entropy = entropies.empty() ? 0.0 : *std::max_element(entropies.begin(), entropies.end());
+
+        // The second call returns the stored value
+        PEW_CHECK(Near(section_hdrs_wrapper->GetSectionEntropy(section), entropy));
+        PEW_CHECK(Near(section_hdrs_wrapper->GetSectionEntropy(section), entropy));
+        PEW_CHECK(section_hdrs_wrapper->GetSectionMaxWindowEntropy(section) == max_window_entropy);
+        PEW_CHECK(section_hdrs_wrapper->GetSectionMaxWindowEntropy(section) == max_window_entropy);
+    }
+}
@@ -0,0 +1,131 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace PewParser;
+
+namespace {
+
+    const size_t kFunctionsCount = 100;
+
+    int64_t FindLinear(const std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY>& functions, DWORD rva)
+    {
+        for (size_t i = 0; i < functions.size(); i++)
+        {
+            if (rva >= functions[i].BeginAddress && rva < functions[i].EndAddress)
+                return (int64_t)i;
+        }
+
+        return -1;
+    }
+
+    // Every rva around the table forwards, backwards and strided, so both the last hit shortcut and the search run
+    void CheckLookups(const ExceptionDirWrapper* exception_dir_wrapper, const std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY>& expected)
+    {
+        PEW_CHECK(exception_dir_wrapper->GetFunctionsCount() == expected.size());
+        for (index_t i = 0; i < expected.size(); i++)
+        {
+            PEW_CHECK(exception_dir_wrapper->GetFunction(i).BeginAddress == expected[i].BeginAddress);
+            PEW_CHECK(exception_dir_wrapper->GetFunction(i).EndAddress == expected[i].EndAddress);
+        }
+
+        DWORD first = expected.front().BeginAddress - 0x20;
+        DWORD last = expected.back().EndAddress + 0x20;
+
+        for (DWORD rva = first; rva < last; rva++)
+            PEW_CHECK(exception_dir_wrapper->FindFunction(rva) == FindLinear(expected, rva));
+
+        for (DWORD rva = last; rva > first; rva--)
+            PEW_CHECK(exception_dir_wrapper->FindFunction(rva) == FindLinear(expected, rva));
+
+        for (DWORD step = 0; step < 0x2000; step++)
+        {
+            DWORD rva = first + (DWORD)((step * 0x9E3779B1u) % (last - first));
+            PEW_CHECK(exception_dir_wrapper->FindFunction(rva) == FindLinear(expected, rva));
+        }
+
+        PEW_CHECK(exception_dir_wrapper->FindFunction(0) == -1);
+        PEW_CHECK(exception_dir_wrapper->FindFunction(0xFFFFFFFF) == -1);
+    }
+
+    std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY> ReadFunctions(const std::vector<BYTE>& image, offset_t offset, size_t count)
+    {
+        std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY> functions(count);
+        std::memcpy(functions.data(), image.data() + offset, count * sizeof(IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY));
+
+        return functions;
+    }
+
+}
+
+PEW_TEST(ExceptionFindFunctionSorted)
+{
+    SyntheticPE::Config config;
+    config.x64 = true;
+    config.functions_count = kFunctionsCount;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "functions_sorted", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ExceptionDirWrapper* exception_dir_wrapper = pe.GetExceptionDirWrapper();
+
+    PEW_CHECK(exception_dir_wrapper->IsInPlace());
+    CheckLookups(exception_dir_wrapper, ReadFunctions(image, exception_dir_wrapper->GetRootEntryOffset(), kFunctionsCount));
+}
+
+PEW_TEST(ExceptionFindFunctionUnsorted)
+{
+    SyntheticPE::Config config;
+    config.x64 = true;
+    config.functions_count = kFunctionsCount;
+    config.malformation = SyntheticPE::Malformation::FUNCTIONS_UNSORTED;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "functions_unsorted", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ExceptionDirWrapper* exception_dir_wrapper = pe.GetExceptionDirWrapper();
+
+    std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY> expected = ReadFunctions(image, exception_dir_wrapper->GetRootEntryOffset(), kFunctionsCount);
+    PEW_CHECK(expected.front().BeginAddress > expected.back().BeginAddress);
+    std::sort(expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) { return lhs.BeginAddress < rhs.BeginAddress; });
+
+    PEW_CHECK(!exception_dir_wrapper->IsInPlace());
+    CheckLookups(exception_dir_wrapper, expected);
+}
+
+PEW_TEST(ExceptionFindFunctionDropsEmptyAndOverlapping)
+{
+    SyntheticPE::Config config;
+    config.x64 = true;
+    config.functions_count = kFunctionsCount;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t root_offset = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "functions_reversed", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        root_offset = pe.GetExceptionDirWrapper()->GetRootEntryOffset();
+    }
+
+    // Reversed table with an empty entry and one that starts inside the function before it
+    std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY> functions = ReadFunctions(image, root_offset, kFunctionsCount);
+    std::vector<IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY> expected = functions;
+    functions[10].EndAddress = functions[10].BeginAddress;
+    functions[20].BeginAddress = functions[19].BeginAddress + 4;
+    expected.erase(expected.begin() + 20);
+    expected.erase(expected.begin() + 10);
+
+    std::reverse(functions.begin(), functions.end());
+    std::memcpy(image.data() + root_offset, functions.data(), functions.size() * sizeof(IMAGE_AMD64_RUNTIME_FUNCTION_ENTRY));
+
+    RawFile raw_file(std::filesystem::path(), "functions_reversed", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ExceptionDirWrapper* exception_dir_wrapper = pe.GetExceptionDirWrapper();
+
+    PEW_CHECK(!exception_dir_wrapper->IsInPlace());
+    CheckLookups(exception_dir_wrapper, expected);
+}
@@ -0,0 +1,36 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+PEW_TEST(ExportOrdinalsAboveWordRange)
+{
+    SyntheticPE::Config config;
+    config.exports_count = 4;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t export_dir_offset = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "exports", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        export_dir_offset = pe.GetExportDirWrapper()->GetExportDirOffset();
+    }
+
+    const DWORD base = 0x12345;
+    std::memcpy(image.data() + export_dir_offset + offsetof(IMAGE_EXPORT_DIRECTORY, Base), &base, sizeof(base));
+
+    RawFile raw_file(std::filesystem::path(), "exports", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ExportDirWrapper* export_dir_wrapper = pe.GetExportDirWrapper();
+
+    PEW_CHECK(export_dir_wrapper->GetNumOfFunctions() == 4);
+    for (index_t entry = 0; entry < export_dir_wrapper->GetNumOfFunctions(); entry++)
+    {
+        export_dir_wrapper->SetEATEntry(entry);
+        PEW_CHECK(export_dir_wrapper->GetOrdinal() == base + entry);
+    }
+}
@@ -0,0 +1,179 @@
+#include <PewParser/PewParser.h>
+#include <FileHasher.h>
+#include <Terminal/Scanner.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    std::vector<BYTE> BuildImage(bool x64)
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.libraries_count = 3;
+        config.exports_count = 5;
+        config.checksum = true;
+        config.certificates_count = 2;
+
+        return SyntheticPE::Build(config);
+    }
+
+    // The synthetic image grown past FileHasher::kParallelMinSize, with sections spread over the overlay:
+    // one ending past the file, two overlapping and one empty
+    std::vector<BYTE> BuildBigImage()
+    {
+        std::vector<BYTE> image = BuildImage(true);
+        size_t image_size = image.size();
+
+        image.resize(FileHasher::kParallelMinSize + 3 * FileHasher::kChunkSize + 123);
+        uint32_t state = 0xC0FFEE;
+        for (size_t i = image_size; i < image.size(); i++)
+        {
+            state = state * 1103515245 + 12345;
+            image[i] = (BYTE)(state >> 16);
+        }
+
+        DWORD e_lfanew;
+        std::memcpy(&e_lfanew, image.data() + offsetof(IMAGE_DOS_HEADER, e_lfanew), sizeof(e_lfanew));
+        IMAGE_NT_HEADERS64* nt_hdrs = (IMAGE_NT_HEADERS64*)(image.data() + e_lfanew);
+        IMAGE_SECTION_HEADER* section_hdrs = (IMAGE_SECTION_HEADER*)((BYTE*)&nt_hdrs->OptionalHeader + nt_hdrs->FileHeader.SizeOfOptionalHeader);
+
+        section_hdrs[0].PointerToRawData = 0x200;
+        section_hdrs[0].SizeOfRawData = 5 * 1024 * 1024 + 1;
+        section_hdrs[1].PointerToRawData = 0x10000;
+        section_hdrs[1].SizeOfRawData = 3 * 1024 * 1024;
+        section_hdrs[2].PointerToRawData = 0x700000;
+        section_hdrs[2].SizeOfRawData = 0x400000;
+
+        return image;
+    }
+
+    std::vector<Digest> HashFile(PEFile* pe, size_t threads_count, Digest (&digests)[3])
+    {
+        digests[0].algorithm = DigestAlgorithm::MD5;
+        digests[1].algorithm = DigestAlgorithm::SHA1;
+        digests[2].algorithm = DigestAlgorithm::SHA256;
+
+        FileHasher file_hasher(pe);
+        std::vector<Digest> section_digests(file_hasher.GetSectionsCount());
+        file_hasher.Compute(digests, 3, section_digests.data(), threads_count);
+
+        return section_digests;
+    }
+
+}
+
+PEW_TEST(FileHasherKnownAnswers)
+{
+    struct KnownAnswer
+    {
+        bool x64;
+        const char* md5;
+        const char* sha1;
+        const char* sha256;
+        const char* sections_sha256[3];
+    };
+
+    // Computed outside the parser over the generated files, the third section has no raw data
+    const KnownAnswer answers[] = {
+        { false,
+            "a205a6a1adfeaca586d499f00d8e815e",
+            "04826952abe92d3165989a7fce9669f297cf1f75",
+            "577d6b4acad24c061cb69379c031cefd99dc74533b9a3fb596db02481b0a48a1",
+            { "803935e59557e56a9380959c5434b3416bd70259671873491412545b95b8969e",
+              "2730cf0dbb1f2559901e31cbc59663c143b0256f106abf2c0ba153954510ecc3",
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" } },
+        { true,
+            "c2c732cde50a5484dbe204428e4854ec",
+            "034f6d737b31f467e4f9ca974398d88315521ab7",
+            "c97e2ffd07899b79796f410b01e3a88a2bad0d94a844487a6887f6b203b850f7",
+            { "803935e59557e56a9380959c5434b3416bd70259671873491412545b95b8969e",
+              "0c34bdb80b302ff7aed14a297a85f90312a414a331abf2faf40b1f8df300e6a6",
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" } },
+    };
+
+    for (const KnownAnswer& answer : answers)
+    {
+        std::vector<BYTE> image = BuildImage(answer.x64);
+        RawFile raw_file(std::filesystem::path(), "hashes", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+        Digest digests[3];
+        std::vector<Digest> section_digests = HashFile(&pe, 1, digests);
+        PEW_CHECK(digests[0].ToHex() == answer.md5);
+        PEW_CHECK(digests[1].ToHex() == answer.sha1);
+        PEW_CHECK(digests[2].ToHex() == answer.sha256);
+
+        PEW_CHECK(section_digests.size() == 3);
+        for (size_t section = 0; section < section_digests.size() && section < 3; section++)
+        {
+            PEW_CHECK(section_digests[section].algorithm == DigestAlgorithm::SHA256);
+            PEW_CHECK(section_digests[section].ToHex() == answer.sections_sha256[section]);
+        }
+    }
+}
+
+PEW_TEST(FileHasherParallelMatchesOnePass)
+{
+    std::vector<BYTE> image = BuildBigImage();
+    RawFile raw_file(std::filesystem::path(), "hashes_big", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    // One thread makes the single pass, more than one hashes the sections on workers
+    Digest one_pass[3];
+    std::vector<Digest> one_pass_sections = HashFile(&pe, 1, one_pass);
+
+    for (size_t threads_count : { 2, 3, 8 })
+    {
+        Digest parallel[3];
+        std::vector<Digest> parallel_sections = HashFile(&pe, threads_count, parallel);
+
+        for (size_t i = 0; i < 3; i++)
+            PEW_CHECK(parallel[i] == one_pass[i]);
+        PEW_CHECK(parallel_sections == one_pass_sections);
+    }
+
+    // And both against the sections hashed on their own, the first one clamped to the end of the file
+    FileHasher file_hasher(&pe);
+    PEW_CHECK(file_hasher.GetSection(0).size() == 5 * 1024 * 1024 + 1);
+    PEW_CHECK(file_hasher.GetSection(2).size() == image.size() - 0x700000);
+    for (index_t section = 0; section < file_hasher.GetSectionsCount(); section++)
+    {
+        ByteSpan raw_data = file_hasher.GetSection(section);
+
+        Digest expected;
+        expected.algorithm = DigestAlgorithm::SHA256;
+        expected.size = Sha256::kDigestSize;
+        Sha256 sha256;
+        sha256.Update(raw_data.data(), raw_data.size());
+        sha256.Final(expected.bytes);
+
+        PEW_CHECK(one_pass_sections[section] == expected);
+    }
+}
+
+PEW_TEST(FileHasherScannerHashThreads)
+{
+    std::vector<BYTE> image = BuildBigImage();
+    RawFile raw_file(std::filesystem::path(), "hashes_scanner", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    Scanner::Record single;
+    Scanner::ExtractRecord(&pe, single, true, 1);
+    Scanner::Record threaded;
+    Scanner::ExtractRecord(&pe, threaded, true, 4);
+
+    PEW_CHECK(threaded.md5 == single.md5);
+    PEW_CHECK(threaded.sha1 == single.sha1);
+    PEW_CHECK(threaded.sha256 == single.sha256);
+    PEW_CHECK(threaded.sections_sha256 == single.sections_sha256);
+    PEW_CHECK(single.sections_sha256.size() == 3);
+
+    PEW_CHECK(Scanner(std::filesystem::path(), 4).GetHashThreadsCount() == 0);
+    PEW_CHECK(Scanner(std::filesystem::path(), 4, Scanner::OutputFormat::NDJSON, PESerializer::ALL_PASSES, 2).GetHashThreadsCount() == 2);
+}
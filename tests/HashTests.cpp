@@ -0,0 +1,144 @@
+#include <PewParser/PewParser.h>
+#include <Hash/Md5.h>
+#include <Hash/Sha1.h>
+#include <Hash/Sha256.h>
+#include <Hash/MultiDigest.h>
+
+#include "Test.h"
+
+#include <string>
+#include <algorithm>
+
+using namespace PewParser;
+
+namespace {
+
+    struct KnownAnswer
+    {
+        std::string message;
+        const char* md5;
+        const char* sha1;
+        const char* sha256;
+    };
+
+    // Fed piece bytes per Update so the buffered tail and the straight from input blocks both run
+    template <typename Hasher>
+    std::string HashHex(Hasher& hasher, DigestAlgorithm algorithm, const BYTE* data, size_t size, size_t piece)
+    {
+        for (size_t i = 0; i < size; i += piece)
+            hasher.Update(data + i, std::min(piece, size - i));
+
+        Digest digest;
+        digest.algorithm = algorithm;
+        digest.size = Hasher::kDigestSize;
+        hasher.Final(digest.bytes);
+
+        return digest.ToHex();
+    }
+
+    std::vector<BYTE> MakeData(size_t size)
+    {
+        std::vector<BYTE> data(size);
+        uint32_t state = 0x9E3779B9;
+        for (size_t i = 0; i < size; i++)
+        {
+            state = state * 1664525 + 1013904223;
+            data[i] = (BYTE)(state >> 24);
+        }
+
+        return data;
+    }
+
+}
+
+PEW_TEST(HashKnownAnswers)
+{
+    // FIPS 180-4 and RFC 1321 test vectors
+    const KnownAnswer answers[] = {
+        { "",
+            "d41d8cd98f00b204e9800998ecf8427e",
+            "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+        { "abc",
+            "900150983cd24fb0d6963f7d28e17f72",
+            "a9993e364706816aba3e25717850c26c9cd0d89d",
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+        { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+            "8215ef0796a20bcaaae116d3876c664a",
+            "84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+        { std::string(1000000, 'a'),
+            "7707d6ae4e027c70eea2a935c2296f21",
+            "34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+    };
+
+    for (const KnownAnswer& answer : answers)
+    {
+        const BYTE* data = (const BYTE*)answer.message.data();
+        size_t size = answer.message.size();
+
+        for (size_t piece : { std::max<size_t>(size, 1), (size_t)1, (size_t)63, (size_t)64, (size_t)65, (size_t)4096 + 7 })
+        {
+            Md5 md5;
+            PEW_CHECK(HashHex(md5, DigestAlgorithm::MD5, data, size, piece) == answer.md5);
+
+            for (bool use_sha_extensions : { false, true })
+            {
+                Sha1 sha1(use_sha_extensions);
+                PEW_CHECK(HashHex(sha1, DigestAlgorithm::SHA1, data, size, piece) == answer.sha1);
+
+                Sha256 sha256(use_sha_extensions);
+                PEW_CHECK(HashHex(sha256, DigestAlgorithm::SHA256, data, size, piece) == answer.sha256);
+            }
+        }
+
+        // All three at once, SHA-256 asked for twice
+        Digest digests[4];
+        digests[0].algorithm = DigestAlgorithm::SHA256;
+        digests[1].algorithm = DigestAlgorithm::MD5;
+        digests[2].algorithm = DigestAlgorithm::SHA1;
+        digests[3].algorithm = DigestAlgorithm::SHA256;
+
+        MultiDigest multi_digest(digests, 4);
+        multi_digest.Update(data, size);
+        multi_digest.Final(digests, 4);
+        PEW_CHECK(digests[0].ToHex() == answer.sha256);
+        PEW_CHECK(digests[1].ToHex() == answer.md5);
+        PEW_CHECK(digests[2].ToHex() == answer.sha1);
+        PEW_CHECK(digests[3].ToHex() == answer.sha256);
+    }
+}
+
+PEW_TEST(HashShaExtensionsMatchPortable)
+{
+    // Without SHA-NI on the CPU both sides take the portable rounds and the test only checks them against themselves
+    std::vector<BYTE> data = MakeData(1024 * 1024 + 37);
+
+    for (size_t size = 0; size <= 300; size++)
+    {
+        for (size_t piece : { std::max<size_t>(size, 1), (size_t)1, (size_t)55, (size_t)64 })
+        {
+            Sha1 sha1_portable(false), sha1_extensions(true);
+            PEW_CHECK(HashHex(sha1_portable, DigestAlgorithm::SHA1, data.data(), size, piece) ==
+                HashHex(sha1_extensions, DigestAlgorithm::SHA1, data.data(), size, piece));
+
+            Sha256 sha256_portable(false), sha256_extensions(true);
+            PEW_CHECK(HashHex(sha256_portable, DigestAlgorithm::SHA256, data.data(), size, piece) ==
+                HashHex(sha256_extensions, DigestAlgorithm::SHA256, data.data(), size, piece));
+        }
+    }
+
+    Sha1 sha1_portable(false), sha1_extensions(true);
+    PEW_CHECK(HashHex(sha1_portable, DigestAlgorithm::SHA1, data.data(), data.size(), 4096 + 1) ==
+        HashHex(sha1_extensions, DigestAlgorithm::SHA1, data.data(), data.size(), data.size()));
+
+    Sha256 sha256_portable(false), sha256_extensions(true);
+    PEW_CHECK(HashHex(sha256_portable, DigestAlgorithm::SHA256, data.data(), data.size(), 4096 + 1) ==
+        HashHex(sha256_extensions, DigestAlgorithm::SHA256, data.data(), data.size(), data.size()));
+
+    // Reset() starts over with the same state
+    sha256_extensions.Reset();
+    PEW_CHECK(HashHex(sha256_extensions, DigestAlgorithm::SHA256, (const BYTE*)"abc", 3, 3) ==
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
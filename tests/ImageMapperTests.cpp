@@ -0,0 +1,132 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    ULONGLONG ReadImageBase(PEFile& pe, ByteSpan image)
+    {
+        bool is_x32 = (pe.GetOptionalHdrWrapper()->GetOptionalHdrType() == OptHdrType::x32);
+        offset_t offset = pe.GetOptionalHdrOffset() + (is_x32 ? offsetof(IMAGE_OPTIONAL_HEADER32, ImageBase) : offsetof(IMAGE_OPTIONAL_HEADER64, ImageBase));
+
+        ULONGLONG image_base = 0;
+        std::memcpy(&image_base, image.data() + offset, is_x32 ? sizeof(DWORD) : sizeof(ULONGLONG));
+
+        return image_base;
+    }
+
+    size_t CountRawSections(PEFile& pe)
+    {
+        SectionHdrsWrapper* section_hdrs_wrapper = pe.GetSectionHdrsWrapper();
+        IMAGE_SECTION_HEADER* section_hdr = section_hdrs_wrapper->GetRootSectionHdr();
+
+        size_t count = 0;
+        for (size_t i = 0; i < section_hdrs_wrapper->GetNumOfSections(); i++, section_hdr++)
+        {
+            if (section_hdr->SizeOfRawData)
+                count++;
+        }
+
+        return count;
+    }
+
+    // The generator points every fixup slot at the first page of the relocated range
+    void CheckRebase(bool x64, ULONGLONG new_base)
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.relocs_count = 700;
+        std::vector<BYTE> file = SyntheticPE::Build(config);
+
+        RawFile raw_file(std::filesystem::path(), "mapper", file.size(), file.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        const RelocTable& table = pe.GetRelocDirWrapper()->GetRelocTable();
+        PEW_CHECK(table.GetFixupsCount() == 700);
+
+        ULONGLONG old_base = pe.GetImageBase();
+        DWORD targets_rva = table.page_rvas[0];
+
+        ImageMapper mapper;
+        {
+            ImageMapper::MappedImage mapped = mapper.Map(&pe, new_base);
+            PEW_CHECK(mapped);
+
+            ByteSpan image = mapped.GetImage();
+            const ImageMapper::Stats& stats = mapped.GetStats();
+            PEW_CHECK(stats.rebased);
+            PEW_CHECK(stats.fixups_applied == 700);
+            PEW_CHECK(stats.fixups_skipped == 0);
+            PEW_CHECK(stats.sections_count == CountRawSections(pe));
+            PEW_CHECK(mapped.GetImageBase() == new_base);
+            PEW_CHECK(ReadImageBase(pe, image) == (x64 ? new_base : (DWORD)new_base));
+
+            for (index_t entry = 0; entry < table.GetTotalEntriesCount(); entry++)
+            {
+                BYTE type = table.types[entry];
+                if (type == IMAGE_REL_BASED_ABSOLUTE)
+                    continue;
+
+                PEW_CHECK(type == (x64 ? IMAGE_REL_BASED_DIR64 : IMAGE_REL_BASED_HIGHLOW));
+
+                ULONGLONG value = 0;
+                std::memcpy(&value, image.data() + table.rvas[entry], x64 ? sizeof(ULONGLONG) : sizeof(DWORD));
+                PEW_CHECK(value == (x64 ? new_base + targets_rva : (DWORD)(new_base + targets_rva)));
+
+                // The file keeps the preferred base
+                offset_t raw = pe.RvaToRaw(table.rvas[entry]);
+                std::memcpy(&value, file.data() + raw, x64 ? sizeof(ULONGLONG) : sizeof(DWORD));
+                PEW_CHECK(value == old_base + targets_rva);
+            }
+        }
+
+        // Mapped at the preferred base the image is the file laid out, with nothing patched
+        ImageMapper::MappedImage mapped = mapper.Map(&pe, old_base);
+        PEW_CHECK(mapper.GetPooledCount() == 0);
+        PEW_CHECK(mapped.GetStats().rebased && mapped.GetStats().fixups_applied == 0);
+        PEW_CHECK(ReadImageBase(pe, mapped.GetImage()) == old_base);
+
+        SectionHdrsWrapper* section_hdrs_wrapper = pe.GetSectionHdrsWrapper();
+        IMAGE_SECTION_HEADER* section_hdr = section_hdrs_wrapper->GetRootSectionHdr();
+        for (size_t i = 0; i < section_hdrs_wrapper->GetNumOfSections(); i++, section_hdr++)
+        {
+            size_t size = std::min<size_t>(section_hdr->SizeOfRawData, section_hdr->Misc.VirtualSize);
+            PEW_CHECK(std::memcmp(mapped.GetImage().data() + section_hdr->VirtualAddress, file.data() + section_hdr->PointerToRawData, size) == 0);
+        }
+    }
+
+}
+
+PEW_TEST(ImageMapperRebasesX64)
+{
+    CheckRebase(true, 0x7FF612340000);
+}
+
+PEW_TEST(ImageMapperRebasesX86)
+{
+    CheckRebase(false, 0x10000000);
+}
+
+PEW_TEST(ImageMapperWithoutRelocs)
+{
+    SyntheticPE::Config config;
+    std::vector<BYTE> file = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "mapper_no_relocs", file.size(), file.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    // The base cannot move, the header keeps the preferred one
+    ImageMapper mapper;
+    ImageMapper::MappedImage mapped = mapper.Map(&pe, pe.GetImageBase() + 0x10000);
+    PEW_CHECK(mapped);
+    PEW_CHECK(!mapped.GetStats().rebased);
+    PEW_CHECK(mapped.GetStats().fixups_applied == 0);
+    PEW_CHECK(ReadImageBase(pe, mapped.GetImage()) == pe.GetImageBase());
+
+    ImageMapper small_mapper(0x1000);
+    PEW_CHECK(!small_mapper.Map(&pe, pe.GetImageBase()));
+}
@@ -0,0 +1,65 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    // Points the lookup table of every descriptor at the one of the first descriptor
+    std::vector<BYTE> BuildSharedLookupImage(size_t libraries_count, size_t imports_per_library)
+    {
+        SyntheticPE::Config config;
+        config.libraries_count = libraries_count;
+        config.imports_per_library = imports_per_library;
+        std::vector<BYTE> image = SyntheticPE::Build(config);
+
+        RawFile raw_file(std::filesystem::path(), "shared_lookup", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        offset_t descriptors_offset = pe.GetImportDirWrapper()->GetRootDescriptorOffset();
+
+        IMAGE_IMPORT_DESCRIPTOR first;
+        std::memcpy(&first, image.data() + descriptors_offset, sizeof(first));
+        for (size_t library = 1; library < libraries_count; library++)
+        {
+            BYTE* descriptor = image.data() + descriptors_offset + library * sizeof(IMAGE_IMPORT_DESCRIPTOR);
+            std::memcpy(descriptor + offsetof(IMAGE_IMPORT_DESCRIPTOR, OriginalFirstThunk), &first.OriginalFirstThunk, sizeof(DWORD));
+        }
+
+        return image;
+    }
+
+}
+
+PEW_TEST(ImportTableWellFormed)
+{
+    SyntheticPE::Config config;
+    config.libraries_count = 8;
+    config.imports_per_library = 16;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "imports", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    const ImportTable& table = pe.GetImportDirWrapper()->GetImportTable();
+
+    PEW_CHECK(table.GetLibrariesCount() == 8);
+    PEW_CHECK(table.GetTotalFuncCount() == 8 * 16);
+    PEW_CHECK(!table.is_truncated);
+}
+
+PEW_TEST(ImportTableSharedLookupIsWalkedOnce)
+{
+    std::vector<BYTE> image = BuildSharedLookupImage(64, 32);
+
+    RawFile raw_file(std::filesystem::path(), "shared_lookup", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    const ImportTable& table = pe.GetImportDirWrapper()->GetImportTable();
+
+    PEW_CHECK(table.GetLibrariesCount() == 64);
+    PEW_CHECK(table.GetFuncCount(0) == 32);
+    PEW_CHECK(table.GetTotalFuncCount() == 32);
+    PEW_CHECK(table.is_truncated);
+}
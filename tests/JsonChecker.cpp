@@ -0,0 +1,264 @@
+#include "JsonChecker.h"
+
+#include <cstring>
+
+namespace PewParser {
+
+    namespace {
+
+        class JsonChecker
+        {
+        public:
+            explicit JsonChecker(std::string_view text)
+                : it_(text.data()), end_(text.data() + text.size()), depth_(0)
+            {
+            }
+
+            bool Check()
+            {
+                SkipSpaces();
+                if (!Value())
+                    return false;
+
+                SkipSpaces();
+                return it_ == end_;
+            }
+        private:
+            static constexpr size_t kMaxDepth = 256;
+
+            void SkipSpaces()
+            {
+                while (it_ < end_ && (*it_ == ' ' || *it_ == '\t' || *it_ == '\n' || *it_ == '\r'))
+                    it_++;
+            }
+
+            bool Consume(char c)
+            {
+                SkipSpaces();
+                if (it_ == end_ || *it_ != c)
+                    return false;
+
+                it_++;
+                return true;
+            }
+
+            bool Literal(const char* literal)
+            {
+                size_t length = std::strlen(literal);
+                if ((size_t)(end_ - it_) < length || std::memcmp(it_, literal, length) != 0)
+                    return false;
+
+                it_ += length;
+                return true;
+            }
+
+            bool Value()
+            {
+                SkipSpaces();
+                if (it_ == end_)
+                    return false;
+
+                switch (*it_)
+                {
+                    case '{':    return Object();
+                    case '[':    return Array();
+                    case '"':    return String();
+                    case 't':    return Literal("true");
+                    case 'f':    return Literal("false");
+                    case 'n':    return Literal("null");
+                    default:     return Number();
+                }
+            }
+
+            bool Object()
+            {
+                if (++depth_ > kMaxDepth)
+                    return false;
+                it_++;
+
+                if (!Consume('}'))
+                {
+                    do
+                    {
+                        SkipSpaces();
+                        if (!String() || !Consume(':') || !Value())
+                            return false;
+                    } while (Consume(','));
+
+                    if (!Consume('}'))
+                        return false;
+                }
+
+                depth_--;
+                return true;
+            }
+
+            bool Array()
+            {
+                if (++depth_ > kMaxDepth)
+                    return false;
+                it_++;
+
+                if (!Consume(']'))
+                {
+                    do
+                    {
+                        if (!Value())
+                            return false;
+                    } while (Consume(','));
+
+                    if (!Consume(']'))
+                        return false;
+                }
+
+                depth_--;
+                return true;
+            }
+
+            static bool IsHexDigit(char c)
+            {
+                return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+            }
+
+            bool Utf8Sequence()
+            {
+                unsigned char lead = (unsigned char)*it_;
+
+                size_t length = 0;
+                unsigned char second_min = 0x80;
+                unsigned char second_max = 0xBF;
+
+                if (lead >= 0xC2 && lead <= 0xDF)
+                    length = 2;
+                else if (lead >= 0xE0 && lead <= 0xEF)
+                {
+                    length = 3;
+                    second_min = (lead == 0xE0) ? 0xA0 : 0x80;
+                    second_max = (lead == 0xED) ? 0x9F : 0xBF;
+                }
+                else if (lead >= 0xF0 && lead <= 0xF4)
+                {
+                    length = 4;
+                    second_min = (lead == 0xF0) ? 0x90 : 0x80;
+                    second_max = (lead == 0xF4) ? 0x8F : 0xBF;
+                }
+                else
+                    return false;
+
+                if ((size_t)(end_ - it_) < length)
+                    return false;
+
+                unsigned char second = (unsigned char)it_[1];
+                if (second < second_min || second > second_max)
+                    return false;
+
+                for (size_t i = 2; i < length; i++)
+                {
+                    if (((unsigned char)it_[i] & 0xC0) != 0x80)
+                        return false;
+                }
+
+                it_ += length;
+                return true;
+            }
+
+            bool String()
+            {
+                if (it_ == end_ || *it_ != '"')
+                    return false;
+                it_++;
+
+                while (it_ < end_)
+                {
+                    unsigned char c = (unsigned char)*it_;
+
+                    if (c == '"')
+                    {
+                        it_++;
+                        return true;
+                    }
+
+                    if (c < 0x20)
+                        return false;
+
+                    if (c >= 0x80)
+                    {
+                        if (!Utf8Sequence())
+                            return false;
+                        continue;
+                    }
+
+                    it_++;
+                    if (c != '\\')
+                        continue;
+
+                    if (it_ == end_)
+                        return false;
+
+                    char escape = *it_++;
+                    if (escape == 'u')
+                    {
+                        for (int i = 0; i < 4; i++)
+                        {
+                            if (it_ == end_ || !IsHexDigit(*it_++))
+                                return false;
+                        }
+                    }
+                    else if (!std::strchr("\"\\/bfnrt", escape))
+                        return false;
+                }
+
+                return false;
+            }
+
+            size_t Digits()
+            {
+                const char* begin = it_;
+                while (it_ < end_ && *it_ >= '0' && *it_ <= '9')
+                    it_++;
+
+                return it_ - begin;
+            }
+
+            bool Number()
+            {
+                if (it_ < end_ && *it_ == '-')
+                    it_++;
+
+                if (it_ < end_ && *it_ == '0')
+                    it_++;
+                else if (!Digits())
+                    return false;
+
+                if (it_ < end_ && *it_ == '.')
+                {
+                    it_++;
+                    if (!Digits())
+                        return false;
+                }
+
+                if (it_ < end_ && (*it_ == 'e' || *it_ == 'E'))
+                {
+                    it_++;
+                    if (it_ < end_ && (*it_ == '+' || *it_ == '-'))
+                        it_++;
+                    if (!Digits())
+                        return false;
+                }
+
+                return true;
+            }
+        private:
+            const char* it_;
+            const char* end_;
+            size_t depth_;
+        };
+
+    }
+
+    bool IsValidJson(std::string_view text)
+    {
+        return JsonChecker(text).Check();
+    }
+
+}
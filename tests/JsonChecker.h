@@ -0,0 +1,9 @@
+#pragma once
+#include <string_view>
+
+namespace PewParser {
+
+    // Strict RFC 8259 check of one JSON text, strings must be well formed UTF-8 like a json.loads(line.decode('utf-8')) consumer expects
+    bool IsValidJson(std::string_view text);
+
+}
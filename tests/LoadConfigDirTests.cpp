@@ -0,0 +1,174 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    // Size written by the generator for each Config::load_config_version
+    template<typename LoadConfig>
+    size_t ExpectedSize(size_t version)
+    {
+        switch (version)
+        {
+            case 1:     return offsetof(LoadConfig, SEHandlerCount) + sizeof(LoadConfig::SEHandlerCount);
+            case 2:     return offsetof(LoadConfig, GuardFlags) + sizeof(LoadConfig::GuardFlags);
+            case 3:     return offsetof(LoadConfig, GuardLongJumpTargetCount) + sizeof(LoadConfig::GuardLongJumpTargetCount);
+            default:    return sizeof(LoadConfig);
+        }
+    }
+
+    SyntheticPE::Config MakeConfig(bool x64, size_t version)
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.load_config_version = version;
+        config.guard_functions_count = 10;
+        config.se_handlers_count = x64 ? 0 : 6;
+
+        return config;
+    }
+
+    // RVA of a file offset inside the raw data of a section
+    DWORD RawToRva(PEFile& pe, offset_t raw)
+    {
+        SectionHdrsWrapper* section_hdrs_wrapper = pe.GetSectionHdrsWrapper();
+        IMAGE_SECTION_HEADER* section_hdr = section_hdrs_wrapper->GetRootSectionHdr();
+        for (size_t i = 0; i < section_hdrs_wrapper->GetNumOfSections(); i++, section_hdr++)
+        {
+            if (raw >= section_hdr->PointerToRawData && raw < (offset_t)section_hdr->PointerToRawData + section_hdr->SizeOfRawData)
+                return section_hdr->VirtualAddress + (DWORD)(raw - section_hdr->PointerToRawData);
+        }
+
+        return 0;
+    }
+
+    template<typename LoadConfig>
+    void CheckVersions(bool x64)
+    {
+        for (size_t version = 1; version <= 4; version++)
+        {
+            std::vector<BYTE> image = SyntheticPE::Build(MakeConfig(x64, version));
+            size_t expected_size = ExpectedSize<LoadConfig>(version);
+
+            // Bytes after the declared struct are not part of it
+            offset_t load_config_offset = 0;
+            {
+                RawFile raw_file(std::filesystem::path(), "load_config", image.size(), image.data(), RawFile::Backing::BORROWED);
+                PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+                load_config_offset = pe.GetLoadConfigDirWrapper()->GetLoadConfigDirOffset();
+            }
+            size_t garbage_size = std::min<size_t>(sizeof(LoadConfig) - expected_size, image.size() - load_config_offset - expected_size);
+            std::memset(image.data() + load_config_offset + expected_size, 0xCC, garbage_size);
+
+            RawFile raw_file(std::filesystem::path(), "load_config", image.size(), image.data(), RawFile::Backing::BORROWED);
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            LoadConfigDirWrapper* load_config_wrapper = pe.GetLoadConfigDirWrapper();
+
+            PEW_CHECK(load_config_wrapper->IsValidWrapper());
+            PEW_CHECK(load_config_wrapper->IsX32() == !x64);
+            PEW_CHECK(load_config_wrapper->GetDeclaredSize() == expected_size);
+            PEW_CHECK(load_config_wrapper->GetLoadConfigSize() == expected_size);
+            PEW_CHECK(!load_config_wrapper->IsTruncated());
+            PEW_CHECK(load_config_wrapper->GetSecurityCookie() != 0);
+
+            bool has_guard = (version >= 2);
+            PEW_CHECK(load_config_wrapper->HasField(offsetof(LoadConfig, GuardFlags), sizeof(DWORD)) == has_guard);
+            PEW_CHECK((load_config_wrapper->GetGuardFlags() != 0) == has_guard);
+            PEW_CHECK(load_config_wrapper->GetTable(LoadConfigDirWrapper::GUARD_CF_FUNCTIONS).count == (has_guard ? 10u : 0u));
+            PEW_CHECK(load_config_wrapper->GetTable(LoadConfigDirWrapper::SE_HANDLERS).count == (x64 ? 0u : 6u));
+
+            // Everything the linker generation did not write reads as zero
+            const BYTE* fields = x64 ? (const BYTE*)&load_config_wrapper->GetLoadConfig64() : (const BYTE*)&load_config_wrapper->GetLoadConfig32();
+            for (size_t offset = expected_size; offset < sizeof(LoadConfig); offset++)
+                PEW_CHECK(fields[offset] == 0);
+
+            if (has_guard)
+            {
+                const LoadConfigTable& functions = load_config_wrapper->GetTable(LoadConfigDirWrapper::GUARD_CF_FUNCTIONS);
+                PEW_CHECK(functions.stride == sizeof(DWORD) + 1);
+                PEW_CHECK(functions.GetRva(3) == 0x1000 + 3 * 16 && functions.GetFlags(3) == 1);
+            }
+        }
+    }
+
+}
+
+PEW_TEST(LoadConfigVersionsX86)
+{
+    CheckVersions<IMAGE_LOAD_CONFIG_DIRECTORY32>(false);
+}
+
+PEW_TEST(LoadConfigVersionsX64)
+{
+    CheckVersions<IMAGE_LOAD_CONFIG_DIRECTORY64>(true);
+}
+
+PEW_TEST(LoadConfigLongerThanKnown)
+{
+    std::vector<BYTE> image = SyntheticPE::Build(MakeConfig(true, 4));
+
+    offset_t load_config_offset = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "load_config_long", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        load_config_offset = pe.GetLoadConfigDirWrapper()->GetLoadConfigDirOffset();
+    }
+
+    const DWORD size = 0x1000;
+    std::memcpy(image.data() + load_config_offset, &size, sizeof(size));
+
+    RawFile raw_file(std::filesystem::path(), "load_config_long", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    LoadConfigDirWrapper* load_config_wrapper = pe.GetLoadConfigDirWrapper();
+
+    PEW_CHECK(load_config_wrapper->GetDeclaredSize() == size);
+    PEW_CHECK(load_config_wrapper->GetLoadConfigSize() == sizeof(IMAGE_LOAD_CONFIG_DIRECTORY64));
+    PEW_CHECK(!load_config_wrapper->IsTruncated());
+    PEW_CHECK(load_config_wrapper->GetTable(LoadConfigDirWrapper::GUARD_CF_FUNCTIONS).count == 10);
+}
+
+PEW_TEST(LoadConfigCutByTheFile)
+{
+    for (bool x64 : { false, true })
+    {
+        std::vector<BYTE> image = SyntheticPE::Build(MakeConfig(x64, 4));
+        size_t struct_size = x64 ? sizeof(IMAGE_LOAD_CONFIG_DIRECTORY64) : sizeof(IMAGE_LOAD_CONFIG_DIRECTORY32);
+
+        // The struct is moved to the end of the file so only its first bytes are inside it
+        for (size_t available : { sizeof(DWORD), sizeof(DWORD) + 1, (size_t)0x40, struct_size - 1 })
+        {
+            std::vector<BYTE> cut = image;
+            offset_t moved = cut.size() - available;
+            {
+                RawFile raw_file(std::filesystem::path(), "load_config_cut", cut.size(), cut.data(), RawFile::Backing::BORROWED);
+                PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+                offset_t load_config_offset = pe.GetLoadConfigDirWrapper()->GetLoadConfigDirOffset();
+
+                std::memmove(cut.data() + moved, image.data() + load_config_offset, available);
+                DWORD moved_rva = RawToRva(pe, moved);
+                PEW_CHECK(moved_rva != 0);
+                pe.GetDataDirectory()[DataDirEntries::LDCFG].VirtualAddress = moved_rva;
+            }
+
+            RawFile raw_file(std::filesystem::path(), "load_config_cut", cut.size(), cut.data(), RawFile::Backing::BORROWED);
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            LoadConfigDirWrapper* load_config_wrapper = pe.GetLoadConfigDirWrapper();
+
+            PEW_CHECK(load_config_wrapper->GetLoadConfigDirOffset() == moved);
+            PEW_CHECK(load_config_wrapper->GetDeclaredSize() == struct_size);
+            PEW_CHECK(load_config_wrapper->GetLoadConfigSize() == available);
+            PEW_CHECK(load_config_wrapper->IsTruncated());
+            PEW_CHECK(load_config_wrapper->HasField(offsetof(IMAGE_LOAD_CONFIG_DIRECTORY64, Size), sizeof(DWORD)));
+            PEW_CHECK(!load_config_wrapper->HasField(0, struct_size));
+
+            const BYTE* fields = x64 ? (const BYTE*)&load_config_wrapper->GetLoadConfig64() : (const BYTE*)&load_config_wrapper->GetLoadConfig32();
+            for (size_t offset = available; offset < struct_size; offset++)
+                PEW_CHECK(fields[offset] == 0);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#include <PewParser/PewParser.h>
+#include <Serializer/JsonWriter.h>
+#include <Serializer/PESerializer.h>
+
+#include "Test.h"
+#include "JsonChecker.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    // Every structure SyntheticPE knows, so each malformation has something to break
+    SyntheticPE::Config FullConfig(bool x64, SyntheticPE::Malformation malformation)
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.sections_count = 5;
+        config.libraries_count = 4;
+        config.bound_imports = true;
+        config.delay_libraries_count = 2;
+        config.delay_va_based = !x64;
+        config.exports_count = 16;
+        config.rsrc_types_count = 3;
+        config.rsrc_names_per_type = 2;
+        config.rsrc_named_entries = true;
+        config.debug_entries_count = 5;
+        config.relocs_count = 64;
+        config.functions_count = x64 ? 32 : 0;
+        config.tls_dir = true;
+        config.tls_callbacks_count = 2;
+        config.load_config_version = 4;
+        config.guard_functions_count = 8;
+        config.se_handlers_count = x64 ? 0 : 4;
+        config.certificates_count = 1;
+        config.checksum = true;
+        config.malformation = malformation;
+
+        return config;
+    }
+
+}
+
+// The generated corpus used to crash the parser, every variant has to go through the whole serializer
+PEW_TEST(MalformedVariantsSerialize)
+{
+    for (int x64 = 0; x64 < 2; x64++)
+    {
+        for (int variant = 0; variant < (int)SyntheticPE::Malformation::MALFORMATIONS_COUNT; variant++)
+        {
+            std::vector<BYTE> image = SyntheticPE::Build(FullConfig(x64 != 0, (SyntheticPE::Malformation)variant));
+
+            RawFile raw_file(std::filesystem::path(), "malformed", image.size(), image.data(), RawFile::Backing::BORROWED);
+            PEType type = PEParser::ValidatePE(raw_file);
+            if (type == PEType::NotPE || type == PEType::Corrupted)
+            {
+                PEW_CHECK((SyntheticPE::Malformation)variant == SyntheticPE::Malformation::BAD_E_LFANEW);
+                continue;
+            }
+
+            PEFile pe(raw_file, type);
+            JsonWriter writer;
+            writer.BeginObject();
+            PESerializer::SerializePE(&pe, writer);
+            writer.EndObject();
+
+            PEW_CHECK(IsValidJson(writer.View()));
+        }
+    }
+}
+
+PEW_TEST(MalformedSectionsCountIsClamped)
+{
+    std::vector<BYTE> image = SyntheticPE::Build(FullConfig(true, SyntheticPE::Malformation::SECTIONS_COUNT_OVERFLOW));
+
+    RawFile raw_file(std::filesystem::path(), "sections_count", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    SectionHdrsWrapper* section_hdrs_wrapper = pe.GetSectionHdrsWrapper();
+
+    PEW_CHECK(pe.GetNumOfSections() == 0xFFFF);
+    PEW_CHECK(section_hdrs_wrapper->GetNumOfSections() < 0xFFFF);
+    PEW_CHECK(section_hdrs_wrapper->GetRootSectionHdrOffset() + section_hdrs_wrapper->GetNumOfSections() * sizeof(IMAGE_SECTION_HEADER) <= image.size());
+}
+
+PEW_TEST(MalformedDataDirsOutOfImage)
+{
+    std::vector<BYTE> image = SyntheticPE::Build(FullConfig(true, SyntheticPE::Malformation::DATA_DIRS_OUT_OF_IMAGE));
+
+    RawFile raw_file(std::filesystem::path(), "data_dirs", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    // Unmapped RVAs past the end of the file, neither the section walk nor the raw fallback may read them
+    PEW_CHECK(pe.GetDataDirectory()[DataDirEntries::IMP].VirtualAddress >= image.size());
+    PEW_CHECK(!pe.GetImportDirWrapper()->IsValidWrapper());
+    PEW_CHECK(!pe.GetExportDirWrapper()->IsValidWrapper());
+    PEW_CHECK(!pe.GetResourceDirWrapper()->IsValidWrapper());
+    PEW_CHECK(!pe.GetDebugDirWrapper()->IsValidWrapper());
+}
+
+PEW_TEST(MalformedRsrcNameOutOfFile)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 1;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t root_offset = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "rsrc_name", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        root_offset = pe.GetResourceDirWrapper()->GetRootRsrcDirOffset();
+    }
+
+    // Root entry named by a string whose Length field is the last WORD of the file and claims 0xFFFF units
+    const WORD length = 0xFFFF;
+    std::memcpy(image.data() + image.size() - sizeof(WORD), &length, sizeof(length));
+    DWORD name = 0x80000000 | (DWORD)(image.size() - sizeof(WORD) - root_offset);
+    std::memcpy(image.data() + root_offset + sizeof(IMAGE_RESOURCE_DIRECTORY), &name, sizeof(name));
+
+    {
+        RawFile raw_file(std::filesystem::path(), "rsrc_name", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+
+        PEW_CHECK(rsrc_dir_wrapper->IsString());
+        PEW_CHECK(rsrc_dir_wrapper->GetName().empty());
+    }
+
+    // Same entry pointing past the end of the file
+    name = 0x80000000 | (DWORD)(image.size() - root_offset);
+    std::memcpy(image.data() + root_offset + sizeof(IMAGE_RESOURCE_DIRECTORY), &name, sizeof(name));
+
+    {
+        RawFile raw_file(std::filesystem::path(), "rsrc_name", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+        PEW_CHECK(pe.GetResourceDirWrapper()->GetName().empty());
+    }
+}
@@ -0,0 +1,95 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    std::vector<IMAGE_SECTION_HEADER> ReadSectionHdrs(std::vector<BYTE>& image, offset_t& section_hdrs_offset)
+    {
+        RawFile raw_file(std::filesystem::path(), "sections", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        section_hdrs_offset = pe.GetSectionHdrsOffset();
+
+        std::vector<IMAGE_SECTION_HEADER> section_hdrs(pe.GetSectionHdrsWrapper()->GetNumOfSections());
+        std::memcpy(section_hdrs.data(), image.data() + section_hdrs_offset, section_hdrs.size() * sizeof(IMAGE_SECTION_HEADER));
+
+        return section_hdrs;
+    }
+
+    void WriteSectionHdrs(std::vector<BYTE>& image, offset_t section_hdrs_offset, const std::vector<IMAGE_SECTION_HEADER>& section_hdrs)
+    {
+        std::memcpy(image.data() + section_hdrs_offset, section_hdrs.data(), section_hdrs.size() * sizeof(IMAGE_SECTION_HEADER));
+    }
+
+}
+
+PEW_TEST(RvaToRawVirtualTailIsNotMapped)
+{
+    SyntheticPE::Config config;
+    config.sections_count = 3;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t section_hdrs_offset = 0;
+    std::vector<IMAGE_SECTION_HEADER> section_hdrs = ReadSectionHdrs(image, section_hdrs_offset);
+    PEW_CHECK(section_hdrs.size() == 3);
+
+    // First section grows a virtual only tail that reaches over the second one, the second one a tail like a .bss
+    IMAGE_SECTION_HEADER first = section_hdrs[0];
+    IMAGE_SECTION_HEADER second = section_hdrs[1];
+    section_hdrs[0].Misc.VirtualSize = second.VirtualAddress + second.SizeOfRawData - first.VirtualAddress;
+    section_hdrs[1].Misc.VirtualSize = second.SizeOfRawData + 0x3000;
+    WriteSectionHdrs(image, section_hdrs_offset, section_hdrs);
+
+    RawFile raw_file(std::filesystem::path(), "sections", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    PEW_CHECK(pe.RvaToRaw(first.VirtualAddress + first.SizeOfRawData - 1) == first.PointerToRawData + first.SizeOfRawData - 1);
+    PEW_CHECK(pe.RvaToRaw(second.VirtualAddress + 4) == second.PointerToRawData + 4);
+
+    PEW_CHECK(pe.RvaToRaw(second.VirtualAddress + second.SizeOfRawData - 1) == second.PointerToRawData + second.SizeOfRawData - 1);
+    PEW_CHECK(pe.RvaToRaw(second.VirtualAddress + second.SizeOfRawData) == 0);
+    PEW_CHECK(pe.RvaToRaw(second.VirtualAddress + second.SizeOfRawData + 0x2000) == 0);
+}
+
+PEW_TEST(RvaToRawOverlapsPickTableOrder)
+{
+    SyntheticPE::Config config;
+    config.sections_count = 3;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t section_hdrs_offset = 0;
+    std::vector<IMAGE_SECTION_HEADER> section_hdrs = ReadSectionHdrs(image, section_hdrs_offset);
+    PEW_CHECK(section_hdrs.size() == 3);
+
+    // The second section starts inside the first, the third one covers the start of both of them
+    DWORD base = section_hdrs[0].VirtualAddress;
+    section_hdrs[0].Misc.VirtualSize = section_hdrs[0].SizeOfRawData = 0x200;
+    section_hdrs[1].VirtualAddress = base + 0x100;
+    section_hdrs[1].Misc.VirtualSize = section_hdrs[1].SizeOfRawData = 0x200;
+    section_hdrs[2].VirtualAddress = base - 0x100;
+    section_hdrs[2].PointerToRawData = 0x600;
+    section_hdrs[2].Misc.VirtualSize = section_hdrs[2].SizeOfRawData = 0x500;
+    WriteSectionHdrs(image, section_hdrs_offset, section_hdrs);
+
+    RawFile raw_file(std::filesystem::path(), "sections", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    // Covered only by the third section
+    PEW_CHECK(pe.RvaToRaw(base - 0x10) == section_hdrs[2].PointerToRawData + 0xF0);
+    // Covered by all three, the first one wins even though the second starts later
+    PEW_CHECK(pe.RvaToRaw(base + 0x180) == section_hdrs[0].PointerToRawData + 0x180);
+    // Past the first section, the second one wins over the third
+    PEW_CHECK(pe.RvaToRaw(base + 0x280) == section_hdrs[1].PointerToRawData + 0x180);
+    // Past the second section, only the third is left
+    PEW_CHECK(pe.RvaToRaw(base + 0x350) == section_hdrs[2].PointerToRawData + 0x450);
+    PEW_CHECK(pe.RvaToRaw(base + 0x400) == 0);
+
+    // Repeated lookups go through the cached section and must not change the pick
+    PEW_CHECK(pe.RvaToRaw(base + 0x280) == section_hdrs[1].PointerToRawData + 0x180);
+    PEW_CHECK(pe.RvaToRaw(base + 0x180) == section_hdrs[0].PointerToRawData + 0x180);
+}
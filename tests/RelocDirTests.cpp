@@ -0,0 +1,153 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    const SimdIsa kIsas[] = { SimdIsa::SCALAR, SimdIsa::SSE2, SimdIsa::AVX2 };
+
+    struct Block
+    {
+        DWORD page_rva;
+        std::vector<WORD> entries;
+        DWORD size_of_block;      // 0 for the real size
+    };
+
+    std::vector<BYTE> BuildChain(const std::vector<Block>& blocks, size_t dir_size)
+    {
+        std::vector<BYTE> chain;
+        for (const Block& block : blocks)
+        {
+            IMAGE_BASE_RELOCATION hdr = {};
+            hdr.VirtualAddress = block.page_rva;
+            hdr.SizeOfBlock = block.size_of_block ? block.size_of_block : (DWORD)(sizeof(hdr) + block.entries.size() * sizeof(WORD));
+
+            chain.insert(chain.end(), (BYTE*)&hdr, (BYTE*)&hdr + sizeof(hdr));
+            chain.insert(chain.end(), (BYTE*)block.entries.data(), (BYTE*)(block.entries.data() + block.entries.size()));
+        }
+
+        chain.resize(dir_size);
+        return chain;
+    }
+
+    std::vector<WORD> Entries(size_t count, WORD type)
+    {
+        std::vector<WORD> entries(count);
+        for (size_t i = 0; i < count; i++)
+            entries[i] = (WORD)((type << 12) | ((i * 8) & 0x0FFF));
+
+        return entries;
+    }
+
+}
+
+PEW_TEST(RelocDecodeEntriesMatchesScalar)
+{
+    std::vector<WORD> entries(64);
+    for (size_t i = 0; i < entries.size(); i++)
+        entries[i] = (WORD)(i * 0x9E37 + 0x1234);
+
+    for (size_t count = 0; count <= entries.size(); count++)
+    {
+        std::vector<DWORD> scalar_rvas(count);
+        std::vector<BYTE> scalar_types(count);
+        RelocDirWrapper::DecodeEntries(SimdIsa::SCALAR, (const BYTE*)entries.data(), count, 0x7FFFF000, scalar_rvas.data(), scalar_types.data());
+
+        for (size_t i = 0; i < count; i++)
+        {
+            PEW_CHECK(scalar_rvas[i] == 0x7FFFF000 + (entries[i] & 0x0FFF));
+            PEW_CHECK(scalar_types[i] == entries[i] >> 12);
+        }
+
+        for (SimdIsa isa : kIsas)
+        {
+            if (isa > GetSimdIsa())
+                continue;
+
+            std::vector<DWORD> rvas(count);
+            std::vector<BYTE> types(count);
+            RelocDirWrapper::DecodeEntries(isa, (const BYTE*)entries.data(), count, 0x7FFFF000, rvas.data(), types.data());
+
+            PEW_CHECK(rvas == scalar_rvas);
+            PEW_CHECK(types == scalar_types);
+        }
+    }
+}
+
+PEW_TEST(RelocTableMatchesForEveryIsa)
+{
+    SyntheticPE::Config config;
+    config.relocs_count = 200;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    // Odd entry count with a HIGHADJ in the middle, HIGHADJs on both sides of the 8 and 16 entry SIMD steps plus one
+    // as the last entry of its block, then a block whose SizeOfBlock runs past the directory
+    Block first = { 0x1000, Entries(21, IMAGE_REL_BASED_HIGHLOW), 0 };
+    first.entries[9] = (IMAGE_REL_BASED_HIGHADJ << 12) | 0x48;
+    first.entries[10] = 0xBEEF;
+    first.entries[20] = IMAGE_REL_BASED_ABSOLUTE << 12;
+
+    Block second = { 0x2000, Entries(37, IMAGE_REL_BASED_DIR64), 0 };
+    second.entries[7] = (IMAGE_REL_BASED_HIGHADJ << 12) | 0x38;
+    second.entries[8] = 0x4321;
+    second.entries[15] = (IMAGE_REL_BASED_HIGHADJ << 12) | 0x78;
+    second.entries[16] = (IMAGE_REL_BASED_HIGHLOW << 12) | 0x80;
+    second.entries[36] = (IMAGE_REL_BASED_HIGHADJ << 12) | 0x120;
+
+    Block truncated = { 0x3000, Entries(17, IMAGE_REL_BASED_HIGHLOW), (DWORD)(sizeof(IMAGE_BASE_RELOCATION) + 40 * sizeof(WORD)) };
+
+    const size_t dir_size = 3 * sizeof(IMAGE_BASE_RELOCATION) + (21 + 37 + 17) * sizeof(WORD);
+    std::vector<BYTE> chain = BuildChain({ first, second, truncated }, dir_size);
+
+    {
+        RawFile raw_file(std::filesystem::path(), "relocs", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        IMAGE_DATA_DIRECTORY* data_dir = pe.GetDataDirectory();
+        PEW_CHECK(data_dir[DataDirEntries::BRELOC].Size >= dir_size);
+
+        data_dir[DataDirEntries::BRELOC].Size = (DWORD)dir_size;
+        std::memcpy(image.data() + pe.GetRelocDirWrapper()->GetRootBlockOffset(), chain.data(), chain.size());
+    }
+
+    RawFile raw_file(std::filesystem::path(), "relocs", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    PEW_CHECK(pe.GetDataDirectory()[DataDirEntries::BRELOC].Size == dir_size);
+
+    RelocDirWrapper scalar(&pe, SimdIsa::SCALAR);
+    const RelocTable& expected = scalar.GetRelocTable();
+
+    PEW_CHECK(!expected.is_chain_valid);
+    PEW_CHECK(expected.GetBlocksCount() == 3);
+    PEW_CHECK(expected.GetEntriesCount(0) == 21 && expected.GetEntriesCount(1) == 37 && expected.GetEntriesCount(2) == 17);
+    PEW_CHECK(expected.rvas[9] == 0x1048 && expected.types[9] == IMAGE_REL_BASED_HIGHADJ);
+    PEW_CHECK(expected.types[10] == IMAGE_REL_BASED_ABSOLUTE);
+    PEW_CHECK(expected.types[21 + 16] == IMAGE_REL_BASED_ABSOLUTE);
+    PEW_CHECK(expected.types[21 + 36] == IMAGE_REL_BASED_HIGHADJ);
+    PEW_CHECK(expected.rvas.back() == 0x3000 + 16 * 8);
+    PEW_CHECK(expected.type_counts[IMAGE_REL_BASED_HIGHADJ] == 4);
+    PEW_CHECK(expected.type_counts[IMAGE_REL_BASED_ABSOLUTE] == 4);
+    PEW_CHECK(expected.type_counts[IMAGE_REL_BASED_DIR64] == 37 - 5);
+    PEW_CHECK(expected.type_counts[IMAGE_REL_BASED_HIGHLOW] == 21 - 3 + 17);
+
+    for (SimdIsa isa : kIsas)
+    {
+        if (isa > GetSimdIsa())
+            continue;
+
+        RelocDirWrapper wrapper(&pe, isa);
+        const RelocTable& table = wrapper.GetRelocTable();
+
+        PEW_CHECK(table.block_offsets == expected.block_offsets);
+        PEW_CHECK(table.page_rvas == expected.page_rvas);
+        PEW_CHECK(table.entry_begin == expected.entry_begin);
+        PEW_CHECK(table.rvas == expected.rvas);
+        PEW_CHECK(table.types == expected.types);
+        PEW_CHECK(table.type_counts == expected.type_counts);
+        PEW_CHECK(table.is_chain_valid == expected.is_chain_valid);
+    }
+}
@@ -0,0 +1,171 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace PewParser;
+
+namespace {
+
+    WORD GetMaxLevel(const RsrcTree& tree)
+    {
+        WORD max_level = 0;
+        for (const RsrcNode& node : tree.nodes)
+            max_level = std::max(max_level, node.level);
+
+        return max_level;
+    }
+
+}
+
+PEW_TEST(RsrcTreeAtMaxLevel)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 2;
+    config.rsrc_extra_depth = RsrcTree::kMaxLevel - 3;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_max_level", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+    const RsrcTree& tree = rsrc_dir_wrapper->GetRsrcTree();
+
+    PEW_CHECK(GetMaxLevel(tree) == RsrcTree::kMaxLevel);
+    PEW_CHECK(tree.truncated_count == 0);
+    PEW_CHECK(rsrc_dir_wrapper->GetPayloads().size() == 2);
+}
+
+PEW_TEST(RsrcTreeDepthIsCapped)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 2;
+    config.rsrc_extra_depth = 64;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_deep", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+    const RsrcTree& tree = rsrc_dir_wrapper->GetRsrcTree();
+
+    PEW_CHECK(GetMaxLevel(tree) == RsrcTree::kMaxLevel);
+    PEW_CHECK(tree.truncated_count == 2);
+    PEW_CHECK(tree.GetNodesCount() == 2 * RsrcTree::kMaxLevel);
+    PEW_CHECK(rsrc_dir_wrapper->GetPayloads().empty());
+}
+
+PEW_TEST(RsrcTreeOverlappingDirsAreNotExpanded)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 1;
+    config.rsrc_payload_size = 0x10000;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t root_offset = 0;
+    DWORD rsrc_size = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "rsrc_overlap", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        root_offset = pe.GetResourceDirWrapper()->GetRootRsrcDirOffset();
+        rsrc_size = pe.GetDataDirectory()[DataDirEntries::RSRC].Size;
+    }
+
+    // Root entry i links to a directory header 8 * i bytes past the root. Those headers sit on the root's own entries,
+    // so each of them reads an entry count of about 0x8000 out of the OffsetToData of the entry before it.
+    const WORD entries_count = 64;
+    IMAGE_RESOURCE_DIRECTORY root = {};
+    root.NumberOfIdEntries = entries_count;
+    std::memcpy(image.data() + root_offset, &root, sizeof(root));
+    for (WORD i = 0; i < entries_count; i++)
+    {
+        DWORD entry[2] = { i, 0x80000000 | (DWORD)(i * 8) };
+        std::memcpy(image.data() + root_offset + sizeof(root) + i * sizeof(entry), entry, sizeof(entry));
+    }
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_overlap", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    const RsrcTree& tree = pe.GetResourceDirWrapper()->GetRsrcTree();
+
+    PEW_CHECK(tree.GetNodesCount() == entries_count);
+    PEW_CHECK(tree.GetNodesCount() <= rsrc_size / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+    PEW_CHECK(tree.revisits_count == 1);
+    PEW_CHECK(tree.overlaps_count == entries_count - 1u);
+}
+
+PEW_TEST(RsrcPayloadsResolveToLeafData)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 3;
+    config.rsrc_names_per_type = 2;
+    config.rsrc_langs_per_name = 2;
+    config.rsrc_payload_size = 0x30;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_payloads", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+    const RsrcTree& tree = rsrc_dir_wrapper->GetRsrcTree();
+    const std::pmr::vector<RsrcPayload>& payloads = rsrc_dir_wrapper->GetPayloads();
+
+    PEW_CHECK(payloads.size() == 3 * 2 * 2);
+
+    // The generator fills leaf i with the byte i
+    std::vector<bool> seen(payloads.size(), false);
+    for (const RsrcPayload& payload : payloads)
+    {
+        PEW_CHECK(payload.size == config.rsrc_payload_size);
+        PEW_CHECK(payload.raw && payload.raw == pe.RvaToRaw(payload.rva));
+        PEW_CHECK(payload.data.data() == image.data() + payload.raw);
+        PEW_CHECK(payload.data.size() == payload.size);
+        PEW_CHECK(!payload.IsTruncated());
+
+        BYTE fill = payload.data[0];
+        PEW_CHECK(fill < seen.size() && !seen[fill]);
+        seen[fill] = true;
+        PEW_CHECK(std::all_of(payload.data.begin(), payload.data.end(), [fill](BYTE b) { return b == fill; }));
+
+        PEW_CHECK(!tree.nodes[payload.node].is_directory);
+        PEW_CHECK(tree.nodes[payload.type_node].level == ResourceDirWrapper::TreeLevel::TYPE);
+        PEW_CHECK(tree.nodes[payload.name_node].level == ResourceDirWrapper::TreeLevel::ID);
+        PEW_CHECK(tree.nodes[payload.lang_node].level == ResourceDirWrapper::TreeLevel::LANGUAGE);
+        PEW_CHECK(tree.nodes[payload.lang_node].GetId() >= 0x409);
+    }
+}
+
+PEW_TEST(RsrcPayloadsPastTheFileAreClamped)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 2;
+    config.rsrc_payload_size = 0x20;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t data_entries[2] = {};
+    {
+        RawFile raw_file(std::filesystem::path(), "rsrc_clamped", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+        const std::pmr::vector<RsrcPayload>& payloads = rsrc_dir_wrapper->GetPayloads();
+        PEW_CHECK(payloads.size() == 2);
+
+        for (index_t i = 0; i < 2; i++)
+            data_entries[i] = rsrc_dir_wrapper->GetRsrcTree().nodes[payloads[i].node].data_offset;
+    }
+
+    // First payload runs past the end of the file, the second one points out of the image
+    IMAGE_RESOURCE_DATA_ENTRY* data_entry = (IMAGE_RESOURCE_DATA_ENTRY*)(image.data() + data_entries[0]);
+    data_entry->Size = 0x7FFFFFFF;
+    data_entry = (IMAGE_RESOURCE_DATA_ENTRY*)(image.data() + data_entries[1]);
+    data_entry->OffsetToData = 0x00F00000;
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_clamped", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    const std::pmr::vector<RsrcPayload>& payloads = pe.GetResourceDirWrapper()->GetPayloads();
+
+    PEW_CHECK(payloads.size() == 2);
+    PEW_CHECK(payloads[0].IsTruncated());
+    PEW_CHECK(payloads[0].data.data() + payloads[0].data.size() == image.data() + image.size());
+    PEW_CHECK(payloads[1].raw == 0);
+    PEW_CHECK(payloads[1].data.empty());
+}
@@ -0,0 +1,141 @@
+#include <PewParser/PewParser.h>
+#include <Terminal/RsrcDumper.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace PewParser;
+
+namespace {
+
+    std::vector<BYTE> ReadBytes(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<BYTE>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Every payload lands in its own file with the bytes of the image
+    void CheckDump(PEFile& pe, const std::filesystem::path& out_dir)
+    {
+        std::filesystem::remove_all(out_dir);
+
+        RsrcDumper dumper(&pe);
+        RsrcDumper::Stats stats = dumper.Dump(out_dir);
+
+        ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+        const std::pmr::vector<RsrcPayload>& payloads = rsrc_dir_wrapper->GetPayloads();
+
+        PEW_CHECK(stats.payloads_count == payloads.size());
+        PEW_CHECK(stats.dumped_count == payloads.size());
+        PEW_CHECK(stats.failed_count == 0);
+        PEW_CHECK(stats.truncated_count == 0);
+
+        uintmax_t bytes_count = 0;
+        for (index_t index = 0; index < payloads.size(); index++)
+        {
+            const RsrcPayload& payload = payloads[index];
+            std::vector<BYTE> dumped = ReadBytes(out_dir / RsrcDumper::GetPayloadFilename(rsrc_dir_wrapper, index, payload));
+
+            PEW_CHECK(dumped.size() == payload.data.size());
+            PEW_CHECK(std::equal(dumped.begin(), dumped.end(), payload.data.begin()));
+            bytes_count += dumped.size();
+        }
+        PEW_CHECK(stats.bytes_count == bytes_count);
+
+        std::filesystem::remove_all(out_dir);
+    }
+
+}
+
+PEW_TEST(RsrcDumperFilenames)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 6;
+    config.rsrc_names_per_type = 2;
+    config.rsrc_named_entries = true;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_filenames", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+    const std::pmr::vector<RsrcPayload>& payloads = rsrc_dir_wrapper->GetPayloads();
+
+    // Type names are sanitized, the named entries keep their generated names
+    PEW_CHECK(payloads.size() == 6 * 2);
+    PEW_CHECK(RsrcDumper::GetPayloadFilename(rsrc_dir_wrapper, 0, payloads[0]) == "0_Cursor_" + SyntheticPE::RsrcName(0) + "_1033.bin");
+    PEW_CHECK(RsrcDumper::GetPayloadFilename(rsrc_dir_wrapper, 1, payloads[1]) == "1_Cursor_" + SyntheticPE::RsrcName(1) + "_1033.bin");
+    PEW_CHECK(RsrcDumper::GetPayloadFilename(rsrc_dir_wrapper, 11, payloads[11]) == "11_String_Table_" + SyntheticPE::RsrcName(1) + "_1033.bin");
+}
+
+PEW_TEST(RsrcDumperFromMemory)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 4;
+    config.rsrc_names_per_type = 3;
+    config.rsrc_payload_size = 0x40;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_dump", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    CheckDump(pe, std::filesystem::temp_directory_path() / "pew_rsrc_dump_memory");
+}
+
+PEW_TEST(RsrcDumperFromFile)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 4;
+    config.rsrc_names_per_type = 3;
+    config.rsrc_payload_size = 0x1000;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    // Mapped from disk the payloads are copied from the source file
+    std::filesystem::path src = std::filesystem::temp_directory_path() / "pew_rsrc_dump_src.bin";
+    {
+        std::ofstream file(src, std::ios::binary | std::ios::trunc);
+        file.write((const char*)image.data(), image.size());
+    }
+
+    RawFile raw_file = LoadFile(src);
+    PEW_CHECK(raw_file && raw_file.Size() == image.size());
+
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    CheckDump(pe, std::filesystem::temp_directory_path() / "pew_rsrc_dump_file");
+
+    raw_file.Delete();
+    std::filesystem::remove(src);
+}
+
+PEW_TEST(RsrcDumperSkipsUnbackedPayloads)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = 2;
+    config.rsrc_payload_size = 0x20;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t data_entry_offset = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "rsrc_unbacked", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+        data_entry_offset = rsrc_dir_wrapper->GetRsrcTree().nodes[rsrc_dir_wrapper->GetPayloads()[1].node].data_offset;
+    }
+    ((IMAGE_RESOURCE_DATA_ENTRY*)(image.data() + data_entry_offset))->OffsetToData = 0x00F00000;
+
+    RawFile raw_file(std::filesystem::path(), "rsrc_unbacked", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+
+    std::filesystem::path out_dir = std::filesystem::temp_directory_path() / "pew_rsrc_dump_unbacked";
+    std::filesystem::remove_all(out_dir);
+
+    RsrcDumper::Stats stats = RsrcDumper(&pe).Dump(out_dir);
+    PEW_CHECK(stats.payloads_count == 2);
+    PEW_CHECK(stats.dumped_count == 1);
+    PEW_CHECK(stats.failed_count == 1);
+    PEW_CHECK(std::filesystem::exists(out_dir / RsrcDumper::GetPayloadFilename(pe.GetResourceDirWrapper(), 0, pe.GetResourceDirWrapper()->GetPayloads()[0])));
+
+    std::filesystem::remove_all(out_dir);
+}
@@ -0,0 +1,99 @@
+#include <PewParser/PewParser.h>
+#include <Serializer/JsonWriter.h>
+#include <Serializer/PESerializer.h>
+
+#include "Test.h"
+#include "JsonChecker.h"
+#include "SyntheticPE.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    std::string WriteString(std::string_view value)
+    {
+        JsonWriter writer;
+        writer.BeginObject();
+        writer.Key("value");
+        writer.String(value);
+        writer.EndObject();
+
+        return std::string(writer.View());
+    }
+
+    // Overwrites every occurrence of pattern with filler bytes of the same length
+    void FillPattern(std::vector<BYTE>& image, std::string_view pattern, BYTE filler)
+    {
+        auto it = image.begin();
+        while ((it = std::search(it, image.end(), pattern.begin(), pattern.end())) != image.end())
+        {
+            std::fill(it, it + pattern.size(), filler);
+            it += pattern.size();
+        }
+    }
+
+}
+
+PEW_TEST(JsonWriterKeepsWellFormedUtf8)
+{
+    // e acute, euro sign and an emoji are copied as is
+    std::string json = WriteString("\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+
+    PEW_CHECK(IsValidJson(json));
+    PEW_CHECK(json == "{\"value\":\"\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\"}");
+}
+
+PEW_TEST(JsonWriterEscapesInvalidUtf8)
+{
+    const char* invalid[] = {
+        "\xC3\xCC\xCC\xCC",        // lead byte followed by a non continuation byte
+        "\xCC\xCC\xCC\xCC",        // stray continuation bytes
+        "\xC0\xAF",                // overlong '/'
+        "\xED\xA0\x80",            // UTF-16 surrogate
+        "\xF4\x90\x80\x80",        // past U+10FFFF
+        "\xE2\x82",                // truncated sequence
+        "\xFF\xFE",
+    };
+
+    for (const char* value : invalid)
+        PEW_CHECK(IsValidJson(WriteString(value)));
+
+    PEW_CHECK(WriteString("\xC3\xCC") == "{\"value\":\"\\u00C3\\u00CC\"}");
+    PEW_CHECK(WriteString("a\x01\"\\") == "{\"value\":\"a\\u0001\\\"\\\\\"}");
+}
+
+PEW_TEST(SerializePEWithRawByteNames)
+{
+    SyntheticPE::Config config;
+    config.sections_count = 4;
+    config.exports_count = 8;
+    config.rsrc_types_count = 2;
+    config.rsrc_named_entries = true;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    // Section names and export names are raw bytes, fill them with values that are not UTF-8
+    FillPattern(image, SyntheticPE::ExportName(0), 0xCC);
+    FillPattern(image, SyntheticPE::ExportName(1), 0x80);
+    const BYTE section_name[IMAGE_SIZEOF_SHORT_NAME] = { 0xC3, 0xCC, 0xCC, 0xFF, 0xED, 0xA0, 0x80, 0xC0 };
+    auto text = std::search(image.begin(), image.end(), ".text", ".text" + 5);
+    PEW_CHECK(text != image.end());
+    std::copy(section_name, section_name + sizeof(section_name), text);
+
+    RawFile raw_file(std::filesystem::path(), "raw_names", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEType type = PEParser::ValidatePE(raw_file);
+    PEW_CHECK(type == PEType::x64PE);
+
+    PEFile pe(raw_file, type);
+    JsonWriter writer;
+    writer.BeginObject();
+    PESerializer::SerializePE(&pe, writer);
+    writer.EndObject();
+
+    std::string_view record = writer.View();
+    PEW_CHECK(IsValidJson(record));
+    PEW_CHECK(record.find("\\u00C3\\u00CC\\u00CC\\u00FF\\u00ED\\u00A0\\u0080\\u00C0") != std::string_view::npos);
+    PEW_CHECK(record.find("\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC\\u00CC") != std::string_view::npos);
+}
@@ -0,0 +1,44 @@
+#include "Test.h"
+
+namespace PewParser {
+
+    TestRegistry& TestRegistry::Get()
+    {
+        static TestRegistry registry;
+        return registry;
+    }
+
+    bool TestRegistry::Register(const char* name, TestFunc func)
+    {
+        tests_.push_back({ name, func });
+        return true;
+    }
+
+    size_t TestRegistry::Run(std::ostream& out, const std::string& filter)
+    {
+        size_t run_count = 0;
+        size_t failed_count = 0;
+
+        for (const Test& test : tests_)
+        {
+            if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos)
+                continue;
+
+            run_count++;
+            try
+            {
+                test.func();
+                out << "[ OK ] " << test.name << "\n";
+            }
+            catch (const Failure& failure)
+            {
+                failed_count++;
+                out << "[FAIL] " << test.name << "\n       " << failure.file << ":" << failure.line << ": " << failure.expression << "\n";
+            }
+        }
+
+        out << run_count - failed_count << "/" << run_count << " tests passed\n";
+        return failed_count;
+    }
+
+}
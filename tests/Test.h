@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace PewParser {
+
+    // Minimal self registering test runner, a test fails on its first PEW_CHECK that does not hold
+    class TestRegistry
+    {
+    public:
+        typedef void (*TestFunc)();
+
+        struct Test
+        {
+            const char* name;
+            TestFunc func;
+        };
+
+        struct Failure
+        {
+            const char* file;
+            int line;
+            std::string expression;
+        };
+    public:
+        static TestRegistry& Get();
+
+        bool Register(const char* name, TestFunc func);
+
+        // Runs every test whose name contains filter, returns the number of failed tests
+        size_t Run(std::ostream& out, const std::string& filter);
+    private:
+        std::vector<Test> tests_;
+    };
+
+}
+
+#define PEW_TEST(name) \
+    static void name(); \
+    static const bool name##_registered = ::PewParser::TestRegistry::Get().Register(#name, name); \
+    static void name()
+
+#define PEW_CHECK(expression) \
+    do { \
+        if (!(expression)) \
+            throw ::PewParser::TestRegistry::Failure{ __FILE__, __LINE__, #expression }; \
+    } while (0)
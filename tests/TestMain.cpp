@@ -0,0 +1,12 @@
+#include "Test.h"
+
+#include <iostream>
+
+// PewParserTests [filter]
+// Exits with 1 when any test fails.
+int main(int argc, char* argv[])
+{
+    std::string filter = (argc > 1) ? argv[1] : "";
+
+    return PewParser::TestRegistry::Get().Run(std::cout, filter) ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    offset_t CallbacksFieldOffset(PEFile& pe, bool x64)
+    {
+        return pe.GetTlsDirWrapper()->GetTlsDirOffset() + (x64 ? offsetof(IMAGE_TLS_DIRECTORY64, AddressOfCallBacks) : offsetof(IMAGE_TLS_DIRECTORY32, AddressOfCallBacks));
+    }
+
+    void PutVa(std::vector<BYTE>& image, offset_t offset, ULONGLONG va, bool x64)
+    {
+        std::memcpy(image.data() + offset, &va, x64 ? sizeof(ULONGLONG) : sizeof(DWORD));
+    }
+
+    // The generator points callback i at .text + 16 * i
+    void CheckCallbacks(bool x64, size_t callbacks_count)
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.tls_dir = true;
+        config.tls_callbacks_count = callbacks_count;
+        std::vector<BYTE> image = SyntheticPE::Build(config);
+
+        RawFile raw_file(std::filesystem::path(), "tls", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        TlsDirWrapper* tls_dir_wrapper = pe.GetTlsDirWrapper();
+
+        PEW_CHECK(tls_dir_wrapper->IsValidWrapper());
+        PEW_CHECK(tls_dir_wrapper->IsCallbacksTerminated());
+        PEW_CHECK(tls_dir_wrapper->GetCallbacksOffset() == pe.VaToRaw(tls_dir_wrapper->GetAddressOfCallBacks()));
+
+        const std::pmr::vector<ULONGLONG>& callbacks = tls_dir_wrapper->GetCallbacks();
+        PEW_CHECK(callbacks.size() == callbacks_count);
+        for (index_t callback = 0; callback < callbacks.size(); callback++)
+            PEW_CHECK(callbacks[callback] == pe.GetImageBase() + 0x1000 + callback * 16);
+
+        ByteSpan raw_data = tls_dir_wrapper->GetRawData();
+        PEW_CHECK(!tls_dir_wrapper->IsRawDataTruncated());
+        PEW_CHECK(raw_data.size() == tls_dir_wrapper->GetEndAddressOfRawData() - tls_dir_wrapper->GetStartAddressOfRawData());
+        for (index_t i = 0; i < raw_data.size(); i++)
+            PEW_CHECK(raw_data[i] == (BYTE)(i + 1));
+    }
+
+}
+
+PEW_TEST(TlsCallbacksX64)
+{
+    for (size_t callbacks_count : { 0, 1, 5, 64 })
+        CheckCallbacks(true, callbacks_count);
+}
+
+PEW_TEST(TlsCallbacksX86)
+{
+    for (size_t callbacks_count : { 0, 1, 5, 64 })
+        CheckCallbacks(false, callbacks_count);
+}
+
+PEW_TEST(TlsCallbacksCutByTheFile)
+{
+    for (bool x64 : { false, true })
+    {
+        SyntheticPE::Config config;
+        config.x64 = x64;
+        config.tls_dir = true;
+        config.tls_callbacks_count = 2;
+        std::vector<BYTE> image = SyntheticPE::Build(config);
+
+        size_t slot_size = x64 ? sizeof(ULONGLONG) : sizeof(DWORD);
+        offset_t callbacks_field = 0;
+        ULONGLONG callbacks_va = 0;
+        {
+            RawFile raw_file(std::filesystem::path(), "tls_cut", image.size(), image.data(), RawFile::Backing::BORROWED);
+            PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+            callbacks_field = CallbacksFieldOffset(pe, x64);
+
+            // Last three slots of the file, none of them null
+            offset_t slots = image.size() - 3 * slot_size;
+            IMAGE_SECTION_HEADER* last_section = pe.GetSectionHdrsWrapper()->GetRootSectionHdr() + pe.GetSectionHdrsWrapper()->GetNumOfSections() - 1;
+            while (!last_section->SizeOfRawData || last_section->PointerToRawData > slots)
+                last_section--;
+            callbacks_va = pe.GetImageBase() + last_section->VirtualAddress + (slots - last_section->PointerToRawData);
+
+            for (index_t slot = 0; slot < 3; slot++)
+                PutVa(image, slots + slot * slot_size, pe.GetImageBase() + 0x1000 + slot, x64);
+        }
+        PutVa(image, callbacks_field, callbacks_va, x64);
+
+        RawFile raw_file(std::filesystem::path(), "tls_cut", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        TlsDirWrapper* tls_dir_wrapper = pe.GetTlsDirWrapper();
+
+        PEW_CHECK(tls_dir_wrapper->GetCallbacksOffset() == image.size() - 3 * slot_size);
+        PEW_CHECK(!tls_dir_wrapper->IsCallbacksTerminated());
+        PEW_CHECK(tls_dir_wrapper->GetCallbacks().size() == 3);
+        PEW_CHECK(tls_dir_wrapper->GetCallbacks()[2] == pe.GetImageBase() + 0x1002);
+    }
+}
+
+PEW_TEST(TlsCallbacksOutOfImage)
+{
+    SyntheticPE::Config config;
+    config.x64 = true;
+    config.tls_dir = true;
+    config.tls_callbacks_count = 2;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    offset_t callbacks_field = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "tls_out", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        callbacks_field = CallbacksFieldOffset(pe, true);
+    }
+
+    // Below the image base, nothing to read
+    PutVa(image, callbacks_field, 0x1000, true);
+
+    RawFile raw_file(std::filesystem::path(), "tls_out", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    TlsDirWrapper* tls_dir_wrapper = pe.GetTlsDirWrapper();
+
+    PEW_CHECK(tls_dir_wrapper->GetCallbacksOffset() == 0);
+    PEW_CHECK(tls_dir_wrapper->GetCallbacks().empty());
+}
@@ -0,0 +1,149 @@
+#include <PewParser/PewParser.h>
+#include <Utf16.h>
+
+#include "Test.h"
+
+#include <string>
+#include <functional>
+
+using namespace PewParser;
+
+namespace {
+
+    const std::string kReplacement = "\xEF\xBF\xBD";
+
+    struct Converted
+    {
+        std::string text;
+        bool valid;
+    };
+
+    // dst gets a guard past Utf8MaxSize(len) that no implementation may touch
+    Converted Convert(SimdIsa isa, const std::u16string& src)
+    {
+        const size_t kGuard = 64;
+        std::string dst(Utf8MaxSize(src.size()) + kGuard, '\x5A');
+
+        Converted converted;
+        converted.valid = false;
+        size_t written = Utf16ToUtf8(isa, (const WCHAR*)src.data(), src.size(), &dst[0], &converted.valid);
+
+        PEW_CHECK(written <= Utf8MaxSize(src.size()));
+        PEW_CHECK(dst.find_first_not_of('\x5A', Utf8MaxSize(src.size())) == std::string::npos);
+
+        converted.text = dst.substr(0, written);
+        return converted;
+    }
+
+    // Every supported vector width gives the bytes and validity of the scalar path
+    Converted CheckIsas(const std::u16string& src)
+    {
+        Converted scalar = Convert(SimdIsa::SCALAR, src);
+
+        for (SimdIsa isa : { SimdIsa::SSE2, SimdIsa::AVX2 })
+        {
+            if (isa > GetSimdIsa())
+                continue;
+
+            Converted simd = Convert(isa, src);
+            PEW_CHECK(simd.text == scalar.text);
+            PEW_CHECK(simd.valid == scalar.valid);
+        }
+
+        return scalar;
+    }
+
+    std::u16string Fill(size_t length, const std::function<char16_t(size_t)>& unit)
+    {
+        std::u16string str(length, u'\0');
+        for (size_t i = 0; i < length; i++)
+            str[i] = unit(i);
+
+        return str;
+    }
+
+    char16_t Ascii(size_t i) { return (char16_t)(u'a' + i % 26); }
+    char16_t TwoBytes(size_t i) { return (char16_t)(0x100 + i * 13 % 0x700); }
+    char16_t ThreeBytes(size_t i) { return (char16_t)(0x4E00 + i * 97); }
+    char16_t Mixed(size_t i) { return (i % 3 == 0) ? Ascii(i) : (i % 3 == 1) ? TwoBytes(i) : ThreeBytes(i); }
+
+    const size_t kMaxLength = 40;
+
+}
+
+PEW_TEST(Utf16RunsMatchScalar)
+{
+    for (size_t length = 0; length <= kMaxLength; length++)
+    {
+        Converted ascii = CheckIsas(Fill(length, Ascii));
+        PEW_CHECK(ascii.valid && ascii.text.size() == length);
+
+        Converted two_bytes = CheckIsas(Fill(length, TwoBytes));
+        PEW_CHECK(two_bytes.valid && two_bytes.text.size() == 2 * length);
+
+        Converted three_bytes = CheckIsas(Fill(length, ThreeBytes));
+        PEW_CHECK(three_bytes.valid && three_bytes.text.size() == 3 * length);
+
+        PEW_CHECK(CheckIsas(Fill(length, Mixed)).valid);
+    }
+
+    // Boundaries of every encoded length
+    std::u16string edges = u"\x007F\x0080\x07FF\x0800\xD7FF\xE000\xFFFF";
+    Converted converted = CheckIsas(edges);
+    PEW_CHECK(converted.valid);
+    PEW_CHECK(converted.text == "\x7F\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xEE\x80\x80\xEF\xBF\xBF");
+}
+
+PEW_TEST(Utf16SurrogatePairsAcrossBlocks)
+{
+    // U+1F600, the pair is moved over every position so it straddles the 8 and 16 unit block ends
+    const std::string kEncoded = "\xF0\x9F\x98\x80";
+
+    for (size_t length = 2; length <= kMaxLength; length++)
+    {
+        for (size_t position = 0; position + 1 < length; position++)
+        {
+            for (char16_t (*background)(size_t) : { Ascii, TwoBytes, ThreeBytes })
+            {
+                std::u16string src = Fill(length, background);
+                src[position] = 0xD83D;
+                src[position + 1] = 0xDE00;
+
+                Converted converted = CheckIsas(src);
+                PEW_CHECK(converted.valid);
+                PEW_CHECK(converted.text.find(kEncoded) != std::string::npos);
+            }
+        }
+    }
+}
+
+PEW_TEST(Utf16LoneSurrogates)
+{
+    for (size_t length = 1; length <= kMaxLength; length++)
+    {
+        for (size_t position = 0; position < length; position++)
+        {
+            for (char16_t surrogate : { (char16_t)0xD800, (char16_t)0xDBFF, (char16_t)0xDC00, (char16_t)0xDFFF })
+            {
+                for (char16_t (*background)(size_t) : { Ascii, TwoBytes, ThreeBytes })
+                {
+                    std::u16string src = Fill(length, background);
+                    src[position] = surrogate;
+
+                    Converted converted = CheckIsas(src);
+                    PEW_CHECK(!converted.valid);
+                    PEW_CHECK(converted.text.find(kReplacement) != std::string::npos);
+                }
+            }
+        }
+    }
+
+    // Two high surrogates in a row are both replaced, the low one after them still pairs with the second
+    Converted converted = CheckIsas(u"\xD83D\xD83D\xDE00");
+    PEW_CHECK(!converted.valid);
+    PEW_CHECK(converted.text == kReplacement + "\xF0\x9F\x98\x80");
+
+    converted = CheckIsas(u"\xDE00\xD83D");
+    PEW_CHECK(!converted.valid);
+    PEW_CHECK(converted.text == kReplacement + kReplacement);
+}
@@ -0,0 +1,204 @@
+#include <PewParser/PewParser.h>
+
+#include "Test.h"
+#include "SyntheticPE.h"
+
+#include <cstring>
+
+using namespace PewParser;
+
+namespace {
+
+    void PutWord(std::vector<BYTE>& bytes, size_t offset, WORD value)
+    {
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    }
+
+    void AppendUtf16(std::vector<BYTE>& bytes, const std::u16string& str)
+    {
+        for (char16_t c : str)
+        {
+            bytes.push_back((BYTE)c);
+            bytes.push_back((BYTE)(c >> 8));
+        }
+        bytes.push_back(0);
+        bytes.push_back(0);
+    }
+
+    void Align4(std::vector<BYTE>& bytes)
+    {
+        bytes.resize((bytes.size() + 3) & ~(size_t)3, 0);
+    }
+
+    // wLength, wValueLength, wType, szKey, padding, Value, padding, Children
+    std::vector<BYTE> Block(const std::u16string& key, const std::vector<BYTE>& value, WORD value_length, WORD type, const std::vector<std::vector<BYTE>>& children = {})
+    {
+        std::vector<BYTE> bytes(3 * sizeof(WORD), 0);
+        AppendUtf16(bytes, key);
+        Align4(bytes);
+        bytes.insert(bytes.end(), value.begin(), value.end());
+
+        for (const std::vector<BYTE>& child : children)
+        {
+            Align4(bytes);
+            bytes.insert(bytes.end(), child.begin(), child.end());
+        }
+
+        PutWord(bytes, 0, (WORD)bytes.size());
+        PutWord(bytes, sizeof(WORD), value_length);
+        PutWord(bytes, 2 * sizeof(WORD), type);
+
+        return bytes;
+    }
+
+    std::vector<BYTE> StringBlock(const std::u16string& key, const std::u16string& value)
+    {
+        std::vector<BYTE> value_bytes;
+        AppendUtf16(value_bytes, value);
+
+        return Block(key, value_bytes, (WORD)(value.size() + 1), 1);
+    }
+
+    std::vector<BYTE> BuildVersionInfo()
+    {
+        VS_FIXEDFILEINFO fixed_info = {};
+        fixed_info.dwSignature = VS_FFI_SIGNATURE;
+        fixed_info.dwStrucVersion = VS_FFI_STRUCVERSION;
+        fixed_info.dwFileVersionMS = 0x00010002;
+        fixed_info.dwFileVersionLS = 0x00030004;
+        fixed_info.dwProductVersionMS = 0x000A0000;
+        fixed_info.dwProductVersionLS = 0x00000001;
+        std::vector<BYTE> fixed_bytes((BYTE*)&fixed_info, (BYTE*)&fixed_info + sizeof(fixed_info));
+
+        std::vector<BYTE> first_table = Block(u"040904B0", {}, 0, 1, {
+            StringBlock(u"CompanyName", u"Pew Corp"),
+            StringBlock(u"FileDescription", u"Café € \xD83D\xDE00"),
+            StringBlock(u"FileVersion", u"1.2.3.4")
+        });
+        std::vector<BYTE> second_table = Block(u"040704B0", {}, 0, 1, {
+            StringBlock(u"CompanyName", u"Pew GmbH")
+        });
+
+        DWORD translation = 0x04B00409;
+        std::vector<BYTE> translation_bytes((BYTE*)&translation, (BYTE*)&translation + sizeof(translation));
+
+        return Block(u"VS_VERSION_INFO", fixed_bytes, sizeof(fixed_info), 0, {
+            Block(u"StringFileInfo", {}, 0, 1, { first_table, second_table }),
+            Block(u"VarFileInfo", {}, 0, 1, { Block(u"Translation", translation_bytes, sizeof(translation), 0) })
+        });
+    }
+
+}
+
+PEW_TEST(VersionInfoParse)
+{
+    std::vector<BYTE> bytes = BuildVersionInfo();
+
+    VersionInfo info;
+    PEW_CHECK(VersionInfoParser::Parse(ByteSpan(bytes.data(), bytes.size()), info));
+
+    PEW_CHECK(info.has_fixed_info);
+    PEW_CHECK(info.GetFileVersion() == "1.2.3.4");
+    PEW_CHECK(info.GetProductVersion() == "10.0.0.1");
+
+    PEW_CHECK(info.string_tables.size() == 2);
+    PEW_CHECK(info.GetTableKey(info.string_tables[0]) == "040904B0");
+    PEW_CHECK(info.string_tables[0].first_string == 0 && info.string_tables[0].strings_count == 3);
+    PEW_CHECK(info.GetTableKey(info.string_tables[1]) == "040704B0");
+    PEW_CHECK(info.string_tables[1].first_string == 3 && info.string_tables[1].strings_count == 1);
+
+    PEW_CHECK(info.strings.size() == 4);
+    PEW_CHECK(info.GetKey(info.strings[1]) == "FileDescription");
+    PEW_CHECK(info.GetValue(info.strings[1]) == "Caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+
+    // First table wins
+    PEW_CHECK(info.GetString("CompanyName") == "Pew Corp");
+    PEW_CHECK(info.GetString("FileVersion") == "1.2.3.4");
+    PEW_CHECK(info.GetString("ProductName").empty());
+
+    PEW_CHECK(info.translations.size() == 1 && info.translations[0] == 0x04B00409);
+}
+
+PEW_TEST(VersionInfoRejectsOtherRoots)
+{
+    std::vector<BYTE> bytes = Block(u"VS_VERSION_INF0", {}, 0, 0);
+
+    VersionInfo info;
+    PEW_CHECK(!VersionInfoParser::Parse(ByteSpan(bytes.data(), bytes.size()), info));
+    PEW_CHECK(!VersionInfoParser::Parse(ByteSpan(), info));
+}
+
+PEW_TEST(VersionInfoValueLengthInBytes)
+{
+    // Some linkers count wValueLength of text values in bytes, the value stops at its null
+    std::vector<BYTE> value_bytes;
+    AppendUtf16(value_bytes, u"1.0");
+    std::vector<BYTE> string_block = Block(u"FileVersion", value_bytes, (WORD)value_bytes.size(), 1);
+
+    std::vector<BYTE> bytes = Block(u"VS_VERSION_INFO", {}, 0, 0, {
+        Block(u"StringFileInfo", {}, 0, 1, { Block(u"000004B0", {}, 0, 1, { string_block, StringBlock(u"ProductName", u"Pew") }) })
+    });
+
+    VersionInfo info;
+    PEW_CHECK(VersionInfoParser::Parse(ByteSpan(bytes.data(), bytes.size()), info));
+    PEW_CHECK(!info.has_fixed_info);
+    PEW_CHECK(info.GetFileVersion().empty());
+    PEW_CHECK(info.GetString("FileVersion") == "1.0");
+    PEW_CHECK(info.GetString("ProductName") == "Pew");
+}
+
+PEW_TEST(VersionInfoTruncated)
+{
+    std::vector<BYTE> bytes = BuildVersionInfo();
+
+    VersionInfo full;
+    PEW_CHECK(VersionInfoParser::Parse(ByteSpan(bytes.data(), bytes.size()), full));
+
+    // Every prefix parses inside its own bytes and never decodes more than the whole resource
+    for (size_t size = 0; size < bytes.size(); size++)
+    {
+        std::vector<BYTE> prefix(bytes.begin(), bytes.begin() + size);
+
+        VersionInfo info;
+        bool parsed = VersionInfoParser::Parse(ByteSpan(prefix.data(), prefix.size()), info);
+        PEW_CHECK(parsed == (size >= 3 * sizeof(WORD) + sizeof(u"VS_VERSION_INFO")));
+        PEW_CHECK(info.strings.size() <= full.strings.size());
+        PEW_CHECK(info.translations.size() <= full.translations.size());
+        PEW_CHECK(info.text.size() <= full.text.size());
+    }
+}
+
+PEW_TEST(VersionInfoFromResources)
+{
+    SyntheticPE::Config config;
+    config.rsrc_types_count = ResourceDirWrapper::RT::VERSION;
+    config.rsrc_payload_size = 0x400;
+    std::vector<BYTE> image = SyntheticPE::Build(config);
+
+    std::vector<BYTE> bytes = BuildVersionInfo();
+    PEW_CHECK(bytes.size() <= config.rsrc_payload_size);
+
+    offset_t data_entry_offset = 0;
+    {
+        RawFile raw_file(std::filesystem::path(), "version_info", image.size(), image.data(), RawFile::Backing::BORROWED);
+        PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+        ResourceDirWrapper* rsrc_dir_wrapper = pe.GetResourceDirWrapper();
+        PEW_CHECK(rsrc_dir_wrapper->GetVersionInfo() == nullptr);
+
+        const RsrcPayload& payload = rsrc_dir_wrapper->GetPayloads().back();
+        PEW_CHECK(rsrc_dir_wrapper->GetRsrcTree().nodes[payload.type_node].GetId() == ResourceDirWrapper::RT::VERSION);
+
+        data_entry_offset = rsrc_dir_wrapper->GetRsrcTree().nodes[payload.node].data_offset;
+        std::memcpy(image.data() + payload.raw, bytes.data(), bytes.size());
+    }
+    ((IMAGE_RESOURCE_DATA_ENTRY*)(image.data() + data_entry_offset))->Size = (DWORD)bytes.size();
+
+    RawFile raw_file(std::filesystem::path(), "version_info", image.size(), image.data(), RawFile::Backing::BORROWED);
+    PEFile pe(raw_file, PEParser::ValidatePE(raw_file));
+    const VersionInfo* info = pe.GetResourceDirWrapper()->GetVersionInfo();
+
+    PEW_CHECK(info != nullptr);
+    PEW_CHECK(info->GetFileVersion() == "1.2.3.4");
+    PEW_CHECK(info->GetString("CompanyName") == "Pew Corp");
+    PEW_CHECK(info->raw == pe.GetResourceDirWrapper()->GetPayloads().back().raw);
+}